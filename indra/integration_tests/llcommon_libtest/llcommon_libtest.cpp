@@ -0,0 +1,247 @@
+/**
+ * @file llcommon_libtest.cpp
+ * @brief Micro benchmarks for llcommon containers.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+#include "linden_common.h"
+#include "lltimer.h"
+
+#include "llcommon_libtest.h"
+
+// Linden library includes
+#include "llerrorcontrol.h"
+#include "llopenhashmap.h"
+#include "lluuid.h"
+
+// system libraries
+#include <iostream>
+#include <map>
+#include <vector>
+
+// doc string provided when invoking the program with --help
+static const char USAGE[] = "\n"
+"usage:\tllcommon_libtest [options]\n"
+"\n"
+" -h, --help\n"
+"        Print this help\n"
+" -n, --objects <n>\n"
+"        Number of objects in the local id benchmark. Default is 200000.\n"
+" -r, --regions <n>\n"
+"        Number of regions the objects are spread over. Default is 9.\n"
+" -p, --passes <n>\n"
+"        Terse update passes over every object. Default is 10.\n"
+"\n";
+
+// The local id benchmark replays what LLViewerObjectList does with its
+// lookup tables: every object is registered under its packed
+// (region index, local id) key and UUID, terse updates resolve local ids to
+// UUIDs and UUIDs to objects, and finally every object is killed.
+struct BenchObject
+{
+	LLUUID	mID;
+	U32		mLocalID;
+	U32		mRegion;
+};
+
+struct LocalIDTimes
+{
+	LocalIDTimes() : mInsert(0.0), mLookup(0.0), mErase(0.0), mChecksum(0) {}
+
+	F64 mInsert;
+	F64 mLookup;
+	F64 mErase;
+	U64 mChecksum;	// keeps the lookups from being optimized away
+};
+
+static inline U64 pack_index(U32 region, U32 local_id)
+{
+	return (((U64)region) << 32) | (U64)local_id;
+}
+
+static LocalIDTimes bench_std_map(const std::vector<BenchObject>& objects, S32 passes)
+{
+	LocalIDTimes times;
+	std::map<U64, LLUUID> local_to_uuid;
+	std::map<LLUUID, const BenchObject*> uuid_to_object;
+	LLTimer timer;
+
+	timer.reset();
+	for (std::vector<BenchObject>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+	{
+		local_to_uuid[pack_index(it->mRegion, it->mLocalID)] = it->mID;
+		uuid_to_object[it->mID] = &(*it);
+	}
+	times.mInsert = timer.getElapsedTimeF64();
+
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (std::vector<BenchObject>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			std::map<U64, LLUUID>::const_iterator found = local_to_uuid.find(pack_index(it->mRegion, it->mLocalID));
+			if (found != local_to_uuid.end())
+			{
+				std::map<LLUUID, const BenchObject*>::const_iterator objectp = uuid_to_object.find(found->second);
+				if (objectp != uuid_to_object.end())
+				{
+					times.mChecksum += objectp->second->mLocalID;
+				}
+			}
+		}
+	}
+	times.mLookup = timer.getElapsedTimeF64();
+
+	timer.reset();
+	for (std::vector<BenchObject>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+	{
+		local_to_uuid.erase(pack_index(it->mRegion, it->mLocalID));
+		uuid_to_object.erase(it->mID);
+	}
+	times.mErase = timer.getElapsedTimeF64();
+
+	return times;
+}
+
+static LocalIDTimes bench_open_hash_map(const std::vector<BenchObject>& objects, S32 passes)
+{
+	LocalIDTimes times;
+	LLOpenHashMap<U64, LLUUID> local_to_uuid;
+	LLOpenHashMap<LLUUID, const BenchObject*> uuid_to_object;
+	LLTimer timer;
+
+	timer.reset();
+	for (std::vector<BenchObject>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+	{
+		local_to_uuid.set(pack_index(it->mRegion, it->mLocalID), it->mID);
+		uuid_to_object.set(it->mID, &(*it));
+	}
+	times.mInsert = timer.getElapsedTimeF64();
+
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (std::vector<BenchObject>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			const LLUUID* idp = local_to_uuid.find(pack_index(it->mRegion, it->mLocalID));
+			if (idp)
+			{
+				const BenchObject* const* objectpp = uuid_to_object.find(*idp);
+				if (objectpp)
+				{
+					times.mChecksum += (*objectpp)->mLocalID;
+				}
+			}
+		}
+	}
+	times.mLookup = timer.getElapsedTimeF64();
+
+	timer.reset();
+	for (std::vector<BenchObject>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+	{
+		local_to_uuid.erase(pack_index(it->mRegion, it->mLocalID));
+		uuid_to_object.erase(it->mID);
+	}
+	times.mErase = timer.getElapsedTimeF64();
+
+	return times;
+}
+
+static void output_times(const char* name, const LocalIDTimes& times, U32 lookups)
+{
+	std::cout << llformat("%20s%12.3f%12.3f%12.3f%12.1f",
+						  name,
+						  times.mInsert * 1000.0,
+						  times.mLookup * 1000.0,
+						  times.mErase * 1000.0,
+						  times.mLookup > 0.0 ? lookups / (times.mLookup * 1000.0) : 0.0) << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	S32 num_objects = 200000;
+	S32 num_regions = 9;
+	S32 passes = 10;
+
+	// Init whatever is necessary
+	LLError::initForApplication(".", ".");
+
+	// Analyze command line arguments
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		if (!strcmp(argv[arg], "--help") || !strcmp(argv[arg], "-h"))
+		{
+			std::cout << USAGE << std::endl;
+			return 0;
+		}
+		else if ((!strcmp(argv[arg], "--objects") || !strcmp(argv[arg], "-n")) && arg < argc-1)
+		{
+			num_objects = llmax(1, atoi(argv[++arg]));
+		}
+		else if ((!strcmp(argv[arg], "--regions") || !strcmp(argv[arg], "-r")) && arg < argc-1)
+		{
+			num_regions = llmax(1, atoi(argv[++arg]));
+		}
+		else if ((!strcmp(argv[arg], "--passes") || !strcmp(argv[arg], "-p")) && arg < argc-1)
+		{
+			passes = llmax(1, atoi(argv[++arg]));
+		}
+	}
+
+	// Simulators hand out local ids roughly sequentially with gaps, and the
+	// viewer numbers regions from 1 in the order it first hears of them.
+	std::vector<BenchObject> objects(num_objects);
+	std::vector<U32> next_local_id(num_regions, 1);
+	for (S32 i = 0; i < num_objects; ++i)
+	{
+		BenchObject& object = objects[i];
+		object.mID.generate();
+		object.mRegion = 1 + (U32)(i % num_regions);
+		U32& local_id = next_local_id[object.mRegion - 1];
+		object.mLocalID = local_id;
+		local_id += 1 + (object.mID.mData[0] & 3);
+	}
+
+	// Terse updates do not arrive in creation order.
+	std::vector<BenchObject> shuffled(objects);
+	for (S32 i = num_objects - 1; i > 0; --i)
+	{
+		std::swap(shuffled[i], shuffled[shuffled[i].mID.mData[1] % (i + 1)]);
+	}
+
+	U32 lookups = (U32)num_objects * (U32)passes;
+	LocalIDTimes map_times = bench_std_map(shuffled, passes);
+	LocalIDTimes hash_times = bench_open_hash_map(shuffled, passes);
+
+	std::cout << num_objects << " objects in " << num_regions << " regions, "
+			  << passes << " update passes" << std::endl;
+	std::cout << llformat("%20s%12s%12s%12s%12s", "Table", "Insert ms", "Lookup ms", "Erase ms", "Lookups/ms") << std::endl;
+	output_times("std::map", map_times, lookups);
+	output_times("LLOpenHashMap", hash_times, lookups);
+
+	if (map_times.mChecksum != hash_times.mChecksum)
+	{
+		std::cout << "Error: tables disagree" << std::endl;
+		return 1;
+	}
+	return 0;
+}
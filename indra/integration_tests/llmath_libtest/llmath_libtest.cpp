@@ -0,0 +1,1364 @@
+/**
+ * @file llmath_libtest.cpp
+ * @brief Headless benchmarks for llmath geometry code.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+#include "linden_common.h"
+#include "lltimer.h"
+
+#include "llmath_libtest.h"
+
+// Linden library includes
+#include "llapr.h"
+#include "llmath.h"
+#include "llcamera.h"
+#include "llerrorcontrol.h"
+#include "lllinearoctree.h"
+#include "llmemory.h"
+#include "lloctree.h"
+#include "llmatrix4a.h"
+#include "llquaternion.h"
+#include "llskinningjob.h"
+#include "llthreadpool.h"
+#include "llvolume.h"
+#include "llvolumegeometryjob.h"
+
+// system libraries
+#include <iostream>
+#include <vector>
+
+// doc string provided when invoking the program with --help
+static const char USAGE[] = "\n"
+"usage:\tllmath_libtest [options]\n"
+"\n"
+" -h, --help\n"
+"        Print this help\n"
+" -n, --prims <n>\n"
+"        Number of prims in the synthetic region. Default is 10000.\n"
+" -t, --threads <n>\n"
+"        Worker threads for the parallel rebuild, 0 picks the viewer default.\n"
+"        Default is 0.\n"
+" -p, --passes <n>\n"
+"        Full region rebuilds and cull frames per run. Default is 5.\n"
+" -c, --cull-nodes <n>\n"
+"        Octree nodes in the frustum cull benchmark. Default is 50000.\n"
+" -o, --octree-elements <n>\n"
+"        Elements in the octree container benchmark. Default is 100000.\n"
+" -a, --avatars <n>\n"
+"        Avatars in the software skinning benchmark. Default is 50.\n"
+" -g, --grid <n>\n"
+"        Vertices per side of the face in the vertex cache benchmark.\n"
+"        Default is 250.\n"
+"\n";
+
+// The rebuild benchmark mimics what LLVolumeGeometryManager::genDrawInfo()
+// does for a region: every face of every prim is copied into vertex buffer
+// memory with its own transform. Plain aligned memory stands in for the
+// mapped GL buffers.
+struct BenchShape
+{
+	U8	mProfile;
+	U8	mPath;
+	F32	mDetail;
+};
+
+// Box, cylinder, prism, sphere and torus at the LODs a region full of
+// builds tends to be drawn at.
+static const BenchShape BENCH_SHAPES[] =
+{
+	{ LL_PCODE_PROFILE_SQUARE,		LL_PCODE_PATH_LINE,		1.f },
+	{ LL_PCODE_PROFILE_CIRCLE,		LL_PCODE_PATH_LINE,		1.f },
+	{ LL_PCODE_PROFILE_CIRCLE,		LL_PCODE_PATH_LINE,		2.f },
+	{ LL_PCODE_PROFILE_EQUALTRI,	LL_PCODE_PATH_LINE,		1.f },
+	{ LL_PCODE_PROFILE_CIRCLE_HALF,	LL_PCODE_PATH_CIRCLE,	1.f },
+	{ LL_PCODE_PROFILE_CIRCLE_HALF,	LL_PCODE_PATH_CIRCLE,	2.f },
+	{ LL_PCODE_PROFILE_CIRCLE,		LL_PCODE_PATH_CIRCLE,	1.f },
+};
+static const S32 NUM_BENCH_SHAPES = LL_ARRAY_SIZE(BENCH_SHAPES);
+
+struct BenchRegion
+{
+	BenchRegion() : mPositions(NULL), mNormals(NULL), mTangents(NULL), mIndices(NULL), mNumVertices(0), mNumIndices(0) {}
+	~BenchRegion()
+	{
+		ll_aligned_free_16(mPositions);
+		ll_aligned_free_16(mNormals);
+		ll_aligned_free_16(mTangents);
+		ll_aligned_free_16(mIndices);
+	}
+
+	std::vector<LLPointer<LLVolume> >		mVolumes;
+	std::vector<LLVolumeFaceGeometryJob>	mJobs;
+	F32*	mPositions;
+	F32*	mNormals;
+	F32*	mTangents;
+	U16*	mIndices;
+	U32		mNumVertices;
+	U32		mNumIndices;
+};
+
+static void build_region(BenchRegion& region, S32 num_prims)
+{
+	for (S32 i = 0; i < NUM_BENCH_SHAPES; ++i)
+	{
+		LLVolumeParams params;
+		params.setType(BENCH_SHAPES[i].mProfile, BENCH_SHAPES[i].mPath);
+		LLVolume* volume = new LLVolume(params, BENCH_SHAPES[i].mDetail);
+		for (S32 face = 0; face < volume->getNumVolumeFaces(); ++face)
+		{
+			volume->genTangents(face);
+		}
+		region.mVolumes.push_back(volume);
+	}
+
+	// Lay out every face the way genDrawInfo() would in one big buffer,
+	// padded so that each face starts 16 byte aligned.
+	U32 seed = 1;
+	for (S32 prim = 0; prim < num_prims; ++prim)
+	{
+		seed = seed * 1664525 + 1013904223;
+		const LLVolume* volume = region.mVolumes[(seed >> 16) % NUM_BENCH_SHAPES];
+
+		LLQuaternion rot;
+		rot.setQuat((F32)(seed & 0xff) * F_TWO_PI / 256.f, 0.f, 0.f, 1.f);
+		LLVector3 pos((F32)((seed >> 8) & 0xff), (F32)((seed >> 4) & 0xff), 20.f + (F32)(seed & 0x3f));
+		LLVector3 scale(0.5f + (F32)((seed >> 3) & 7), 0.5f + (F32)((seed >> 6) & 7), 0.5f + (F32)((seed >> 9) & 7));
+
+		LLMatrix4 mat_vert;
+		mat_vert.initAll(scale, rot, pos);
+		LLMatrix3 mat_normal = rot.getMatrix3();
+		mat_normal.invert();
+		mat_normal.transpose();
+
+		for (S32 face = 0; face < volume->getNumVolumeFaces(); ++face)
+		{
+			const LLVolumeFace& vf = volume->getVolumeFace(face);
+			LLVolumeFaceGeometryJob job;
+			job.mFace = &vf;
+			job.mVertexMatrix = mat_vert;
+			job.mNormalMatrix = mat_normal;
+			job.mIndexOffset = (U16)(region.mNumVertices & 0xffff);
+			job.mPositionCount = vf.mNumVertices;
+			job.mTextureIndex = face % 8;
+			// Offsets for now, turned into pointers once allocated.
+			job.mPositions = (F32*)(size_t)region.mNumVertices;
+			job.mIndices = (U16*)(size_t)region.mNumIndices;
+			region.mJobs.push_back(job);
+
+			region.mNumVertices += vf.mNumVertices;
+			region.mNumIndices += (vf.mNumIndices + 7) & ~7;
+		}
+	}
+
+	size_t vec_bytes = region.mNumVertices * 4 * sizeof(F32);
+	region.mPositions = (F32*)ll_aligned_malloc_16(vec_bytes);
+	region.mNormals = (F32*)ll_aligned_malloc_16(vec_bytes);
+	region.mTangents = (F32*)ll_aligned_malloc_16(vec_bytes);
+	region.mIndices = (U16*)ll_aligned_malloc_16(region.mNumIndices * sizeof(U16));
+
+	for (std::vector<LLVolumeFaceGeometryJob>::iterator it = region.mJobs.begin(); it != region.mJobs.end(); ++it)
+	{
+		size_t vertex = (size_t)it->mPositions;
+		it->mPositions = region.mPositions + vertex * 4;
+		it->mNormals = region.mNormals + vertex * 4;
+		it->mTangents = region.mTangents + vertex * 4;
+		it->mIndices = region.mIndices + (size_t)it->mIndices;
+	}
+}
+
+static void clear_region(BenchRegion& region)
+{
+	size_t vec_bytes = region.mNumVertices * 4 * sizeof(F32);
+	memset(region.mPositions, 0, vec_bytes);
+	memset(region.mNormals, 0, vec_bytes);
+	memset(region.mTangents, 0, vec_bytes);
+	memset(region.mIndices, 0, region.mNumIndices * sizeof(U16));
+}
+
+// FNV-1a over the output, serial and parallel runs must agree bit for bit.
+static U64 checksum_region(const BenchRegion& region)
+{
+	U64 hash = 14695981039346656037ULL;
+	const U8* blocks[] = { (const U8*)region.mPositions, (const U8*)region.mNormals, (const U8*)region.mTangents, (const U8*)region.mIndices };
+	size_t sizes[] = { region.mNumVertices * 4 * sizeof(F32), region.mNumVertices * 4 * sizeof(F32), region.mNumVertices * 4 * sizeof(F32), region.mNumIndices * sizeof(U16) };
+	for (S32 b = 0; b < 4; ++b)
+	{
+		for (size_t i = 0; i < sizes[b]; ++i)
+		{
+			hash = (hash ^ blocks[b][i]) * 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
+static F64 rebuild_serial(const BenchRegion& region, S32 passes)
+{
+	LLTimer timer;
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (std::vector<LLVolumeFaceGeometryJob>::const_iterator it = region.mJobs.begin(); it != region.mJobs.end(); ++it)
+		{
+			it->run();
+		}
+	}
+	return timer.getElapsedTimeF64() / passes;
+}
+
+static F64 rebuild_parallel(const BenchRegion& region, LLThreadPool& pool, U32 grain, S32 passes)
+{
+	const LLVolumeFaceGeometryJob* jobs = &region.mJobs[0];
+	LLTimer timer;
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		pool.parallelFor((U32)region.mJobs.size(), grain,
+			[jobs](U32 begin, U32 end)
+			{
+				for (U32 i = begin; i < end; ++i)
+				{
+					jobs[i].run();
+				}
+			});
+	}
+	return timer.getElapsedTimeF64() / passes;
+}
+
+// The cull benchmark tests sibling sets of octree node bounds against the
+// main camera and the four sun shadow cameras, once node by node as the
+// culling traversal used to and once a sibling set at a time.
+static const S32 NUM_CULL_CAMERAS = 5;
+
+struct CullNodes
+{
+	CullNodes(S32 count)
+	:	mCount(count)
+	{
+		mCenters = (LLVector4a*)ll_aligned_malloc_16(count * sizeof(LLVector4a));
+		mRadii = (LLVector4a*)ll_aligned_malloc_16(count * sizeof(LLVector4a));
+		mResults = new S32[count];
+	}
+	~CullNodes()
+	{
+		ll_aligned_free_16(mCenters);
+		ll_aligned_free_16(mRadii);
+		delete [] mResults;
+	}
+
+	LLVector4a*	mCenters;
+	LLVector4a*	mRadii;
+	S32*		mResults;
+	S32			mCount;
+};
+
+// Frustum from its apex, view target, near/far distances and half widths.
+static void setup_cull_camera(LLCamera& camera, const LLVector3& origin, const LLVector3& target,
+							  F32 near_dist, F32 near_half, F32 far_dist, F32 far_half)
+{
+	camera.lookAt(origin, target);
+	LLVector3 at = camera.getAtAxis();
+	LLVector3 left = camera.getLeftAxis();
+	LLVector3 up = camera.getUpAxis();
+
+	// Near corners, then far corners, in the order LLViewerCamera passes them.
+	LLVector3 frust[8];
+	frust[0] = origin + at * near_dist + left * near_half - up * near_half;
+	frust[1] = origin + at * near_dist - left * near_half - up * near_half;
+	frust[2] = origin + at * near_dist - left * near_half + up * near_half;
+	frust[3] = origin + at * near_dist + left * near_half + up * near_half;
+	frust[4] = origin + at * far_dist + left * far_half - up * far_half;
+	frust[5] = origin + at * far_dist - left * far_half - up * far_half;
+	frust[6] = origin + at * far_dist - left * far_half + up * far_half;
+	frust[7] = origin + at * far_dist + left * far_half + up * far_half;
+	camera.calcAgentFrustumPlanes(frust);
+}
+
+static void setup_cull_cameras(LLCamera* cameras)
+{
+	// Main camera standing in the region, shadow cameras looking down the sun
+	// direction over growing splits of its view.
+	LLVector3 eye(128.f, 40.f, 30.f);
+	setup_cull_camera(cameras[0], eye, LLVector3(128.f, 200.f, 25.f), 0.1f, 0.08f, 256.f, 200.f);
+	LLVector3 sun(0.3f, -0.4f, 0.87f);
+	sun.normalize();
+	static const F32 SPLITS[] = { 16.f, 48.f, 128.f, 256.f };
+	for (S32 i = 0; i < 4; ++i)
+	{
+		LLVector3 center = eye + LLVector3(0.f, SPLITS[i] * 0.5f, 0.f);
+		setup_cull_camera(cameras[i + 1], center + sun * 300.f, center, 1.f, SPLITS[i], 600.f, SPLITS[i]);
+	}
+}
+
+static void build_cull_scene(CullNodes& nodes, LLCamera* cameras)
+{
+	// Node bounds of a dense region, small leaves near the ground and fewer,
+	// larger nodes above.
+	U32 seed = 7;
+	for (S32 i = 0; i < nodes.mCount; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		F32 size = 0.5f + (F32)(1 << ((seed >> 24) % 6));
+		nodes.mCenters[i].set((F32)((seed >> 4) & 0xff), (F32)((seed >> 12) & 0xff), 20.f + (F32)((seed >> 20) & 0x3f) * size * 0.25f);
+		nodes.mRadii[i].set(size, size * 0.75f, size * 0.5f);
+	}
+
+	setup_cull_cameras(cameras);
+}
+
+static U64 checksum_cull(const CullNodes& nodes)
+{
+	U64 hash = 14695981039346656037ULL;
+	for (S32 i = 0; i < nodes.mCount; ++i)
+	{
+		hash = (hash ^ (U64)nodes.mResults[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+static F64 cull_single(CullNodes& nodes, LLCamera* cameras, S32 passes, U64& checksum)
+{
+	LLTimer timer;
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		checksum = 0;
+		for (S32 cam = 0; cam < NUM_CULL_CAMERAS; ++cam)
+		{
+			// The main camera culls without the far plane, shadow cameras with.
+			for (S32 i = 0; i < nodes.mCount; ++i)
+			{
+				nodes.mResults[i] = cam ? cameras[cam].AABBInFrustum(nodes.mCenters[i], nodes.mRadii[i])
+										: cameras[cam].AABBInFrustumNoFarClip(nodes.mCenters[i], nodes.mRadii[i]);
+			}
+			checksum += checksum_cull(nodes);
+		}
+	}
+	return timer.getElapsedTimeF64() / passes;
+}
+
+static F64 cull_batched(CullNodes& nodes, LLCamera* cameras, S32 passes, U64& checksum)
+{
+	LLTimer timer;
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		checksum = 0;
+		for (S32 cam = 0; cam < NUM_CULL_CAMERAS; ++cam)
+		{
+			for (S32 i = 0; i < nodes.mCount; i += 8)
+			{
+				cameras[cam].AABBInFrustumBatch(nodes.mCenters + i, nodes.mRadii + i, llmin(8, nodes.mCount - i),
+												nodes.mResults + i, cam != 0);
+			}
+			checksum += checksum_cull(nodes);
+		}
+	}
+	return timer.getElapsedTimeF64() / passes;
+}
+
+// The octree benchmark fills an LLOctreeRoot and an LLLinearOctree with the
+// same elements and times insertion, the five camera cull, ray casts and
+// removal. The pointer based tree gets bounds from a listener per node the
+// way LLSpatialGroup provides them, and both traversals must hand back every
+// element whose own box is visible or hit.
+class BenchOctreeElement : public LLRefCount
+{
+public:
+	void* operator new(size_t size)
+	{
+		return ll_aligned_malloc_16(size);
+	}
+
+	void operator delete(void* ptr)
+	{
+		ll_aligned_free_16(ptr);
+	}
+
+	BenchOctreeElement()
+	:	mRadius(0.f),
+		mBinIndex(-1),
+		mNode(NULL),
+		mHandle(LLLinearOctree<BenchOctreeElement>::INVALID),
+		mVisited(0)
+	{
+	}
+
+	const LLVector4a& getPositionGroup() const	{ return mPosition; }
+	F32 getBinRadius() const					{ return mRadius; }
+	S32 getBinIndex() const						{ return mBinIndex; }
+	void setBinIndex(S32 index) const			{ mBinIndex = index; }
+
+	LLVector4a							mPosition;
+	F32									mRadius;
+	mutable S32							mBinIndex;
+	LLOctreeNode<BenchOctreeElement>*	mNode;		// node holding it in the pointer based tree
+	U32									mHandle;	// handle in the linear tree
+	mutable U32							mVisited;	// stamp of the last traversal that reported it
+};
+
+typedef LLOctreeNode<BenchOctreeElement> BenchOctreeNode;
+typedef std::vector<LLPointer<BenchOctreeElement> > bench_element_list_t;
+
+class BenchOctreeGroup : public LLOctreeListener<BenchOctreeElement>
+{
+public:
+	void* operator new(size_t size)
+	{
+		return ll_aligned_malloc_16(size);
+	}
+
+	void operator delete(void* ptr)
+	{
+		ll_aligned_free_16(ptr);
+	}
+
+	BenchOctreeGroup(BenchOctreeNode* node)
+	{
+		mCenter = node->getCenter();
+		mExtents = node->getSize();
+		node->addListener(this);
+	}
+
+	virtual void handleInsertion(const LLTreeNode<BenchOctreeElement>* node, BenchOctreeElement* data)
+	{
+		data->mNode = (BenchOctreeNode*)node;
+	}
+	virtual void handleRemoval(const LLTreeNode<BenchOctreeElement>* node, BenchOctreeElement* data)
+	{
+		data->mNode = NULL;
+	}
+	virtual void handleDestruction(const LLTreeNode<BenchOctreeElement>* node) {}
+	virtual void handleStateChange(const LLTreeNode<BenchOctreeElement>* node) {}
+	virtual void handleChildAddition(const BenchOctreeNode* parent, BenchOctreeNode* child)
+	{
+		if (!child->getListenerCount())
+		{
+			new BenchOctreeGroup(child);
+		}
+	}
+	virtual void handleChildRemoval(const BenchOctreeNode* parent, const BenchOctreeNode* child) {}
+
+	LLVector4a	mCenter;
+	LLVector4a	mExtents;
+};
+
+// Loose bounds of every node's elements and children around the node
+// center, standing in for the bounds LLSpatialGroup keeps up to date.
+static const LLVector4a& update_group_bounds(const BenchOctreeNode* node)
+{
+	BenchOctreeGroup* group = (BenchOctreeGroup*)node->getListener(0);
+	group->mCenter = node->getCenter();
+	LLVector4a extents = LLVector4a::getZero();
+	for (BenchOctreeNode::const_element_iter it = node->getDataBegin(); it != node->getDataEnd(); ++it)
+	{
+		LLVector4a reach;
+		reach.setSub((*it)->mPosition, group->mCenter);
+		reach.setAbs(reach);
+		LLVector4a radius;
+		radius.splat((*it)->mRadius);
+		reach.add(radius);
+		extents.setMax(extents, reach);
+	}
+	for (U32 i = 0; i < node->getChildCount(); ++i)
+	{
+		const BenchOctreeNode* child = node->getChild(i);
+		LLVector4a reach;
+		reach.setSub(child->getCenter(), group->mCenter);
+		reach.setAbs(reach);
+		reach.add(update_group_bounds(child));
+		extents.setMax(extents, reach);
+	}
+	group->mExtents = extents;
+	return group->mExtents;
+}
+
+class BenchOctreeCull : public LLOctreeTraveler<BenchOctreeElement>
+{
+public:
+	BenchOctreeCull(LLCamera* camera, bool far_clip, U32 stamp)
+	:	mCamera(camera),
+		mFarClip(far_clip),
+		mInside(false),
+		mStamp(stamp)
+	{
+	}
+
+	virtual void traverse(const BenchOctreeNode* node)
+	{
+		const BenchOctreeGroup* group = (const BenchOctreeGroup*)node->getListener(0);
+		S32 res = 2;
+		if (!mInside)
+		{
+			res = mFarClip ? mCamera->AABBInFrustum(group->mCenter, group->mExtents)
+						   : mCamera->AABBInFrustumNoFarClip(group->mCenter, group->mExtents);
+			if (!res)
+			{
+				return;
+			}
+		}
+
+		bool inside = mInside;
+		mInside = res == 2;
+		visit(node);
+		for (U32 i = 0; i < node->getChildCount(); ++i)
+		{
+			traverse(node->getChild(i));
+		}
+		mInside = inside;
+	}
+
+	virtual void visit(const BenchOctreeNode* branch)
+	{
+		for (BenchOctreeNode::const_element_iter it = branch->getDataBegin(); it != branch->getDataEnd(); ++it)
+		{
+			(*it)->mVisited = mStamp;
+		}
+	}
+
+	LLCamera*	mCamera;
+	bool		mFarClip;
+	bool		mInside;
+	U32			mStamp;
+};
+
+class BenchOctreeRay : public LLOctreeTraveler<BenchOctreeElement>
+{
+public:
+	BenchOctreeRay(const LLVector4a& start, const LLVector4a& end, U32 stamp)
+	:	mStart(start),
+		mEnd(end),
+		mStamp(stamp)
+	{
+	}
+
+	virtual void traverse(const BenchOctreeNode* node)
+	{
+		const BenchOctreeGroup* group = (const BenchOctreeGroup*)node->getListener(0);
+		if (LLLineSegmentBoxIntersect(mStart, mEnd, group->mCenter, group->mExtents))
+		{
+			visit(node);
+			for (U32 i = 0; i < node->getChildCount(); ++i)
+			{
+				traverse(node->getChild(i));
+			}
+		}
+	}
+
+	virtual void visit(const BenchOctreeNode* branch)
+	{
+		// Same bin box test LLLinearOctree::intersectRay() does per element.
+		for (BenchOctreeNode::const_element_iter it = branch->getDataBegin(); it != branch->getDataEnd(); ++it)
+		{
+			LLVector4a radius;
+			radius.splat((*it)->mRadius);
+			if (LLLineSegmentBoxIntersect(mStart, mEnd, (*it)->mPosition, radius))
+			{
+				(*it)->mVisited = mStamp;
+			}
+		}
+	}
+
+	const LLVector4a&	mStart;
+	const LLVector4a&	mEnd;
+	U32					mStamp;
+};
+
+struct OctreeTimes
+{
+	OctreeTimes() : mInsert(0.0), mRemove(0.0), mCull(0.0), mRay(0.0), mMissed(0) {}
+
+	F64 mInsert;
+	F64 mRemove;
+	F64 mCull;
+	F64 mRay;
+	U32 mMissed;	// elements a traversal failed to report
+};
+
+static const S32 NUM_BENCH_RAYS = 1000;
+static const S32 NUM_CHECKED_RAYS = 50;
+
+static void build_octree_scene(bench_element_list_t& elements, S32 count, std::vector<LLVector4a>& rays)
+{
+	// Mostly small prims over a region with some large builds and terrain
+	// sized pieces, the spread LLSpatialPartition sees.
+	U32 seed = 11;
+	elements.resize(count);
+	for (S32 i = 0; i < count; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		BenchOctreeElement* element = new BenchOctreeElement();
+		element->mPosition.set((F32)((seed >> 4) & 0xff) + (F32)((seed >> 12) & 0xf) * 0.0625f,
+							   (F32)((seed >> 16) & 0xff) + (F32)((seed >> 8) & 0xf) * 0.0625f,
+							   20.f + (F32)((seed >> 24) & 0x7f) * 0.5f);
+		element->mRadius = 0.05f + (F32)((seed >> 8) & 0xf) * (F32)(1 << ((seed >> 28) % 4)) * 0.125f;
+		elements[i] = element;
+	}
+
+	// Pick rays from the camera position into the region.
+	rays.resize(NUM_BENCH_RAYS * 2);
+	for (S32 i = 0; i < NUM_BENCH_RAYS; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		rays[i * 2].set(128.f, 40.f, 30.f);
+		rays[i * 2 + 1].set((F32)((seed >> 4) & 0xff), (F32)((seed >> 12) & 0xff), 20.f + (F32)((seed >> 20) & 0x3f));
+	}
+}
+
+// Counts elements the last traversal with stamp should have reported.
+static U32 count_cull_misses(const bench_element_list_t& elements, LLCamera& camera, bool far_clip, U32 stamp)
+{
+	U32 missed = 0;
+	for (bench_element_list_t::const_iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		LLVector4a radius;
+		radius.splat((*it)->mRadius);
+		S32 res = far_clip ? camera.AABBInFrustum((*it)->mPosition, radius)
+						   : camera.AABBInFrustumNoFarClip((*it)->mPosition, radius);
+		if (res && (*it)->mVisited != stamp)
+		{
+			++missed;
+		}
+	}
+	return missed;
+}
+
+static U32 count_ray_misses(const bench_element_list_t& elements, const LLVector4a& start, const LLVector4a& end, U32 stamp)
+{
+	U32 missed = 0;
+	for (bench_element_list_t::const_iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		LLVector4a radius;
+		radius.splat((*it)->mRadius);
+		if (LLLineSegmentBoxIntersect(start, end, (*it)->mPosition, radius) && (*it)->mVisited != stamp)
+		{
+			++missed;
+		}
+	}
+	return missed;
+}
+
+static OctreeTimes bench_pointer_octree(bench_element_list_t& elements, LLCamera* cameras,
+										const std::vector<LLVector4a>& rays, S32 passes)
+{
+	OctreeTimes times;
+	LLTimer timer;
+	U32 stamp = 0;
+
+	LLOctreeRoot<BenchOctreeElement>* root = new LLOctreeRoot<BenchOctreeElement>(LLVector4a(128.f, 128.f, 128.f),
+																				  LLVector4a(128.f, 128.f, 128.f), NULL);
+	new BenchOctreeGroup(root);
+
+	timer.reset();
+	for (bench_element_list_t::iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		root->insert(*it);
+	}
+	times.mInsert = timer.getElapsedTimeF64();
+
+	update_group_bounds(root);
+
+	for (S32 cam = 0; cam < NUM_CULL_CAMERAS; ++cam)
+	{
+		BenchOctreeCull cull(&cameras[cam], cam != 0, ++stamp);
+		cull.traverse(root);
+		times.mMissed += count_cull_misses(elements, cameras[cam], cam != 0, stamp);
+	}
+	for (S32 i = 0; i < NUM_CHECKED_RAYS; ++i)
+	{
+		BenchOctreeRay ray(rays[i * 2], rays[i * 2 + 1], ++stamp);
+		ray.traverse(root);
+		times.mMissed += count_ray_misses(elements, rays[i * 2], rays[i * 2 + 1], stamp);
+	}
+
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (S32 cam = 0; cam < NUM_CULL_CAMERAS; ++cam)
+		{
+			BenchOctreeCull cull(&cameras[cam], cam != 0, ++stamp);
+			cull.traverse(root);
+		}
+	}
+	times.mCull = timer.getElapsedTimeF64() / passes;
+
+	timer.reset();
+	for (S32 i = 0; i < NUM_BENCH_RAYS; ++i)
+	{
+		BenchOctreeRay ray(rays[i * 2], rays[i * 2 + 1], ++stamp);
+		ray.traverse(root);
+	}
+	times.mRay = timer.getElapsedTimeF64();
+
+	timer.reset();
+	for (bench_element_list_t::iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		if ((*it)->mNode)
+		{
+			(*it)->mNode->remove(*it);
+		}
+	}
+	times.mRemove = timer.getElapsedTimeF64();
+
+	delete root;
+	return times;
+}
+
+static OctreeTimes bench_linear_octree(bench_element_list_t& elements, LLCamera* cameras,
+									   const std::vector<LLVector4a>& rays, S32 passes)
+{
+	OctreeTimes times;
+	LLTimer timer;
+	U32 stamp = 0;
+
+	LLLinearOctree<BenchOctreeElement> tree(LLVector4a(128.f, 128.f, 128.f), LLVector4a(128.f, 128.f, 128.f));
+
+	timer.reset();
+	for (bench_element_list_t::iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		(*it)->mHandle = tree.insert(*it);
+	}
+	times.mInsert = timer.getElapsedTimeF64();
+
+	for (S32 cam = 0; cam < NUM_CULL_CAMERAS; ++cam)
+	{
+		U32 cur = ++stamp;
+		tree.cullFrustum(cameras[cam], [cur](BenchOctreeElement* element) { element->mVisited = cur; }, cam != 0);
+		times.mMissed += count_cull_misses(elements, cameras[cam], cam != 0, cur);
+	}
+	for (S32 i = 0; i < NUM_CHECKED_RAYS; ++i)
+	{
+		U32 cur = ++stamp;
+		tree.intersectRay(rays[i * 2], rays[i * 2 + 1], [cur](BenchOctreeElement* element) { element->mVisited = cur; });
+		times.mMissed += count_ray_misses(elements, rays[i * 2], rays[i * 2 + 1], cur);
+	}
+
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (S32 cam = 0; cam < NUM_CULL_CAMERAS; ++cam)
+		{
+			U32 cur = ++stamp;
+			tree.cullFrustum(cameras[cam], [cur](BenchOctreeElement* element) { element->mVisited = cur; }, cam != 0);
+		}
+	}
+	times.mCull = timer.getElapsedTimeF64() / passes;
+
+	timer.reset();
+	for (S32 i = 0; i < NUM_BENCH_RAYS; ++i)
+	{
+		U32 cur = ++stamp;
+		tree.intersectRay(rays[i * 2], rays[i * 2 + 1], [cur](BenchOctreeElement* element) { element->mVisited = cur; });
+	}
+	times.mRay = timer.getElapsedTimeF64();
+
+	timer.reset();
+	for (bench_element_list_t::iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		tree.remove((*it)->mHandle);
+		(*it)->mHandle = LLLinearOctree<BenchOctreeElement>::INVALID;
+	}
+	times.mRemove = timer.getElapsedTimeF64();
+
+	return times;
+}
+
+static void output_octree_times(const char* name, const OctreeTimes& times)
+{
+	std::cout << llformat("%24s%12.3f%12.3f%12.3f%12.3f",
+						  name,
+						  times.mInsert * 1000.0,
+						  times.mRemove * 1000.0,
+						  times.mCull * 1000.0,
+						  times.mRay * 1000.0) << std::endl;
+}
+
+// The skinning benchmark replays what LLDrawPoolAvatar does when skinning
+// rigged attachments on the CPU for a crowd. Every avatar wears a few rigged
+// meshes, and many avatars wear the same ones. The old way runs each vertex
+// through the bind shape matrix and then the blended joint matrix. The new
+// way folds the bind shape into the palette and uses LLSkinningJob, on the
+// main thread and split across the pool.
+static const U32 BENCH_SKIN_JOINTS = 64;
+static const U32 BENCH_SKIN_MESH_SIZES[] = { 1500, 4000, 9000, 16000, 25000 };
+static const S32 NUM_BENCH_SKIN_MESHES = LL_ARRAY_SIZE(BENCH_SKIN_MESH_SIZES);
+static const S32 BENCH_MESHES_PER_AVATAR = 3;
+static const U32 BENCH_SKIN_GRAIN = 4096;	// SKINNING_JOB_GRAIN in lldrawpoolavatar.cpp
+
+struct BenchSkinMesh
+{
+	BenchSkinMesh(U32 count)
+	:	mCount(count)
+	{
+		mPositions = (LLVector4a*)ll_aligned_malloc_16(count * sizeof(LLVector4a));
+		mNormals = (LLVector4a*)ll_aligned_malloc_16(count * sizeof(LLVector4a));
+		mWeights = (LLVector4a*)ll_aligned_malloc_16(count * sizeof(LLVector4a));
+	}
+	~BenchSkinMesh()
+	{
+		ll_aligned_free_16(mPositions);
+		ll_aligned_free_16(mNormals);
+		ll_aligned_free_16(mWeights);
+	}
+
+	LLMatrix4a	mBindShape;
+	LLMatrix4a	mInvBind[BENCH_SKIN_JOINTS];
+	LLVector4a*	mPositions;
+	LLVector4a*	mNormals;
+	LLVector4a*	mWeights;
+	U32			mCount;
+};
+
+struct BenchAttachment
+{
+	BenchAttachment(const BenchSkinMesh* mesh)
+	:	mMesh(mesh)
+	{
+		mOutPositions = (LLVector4a*)ll_aligned_malloc_16(mesh->mCount * sizeof(LLVector4a));
+		mOutNormals = (LLVector4a*)ll_aligned_malloc_16(mesh->mCount * sizeof(LLVector4a));
+	}
+	~BenchAttachment()
+	{
+		ll_aligned_free_16(mOutPositions);
+		ll_aligned_free_16(mOutNormals);
+	}
+
+	const BenchSkinMesh*	mMesh;
+	LLVector4a*				mOutPositions;
+	LLVector4a*				mOutNormals;
+};
+
+struct BenchSkinAvatar
+{
+	LLMatrix4a						mJoints[BENCH_SKIN_JOINTS];	// joint world matrices this frame
+	std::vector<BenchAttachment*>	mAttachments;
+};
+
+struct BenchCrowd
+{
+	~BenchCrowd()
+	{
+		for (size_t i = 0; i < mAvatars.size(); ++i)
+		{
+			for (size_t j = 0; j < mAvatars[i].mAttachments.size(); ++j)
+			{
+				delete mAvatars[i].mAttachments[j];
+			}
+		}
+		for (size_t i = 0; i < mMeshes.size(); ++i)
+		{
+			delete mMeshes[i];
+		}
+	}
+
+	std::vector<BenchSkinMesh*>		mMeshes;
+	std::vector<BenchSkinAvatar>	mAvatars;
+	U32								mNumVertices;
+};
+
+static void bench_skin_matrix(LLMatrix4a& res, U32 seed, F32 reach)
+{
+	LLQuaternion rot;
+	rot.setQuat((F32)(seed & 0xff) * F_TWO_PI / 256.f, (F32)((seed >> 8) & 7) - 3.5f, 1.f, (F32)((seed >> 11) & 7) - 3.5f);
+	LLVector3 pos((F32)((seed >> 4) & 0xf) * reach, (F32)((seed >> 12) & 0xf) * reach, (F32)((seed >> 20) & 0xf) * reach);
+	LLMatrix4 mat;
+	mat.initAll(LLVector3(1.f, 1.f, 1.f), rot, pos);
+	res.loadu(mat);
+}
+
+static void build_crowd(BenchCrowd& crowd, S32 num_avatars)
+{
+	U32 seed = 5;
+	for (S32 i = 0; i < NUM_BENCH_SKIN_MESHES; ++i)
+	{
+		BenchSkinMesh* mesh = new BenchSkinMesh(BENCH_SKIN_MESH_SIZES[i]);
+		seed = seed * 1664525 + 1013904223;
+		bench_skin_matrix(mesh->mBindShape, seed, 0.01f);
+		for (U32 j = 0; j < BENCH_SKIN_JOINTS; ++j)
+		{
+			seed = seed * 1664525 + 1013904223;
+			bench_skin_matrix(mesh->mInvBind[j], seed, 0.05f);
+		}
+
+		for (U32 v = 0; v < mesh->mCount; ++v)
+		{
+			seed = seed * 1664525 + 1013904223;
+			mesh->mPositions[v].set((F32)((seed >> 4) & 0xff) / 256.f - 0.5f, (F32)((seed >> 12) & 0xff) / 256.f - 0.5f, (F32)((seed >> 20) & 0xff) / 128.f);
+			mesh->mNormals[v].set((F32)((seed >> 8) & 0xf) - 7.5f, (F32)((seed >> 16) & 0xf) - 7.5f, 1.f);
+			mesh->mNormals[v].normalize3fast();
+
+			// One to four influences on nearby joints, the way scrubbed
+			// weights look after unpackVolumeFaces().
+			U32 base = (seed >> 24) % (BENCH_SKIN_JOINTS - 4);
+			F32 w[4];
+			for (U32 k = 0; k < 4; ++k)
+			{
+				seed = seed * 1664525 + 1013904223;
+				F32 weight = (k == 0 || (seed & 3) == 0) ? 0.05f + (F32)((seed >> 20) & 0xff) / 300.f : 0.f;
+				w[k] = (F32)(base + k) + weight;
+			}
+			mesh->mWeights[v].set(w[0], w[1], w[2], w[3]);
+		}
+		crowd.mMeshes.push_back(mesh);
+	}
+
+	crowd.mNumVertices = 0;
+	crowd.mAvatars.resize(num_avatars);
+	for (S32 i = 0; i < num_avatars; ++i)
+	{
+		BenchSkinAvatar& avatar = crowd.mAvatars[i];
+		for (U32 j = 0; j < BENCH_SKIN_JOINTS; ++j)
+		{
+			seed = seed * 1664525 + 1013904223;
+			bench_skin_matrix(avatar.mJoints[j], seed, 0.1f);
+		}
+		for (S32 j = 0; j < BENCH_MESHES_PER_AVATAR; ++j)
+		{
+			seed = seed * 1664525 + 1013904223;
+			const BenchSkinMesh* mesh = crowd.mMeshes[(i + j * 2 + (seed >> 28)) % NUM_BENCH_SKIN_MESHES];
+			avatar.mAttachments.push_back(new BenchAttachment(mesh));
+			crowd.mNumVertices += mesh->mCount;
+		}
+	}
+}
+
+// Per face palette and two transforms per vertex, as the viewer used to.
+static F64 skin_crowd_legacy(BenchCrowd& crowd, S32 passes)
+{
+	LLTimer timer;
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (size_t a = 0; a < crowd.mAvatars.size(); ++a)
+		{
+			const BenchSkinAvatar& avatar = crowd.mAvatars[a];
+			for (size_t f = 0; f < avatar.mAttachments.size(); ++f)
+			{
+				BenchAttachment& attachment = *avatar.mAttachments[f];
+				const BenchSkinMesh& mesh = *attachment.mMesh;
+
+				LLMatrix4a mat[BENCH_SKIN_JOINTS];
+				for (U32 j = 0; j < BENCH_SKIN_JOINTS; ++j)
+				{
+					matMul(mesh.mInvBind[j], avatar.mJoints[j], mat[j]);
+				}
+
+				for (U32 v = 0; v < mesh.mCount; ++v)
+				{
+					// LLSkinningUtil::getPerVertexSkinMatrix()
+					const F32* weights = mesh.mWeights[v].getF32ptr();
+					S32 idx[4];
+					F32 wght[4];
+					F32 scale = 0.f;
+					for (U32 k = 0; k < 4; ++k)
+					{
+						F32 w = weights[k];
+						idx[k] = llclamp((S32)floorf(w), (S32)0, (S32)BENCH_SKIN_JOINTS - 1);
+						wght[k] = w - floorf(w);
+						scale += wght[k];
+					}
+					LLMatrix4a final_mat;
+					final_mat.clear();
+					for (U32 k = 0; k < 4; ++k)
+					{
+						LLMatrix4a src;
+						src.setMul(mat[idx[k]], wght[k] / scale);
+						final_mat.add(src);
+					}
+
+					LLVector4a t;
+					mesh.mBindShape.affineTransform(mesh.mPositions[v], t);
+					final_mat.affineTransform(t, attachment.mOutPositions[v]);
+
+					LLMatrix4a bind_shape = mesh.mBindShape;
+					bind_shape.rotate(mesh.mNormals[v], t);
+					final_mat.rotate(t, attachment.mOutNormals[v]);
+					attachment.mOutNormals[v].normalize3fast();
+				}
+			}
+		}
+	}
+	return timer.getElapsedTimeF64() / passes;
+}
+
+// One folded palette per avatar and mesh, faces skinned by LLSkinningJob.
+static F64 skin_crowd_jobs(BenchCrowd& crowd, LLThreadPool* pool, S32 passes)
+{
+	LLTimer timer;
+	timer.reset();
+	for (S32 pass = 0; pass < passes; ++pass)
+	{
+		for (size_t a = 0; a < crowd.mAvatars.size(); ++a)
+		{
+			const BenchSkinAvatar& avatar = crowd.mAvatars[a];
+			for (size_t f = 0; f < avatar.mAttachments.size(); ++f)
+			{
+				BenchAttachment& attachment = *avatar.mAttachments[f];
+				const BenchSkinMesh& mesh = *attachment.mMesh;
+
+				LLMatrix4a joints[BENCH_SKIN_JOINTS];
+				for (U32 j = 0; j < BENCH_SKIN_JOINTS; ++j)
+				{
+					matMul(mesh.mInvBind[j], avatar.mJoints[j], joints[j]);
+				}
+				LLMatrix4a palette[BENCH_SKIN_JOINTS];
+				LLSkinningJob::buildPalette(mesh.mBindShape, joints, BENCH_SKIN_JOINTS, palette);
+
+				LLSkinningJob job;
+				job.mPalette = palette;
+				job.mJointCount = BENCH_SKIN_JOINTS;
+				job.mWeights = mesh.mWeights;
+				job.mPositions = mesh.mPositions;
+				job.mNormals = mesh.mNormals;
+				job.mOutPositions = attachment.mOutPositions;
+				job.mOutNormals = attachment.mOutNormals;
+				job.mVertexCount = mesh.mCount;
+
+				if (pool)
+				{
+					pool->parallelFor(job.mVertexCount, BENCH_SKIN_GRAIN,
+						[&job](U32 begin, U32 end)
+						{
+							job.run(begin, end);
+						});
+				}
+				else
+				{
+					job.run();
+				}
+			}
+		}
+	}
+	return timer.getElapsedTimeF64() / passes;
+}
+
+static void snapshot_crowd(const BenchCrowd& crowd, std::vector<LLVector4a>& out)
+{
+	out.clear();
+	for (size_t a = 0; a < crowd.mAvatars.size(); ++a)
+	{
+		const BenchSkinAvatar& avatar = crowd.mAvatars[a];
+		for (size_t f = 0; f < avatar.mAttachments.size(); ++f)
+		{
+			const BenchAttachment& attachment = *avatar.mAttachments[f];
+			out.insert(out.end(), attachment.mOutPositions, attachment.mOutPositions + attachment.mMesh->mCount);
+			out.insert(out.end(), attachment.mOutNormals, attachment.mOutNormals + attachment.mMesh->mCount);
+		}
+	}
+}
+
+// Largest difference in x, y or z between two snapshots.
+static F32 compare_crowd(const std::vector<LLVector4a>& lhs, const std::vector<LLVector4a>& rhs)
+{
+	F32 max_diff = 0.f;
+	for (size_t i = 0; i < lhs.size(); ++i)
+	{
+		for (U32 k = 0; k < 3; ++k)
+		{
+			max_diff = llmax(max_diff, fabsf(lhs[i][k] - rhs[i][k]));
+		}
+	}
+	return max_diff;
+}
+
+// The vertex cache benchmark optimizes a large grid face with its
+// triangles shuffled, the worst case for a mesh LOD, once from scratch and
+// once with the triangle order saved by the first run as the mesh
+// repository does for LODs it has seen before.
+static void build_grid_face(LLVolumeFace& face, U32 side)
+{
+	face.resizeVertices(side * side);
+	for (U32 y = 0; y < side; ++y)
+	{
+		for (U32 x = 0; x < side; ++x)
+		{
+			U32 i = y * side + x;
+			face.mPositions[i].set((F32)x, (F32)y, 0.f);
+			face.mNormals[i].set(0.f, 0.f, 1.f);
+			face.mTexCoords[i].set((F32)x / side, (F32)y / side);
+		}
+	}
+
+	face.resizeIndices((side - 1) * (side - 1) * 6);
+	U16* idx = face.mIndices;
+	for (U32 y = 0; y + 1 < side; ++y)
+	{
+		for (U32 x = 0; x + 1 < side; ++x)
+		{
+			U16 v = (U16)(y * side + x);
+			*idx++ = v;
+			*idx++ = v + 1;
+			*idx++ = v + side;
+			*idx++ = v + 1;
+			*idx++ = v + side + 1;
+			*idx++ = v + side;
+		}
+	}
+
+	U32 num_triangles = face.mNumIndices / 3;
+	U32 seed = 3;
+	for (U32 i = num_triangles - 1; i > 0; --i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		U32 j = (seed >> 8) % (i + 1);
+		for (U32 k = 0; k < 3; ++k)
+		{
+			std::swap(face.mIndices[i * 3 + k], face.mIndices[j * 3 + k]);
+		}
+	}
+}
+
+// Average vertex cache misses per triangle for a FIFO cache of the given size.
+static F32 measure_acmr(const LLVolumeFace& face, U32 cache_size)
+{
+	std::vector<S32> in_cache(face.mNumVertices, -1);
+	std::vector<U16> fifo(cache_size, 0);
+	U32 head = 0;
+	U32 misses = 0;
+	for (S32 i = 0; i < face.mNumIndices; ++i)
+	{
+		U16 v = face.mIndices[i];
+		if (in_cache[v] < 0)
+		{
+			++misses;
+			if (misses > cache_size)
+			{
+				in_cache[fifo[head]] = -1;
+			}
+			fifo[head] = v;
+			in_cache[v] = head;
+			head = (head + 1) % cache_size;
+		}
+	}
+	return (F32)misses / (face.mNumIndices / 3);
+}
+
+int main(int argc, char** argv)
+{
+	S32 num_prims = 10000;
+	S32 num_threads = 0;
+	S32 passes = 5;
+	S32 num_cull_nodes = 50000;
+	S32 num_octree_elements = 100000;
+	S32 num_avatars = 50;
+	S32 grid_side = 250;
+
+	// Init whatever is necessary
+	ll_init_apr();
+	LLError::initForApplication(".", ".");
+
+	// Analyze command line arguments
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		if (!strcmp(argv[arg], "--help") || !strcmp(argv[arg], "-h"))
+		{
+			std::cout << USAGE << std::endl;
+			return 0;
+		}
+		else if ((!strcmp(argv[arg], "--prims") || !strcmp(argv[arg], "-n")) && arg < argc-1)
+		{
+			num_prims = llmax(1, atoi(argv[++arg]));
+		}
+		else if ((!strcmp(argv[arg], "--threads") || !strcmp(argv[arg], "-t")) && arg < argc-1)
+		{
+			num_threads = llmax(0, atoi(argv[++arg]));
+		}
+		else if ((!strcmp(argv[arg], "--passes") || !strcmp(argv[arg], "-p")) && arg < argc-1)
+		{
+			passes = llmax(1, atoi(argv[++arg]));
+		}
+		else if ((!strcmp(argv[arg], "--cull-nodes") || !strcmp(argv[arg], "-c")) && arg < argc-1)
+		{
+			num_cull_nodes = llmax(1, atoi(argv[++arg]));
+		}
+		else if ((!strcmp(argv[arg], "--octree-elements") || !strcmp(argv[arg], "-o")) && arg < argc-1)
+		{
+			num_octree_elements = llmax(1, atoi(argv[++arg]));
+		}
+		else if ((!strcmp(argv[arg], "--avatars") || !strcmp(argv[arg], "-a")) && arg < argc-1)
+		{
+			num_avatars = llmax(1, atoi(argv[++arg]));
+		}
+		else if ((!strcmp(argv[arg], "--grid") || !strcmp(argv[arg], "-g")) && arg < argc-1)
+		{
+			// 16 bit indices
+			grid_side = llclamp(atoi(argv[++arg]), 2, 256);
+		}
+	}
+
+	LLThreadPool::initClass(num_threads);
+	LLThreadPool& pool = *LLThreadPool::getInstance();
+
+	S32 result = 0;
+	{
+		BenchRegion region;
+		build_region(region, num_prims);
+		std::cout << num_prims << " prims, " << region.mJobs.size() << " faces, "
+				  << region.mNumVertices << " vertices, " << region.mNumIndices << " indices" << std::endl;
+
+		clear_region(region);
+		F64 serial = rebuild_serial(region, passes);
+		U64 serial_sum = checksum_region(region);
+
+		std::cout << llformat("%24s%12s%12s", "Rebuild", "ms/region", "Speedup") << std::endl;
+		std::cout << llformat("%24s%12.3f%12.2f", "main thread", serial * 1000.0, 1.0) << std::endl;
+
+		static const U32 GRAINS[] = { 4, 16, 64 };
+		for (S32 i = 0; i < (S32)LL_ARRAY_SIZE(GRAINS); ++i)
+		{
+			clear_region(region);
+			F64 parallel = rebuild_parallel(region, pool, GRAINS[i], passes);
+			if (checksum_region(region) != serial_sum)
+			{
+				std::cout << "Error: parallel rebuild output differs" << std::endl;
+				result = 1;
+			}
+			std::string name = llformat("%d threads, grain %d", pool.getThreadCount() + 1, GRAINS[i]);
+			std::cout << llformat("%24s%12.3f%12.2f", name.c_str(), parallel * 1000.0,
+								  parallel > 0.0 ? serial / parallel : 0.0) << std::endl;
+		}
+	}
+
+	{
+		CullNodes nodes(num_cull_nodes);
+		LLCamera cameras[NUM_CULL_CAMERAS];
+		build_cull_scene(nodes, cameras);
+
+		U64 single_sum = 0;
+		U64 batched_sum = 0;
+		F64 single = cull_single(nodes, cameras, passes, single_sum);
+		F64 batched = cull_batched(nodes, cameras, passes, batched_sum);
+
+		std::cout << std::endl << num_cull_nodes << " octree nodes, " << NUM_CULL_CAMERAS << " cameras" << std::endl;
+		std::cout << llformat("%24s%12s%12s", "Cull", "ms/frame", "Speedup") << std::endl;
+		std::cout << llformat("%24s%12.3f%12.2f", "node by node", single * 1000.0, 1.0) << std::endl;
+		std::cout << llformat("%24s%12.3f%12.2f", "sibling batches", batched * 1000.0,
+							  batched > 0.0 ? single / batched : 0.0) << std::endl;
+		if (single_sum != batched_sum)
+		{
+			std::cout << "Error: batched cull results differ" << std::endl;
+			result = 1;
+		}
+	}
+
+	{
+		// OctreeMinimumNodeSize and OctreeMaxNodeCapacity defaults.
+		gOctreeMinSize = 0.01f;
+		gOctreeMaxCapacity = 128;
+
+		bench_element_list_t elements;
+		std::vector<LLVector4a> rays;
+		LLCamera cameras[NUM_CULL_CAMERAS];
+		build_octree_scene(elements, num_octree_elements, rays);
+		setup_cull_cameras(cameras);
+
+		OctreeTimes pointer_times = bench_pointer_octree(elements, cameras, rays, passes);
+		OctreeTimes linear_times = bench_linear_octree(elements, cameras, rays, passes);
+
+		std::cout << std::endl << num_octree_elements << " octree elements, " << NUM_CULL_CAMERAS << " cameras, "
+				  << NUM_BENCH_RAYS << " rays" << std::endl;
+		std::cout << llformat("%24s%12s%12s%12s%12s", "Octree", "Insert ms", "Remove ms", "Cull ms", "Ray ms") << std::endl;
+		output_octree_times("LLOctreeRoot", pointer_times);
+		output_octree_times("LLLinearOctree", linear_times);
+		if (pointer_times.mMissed || linear_times.mMissed)
+		{
+			std::cout << "Error: octree traversals missed " << pointer_times.mMissed << " and "
+					  << linear_times.mMissed << " elements" << std::endl;
+			result = 1;
+		}
+	}
+
+	{
+		BenchCrowd crowd;
+		build_crowd(crowd, num_avatars);
+
+		std::vector<LLVector4a> legacy_out;
+		std::vector<LLVector4a> serial_out;
+		std::vector<LLVector4a> parallel_out;
+		F64 legacy = skin_crowd_legacy(crowd, passes);
+		snapshot_crowd(crowd, legacy_out);
+		F64 serial = skin_crowd_jobs(crowd, NULL, passes);
+		snapshot_crowd(crowd, serial_out);
+		F64 parallel = skin_crowd_jobs(crowd, &pool, passes);
+		snapshot_crowd(crowd, parallel_out);
+
+		std::cout << std::endl << num_avatars << " avatars, " << BENCH_MESHES_PER_AVATAR << " rigged meshes each, "
+				  << crowd.mNumVertices << " vertices" << std::endl;
+		std::cout << llformat("%24s%12s%12s", "Skinning", "ms/frame", "Speedup") << std::endl;
+		std::cout << llformat("%24s%12.3f%12.2f", "two transforms", legacy * 1000.0, 1.0) << std::endl;
+		std::cout << llformat("%24s%12.3f%12.2f", "folded palette", serial * 1000.0,
+							  serial > 0.0 ? legacy / serial : 0.0) << std::endl;
+		std::string name = llformat("%d threads", pool.getThreadCount() + 1);
+		std::cout << llformat("%24s%12.3f%12.2f", name.c_str(), parallel * 1000.0,
+							  parallel > 0.0 ? legacy / parallel : 0.0) << std::endl;
+
+		// Normals go through normalize3fast(), which is good to about 1e-3.
+		F32 max_diff = compare_crowd(legacy_out, serial_out);
+		if (max_diff > 0.01f)
+		{
+			std::cout << "Error: folded palette differs from two transforms by " << max_diff << std::endl;
+			result = 1;
+		}
+		if (compare_crowd(serial_out, parallel_out) != 0.f)
+		{
+			std::cout << "Error: parallel skinning output differs" << std::endl;
+			result = 1;
+		}
+	}
+
+	{
+		LLVolumeFace shuffled;
+		build_grid_face(shuffled, grid_side);
+		F32 shuffled_acmr = measure_acmr(shuffled, 32);
+
+		LLVolumeFace fresh = shuffled;
+		std::vector<U16> order;
+		LLTimer timer;
+		timer.reset();
+		bool ok = fresh.cacheOptimize(&order);
+		F64 optimize = timer.getElapsedTimeF64();
+
+		LLVolumeFace cached = shuffled;
+		std::vector<U16> saved(order);
+		timer.reset();
+		ok = cached.cacheOptimize(&saved) && ok;
+		F64 reuse = timer.getElapsedTimeF64();
+
+		std::cout << std::endl << shuffled.mNumVertices << " vertices, " << shuffled.mNumIndices / 3 << " triangles" << std::endl;
+		std::cout << llformat("%24s%12s%12s", "Vertex cache", "ms", "ACMR") << std::endl;
+		std::cout << llformat("%24s%12s%12.3f", "shuffled", "", shuffled_acmr) << std::endl;
+		std::cout << llformat("%24s%12.3f%12.3f", "optimized", optimize * 1000.0, measure_acmr(fresh, 32)) << std::endl;
+		std::cout << llformat("%24s%12.3f%12.3f", "saved order", reuse * 1000.0, measure_acmr(cached, 32)) << std::endl;
+
+		if (!ok || saved != order ||
+			memcmp(fresh.mIndices, cached.mIndices, fresh.mNumIndices * sizeof(U16)) ||
+			memcmp(fresh.mPositions, cached.mPositions, fresh.mNumVertices * sizeof(LLVector4a)))
+		{
+			std::cout << "Error: optimizing with the saved order gave a different face" << std::endl;
+			result = 1;
+		}
+	}
+
+	LLThreadPool::cleanupClass();
+	ll_cleanup_apr();
+	return result;
+}
@@ -0,0 +1,282 @@
+/**
+ * @file llmessage_libtest.cpp
+ * @brief Replays a packet capture through the message system and reports
+ * per message decode and handler times.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+#include "linden_common.h"
+#include "lltimer.h"
+
+#include "llmessage_libtest.h"
+
+// Linden library includes
+#include "llapr.h"
+#include "llerrorcontrol.h"
+#include "llmessagetemplate.h"
+#include "llpacketcapture.h"
+#include "message.h"
+#include "net.h"
+
+// system libraries
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+
+// doc string provided when invoking the program with --help
+static const char USAGE[] = "\n"
+"usage:\tllmessage_libtest [options]\n"
+"\n"
+" -h, --help\n"
+"        Print this help\n"
+" -i, --input <file>\n"
+"        Packet capture to replay. Captures are recorded by the viewer when the\n"
+"        PacketCaptureFile debug setting is set.\n"
+" -t, --template <file>\n"
+"        Message template the capture was recorded with.\n"
+"        Default is message_template.msg in the current directory.\n"
+" -r, --repeat <n>\n"
+"        Replay the capture n times. Default is 1.\n"
+"\n";
+
+struct MessageStats
+{
+	MessageStats() : mCount(0), mTotalTime(0.0), mHandlerTime(0.0), mMaxTime(0.0) {}
+
+	U32 mCount;
+	F64 mTotalTime;		// checkMessages() time for packets carrying this message
+	F64 mHandlerTime;	// time spent in the registered handler
+	F64 mMaxTime;
+};
+
+typedef std::map<const char*, MessageStats> message_stats_map_t;
+static message_stats_map_t sMessageStats;
+
+// Called by the message system with the time spent in each handler.
+static void record_handler_time(const char* hashed_name, F32 time, void*)
+{
+	sMessageStats[hashed_name].mHandlerTime += time;
+}
+
+// Stand-in handler that pulls every variable of every block out of the
+// decoded message, which is what a real handler does at the very least.
+static void decode_all_handler(LLMessageSystem* msg, void** user_data)
+{
+	const LLMessageTemplate* templatep = (const LLMessageTemplate*)user_data;
+	U8 buffer[MAX_BUFFER_SIZE];
+
+	for (LLMessageTemplate::message_block_map_t::const_iterator block_it = templatep->mMemberBlocks.begin();
+		 block_it != templatep->mMemberBlocks.end(); ++block_it)
+	{
+		const LLMessageBlock* blockp = *block_it;
+		S32 num_blocks = msg->getNumberOfBlocksFast(blockp->mName);
+		for (S32 i = 0; i < num_blocks; ++i)
+		{
+			for (LLMessageBlock::message_variable_map_t::const_iterator var_it = blockp->mMemberVariables.begin();
+				 var_it != blockp->mMemberVariables.end(); ++var_it)
+			{
+				const LLMessageVariable* varp = *var_it;
+				if (msg->getSizeFast(blockp->mName, i, varp->getName()) > 0)
+				{
+					msg->getBinaryDataFast(blockp->mName, varp->getName(), buffer, 0, i, sizeof(buffer));
+				}
+			}
+		}
+	}
+}
+
+// Every sender found in the capture gets a trusted circuit, as the viewer
+// would have had when the capture was recorded.
+static void enable_capture_circuits(const std::string& filename, std::set<LLHost>& hosts)
+{
+	LLPacketCaptureReader reader;
+	if (!reader.open(filename))
+	{
+		return;
+	}
+
+	char buffer[NET_BUFFER_SIZE];
+	while (reader.readPacket(buffer, sizeof(buffer)))
+	{
+		hosts.insert(LLHost(reader.getSenderIP(), reader.getSenderPort()));
+	}
+
+	for (std::set<LLHost>::const_iterator it = hosts.begin(); it != hosts.end(); ++it)
+	{
+		gMessageSystem->enableCircuit(*it, TRUE);
+	}
+}
+
+static bool compare_total_time(const message_stats_map_t::value_type* a, const message_stats_map_t::value_type* b)
+{
+	return a->second.mTotalTime > b->second.mTotalTime;
+}
+
+static void output_stats(U32 packets, F64 elapsed)
+{
+	std::vector<const message_stats_map_t::value_type*> sorted;
+	for (message_stats_map_t::const_iterator it = sMessageStats.begin(); it != sMessageStats.end(); ++it)
+	{
+		if (it->second.mCount)
+		{
+			sorted.push_back(&(*it));
+		}
+	}
+	std::sort(sorted.begin(), sorted.end(), compare_total_time);
+
+	std::cout << llformat("%35s%10s%12s%12s%12s%10s%10s", "Message", "Count", "Total ms", "Decode ms", "Handler ms", "Avg us", "Max us") << std::endl;
+	for (std::vector<const message_stats_map_t::value_type*>::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+	{
+		const MessageStats& stats = (*it)->second;
+		F64 decode_time = llmax(0.0, stats.mTotalTime - stats.mHandlerTime);
+		std::cout << llformat("%35s%10u%12.3f%12.3f%12.3f%10.2f%10.2f",
+							  (*it)->first,
+							  stats.mCount,
+							  stats.mTotalTime * 1000.0,
+							  decode_time * 1000.0,
+							  stats.mHandlerTime * 1000.0,
+							  stats.mTotalTime * 1000000.0 / stats.mCount,
+							  stats.mMaxTime * 1000000.0) << std::endl;
+	}
+	std::cout << packets << " packets in " << elapsed * 1000.0 << " ms";
+	if (elapsed > 0.0)
+	{
+		std::cout << " (" << (U32)(packets / elapsed) << " packets/s)";
+	}
+	std::cout << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	std::string input_filename;
+	std::string template_filename = "message_template.msg";
+	S32 repeat = 1;
+
+	// Init whatever is necessary
+	ll_init_apr();
+	LLError::initForApplication(".", ".");
+
+	// Analyze command line arguments
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		if (!strcmp(argv[arg], "--help") || !strcmp(argv[arg], "-h"))
+		{
+			std::cout << USAGE << std::endl;
+			return 0;
+		}
+		else if ((!strcmp(argv[arg], "--input") || !strcmp(argv[arg], "-i")) && arg < argc-1)
+		{
+			input_filename = argv[++arg];
+		}
+		else if ((!strcmp(argv[arg], "--template") || !strcmp(argv[arg], "-t")) && arg < argc-1)
+		{
+			template_filename = argv[++arg];
+		}
+		else if ((!strcmp(argv[arg], "--repeat") || !strcmp(argv[arg], "-r")) && arg < argc-1)
+		{
+			repeat = llmax(1, atoi(argv[++arg]));
+		}
+	}
+
+	if (input_filename.empty())
+	{
+		std::cout << "No input capture, nothing to do -> exit" << std::endl;
+		return 0;
+	}
+
+	if (!start_messaging_system(template_filename,
+								NET_USE_OS_ASSIGNED_PORT,
+								1, 0, 0,
+								FALSE,
+								std::string(),
+								NULL,
+								false,
+								5.f,
+								100.f))
+	{
+		std::cout << "Error: message template " << template_filename << " could not be loaded" << std::endl;
+		return 1;
+	}
+
+	LLMessageSystem* msg = gMessageSystem;
+
+	const LLMessageSystem::message_template_name_map_t& templates = msg->getMessageTemplates();
+	for (LLMessageSystem::message_template_name_map_t::const_iterator it = templates.begin(); it != templates.end(); ++it)
+	{
+		msg->setHandlerFuncFast(it->first, decode_all_handler, (void**)it->second);
+	}
+	msg->setTimingFunc(record_handler_time);
+
+	std::set<LLHost> hosts;
+	enable_capture_circuits(input_filename, hosts);
+	if (hosts.empty())
+	{
+		std::cout << "Error: capture " << input_filename << " is empty or unreadable" << std::endl;
+		end_messaging_system(false);
+		return 1;
+	}
+
+	U32 packets = 0;
+	F64 elapsed = 0.0;
+	LLTimer timer;
+	for (S32 pass = 0; pass < repeat; ++pass)
+	{
+		if (!msg->startPacketReplay(input_filename))
+		{
+			break;
+		}
+
+		while (true)
+		{
+			timer.reset();
+			BOOL valid = msg->checkMessages();
+			F64 packet_time = timer.getElapsedTimeF64();
+			if (!valid)
+			{
+				break;
+			}
+
+			MessageStats& stats = sMessageStats[msg->getMessageName()];
+			stats.mCount++;
+			stats.mTotalTime += packet_time;
+			stats.mMaxTime = llmax(stats.mMaxTime, packet_time);
+			elapsed += packet_time;
+			packets++;
+		}
+		msg->stopPacketReplay();
+
+		// Fresh circuits so that the next pass does not see every packet as
+		// out of order.
+		for (std::set<LLHost>::const_iterator it = hosts.begin(); it != hosts.end(); ++it)
+		{
+			msg->disableCircuit(*it);
+			msg->enableCircuit(*it, TRUE);
+		}
+	}
+
+	output_stats(packets, elapsed);
+
+	end_messaging_system(false);
+	return 0;
+}
@@ -0,0 +1,311 @@
+/**
+ * @file llopenhashmap.h
+ * @brief Open addressing hash map for small, trivially hashed keys.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLOPENHASHMAP_H
+#define LL_LLOPENHASHMAP_H
+
+#include <vector>
+
+#include "lluuid.h"
+
+// Hashers return a well mixed 64 bit value, the map uses the low bits.
+template <typename KEY>
+struct LLOpenHash;
+
+template <>
+struct LLOpenHash<U64>
+{
+	U64 operator()(U64 key) const
+	{
+		// MurmurHash3 finalizer, packed (index, local id) keys differ mostly
+		// in their low bits and region indices in the high ones.
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdULL;
+		key ^= key >> 33;
+		key *= 0xc4ceb9fe1a85ec53ULL;
+		key ^= key >> 33;
+		return key;
+	}
+};
+
+template <>
+struct LLOpenHash<U32>
+{
+	U64 operator()(U32 key) const
+	{
+		return LLOpenHash<U64>()((U64)key);
+	}
+};
+
+template <>
+struct LLOpenHash<LLUUID>
+{
+	U64 operator()(const LLUUID& key) const
+	{
+		// UUIDs are already random, fold the two halves and mix once.
+		U64 lo, hi;
+		memcpy(&lo, key.mData, sizeof(lo));
+		memcpy(&hi, key.mData + sizeof(lo), sizeof(hi));
+		return LLOpenHash<U64>()(lo ^ hi);
+	}
+};
+
+// Linear probing over a power of two table of (key, value) slots with
+// backward shift deletion, so there are no tombstones and lookups touch a
+// handful of adjacent slots instead of walking a tree of heap nodes.
+//
+// Pointers returned by find() and references from operator[] are only valid
+// until the next insertion or erasure.
+template <typename KEY, typename VALUE, typename HASH = LLOpenHash<KEY> >
+class LLOpenHashMap
+{
+public:
+	typedef KEY key_type;
+	typedef VALUE mapped_type;
+
+	LLOpenHashMap()
+	:	mSize(0),
+		mMask(0)
+	{
+	}
+
+	size_t size() const		{ return mSize; }
+	bool empty() const		{ return mSize == 0; }
+	size_t capacity() const	{ return mSlots.size(); }
+
+	VALUE* find(const KEY& key)
+	{
+		if (!mSize)
+		{
+			return NULL;
+		}
+		for (size_t i = slotFor(key); mSlots[i].mUsed; i = (i + 1) & mMask)
+		{
+			if (mSlots[i].mKey == key)
+			{
+				return &mSlots[i].mValue;
+			}
+		}
+		return NULL;
+	}
+
+	const VALUE* find(const KEY& key) const
+	{
+		return const_cast<LLOpenHashMap*>(this)->find(key);
+	}
+
+	bool contains(const KEY& key) const
+	{
+		return find(key) != NULL;
+	}
+
+	// Value for key, or def when it is not in the map. Never inserts.
+	VALUE get(const KEY& key, const VALUE& def) const
+	{
+		const VALUE* value = find(key);
+		return value ? *value : def;
+	}
+
+	// Find or default-construct, like std::map.
+	VALUE& operator[](const KEY& key)
+	{
+		VALUE* value = find(key);
+		if (value)
+		{
+			return *value;
+		}
+		return insertNew(key, VALUE());
+	}
+
+	void set(const KEY& key, const VALUE& value)
+	{
+		VALUE* existing = find(key);
+		if (existing)
+		{
+			*existing = value;
+		}
+		else
+		{
+			insertNew(key, value);
+		}
+	}
+
+	bool erase(const KEY& key)
+	{
+		if (!mSize)
+		{
+			return false;
+		}
+
+		size_t i = slotFor(key);
+		while (true)
+		{
+			if (!mSlots[i].mUsed)
+			{
+				return false;
+			}
+			if (mSlots[i].mKey == key)
+			{
+				break;
+			}
+			i = (i + 1) & mMask;
+		}
+
+		// Released on return, same reasoning as clear().
+		VALUE removed = mSlots[i].mValue;
+
+		// Pull following entries of the probe run back into the hole as long
+		// as that does not move them in front of their home slot.
+		size_t hole = i;
+		size_t j = i;
+		while (true)
+		{
+			j = (j + 1) & mMask;
+			if (!mSlots[j].mUsed)
+			{
+				break;
+			}
+			size_t home = slotFor(mSlots[j].mKey);
+			if (((j - home) & mMask) >= ((j - hole) & mMask))
+			{
+				mSlots[hole].mKey = mSlots[j].mKey;
+				mSlots[hole].mValue = mSlots[j].mValue;
+				hole = j;
+			}
+		}
+		mSlots[hole].mUsed = false;
+		mSlots[hole].mKey = KEY();
+		mSlots[hole].mValue = VALUE();
+		--mSize;
+		return true;
+	}
+
+	void clear()
+	{
+		// Values may hold references whose release ends up back in here,
+		// so only destroy them once the map is consistent again.
+		std::vector<Slot> old_slots;
+		old_slots.swap(mSlots);
+		mSize = 0;
+		mMask = 0;
+	}
+
+	// Make room for count entries without rehashing.
+	void reserve(size_t count)
+	{
+		size_t wanted = MIN_CAPACITY;
+		while (wanted * MAX_LOAD_NUM < count * MAX_LOAD_DEN)
+		{
+			wanted <<= 1;
+		}
+		if (wanted > mSlots.size())
+		{
+			rehash(wanted);
+		}
+	}
+
+	// Calls func(key, value) for every entry, in no particular order. The map
+	// must not be modified from func.
+	template <typename FUNC>
+	void forEach(FUNC func) const
+	{
+		for (typename std::vector<Slot>::const_iterator it = mSlots.begin(); it != mSlots.end(); ++it)
+		{
+			if (it->mUsed)
+			{
+				func(it->mKey, it->mValue);
+			}
+		}
+	}
+
+private:
+	struct Slot
+	{
+		Slot() : mKey(), mValue(), mUsed(false) {}
+
+		KEY		mKey;
+		VALUE	mValue;
+		bool	mUsed;
+	};
+
+	static const size_t MIN_CAPACITY = 16;
+	// Grow past 3/4 full, probe runs get long quickly after that.
+	static const size_t MAX_LOAD_NUM = 3;
+	static const size_t MAX_LOAD_DEN = 4;
+
+	size_t slotFor(const KEY& key) const
+	{
+		return (size_t)(mHash(key) & mMask);
+	}
+
+	VALUE& insertNew(const KEY& key, const VALUE& value)
+	{
+		if ((mSize + 1) * MAX_LOAD_DEN > mSlots.size() * MAX_LOAD_NUM)
+		{
+			rehash(mSlots.empty() ? MIN_CAPACITY : mSlots.size() * 2);
+		}
+
+		size_t i = slotFor(key);
+		while (mSlots[i].mUsed)
+		{
+			i = (i + 1) & mMask;
+		}
+		mSlots[i].mKey = key;
+		mSlots[i].mValue = value;
+		mSlots[i].mUsed = true;
+		++mSize;
+		return mSlots[i].mValue;
+	}
+
+	void rehash(size_t new_capacity)
+	{
+		std::vector<Slot> old_slots(new_capacity);
+		old_slots.swap(mSlots);
+		mMask = new_capacity - 1;
+
+		for (typename std::vector<Slot>::iterator it = old_slots.begin(); it != old_slots.end(); ++it)
+		{
+			if (it->mUsed)
+			{
+				size_t i = slotFor(it->mKey);
+				while (mSlots[i].mUsed)
+				{
+					i = (i + 1) & mMask;
+				}
+				mSlots[i].mKey = it->mKey;
+				mSlots[i].mValue = it->mValue;
+				mSlots[i].mUsed = true;
+			}
+		}
+	}
+
+	std::vector<Slot>	mSlots;
+	size_t				mSize;
+	size_t				mMask;
+	HASH				mHash;
+};
+
+#endif // LL_LLOPENHASHMAP_H
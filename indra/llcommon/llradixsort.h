@@ -0,0 +1,93 @@
+/**
+ * @file llradixsort.h
+ * @brief Least significant digit radix sort on 64 bit keys.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLRADIXSORT_H
+#define LL_LLRADIXSORT_H
+
+#include <utility>
+#include <vector>
+
+// Stable ascending sort of items by their U64 mKey member, one byte per
+// pass. Bytes that are the same in every key (common when keys pack a few
+// small ids) are skipped, so sorting costs one histogram pass plus one
+// scatter per byte that actually varies.
+//
+// scratch is resized to items.size() and may be kept between calls to
+// avoid reallocating every frame. T should be cheap to copy.
+template <typename T>
+void ll_radix_sort(std::vector<T>& items, std::vector<T>& scratch)
+{
+	const size_t count = items.size();
+	if (count < 2)
+	{
+		return;
+	}
+	scratch.resize(count);
+
+	// All eight histograms in one pass over the keys.
+	size_t histogram[8][256] = {};
+	for (size_t i = 0; i < count; ++i)
+	{
+		U64 key = items[i].mKey;
+		for (U32 digit = 0; digit < 8; ++digit)
+		{
+			++histogram[digit][(key >> (digit * 8)) & 0xff];
+		}
+	}
+
+	T* src = &items[0];
+	T* dst = &scratch[0];
+	for (U32 digit = 0; digit < 8; ++digit)
+	{
+		size_t* counts = histogram[digit];
+		U32 shift = digit * 8;
+		if (counts[(src[0].mKey >> shift) & 0xff] == count)
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (U32 b = 0; b < 256; ++b)
+		{
+			size_t n = counts[b];
+			counts[b] = offset;
+			offset += n;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			dst[counts[(src[i].mKey >> shift) & 0xff]++] = src[i];
+		}
+		std::swap(src, dst);
+	}
+
+	if (src != &items[0])
+	{
+		items.swap(scratch);
+	}
+}
+
+#endif // LL_LLRADIXSORT_H
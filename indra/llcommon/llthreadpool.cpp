@@ -0,0 +1,259 @@
+/**
+ * @file llthreadpool.cpp
+ * @brief Fixed size pool of worker threads for short CPU bound jobs.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llthreadpool.h"
+
+#include "llatomic.h"
+
+#include <memory>
+
+/*static*/ LLThreadPool* LLThreadPool::sLocal = NULL;
+
+// Keep a core free for the main thread and one for the GL driver.
+static const U32 MAX_DEFAULT_THREADS = 8;
+
+//============================================================================
+// Run on MAIN thread
+//static
+void LLThreadPool::initClass(U32 num_threads)
+{
+	llassert(sLocal == NULL);
+	if (!num_threads)
+	{
+		U32 cores = std::thread::hardware_concurrency();
+		num_threads = llclamp(cores > 2 ? cores - 2 : 1U, 1U, MAX_DEFAULT_THREADS);
+	}
+	sLocal = new LLThreadPool("General", num_threads);
+}
+
+//static
+void LLThreadPool::cleanupClass()
+{
+	delete sLocal;
+	sLocal = NULL;
+}
+
+//----------------------------------------------------------------------------
+
+LLThreadPool::LLThreadPool(const std::string& name, U32 num_threads)
+:	mBusy(0),
+	mQuitting(false)
+{
+	for (U32 i = 0; i < num_threads; ++i)
+	{
+		Worker* worker = new Worker(llformat("%s Pool %d", name.c_str(), i), this);
+		mWorkers.push_back(worker);
+		worker->start();
+	}
+	LL_INFOS("ThreadPool") << "Started " << num_threads << " " << name << " pool threads" << LL_ENDL;
+}
+
+LLThreadPool::~LLThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(mQueueMutex);
+		mQuitting = true;
+		mQueue.clear();
+	}
+	mQueueCondition.notify_all();
+
+	for (std::vector<Worker*>::iterator iter = mWorkers.begin(); iter != mWorkers.end(); ++iter)
+	{
+		(*iter)->shutdown();
+		delete *iter;
+	}
+	mWorkers.clear();
+}
+
+void LLThreadPool::post(const task_t& task)
+{
+	if (mWorkers.empty())
+	{
+		task();
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mQueueMutex);
+		mQueue.push_back(task);
+	}
+	mQueueCondition.notify_one();
+}
+
+U32 LLThreadPool::getPending()
+{
+	std::unique_lock<std::mutex> lock(mQueueMutex);
+	return (U32)mQueue.size();
+}
+
+bool LLThreadPool::waitForTask(task_t& task)
+{
+	std::unique_lock<std::mutex> lock(mQueueMutex);
+	while (mQueue.empty() && !mQuitting)
+	{
+		mQueueCondition.wait(lock);
+	}
+	if (mQuitting)
+	{
+		return false;
+	}
+	task = mQueue.front();
+	mQueue.pop_front();
+	++mBusy;
+	return true;
+}
+
+void LLThreadPool::taskDone()
+{
+	{
+		std::unique_lock<std::mutex> lock(mQueueMutex);
+		--mBusy;
+	}
+	mIdleCondition.notify_all();
+}
+
+void LLThreadPool::waitForIdle()
+{
+	std::unique_lock<std::mutex> lock(mQueueMutex);
+	while ((!mQueue.empty() || mBusy > 0) && !mQuitting)
+	{
+		mIdleCondition.wait(lock);
+	}
+}
+
+//----------------------------------------------------------------------------
+
+namespace
+{
+	// Shared between the caller of parallelFor() and the helper jobs, which
+	// may still be sitting in the queue after the range has completed.
+	struct ParallelRange
+	{
+		ParallelRange(U32 count, U32 grain, const LLThreadPool::range_func_t& func)
+		:	mCount(count),
+			mGrain(grain),
+			mNumChunks((count + grain - 1) / grain),
+			mNextChunk(0),
+			mRemaining((count + grain - 1) / grain),
+			mFunc(func)
+		{
+		}
+
+		// Claim and process one chunk, returns false when none are left.
+		bool runChunk()
+		{
+			U32 chunk = mNextChunk++;
+			if (chunk >= mNumChunks)
+			{
+				return false;
+			}
+
+			U32 begin = chunk * mGrain;
+			mFunc(begin, llmin(begin + mGrain, mCount));
+
+			if (--mRemaining == 0)
+			{
+				std::unique_lock<std::mutex> lock(mDoneMutex);
+				mDoneCondition.notify_all();
+			}
+			return true;
+		}
+
+		void waitForCompletion()
+		{
+			std::unique_lock<std::mutex> lock(mDoneMutex);
+			while (mRemaining.CurrentValue() > 0)
+			{
+				mDoneCondition.wait(lock);
+			}
+		}
+
+		const U32 mCount;
+		const U32 mGrain;
+		const U32 mNumChunks;
+		LLAtomicU32 mNextChunk;
+		LLAtomicU32 mRemaining;
+		LLThreadPool::range_func_t mFunc;
+		std::mutex mDoneMutex;
+		std::condition_variable mDoneCondition;
+	};
+}
+
+void LLThreadPool::parallelFor(U32 count, U32 grain, const range_func_t& func)
+{
+	if (!count)
+	{
+		return;
+	}
+
+	grain = llmax(grain, 1U);
+	if (mWorkers.empty() || count <= grain)
+	{
+		func(0, count);
+		return;
+	}
+
+	std::shared_ptr<ParallelRange> range = std::make_shared<ParallelRange>(count, grain, func);
+
+	// One helper per worker at most, the caller takes chunks as well.
+	U32 helpers = llmin(range->mNumChunks - 1, getThreadCount());
+	for (U32 i = 0; i < helpers; ++i)
+	{
+		post([range]()
+			{
+				while (range->runChunk())
+				{
+				}
+			});
+	}
+
+	while (range->runChunk())
+	{
+	}
+	range->waitForCompletion();
+}
+
+//============================================================================
+
+LLThreadPool::Worker::Worker(const std::string& name, LLThreadPool* pool)
+:	LLThread(name),
+	mPool(pool)
+{
+}
+
+//virtual
+void LLThreadPool::Worker::run()
+{
+	task_t task;
+	while (mPool->waitForTask(task))
+	{
+		task();
+		task = task_t();
+		mPool->taskDone();
+	}
+}
@@ -0,0 +1,112 @@
+/**
+ * @file llthreadpool.h
+ * @brief Fixed size pool of worker threads for short CPU bound jobs.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTHREADPOOL_H
+#define LL_LLTHREADPOOL_H
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "llthread.h"
+
+#if LL_WINDOWS
+#pragma warning (push)
+#pragma warning (disable:4265)
+#endif
+// 'std::_Pad' : class has virtual functions, but destructor is not virtual
+#include <mutex>
+#include <condition_variable>
+
+#if LL_WINDOWS
+#pragma warning (pop)
+#endif
+
+//============================================================================
+// Unlike LLQueuedThread there are no handles, priorities or completion
+// polling: jobs are fire-and-forget closures, and parallelFor() blocks the
+// caller until a range has been processed. Jobs must not touch GL or any
+// main-thread-only state.
+
+class LL_COMMON_API LLThreadPool
+{
+public:
+	typedef std::function<void()> task_t;
+	typedef std::function<void(U32 begin, U32 end)> range_func_t;
+
+	LLThreadPool(const std::string& name, U32 num_threads);
+	~LLThreadPool();
+
+	// Queue a job for any worker.
+	void post(const task_t& task);
+
+	// Call func on sub-ranges of [0, count), each at most grain items long.
+	// The calling thread works on the range too and only returns once every
+	// sub-range has completed. Runs inline when the pool has no threads or
+	// the range fits in a single grain.
+	void parallelFor(U32 count, U32 grain, const range_func_t& func);
+
+	// Block until every queued job has finished running.
+	void waitForIdle();
+
+	U32 getThreadCount() const			{ return (U32)mWorkers.size(); }
+	U32 getPending();
+
+	// Shared pool used by the viewer, sized from the CPU count when
+	// num_threads is 0.
+	static void initClass(U32 num_threads = 0);
+	static void cleanupClass();
+	static LLThreadPool* getInstance()	{ return sLocal; }
+
+private:
+	class Worker : public LLThread
+	{
+	public:
+		Worker(const std::string& name, LLThreadPool* pool);
+		/*virtual*/ void run();
+
+	private:
+		LLThreadPool* mPool;
+	};
+	friend class Worker;
+
+	// Blocks until a job is available; returns false when the pool is
+	// shutting down.
+	bool waitForTask(task_t& task);
+	void taskDone();
+
+	std::mutex				mQueueMutex;
+	std::condition_variable	mQueueCondition;
+	std::condition_variable	mIdleCondition;
+	std::deque<task_t>		mQueue;
+	U32						mBusy;		// jobs currently running
+	bool					mQuitting;
+	std::vector<Worker*>	mWorkers;
+
+	static LLThreadPool*	sLocal;
+};
+
+#endif // LL_LLTHREADPOOL_H
@@ -0,0 +1,146 @@
+/**
+ * @file llopenhashmap_test.cpp
+ * @brief LLOpenHashMap test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llopenhashmap.h"
+
+#include <map>
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct openhashmap_data
+	{
+	};
+	typedef test_group<openhashmap_data> openhashmap_test;
+	typedef openhashmap_test::object openhashmap_object;
+	tut::openhashmap_test openhashmap_testcase("LLOpenHashMap");
+
+	template<> template<>
+	void openhashmap_object::test<1>()
+	{
+		set_test_name("insert, find and erase");
+
+		LLOpenHashMap<U64, U32> map;
+		ensure("starts empty", map.empty());
+		ensure("find in empty map", map.find(42) == NULL);
+		ensure("erase from empty map", !map.erase(42));
+
+		map.set(42, 1);
+		map[43] = 2;
+		ensure_equals("size", map.size(), (size_t)2);
+		ensure_equals("set value", *map.find(42), 1U);
+		ensure_equals("operator[] value", map.get(43, 0), 2U);
+		ensure_equals("missing uses default", map.get(44, 7), 7U);
+		ensure("get does not insert", !map.contains(44));
+
+		map.set(42, 3);
+		ensure_equals("overwrite keeps size", map.size(), (size_t)2);
+		ensure_equals("overwritten value", map.get(42, 0), 3U);
+
+		ensure("erase existing", map.erase(42));
+		ensure("erase again", !map.erase(42));
+		ensure("erased key gone", !map.contains(42));
+		ensure("other key kept", map.contains(43));
+
+		map.clear();
+		ensure("cleared", map.empty() && !map.contains(43));
+	}
+
+	template<> template<>
+	void openhashmap_object::test<2>()
+	{
+		set_test_name("matches std::map under churn");
+
+		// Packed (region index, local id) keys like LLViewerObjectList uses,
+		// with enough collisions to exercise backward shift deletion.
+		LLOpenHashMap<U64, U32> map;
+		std::map<U64, U32> reference;
+		U32 seed = 12345;
+		for (S32 i = 0; i < 200000; ++i)
+		{
+			seed = seed * 1664525 + 1013904223;
+			U64 key = ((U64)((seed >> 8) % 4) << 32) | (U64)((seed >> 12) % 3000);
+			switch ((seed >> 28) % 3)
+			{
+			case 0:
+				map.set(key, seed);
+				reference[key] = seed;
+				break;
+			case 1:
+				ensure_equals("erase result", map.erase(key), reference.erase(key) > 0);
+				break;
+			default:
+				{
+					std::map<U64, U32>::const_iterator it = reference.find(key);
+					const U32* value = map.find(key);
+					ensure_equals("presence", value != NULL, it != reference.end());
+					if (value)
+					{
+						ensure_equals("value", *value, it->second);
+					}
+				}
+				break;
+			}
+		}
+		ensure_equals("final size", map.size(), reference.size());
+
+		size_t visited = 0;
+		map.forEach([&visited, &reference](U64 key, U32 value)
+					{
+						ensure_equals("forEach value", reference[key], value);
+						++visited;
+					});
+		ensure_equals("forEach visits all", visited, reference.size());
+	}
+
+	template<> template<>
+	void openhashmap_object::test<3>()
+	{
+		set_test_name("UUID keys and reserve");
+
+		LLOpenHashMap<LLUUID, S32> map;
+		map.reserve(1000);
+		size_t capacity = map.capacity();
+		ensure("reserved", capacity * 3 >= 1000 * 4);
+
+		std::vector<LLUUID> ids(1000);
+		for (S32 i = 0; i < 1000; ++i)
+		{
+			ids[i].generate();
+			map.set(ids[i], i);
+		}
+		ensure_equals("no rehash after reserve", map.capacity(), capacity);
+
+		for (S32 i = 0; i < 1000; ++i)
+		{
+			ensure_equals("uuid lookup", map.get(ids[i], -1), i);
+		}
+		ensure("null uuid absent", !map.contains(LLUUID::null));
+	}
+}
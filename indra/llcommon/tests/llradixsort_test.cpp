@@ -0,0 +1,128 @@
+/**
+ * @file llradixsort_test.cpp
+ * @brief ll_radix_sort test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llradixsort.h"
+
+#include <algorithm>
+
+#include "../test/lltut.h"
+
+namespace
+{
+	struct SortItem
+	{
+		U64	mKey;
+		U32	mIndex;
+	};
+
+	bool key_less(const SortItem& lhs, const SortItem& rhs)
+	{
+		return lhs.mKey < rhs.mKey;
+	}
+}
+
+namespace tut
+{
+	struct radixsort_data
+	{
+	};
+	typedef test_group<radixsort_data> radixsort_test;
+	typedef radixsort_test::object radixsort_object;
+	tut::radixsort_test radixsort_testcase("ll_radix_sort");
+
+	template<> template<>
+	void radixsort_object::test<1>()
+	{
+		set_test_name("matches std::stable_sort");
+
+		// Keys shaped like draw sort keys: a few distinct high fields, many
+		// low ones and lots of duplicates to check stability.
+		std::vector<SortItem> items(20000);
+		U32 seed = 12345;
+		for (U32 i = 0; i < items.size(); ++i)
+		{
+			seed = seed * 1664525 + 1013904223;
+			items[i].mKey = ((U64)((seed >> 28) % 5) << 56) | ((U64)((seed >> 8) % 300) << 20) | (U64)((seed >> 16) % 7);
+			items[i].mIndex = i;
+		}
+
+		std::vector<SortItem> expected(items);
+		std::stable_sort(expected.begin(), expected.end(), key_less);
+
+		std::vector<SortItem> scratch;
+		ll_radix_sort(items, scratch);
+		ensure_equals("size", items.size(), expected.size());
+		for (U32 i = 0; i < items.size(); ++i)
+		{
+			ensure_equals("key", items[i].mKey, expected[i].mKey);
+			ensure_equals("stable", items[i].mIndex, expected[i].mIndex);
+		}
+	}
+
+	template<> template<>
+	void radixsort_object::test<2>()
+	{
+		set_test_name("trivial inputs");
+
+		std::vector<SortItem> items;
+		std::vector<SortItem> scratch;
+		ll_radix_sort(items, scratch);
+		ensure("empty", items.empty());
+
+		SortItem item = { 42, 0 };
+		items.push_back(item);
+		ll_radix_sort(items, scratch);
+		ensure_equals("single", items[0].mKey, (U64)42);
+
+		// Identical keys skip every pass and keep their order.
+		items.clear();
+		for (U32 i = 0; i < 100; ++i)
+		{
+			SortItem same = { 0x0123456789abcdefULL, i };
+			items.push_back(same);
+		}
+		ll_radix_sort(items, scratch);
+		for (U32 i = 0; i < items.size(); ++i)
+		{
+			ensure_equals("order kept", items[i].mIndex, i);
+		}
+
+		// Full width keys.
+		items.clear();
+		SortItem high = { 0xffffffffffffffffULL, 0 };
+		SortItem low = { 0, 1 };
+		SortItem mid = { 0x8000000000000000ULL, 2 };
+		items.push_back(high);
+		items.push_back(low);
+		items.push_back(mid);
+		ll_radix_sort(items, scratch);
+		ensure_equals("low first", items[0].mIndex, 1U);
+		ensure_equals("mid second", items[1].mIndex, 2U);
+		ensure_equals("high last", items[2].mIndex, 0U);
+	}
+}
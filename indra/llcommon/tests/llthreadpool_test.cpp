@@ -0,0 +1,88 @@
+/**
+ * @file   llthreadpool_test.cpp
+ * @brief  Test for LLThreadPool.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Copyright (c) 2026, Linden Research, Inc.
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llthreadpool.h"
+// STL headers
+#include <vector>
+// other Linden headers
+#include "llatomic.h"
+#include "lltimer.h"
+#include "../test/lltut.h"
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+    struct llthreadpool_data
+    {
+    };
+    typedef test_group<llthreadpool_data> llthreadpool_group;
+    typedef llthreadpool_group::object object;
+    llthreadpool_group llthreadpoolgrp("llthreadpool");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("parallelFor visits every index exactly once");
+        LLThreadPool pool("test", 4);
+
+        std::vector<U32> visits(10007, 0);
+        pool.parallelFor(visits.size(), 64,
+                         [&visits](U32 begin, U32 end)
+                         {
+                             for (U32 i = begin; i < end; ++i)
+                             {
+                                 visits[i]++;
+                             }
+                         });
+        for (U32 i = 0; i < visits.size(); ++i)
+        {
+            ensure_equals("visit count", visits[i], 1U);
+        }
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("parallelFor without workers runs inline");
+        LLThreadPool pool("test", 0);
+
+        U32 calls = 0;
+        pool.parallelFor(100, 8, [&calls](U32 begin, U32 end)
+                         {
+                             ensure_equals("whole range", end - begin, 100U);
+                             ++calls;
+                         });
+        ensure_equals("single call", calls, 1U);
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("posted jobs all run");
+        LLAtomicU32 done(0);
+        {
+            LLThreadPool pool("test", 3);
+            for (U32 i = 0; i < 50; ++i)
+            {
+                pool.post([&done]() { done++; });
+            }
+            LLTimer timer;
+            while (done.CurrentValue() < 50 && timer.getElapsedTimeF32() < 10.f)
+            {
+                ms_sleep(1);
+            }
+        }
+        ensure_equals("jobs completed", done.CurrentValue(), 50U);
+    }
+} // namespace tut
@@ -41,6 +41,7 @@
 #include "llmemory.h"
 
 #include <boost/preprocessor.hpp>
+#include <emmintrin.h>
 
 //..................................................................................
 //..................................................................................
@@ -841,6 +842,7 @@ LLImageRaw::~LLImageRaw()
 // virtual
 U8* LLImageRaw::allocateData(S32 size)
 {
+	clearAlphaScan();
 	U8* res = LLImageBase::allocateData(size);
 	sGlobalRawMemory += getDataSize();
 	return res;
@@ -849,6 +851,7 @@ U8* LLImageRaw::allocateData(S32 size)
 // virtual
 U8* LLImageRaw::reallocateData(S32 size)
 {
+	clearAlphaScan();
 	sGlobalRawMemory -= getDataSize();
 	U8* res = LLImageBase::reallocateData(size);
 	sGlobalRawMemory += getDataSize();
@@ -858,6 +861,7 @@ U8* LLImageRaw::reallocateData(S32 size)
 // virtual
 void LLImageRaw::deleteData()
 {
+	clearAlphaScan();
 	sGlobalRawMemory -= getDataSize();
 	LLImageBase::deleteData();
 }
@@ -894,6 +898,7 @@ bool LLImageRaw::resize(U16 width, U16 height, S8 components)
 bool LLImageRaw::setSubImage(U32 x_pos, U32 y_pos, U32 width, U32 height,
 							 const U8 *data, U32 stride, bool reverse_y)
 {
+	clearAlphaScan();
 	if (!getData())
 	{
 		return false;
@@ -920,6 +925,7 @@ bool LLImageRaw::setSubImage(U32 x_pos, U32 y_pos, U32 width, U32 height,
 
 void LLImageRaw::clear(U8 r, U8 g, U8 b, U8 a)
 {
+	clearAlphaScan();
 	llassert( getComponents() <= 4 );
 	// This is fairly bogus, but it'll do for now.
 	if (isBufferInvalid())
@@ -961,6 +967,7 @@ void LLImageRaw::clear(U8 r, U8 g, U8 b, U8 a)
 // Reverses the order of the rows in the image
 void LLImageRaw::verticalFlip()
 {
+	clearAlphaScan();
 	S32 row_bytes = getWidth() * getComponents();
 	llassert(row_bytes > 0);
 	std::vector<U8> line_buffer(row_bytes);
@@ -1053,6 +1060,7 @@ inline U8 LLImageRaw::fastFractionalMult( U8 a, U8 b )
 
 void LLImageRaw::composite( LLImageRaw* src )
 {
+	clearAlphaScan();
 	LLImageRaw* dst = this;  // Just for clarity.
 
 	if (!validateSrcAndDst("LLImageRaw::composite", src, dst))
@@ -1095,6 +1103,7 @@ void LLImageRaw::composite( LLImageRaw* src )
 // Src and dst can be any size.  Src has 4 components.  Dst has 3 components.
 void LLImageRaw::compositeScaled4onto3(LLImageRaw* src)
 {
+	clearAlphaScan();
 	LL_INFOS() << "compositeScaled4onto3" << LL_ENDL;
 
 	LLImageRaw* dst = this;  // Just for clarity.
@@ -1122,6 +1131,7 @@ void LLImageRaw::compositeScaled4onto3(LLImageRaw* src)
 // Src and dst are same size.  Src has 4 components.  Dst has 3 components.
 void LLImageRaw::compositeUnscaled4onto3( LLImageRaw* src )
 {
+	clearAlphaScan();
 	LLImageRaw* dst = this;  // Just for clarity.
 
 	llassert( (3 == src->getComponents()) || (4 == src->getComponents()) );
@@ -1159,6 +1169,7 @@ void LLImageRaw::compositeUnscaled4onto3( LLImageRaw* src )
 
 void LLImageRaw::copyUnscaledAlphaMask( LLImageRaw* src, const LLColor4U& fill)
 {
+	clearAlphaScan();
 	LLImageRaw* dst = this;  // Just for clarity.
 
 	if (!validateSrcAndDst("LLImageRaw::copyUnscaledAlphaMask", src, dst))
@@ -1188,6 +1199,7 @@ void LLImageRaw::copyUnscaledAlphaMask( LLImageRaw* src, const LLColor4U& fill)
 // Fill the buffer with a constant color
 void LLImageRaw::fill( const LLColor4U& color )
 {
+	clearAlphaScan();
 	if (isBufferInvalid())
 	{
 		LL_WARNS() << "Invalid image buffer" << LL_ENDL;
@@ -1233,6 +1245,7 @@ LLPointer<LLImageRaw> LLImageRaw::duplicate()
 // Src and dst can be any size.  Src and dst can each have 3 or 4 components.
 void LLImageRaw::copy(LLImageRaw* src)
 {
+	clearAlphaScan();
 	LLImageRaw* dst = this;  // Just for clarity.
 
 	if (!validateSrcAndDst("LLImageRaw::copy", src, dst))
@@ -1282,6 +1295,7 @@ void LLImageRaw::copy(LLImageRaw* src)
 // Src and dst are same size.  Src and dst have same number of components.
 void LLImageRaw::copyUnscaled(LLImageRaw* src)
 {
+	clearAlphaScan();
 	LLImageRaw* dst = this;  // Just for clarity.
 
 	llassert( (1 == src->getComponents()) || (3 == src->getComponents()) || (4 == src->getComponents()) );
@@ -1295,6 +1309,7 @@ void LLImageRaw::copyUnscaled(LLImageRaw* src)
 // Src and dst can be any size.  Src has 3 components.  Dst has 4 components.
 void LLImageRaw::copyScaled3onto4(LLImageRaw* src)
 {
+	clearAlphaScan();
 	llassert( (3 == src->getComponents()) && (4 == getComponents()) );
 
 	// Slow, but simple.  Optimize later if needed.
@@ -1307,6 +1322,7 @@ void LLImageRaw::copyScaled3onto4(LLImageRaw* src)
 // Src and dst can be any size.  Src has 4 components.  Dst has 3 components.
 void LLImageRaw::copyScaled4onto3(LLImageRaw* src)
 {
+	clearAlphaScan();
 	llassert( (4 == src->getComponents()) && (3 == getComponents()) );
 
 	// Slow, but simple.  Optimize later if needed.
@@ -1319,6 +1335,7 @@ void LLImageRaw::copyScaled4onto3(LLImageRaw* src)
 // Src and dst are same size.  Src has 4 components.  Dst has 3 components.
 void LLImageRaw::copyUnscaled4onto3( LLImageRaw* src )
 {
+	clearAlphaScan();
 	LLImageRaw* dst = this;  // Just for clarity.
 
 	llassert( (3 == dst->getComponents()) && (4 == src->getComponents()) );
@@ -1341,6 +1358,7 @@ void LLImageRaw::copyUnscaled4onto3( LLImageRaw* src )
 // Src and dst are same size.  Src has 3 components.  Dst has 4 components.
 void LLImageRaw::copyUnscaled3onto4( LLImageRaw* src )
 {
+	clearAlphaScan();
 	LLImageRaw* dst = this;  // Just for clarity.
 	llassert( 3 == src->getComponents() );
 	llassert( 4 == dst->getComponents() );
@@ -1364,6 +1382,7 @@ void LLImageRaw::copyUnscaled3onto4( LLImageRaw* src )
 // Src and dst can be any size.  Src and dst have same number of components.
 void LLImageRaw::copyScaled( LLImageRaw* src )
 {
+	clearAlphaScan();
 	LLImageRaw* dst = this;  // Just for clarity.
 
 	if (!validateSrcAndDst("LLImageRaw::copyScaled", src, dst))
@@ -1744,6 +1763,222 @@ void LLImageRaw::compositeRowScaled4onto3( U8* in, U8* out, S32 in_pixel_len, S3
 	}
 }
 
+void LLImageRaw::scanAlpha()
+{
+	clearAlphaScan();
+
+	S32 width = getWidth();
+	S32 height = getHeight();
+	const U8* data = getData();
+	if (getComponents() != 4 || !data || isBufferInvalid() || width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	mAlphaScan.mPickMask.assign(pickMaskSize(width, height), 0);
+
+	// Most textures are fully opaque, which decides both results and is
+	// cheap to check sixteen bytes at a time
+	const S32 pixels = width * height;
+	const __m128i alpha_bits = _mm_set1_epi32(0xff000000);
+	bool opaque = true;
+	S32 i = 0;
+	while (opaque && i + 4 <= pixels)
+	{
+		__m128i all = alpha_bits;
+		S32 end = llmin(i + 256, pixels & ~3);
+		for (; i < end; i += 4)
+		{
+			all = _mm_and_si128(all, _mm_loadu_si128((const __m128i*)(data + i * 4)));
+		}
+		opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(all, alpha_bits)) == 0xffff;
+	}
+	for (; opaque && i < pixels; ++i)
+	{
+		opaque = data[i * 4 + 3] == 255;
+	}
+
+	if (opaque)
+	{
+		mAlphaScan.mIsMask = true;
+		U32 samples = ((width + 1) / 2) * ((height + 1) / 2);
+		memset(&mAlphaScan.mPickMask[0], 0xff, samples / 8);
+		if (samples % 8)
+		{
+			mAlphaScan.mPickMask[samples / 8] = (1 << (samples % 8)) - 1;
+		}
+	}
+	else
+	{
+		mAlphaScan.mIsMask = isAlphaMask(data + 3, width, height, 4);
+		buildPickMask(data, width, height, &mAlphaScan.mPickMask[0]);
+	}
+
+	mAlphaScan.mWidth = width;
+	mAlphaScan.mHeight = height;
+}
+
+const LLImageRaw::AlphaScan* LLImageRaw::getAlphaScan() const
+{
+	if (mAlphaScan.mWidth == 0 || mAlphaScan.mWidth != getWidth() || mAlphaScan.mHeight != getHeight() ||
+		getComponents() != 4)
+	{
+		return NULL;
+	}
+	return &mAlphaScan;
+}
+
+//static
+bool LLImageRaw::isAlphaMask(const U8* alpha, U32 w, U32 h, U32 stride)
+{
+	U32 length = w * h;
+	U32 alphatotal = 0;
+	
+	U32 sample[16];
+	memset(sample, 0, sizeof(U32)*16);
+
+	// generate histogram of quantized alpha.
+	// also add-in the histogram of a 2x2 box-sampled version.  The idea is
+	// this will mid-skew the data (and thus increase the chances of not
+	// being used as a mask) from high-frequency alpha maps which
+	// suffer the worst from aliasing when used as alpha masks.
+	if (w >= 2 && h >= 2)
+	{
+		llassert(w%2 == 0);
+		llassert(h%2 == 0);
+		const U8* rowstart = alpha;
+		for (U32 y = 0; y < h; y+=2)
+		{
+			const U8* current = rowstart;
+			for (U32 x = 0; x < w; x+=2)
+			{
+				const U32 s1 = current[0];
+				alphatotal += s1;
+				const U32 s2 = current[w * stride];
+				alphatotal += s2;
+				current += stride;
+				const U32 s3 = current[0];
+				alphatotal += s3;
+				const U32 s4 = current[w * stride];
+				alphatotal += s4;
+				current += stride;
+
+				++sample[s1/16];
+				++sample[s2/16];
+				++sample[s3/16];
+				++sample[s4/16];
+
+				const U32 asum = (s1+s2+s3+s4);
+				alphatotal += asum;
+				sample[asum/(16*4)] += 4;
+			}
+			
+			
+			rowstart += 2 * w * stride;
+		}
+		length *= 2; // we sampled everything twice, essentially
+	}
+	else
+	{
+		const U8* current = alpha;
+		for (U32 i = 0; i < length; i++)
+		{
+			const U32 s1 = *current;
+			alphatotal += s1;
+			++sample[s1/16];
+			current += stride;
+		}
+	}
+	
+	// if more than 1/16th of alpha samples are mid-range, this
+	// shouldn't be treated as a 1-bit mask
+
+	// also, if all of the alpha samples are clumped on one half
+	// of the range (but not at an absolute extreme), then consider
+	// this to be an intentional effect and don't treat as a mask.
+
+	U32 midrangetotal = 0;
+	for (U32 i = 2; i < 13; i++)
+	{
+		midrangetotal += sample[i];
+	}
+	U32 lowerhalftotal = 0;
+	for (U32 i = 0; i < 8; i++)
+	{
+		lowerhalftotal += sample[i];
+	}
+	U32 upperhalftotal = 0;
+	for (U32 i = 8; i < 16; i++)
+	{
+		upperhalftotal += sample[i];
+	}
+
+	if (midrangetotal > length/48 || // lots of midrange, or
+	    (lowerhalftotal == length && alphatotal != 0) || // all close to transparent but not all totally transparent, or
+	    (upperhalftotal == length && alphatotal != 255*length)) // all close to opaque but not all totally opaque
+	{
+		return false; // not suitable for masking
+	}
+	return true;
+}
+
+//static
+U32 LLImageRaw::pickMaskSize(S32 width, S32 height)
+{
+	U32 pick_width = width/2 + 1;
+	U32 pick_height = height/2 + 1;
+	return (pick_width * pick_height + 7) / 8; // pixelcount-to-bits
+}
+
+//static
+void LLImageRaw::buildPickMask(const U8* rgba, S32 width, S32 height, U8* mask)
+{
+	if (width % 16 == 0)
+	{
+		// Every row of samples starts on a byte, and each 64 bytes of pixels
+		// give one byte of mask: the alpha of every other pixel, compared as
+		// signed bytes after moving the range down by 128.
+		const __m128i bias = _mm_set1_epi8((char)0x80);
+		const __m128i threshold = _mm_set1_epi8((char)(32 ^ 0x80));
+		for (S32 y = 0; y < height; y += 2)
+		{
+			const U8* row = rgba + y * width * 4;
+			for (S32 x = 0; x < width; x += 16)
+			{
+				U32 bits = 0;
+				for (S32 j = 0; j < 4; ++j)
+				{
+					__m128i pixels = _mm_loadu_si128((const __m128i*)(row + (x + j * 4) * 4));
+					U32 above = _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_xor_si128(pixels, bias), threshold));
+					bits |= ((above >> 3) & 1) << (j * 2);
+					bits |= ((above >> 11) & 1) << (j * 2 + 1);
+				}
+				*mask++ = (U8)bits;
+			}
+		}
+		return;
+	}
+
+	U32 pick_bit = 0;
+	for (S32 y = 0; y < height; y += 2)
+	{
+		for (S32 x = 0; x < width; x += 2)
+		{
+			U8 alpha = rgba[(y*width+x)*4+3];
+
+			if (alpha > 32)
+			{
+				U32 pick_idx = pick_bit/8;
+				U32 pick_offset = pick_bit%8;
+
+				mask[pick_idx] |= 1 << pick_offset;
+			}
+			
+			++pick_bit;
+		}
+	}
+}
+
 bool LLImageRaw::validateSrcAndDst(std::string func, LLImageRaw* src, LLImageRaw* dst)
 {
 	if (!src || !dst || src->isBufferInvalid() || dst->isBufferInvalid())
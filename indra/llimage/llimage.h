@@ -260,6 +260,37 @@ public:
 	// Src and dst are same size.  Src has 4 components.  Dst has 3 components.
 	void compositeUnscaled4onto3( LLImageRaw* src );
 
+	// Alpha analysis
+
+	// What LLImageGL needs to know about the alpha channel of a 4 component
+	// image, worked out off the main thread by scanAlpha() so uploads do not
+	// have to read the pixels again.
+	struct AlphaScan
+	{
+		AlphaScan() : mWidth(0), mHeight(0), mIsMask(false) {}
+
+		U16				mWidth;		// 0 if there is no scan
+		U16				mHeight;
+		bool			mIsMask;	// suitable for alpha masking
+		std::vector<U8>	mPickMask;	// see buildPickMask()
+	};
+
+	void scanAlpha();
+	// The methods here that change pixels call this. Anything writing
+	// through getData() after scanAlpha() must call it too.
+	void clearAlphaScan() { mAlphaScan.mWidth = 0; }
+	// NULL unless scanAlpha() was called on the current pixels
+	const AlphaScan* getAlphaScan() const;
+
+	// Histogram test for alpha that is mostly fully on or off. alpha is
+	// the first alpha byte and stride the distance between pixels.
+	static bool isAlphaMask(const U8* alpha, U32 width, U32 height, U32 stride);
+	// One bit per 2x2 block of an RGBA image, set where the top left alpha
+	// is above 32, with the rows packed together. mask must be zeroed and
+	// hold pickMaskSize() bytes.
+	static U32 pickMaskSize(S32 width, S32 height);
+	static void buildPickMask(const U8* rgba, S32 width, S32 height, U8* mask);
+
 protected:
 	// Create an image from a local file (generally used in tools)
 	//bool createFromFile(const std::string& filename, bool j2c_lowest_mip_only = false);
@@ -277,6 +308,8 @@ public:
 
 private:
 	bool validateSrcAndDst(std::string func, LLImageRaw* src, LLImageRaw* dst);
+
+	AlphaScan mAlphaScan;
 };
 
 // Compressed representation of image.
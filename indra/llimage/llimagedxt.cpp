@@ -459,6 +459,264 @@ bool LLImageDXT::convertToDXR()
 	return true;
 }
 
+//============================================================================
+// Block compression
+//
+// Fast single pass encoders: the end points are the inset bounding box of
+// the block, which is much cheaper than a best fit and good enough for
+// photographic content at texture distances.
+
+namespace
+{
+	inline U16 pack_565(const S32* color)
+	{
+		return (U16)(((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3));
+	}
+
+	inline void unpack_565(U16 packed, S32* color)
+	{
+		S32 r = (packed >> 11) & 0x1f;
+		S32 g = (packed >> 5) & 0x3f;
+		S32 b = packed & 0x1f;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	// Copies a 4x4 block of RGBA pixels, repeating the last row and column
+	// for mips smaller than a block.
+	void fetch_block(const U8* data, S32 width, S32 height, S32 ncomponents, S32 x, S32 y, U8* block)
+	{
+		for (S32 by = 0; by < 4; ++by)
+		{
+			S32 sy = llmin(y + by, height - 1);
+			for (S32 bx = 0; bx < 4; ++bx)
+			{
+				S32 sx = llmin(x + bx, width - 1);
+				const U8* src = data + (sy * width + sx) * ncomponents;
+				U8* dst = block + (by * 4 + bx) * 4;
+				dst[0] = src[0];
+				dst[1] = src[1];
+				dst[2] = src[2];
+				dst[3] = ncomponents == 4 ? src[3] : 255;
+			}
+		}
+	}
+
+	// 8 byte four colour block, as used by BC1 and the colour half of BC3
+	void compress_color_block(const U8* block, U8* out)
+	{
+		S32 lo[3] = { 255, 255, 255 };
+		S32 hi[3] = { 0, 0, 0 };
+		for (S32 i = 0; i < 16; ++i)
+		{
+			for (S32 c = 0; c < 3; ++c)
+			{
+				lo[c] = llmin(lo[c], (S32)block[i * 4 + c]);
+				hi[c] = llmax(hi[c], (S32)block[i * 4 + c]);
+			}
+		}
+		for (S32 c = 0; c < 3; ++c)
+		{
+			S32 inset = (hi[c] - lo[c]) >> 4;
+			lo[c] += inset;
+			hi[c] -= inset;
+		}
+
+		U16 c0 = pack_565(hi);
+		U16 c1 = pack_565(lo);
+		if (c0 < c1)
+		{
+			std::swap(c0, c1);
+		}
+
+		U32 indices = 0;
+		if (c0 != c1)
+		{
+			S32 palette[4][3];
+			unpack_565(c0, palette[0]);
+			unpack_565(c1, palette[1]);
+			for (S32 c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (S32 i = 0; i < 16; ++i)
+			{
+				const U8* pixel = block + i * 4;
+				U32 best = 0;
+				S32 best_dist = S32_MAX;
+				for (U32 p = 0; p < 4; ++p)
+				{
+					S32 dr = pixel[0] - palette[p][0];
+					S32 dg = pixel[1] - palette[p][1];
+					S32 db = pixel[2] - palette[p][2];
+					S32 dist = dr * dr + dg * dg + db * db;
+					if (dist < best_dist)
+					{
+						best_dist = dist;
+						best = p;
+					}
+				}
+				indices |= best << (i * 2);
+			}
+		}
+
+		out[0] = c0 & 0xff;
+		out[1] = c0 >> 8;
+		out[2] = c1 & 0xff;
+		out[3] = c1 >> 8;
+		out[4] = indices & 0xff;
+		out[5] = (indices >> 8) & 0xff;
+		out[6] = (indices >> 16) & 0xff;
+		out[7] = indices >> 24;
+	}
+
+	// 8 byte eight value alpha block of BC3
+	void compress_alpha_block(const U8* block, U8* out)
+	{
+		S32 lo = 255;
+		S32 hi = 0;
+		for (S32 i = 0; i < 16; ++i)
+		{
+			lo = llmin(lo, (S32)block[i * 4 + 3]);
+			hi = llmax(hi, (S32)block[i * 4 + 3]);
+		}
+
+		U64 indices = 0;
+		if (hi != lo)
+		{
+			S32 palette[8];
+			palette[0] = hi;
+			palette[1] = lo;
+			for (S32 k = 1; k < 7; ++k)
+			{
+				palette[k + 1] = ((7 - k) * hi + k * lo) / 7;
+			}
+
+			for (S32 i = 0; i < 16; ++i)
+			{
+				S32 alpha = block[i * 4 + 3];
+				U64 best = 0;
+				S32 best_dist = S32_MAX;
+				for (U32 p = 0; p < 8; ++p)
+				{
+					S32 dist = llabs(alpha - palette[p]);
+					if (dist < best_dist)
+					{
+						best_dist = dist;
+						best = p;
+					}
+				}
+				indices |= best << (i * 3);
+			}
+		}
+
+		out[0] = (U8)hi;
+		out[1] = (U8)lo;
+		for (S32 b = 0; b < 6; ++b)
+		{
+			out[2 + b] = (indices >> (b * 8)) & 0xff;
+		}
+	}
+}
+
+bool LLImageDXT::compress(const LLImageRaw* raw_image)
+{
+	llassert_always(raw_image);
+
+	S32 ncomponents = raw_image->getComponents();
+	S32 width = raw_image->getWidth();
+	S32 height = raw_image->getHeight();
+	const U8* rawdata = raw_image->getData();
+	if ((ncomponents != 3 && ncomponents != 4) || !rawdata ||
+		width < 4 || height < 4 || (width & 3) || (height & 3))
+	{
+		return false;
+	}
+
+	EFileFormat format = FORMAT_DXR1;
+	if (ncomponents == 4)
+	{
+		S32 size = width * height * 4;
+		for (S32 i = 3; i < size; i += 4)
+		{
+			if (rawdata[i] != 255)
+			{
+				format = FORMAT_DXR5;
+				break;
+			}
+		}
+	}
+
+	setSize(width, height, ncomponents);
+	mHeaderSize = sizeof(dxtfile_header_t);
+	mFileFormat = format;
+
+	S32 nmips = calcNumMips(width, height);
+	S32 w = width;
+	S32 h = height;
+
+	S32 totbytes = mHeaderSize;
+	for (S32 mip=0; mip<nmips; mip++)
+	{
+		totbytes += formatBytes(format,w,h);
+		w >>= 1;
+		h >>= 1;
+	}
+
+	U8* data = allocateData(totbytes);
+	if (!data)
+	{
+		return false;
+	}
+
+	dxtfile_header_t* header = (dxtfile_header_t*)data;
+	memset(header, 0, mHeaderSize);
+	header->fourcc = 0x20534444;
+	header->pixel_fmt.fourcc = getFourCC(format);
+	header->num_mips = nmips;
+	header->maxwidth = width;
+	header->maxheight = height;
+
+	// Each mip is filtered from the one before it
+	std::vector<U8> mip_buffers[2];
+	const U8* src = rawdata;
+	U8 block[64];
+	w = width, h = height;
+	for (S32 mip=0; mip<nmips; mip++)
+	{
+		if (mip > 0)
+		{
+			std::vector<U8>& mip_buffer = mip_buffers[mip & 1];
+			mip_buffer.resize(w * h * ncomponents);
+			generateMip(src, &mip_buffer[0], w, h, ncomponents);
+			src = &mip_buffer[0];
+		}
+
+		U8* out = data + getMipOffset(mip);
+		for (S32 y = 0; y < h; y += 4)
+		{
+			for (S32 x = 0; x < w; x += 4)
+			{
+				fetch_block(src, w, h, ncomponents, x, y, block);
+				if (format == FORMAT_DXR5)
+				{
+					compress_alpha_block(block, out);
+					out += 8;
+				}
+				compress_color_block(block, out);
+				out += 8;
+			}
+		}
+		w >>= 1;
+		h >>= 1;
+	}
+
+	return true;
+}
+
 // virtual
 S32 LLImageDXT::calcHeaderSize()
 {
@@ -116,6 +116,11 @@ public:
 	bool isCompressed() { return (mFileFormat >= FORMAT_DXT1 && mFileFormat <= FORMAT_DXR5); }
 
 	bool convertToDXR(); // convert from DXT to DXR
+
+	// Block compresses a 3 or 4 component image and a box filtered mip chain
+	// to DXR1, or to DXR5 when any pixel is not opaque. Width and height must
+	// be multiples of 4. Returns false if the image can not be compressed.
+	bool compress(const LLImageRaw* raw_image);
 	
 	static void checkMinWidthHeight(EFileFormat format, S32& width, S32& height);
 	static S32 formatBits(EFileFormat format);
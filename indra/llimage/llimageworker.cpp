@@ -145,6 +145,11 @@ bool LLImageDecodeThread::ImageRequest::processRequest()
 		done = mFormattedImage->decode(mDecodedImageRaw, decode_time_slice); // 1ms
 		// some decoders are removing data when task is complete and there were errors
 		mDecodedRaw = done && mDecodedImageRaw->getData();
+		if (mDecodedRaw)
+		{
+			// Alpha mask and pick mask results are picked up by LLImageGL at upload
+			mDecodedImageRaw->scanAlpha();
+		}
 	}
 	if (done && mNeedsAux && !mDecodedAux && mFormattedImage.notNull())
 	{
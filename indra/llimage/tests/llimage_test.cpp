@@ -0,0 +1,256 @@
+/**
+ * @file llimage_test.cpp
+ * @brief LLImageRaw alpha scan test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llimage.h"
+#include "v4coloru.h"
+
+#include <vector>
+
+#include "../test/lltut.h"
+
+namespace
+{
+	// The per pixel loop LLImageGL used before the pick mask moved to
+	// LLImageRaw, kept here as the reference for the SSE2 path.
+	void reference_pick_mask(const U8* rgba, S32 width, S32 height, std::vector<U8>& mask)
+	{
+		mask.assign(LLImageRaw::pickMaskSize(width, height), 0);
+		U32 pick_bit = 0;
+		for (S32 y = 0; y < height; y += 2)
+		{
+			for (S32 x = 0; x < width; x += 2)
+			{
+				if (rgba[(y*width+x)*4+3] > 32)
+				{
+					mask[pick_bit/8] |= 1 << (pick_bit%8);
+				}
+				++pick_bit;
+			}
+		}
+	}
+
+	// Alpha values either side of the pick threshold and of the sign bit
+	// the SSE2 compare flips, cycled across the image with white colour so
+	// a compare picking up the wrong byte of a pixel shows.
+	const U8 EDGE_ALPHAS[] = { 0, 31, 32, 33, 127, 128, 129, 160, 254, 255, 1 };
+	const U32 NUM_EDGE_ALPHAS = sizeof(EDGE_ALPHAS) / sizeof(EDGE_ALPHAS[0]);
+
+	void fill_edge_alphas(U8* rgba, S32 width, S32 height)
+	{
+		for (S32 i = 0; i < width * height; ++i)
+		{
+			rgba[i*4] = rgba[i*4+1] = rgba[i*4+2] = 255;
+			rgba[i*4+3] = EDGE_ALPHAS[(i * 7 + i / width) % NUM_EDGE_ALPHAS];
+		}
+	}
+
+	enum EAlphaKind
+	{
+		ALPHA_OPAQUE,
+		ALPHA_BINARY,
+		ALPHA_BLENDED
+	};
+
+	LLPointer<LLImageRaw> make_image(S32 width, S32 height, EAlphaKind kind)
+	{
+		LLPointer<LLImageRaw> raw = new LLImageRaw(width, height, 4);
+		U8* data = raw->getData();
+		for (S32 y = 0; y < height; ++y)
+		{
+			for (S32 x = 0; x < width; ++x)
+			{
+				U8* pixel = data + (y * width + x) * 4;
+				pixel[0] = (U8)(x * 3);
+				pixel[1] = (U8)(y * 5);
+				pixel[2] = (U8)(x ^ y);
+				switch (kind)
+				{
+				case ALPHA_OPAQUE:
+					pixel[3] = 255;
+					break;
+				case ALPHA_BINARY:
+					pixel[3] = ((x / 4 + y / 4) & 1) ? 255 : 0;
+					break;
+				case ALPHA_BLENDED:
+					pixel[3] = (U8)(x * 255 / width);
+					break;
+				}
+			}
+		}
+		return raw;
+	}
+}
+
+namespace tut
+{
+	struct llimage_data
+	{
+	};
+	typedef test_group<llimage_data> llimage_test;
+	typedef llimage_test::object llimage_object;
+	tut::llimage_test llimage_testcase("LLImageRaw");
+
+	template<> template<>
+	void llimage_object::test<1>()
+	{
+		set_test_name("pick mask matches the scalar loop");
+
+		// Multiples of 16 take the SSE2 path, the rest the scalar one
+		const S32 widths[] = { 16, 32, 48, 80, 256, 1, 2, 3, 15, 17, 30, 33, 100 };
+		const S32 heights[] = { 1, 2, 3, 16, 17 };
+		for (U32 w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w)
+		{
+			for (U32 h = 0; h < sizeof(heights) / sizeof(heights[0]); ++h)
+			{
+				S32 width = widths[w];
+				S32 height = heights[h];
+				std::vector<U8> rgba(width * height * 4);
+				fill_edge_alphas(&rgba[0], width, height);
+
+				std::vector<U8> expected;
+				reference_pick_mask(&rgba[0], width, height, expected);
+				std::vector<U8> mask(LLImageRaw::pickMaskSize(width, height), 0);
+				LLImageRaw::buildPickMask(&rgba[0], width, height, &mask[0]);
+
+				std::string msg = llformat("pick mask %dx%d", width, height);
+				ensure_memory_matches(msg.c_str(), &mask[0], mask.size(), &expected[0], expected.size());
+			}
+		}
+	}
+
+	template<> template<>
+	void llimage_object::test<2>()
+	{
+		set_test_name("scanAlpha agrees with isAlphaMask");
+
+		const EAlphaKind kinds[] = { ALPHA_OPAQUE, ALPHA_BINARY, ALPHA_BLENDED };
+		const bool is_mask[] = { true, true, false };
+		// 64 wide takes the SSE2 pick mask, 30 wide the scalar one
+		const S32 widths[] = { 64, 30 };
+		for (U32 k = 0; k < 3; ++k)
+		{
+			for (U32 w = 0; w < 2; ++w)
+			{
+				LLPointer<LLImageRaw> raw = make_image(widths[w], 18, kinds[k]);
+				raw->scanAlpha();
+				const LLImageRaw::AlphaScan* scan = raw->getAlphaScan();
+				std::string msg = llformat("kind %d width %d", k, widths[w]);
+				ensure(msg + " scanned", scan != NULL);
+
+				bool expected = LLImageRaw::isAlphaMask(raw->getData() + 3, raw->getWidth(), raw->getHeight(), 4);
+				ensure_equals(msg + " matches isAlphaMask", scan->mIsMask, expected);
+				ensure_equals(msg + " mask decision", scan->mIsMask, is_mask[k]);
+
+				std::vector<U8> pick;
+				reference_pick_mask(raw->getData(), raw->getWidth(), raw->getHeight(), pick);
+				ensure_memory_matches((msg + " pick mask").c_str(), &scan->mPickMask[0], scan->mPickMask.size(), &pick[0], pick.size());
+			}
+		}
+
+		// Odd sizes leave a partial last byte on the opaque fast path
+		LLPointer<LLImageRaw> odd = make_image(17, 9, ALPHA_OPAQUE);
+		odd->scanAlpha();
+		ensure("odd opaque scanned", odd->getAlphaScan() != NULL);
+		ensure("odd opaque is a mask", odd->getAlphaScan()->mIsMask);
+		std::vector<U8> pick;
+		reference_pick_mask(odd->getData(), 17, 9, pick);
+		ensure_memory_matches("odd opaque pick mask", &odd->getAlphaScan()->mPickMask[0], odd->getAlphaScan()->mPickMask.size(), &pick[0], pick.size());
+
+		LLPointer<LLImageRaw> rgb = new LLImageRaw(16, 16, 3);
+		rgb->scanAlpha();
+		ensure("no scan without alpha", rgb->getAlphaScan() == NULL);
+	}
+
+	template<> template<>
+	void llimage_object::test<3>()
+	{
+		set_test_name("changing the pixels drops the scan");
+
+		LLPointer<LLImageRaw> raw = make_image(32, 32, ALPHA_BINARY);
+		LLPointer<LLImageRaw> src = make_image(32, 32, ALPHA_BLENDED);
+		LLPointer<LLImageRaw> alpha = new LLImageRaw(32, 32, 1);
+		memset(alpha->getData(), 0x80, 32 * 32);
+
+		raw->scanAlpha();
+		ensure("scanned", raw->getAlphaScan() != NULL);
+
+		raw->clear();
+		ensure("clear", raw->getAlphaScan() == NULL);
+
+		raw->scanAlpha();
+		raw->fill(LLColor4U(1, 2, 3, 4));
+		ensure("fill", raw->getAlphaScan() == NULL);
+
+		raw->scanAlpha();
+		raw->verticalFlip();
+		ensure("verticalFlip", raw->getAlphaScan() == NULL);
+
+		raw->scanAlpha();
+		raw->setSubImage(0, 0, 4, 4, src->getData(), 32 * 4, false);
+		ensure("setSubImage", raw->getAlphaScan() == NULL);
+
+		raw->scanAlpha();
+		raw->copy(src);
+		ensure("copy", raw->getAlphaScan() == NULL);
+
+		raw->scanAlpha();
+		raw->copyUnscaledAlphaMask(alpha, LLColor4U(255, 255, 255, 255));
+		ensure("copyUnscaledAlphaMask", raw->getAlphaScan() == NULL);
+
+		// Same size as the scan again afterwards, so only the clear catches it
+		raw->scanAlpha();
+		raw->scale(64, 64);
+		raw->scale(32, 32);
+		ensure("scale", raw->getAlphaScan() == NULL);
+
+		raw->scanAlpha();
+		raw->scale(64, 64, false);
+		raw->scale(32, 32, false);
+		ensure("scale without image data", raw->getAlphaScan() == NULL);
+
+		raw->scanAlpha();
+		raw->biasedScaleToPowerOfTwo(16);
+		raw->scale(32, 32);
+		ensure("biasedScaleToPowerOfTwo", raw->getAlphaScan() == NULL);
+
+		// Compositing only writes 3 component images, which never carry a
+		// scan, so check that reading the 4 component source leaves its
+		// scan alone.
+		LLPointer<LLImageRaw> rgb = new LLImageRaw(32, 32, 3);
+		src->scanAlpha();
+		rgb->compositeUnscaled4onto3(src);
+		rgb->compositeScaled4onto3(make_image(16, 16, ALPHA_BLENDED));
+		rgb->copy(src);
+		ensure("composite source keeps its scan", src->getAlphaScan() != NULL);
+		ensure("composite target has none", rgb->getAlphaScan() == NULL);
+
+		raw->scanAlpha();
+		raw->resize(32, 32, 3);
+		ensure("resize", raw->getAlphaScan() == NULL);
+	}
+}
@@ -289,6 +289,89 @@ S32 LLCamera::AABBInFrustumNoFarClip(const LLVector4a& center, const LLVector4a&
 	return result?1:2;
 }
 
+void LLCamera::AABBInFrustumBatch(const LLVector4a* centers, const LLVector4a* radii, S32 count, S32* results,
+								  bool far_clip, const LLPlane* planes)
+{
+	if(!planes)
+	{
+		//use agent space
+		planes = mAgentPlanes;
+	}
+
+	U32 max_planes = llmin(mPlaneCount, (U32) AGENT_PLANE_USER_CLIP_NUM);
+	const LLQuad zero = _mm_setzero_ps();
+
+	for (S32 base = 0; base < count; base += 4)
+	{
+		// Transpose four boxes into x, y and z lanes, repeating the last box
+		// to fill a partial batch.
+		LLQuad cx, cy, cz, cw, rx, ry, rz, rw;
+		{
+			const S32 last = count - 1;
+			cx = (LLQuad) centers[base];
+			cy = (LLQuad) centers[llmin(base + 1, last)];
+			cz = (LLQuad) centers[llmin(base + 2, last)];
+			cw = (LLQuad) centers[llmin(base + 3, last)];
+			_MM_TRANSPOSE4_PS(cx, cy, cz, cw);
+
+			rx = (LLQuad) radii[base];
+			ry = (LLQuad) radii[llmin(base + 1, last)];
+			rz = (LLQuad) radii[llmin(base + 2, last)];
+			rw = (LLQuad) radii[llmin(base + 3, last)];
+			_MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+		}
+
+		LLQuad outside = zero;
+		LLQuad partial = zero;
+		for (U32 i = 0; i < max_planes; i++)
+		{
+			U8 mask = mPlaneMask[i];
+			if (mask >= PLANE_MASK_NUM || (!far_clip && i == AGENT_PLANE_FAR))
+			{
+				continue;
+			}
+
+			const LLPlane& p(planes[i]);
+			const LLVector4a& scale = sFrustumScaler[mask];
+
+			// Offsets toward the box corner furthest along the plane normal,
+			// the same corner the single box tests pick.
+			LLQuad ox = _mm_mul_ps(rx, _mm_set1_ps(scale[0]));
+			LLQuad oy = _mm_mul_ps(ry, _mm_set1_ps(scale[1]));
+			LLQuad oz = _mm_mul_ps(rz, _mm_set1_ps(scale[2]));
+
+			LLQuad nx = _mm_set1_ps(p[0]);
+			LLQuad ny = _mm_set1_ps(p[1]);
+			LLQuad nz = _mm_set1_ps(p[2]);
+			LLQuad d = _mm_set1_ps(-p[3]);
+
+			LLQuad dist_min = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_sub_ps(cx, ox)),
+													_mm_mul_ps(ny, _mm_sub_ps(cy, oy))),
+										 _mm_mul_ps(nz, _mm_sub_ps(cz, oz)));
+			outside = _mm_or_ps(outside, _mm_cmpgt_ps(dist_min, d));
+
+			LLQuad dist_max = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_add_ps(cx, ox)),
+													_mm_mul_ps(ny, _mm_add_ps(cy, oy))),
+										 _mm_mul_ps(nz, _mm_add_ps(cz, oz)));
+			partial = _mm_or_ps(partial, _mm_cmpgt_ps(dist_max, d));
+
+			if (_mm_movemask_ps(outside) == 0xf)
+			{
+				break;
+			}
+		}
+
+		S32 outside_bits = _mm_movemask_ps(outside);
+		S32 partial_bits = _mm_movemask_ps(partial);
+		S32 end = llmin(base + 4, count);
+		for (S32 j = base; j < end; j++)
+		{
+			S32 bit = 1 << (j - base);
+			results[j] = (outside_bits & bit) ? 0 : ((partial_bits & bit) ? 1 : 2);
+		}
+	}
+}
+
 //exactly same as the function AABBInFrustumNoFarClip(...)
 //except uses mRegionPlanes instead of mAgentPlanes.
 S32 LLCamera::AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius) 
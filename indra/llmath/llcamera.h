@@ -208,6 +208,10 @@ public:
 	S32 AABBInRegionFrustum(const LLVector4a& center, const LLVector4a& radius);
 	S32 AABBInFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius, const LLPlane* planes = NULL);
 	S32 AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius);
+	// Same results as AABBInFrustum() (or AABBInFrustumNoFarClip() without
+	// far_clip) for count boxes, four at a time.
+	void AABBInFrustumBatch(const LLVector4a* centers, const LLVector4a* radii, S32 count, S32* results,
+							bool far_clip = true, const LLPlane* planes = NULL);
 
 	//does a quick 'n dirty sphere-sphere check
 	S32 sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius); 
@@ -0,0 +1,673 @@
+/**
+ * @file lllinearoctree.h
+ * @brief Octree with contiguous node and element storage.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLLINEAROCTREE_H
+#define LL_LLLINEAROCTREE_H
+
+#include <vector>
+
+#include "llalignedarray.h"
+#include "llcamera.h"
+#include "lloctree.h"
+#include "llvector4a.h"
+#include "llvolume.h"
+
+// Alternative to LLOctreeRoot for large, mostly static sets of elements.
+//
+// Nodes live in one pool and the children of a node are always allocated
+// as a block of eight consecutive entries, one per octant, so a node only
+// stores the index of its first child and a mask of the octants in use.
+// Node centers and loose half extents are kept in separate aligned arrays,
+// which lets a traversal test all children of a node against the frustum
+// with one LLCamera::AABBInFrustumBatch() call. Elements are plain T*
+// entries in a slot array linked per node. The tree holds no references,
+// callers keep the handle insert() returns the way LLOctreeNode users keep
+// the bin index.
+//
+// T needs getPositionGroup() and getBinRadius(), like LLOctreeNode<T>.
+// A leaf takes up to gOctreeMaxCapacity elements (at most 16) before it
+// splits, and elements only move down into cells whose half size still
+// covers their bin radius and is at least gOctreeMinSize.
+template <class T>
+class LLLinearOctree
+{
+public:
+	static const U32 INVALID = 0xFFFFFFFF;
+
+	LLLinearOctree(const LLVector4a& center, const LLVector4a& size)
+	:	mFirstFreeElement(INVALID),
+		mElementCount(0),
+		mNodeCount(1)
+	{
+		// Extremely small minimum sizes would only make the tree deeper.
+		mMinSize = llmax(gOctreeMinSize, 0.001f);
+		// Unlike LLOctreeNode, leaves mix element sizes and their elements
+		// are spread over the element array, so keep them small.
+		mLeafCapacity = llclamp(gOctreeMaxCapacity, 1U, MAX_LEAF_CAPACITY);
+
+		mNodes.push_back(Node(INVALID, 255));
+		LLVector4a half_size;
+		half_size.splat(llmax(size[0], mMinSize));
+		mCenters.push_back(center);
+		mSizes.push_back(half_size);
+		mExtents.push_back(LLVector4a::getZero());
+	}
+
+	U32 getElementCount() const		{ return mElementCount; }
+	U32 getNodeCount() const		{ return mNodeCount; }
+	const LLVector4a& getCenter() const	{ return mCenters[0]; }
+	const LLVector4a& getSize() const	{ return mSizes[0]; }
+
+	T* getElement(U32 handle) const
+	{
+		return handle < mElements.size() ? mElements[handle].mData : NULL;
+	}
+
+	// Returns the handle to pass to remove(), or INVALID if data is out of
+	// range of the tree (same limits as LLOctreeRoot).
+	U32 insert(T* data)
+	{
+		if (!data)
+		{
+			OCT_ERRS << "!!! INVALID ELEMENT ADDED TO LINEAR OCTREE !!!" << LL_ENDL;
+			return INVALID;
+		}
+
+		const LLVector4a& pos = data->getPositionGroup();
+		F32 radius = data->getBinRadius();
+		if (radius > 4096.f)
+		{
+			OCT_ERRS << "!!! ELEMENT EXCEEDS MAXIMUM SIZE IN LINEAR OCTREE !!!" << LL_ENDL;
+			return INVALID;
+		}
+
+		LLVector4a max_mag;
+		max_mag.splat(1024.f*1024.f);
+		LLVector4a val;
+		val.setSub(pos, mCenters[0]);
+		val.setAbs(val);
+		if ((val.lessThan(max_mag).getGatheredBits() & 0x7) != 0x7)
+		{
+			return INVALID;
+		}
+
+		growRoot(pos, radius);
+
+		// Descend through branches while the element fits a child cell and
+		// stop at the first leaf.
+		U32 node = 0;
+		while (true)
+		{
+			growExtent(node, pos, radius);
+
+			if (mNodes[node].mFirstChild == INVALID || !fitsChild(node, radius))
+			{
+				break;
+			}
+			node = getOrCreateChild(node, getOctant(pos, mCenters[node]));
+		}
+
+		U32 handle = allocElement();
+		Element& element = mElements[handle];
+		element.mData = data;
+		LLVector4a& bounds = mElementBounds[handle];
+		bounds = pos;
+		bounds.getF32ptr()[3] = radius;
+		linkElement(handle, node);
+		++mElementCount;
+
+		if (mNodes[node].mFirstChild == INVALID && mNodes[node].mElementCount > mLeafCapacity)
+		{
+			split(node);
+		}
+		return handle;
+	}
+
+	bool remove(U32 handle)
+	{
+		if (handle >= mElements.size() || !mElements[handle].mData)
+		{
+			OCT_ERRS << "Linear octree removal of unknown element " << handle << LL_ENDL;
+			return false;
+		}
+
+		U32 node = mElements[handle].mNode;
+		unlinkElement(handle);
+		freeElement(handle);
+		--mElementCount;
+
+		// Prune the branch up to the first node that still holds something.
+		// Extents are left as they are until the next balance().
+		while (node != 0 && isEmpty(node))
+		{
+			U32 parent = mNodes[node].mParent;
+			Node& parent_node = mNodes[parent];
+			parent_node.mChildMask &= ~(1 << mNodes[node].mOctant);
+			--mNodeCount;
+			if (!parent_node.mChildMask)
+			{
+				freeBlock(parent_node.mFirstChild);
+				parent_node.mFirstChild = INVALID;
+			}
+			node = parent;
+		}
+		return true;
+	}
+
+	// Shrinks the root while it has a single child and no elements of its
+	// own, like LLOctreeRoot::balance(), and recomputes the loose extents
+	// that removals leave oversized.
+	void balance()
+	{
+		while (mNodes[0].mElementCount == 0 && isSingleBit(mNodes[0].mChildMask))
+		{
+			U32 block = mNodes[0].mFirstChild;
+			U32 child = block + lowestBit(mNodes[0].mChildMask);
+			mCenters[0] = mCenters[child];
+			mSizes[0] = mSizes[child];
+			moveNode(child, 0);
+			freeBlock(block);
+			--mNodeCount;
+		}
+		updateExtents(0);
+	}
+
+	// Calls func(T*) for every element in a node whose loose bounds are at
+	// least partially inside camera's agent space frustum.
+	template <class FUNC>
+	void cullFrustum(LLCamera& camera, FUNC func, bool far_clip = true) const
+	{
+		if (isEmpty(0))
+		{
+			return;
+		}
+
+		S32 res = far_clip ? camera.AABBInFrustum(mCenters[0], mExtents[0])
+						   : camera.AABBInFrustumNoFarClip(mCenters[0], mExtents[0]);
+		if (!res)
+		{
+			return;
+		}
+
+		U32 stack[STACK_SIZE];
+		S32 depth = 0;
+		stack[depth++] = res == 2 ? FULLY_INSIDE : 0;
+
+		while (depth > 0)
+		{
+			U32 entry = stack[--depth];
+			U32 node = entry & ~FULLY_INSIDE;
+			const Node& n = mNodes[node];
+
+			for (U32 e = n.mFirstElement; e != INVALID; e = mElements[e].mNext)
+			{
+				func(mElements[e].mData);
+			}
+
+			if (!n.mChildMask)
+			{
+				continue;
+			}
+
+			if (entry & FULLY_INSIDE)
+			{
+				for (U32 i = 0; i < 8; ++i)
+				{
+					if (n.mChildMask & (1 << i))
+					{
+						llassert(depth < STACK_SIZE);
+						stack[depth++] = (n.mFirstChild + i) | FULLY_INSIDE;
+					}
+				}
+				continue;
+			}
+
+			S32 results[8];
+			camera.AABBInFrustumBatch(mCenters.mArray + n.mFirstChild, mExtents.mArray + n.mFirstChild, 8,
+									  results, far_clip);
+			for (U32 i = 0; i < 8; ++i)
+			{
+				if ((n.mChildMask & (1 << i)) && results[i])
+				{
+					llassert(depth < STACK_SIZE);
+					stack[depth++] = (n.mFirstChild + i) | (results[i] == 2 ? FULLY_INSIDE : 0);
+				}
+			}
+		}
+	}
+
+	// Calls func(T*) for every element whose bin box, position group plus
+	// or minus bin radius, the segment from start to end passes through.
+	// func does the exact test.
+	template <class FUNC>
+	void intersectRay(const LLVector4a& start, const LLVector4a& end, FUNC func) const
+	{
+		if (isEmpty(0) || !LLLineSegmentBoxIntersect(start, end, mCenters[0], mExtents[0]))
+		{
+			return;
+		}
+
+		U32 stack[STACK_SIZE];
+		S32 depth = 0;
+		stack[depth++] = 0;
+
+		while (depth > 0)
+		{
+			const Node& n = mNodes[stack[--depth]];
+
+			for (U32 e = n.mFirstElement; e != INVALID; e = mElements[e].mNext)
+			{
+				LLVector4a radius;
+				radius.splat<3>(mElementBounds[e]);
+				if (LLLineSegmentBoxIntersect(start, end, mElementBounds[e], radius))
+				{
+					func(mElements[e].mData);
+				}
+			}
+
+			for (U32 i = 0; i < 8; ++i)
+			{
+				U32 child = n.mFirstChild + i;
+				if ((n.mChildMask & (1 << i)) &&
+					LLLineSegmentBoxIntersect(start, end, mCenters[child], mExtents[child]))
+				{
+					llassert(depth < STACK_SIZE);
+					stack[depth++] = child;
+				}
+			}
+		}
+	}
+
+private:
+	struct Node
+	{
+		Node(U32 parent, U8 octant)
+		:	mParent(parent),
+			mFirstChild(INVALID),
+			mFirstElement(INVALID),
+			mElementCount(0),
+			mChildMask(0),
+			mOctant(octant)
+		{
+		}
+
+		U32	mParent;
+		U32	mFirstChild;	// first of eight consecutive nodes, INVALID if none
+		U32	mFirstElement;	// head of this node's element list
+		U32	mElementCount;
+		U8	mChildMask;		// octants that hold a live child
+		U8	mOctant;
+	};
+
+	struct Element
+	{
+		Element() : mData(NULL), mNode(INVALID), mNext(INVALID), mPrev(INVALID) {}
+
+		T*	mData;
+		U32	mNode;			// owning node, next free slot when unused
+		U32	mNext;
+		U32	mPrev;
+	};
+
+	// Depth first stacks hold at most seven pending siblings per level.
+	static const S32 STACK_SIZE = 512;
+	static const U32 FULLY_INSIDE = 0x80000000;
+	static const U32 MAX_LEAF_CAPACITY = 16;
+
+	static U8 getOctant(const LLVector4a& pos, const LLVector4a& center)
+	{
+		return (U8) (pos.greaterThan(center).getGatheredBits() & 0x7);
+	}
+
+	static bool isSingleBit(U8 mask)
+	{
+		return mask && !(mask & (mask - 1));
+	}
+
+	static U32 lowestBit(U8 mask)
+	{
+		U32 i = 0;
+		while (!(mask & (1 << i)))
+		{
+			++i;
+		}
+		return i;
+	}
+
+	bool isEmpty(U32 node) const
+	{
+		return mNodes[node].mElementCount == 0 && mNodes[node].mChildMask == 0;
+	}
+
+	// Same bounds convention as LLOctreeNode::isInside().
+	bool isInside(U32 node, const LLVector4a& pos) const
+	{
+		LLVector4a max, min;
+		max.setAdd(mCenters[node], mSizes[node]);
+		min.setSub(mCenters[node], mSizes[node]);
+		return !(pos.greaterThan(max).getGatheredBits() & 0x7) &&
+			   !(pos.lessEqual(min).getGatheredBits() & 0x7);
+	}
+
+	// Whether an element of this radius stays covered by a child cell.
+	bool fitsChild(U32 node, F32 radius) const
+	{
+		F32 child_size = mSizes[node][0] * 0.5f;
+		return child_size >= mMinSize && radius <= child_size;
+	}
+
+	// Pushes the elements of an over full leaf that fit a child cell down
+	// one level, splitting children that end up over full in turn.
+	void split(U32 node)
+	{
+		U32 e = mNodes[node].mFirstElement;
+		while (e != INVALID)
+		{
+			U32 next = mElements[e].mNext;
+			F32 radius = mElementBounds[e][3];
+			if (fitsChild(node, radius))
+			{
+				U32 child = getOrCreateChild(node, getOctant(mElementBounds[e], mCenters[node]));
+				unlinkElement(e);
+				linkElement(e, child);
+				growExtent(child, mElementBounds[e], radius);
+			}
+			e = next;
+		}
+
+		U32 block = mNodes[node].mFirstChild;
+		for (U32 i = 0; i < 8; ++i)
+		{
+			if ((mNodes[node].mChildMask & (1 << i)) && mNodes[block + i].mElementCount > mLeafCapacity)
+			{
+				split(block + i);
+			}
+		}
+	}
+
+	void growExtent(U32 node, const LLVector4a& pos, F32 radius)
+	{
+		LLVector4a reach;
+		reach.setSub(pos, mCenters[node]);
+		reach.setAbs(reach);
+		LLVector4a rad;
+		rad.splat(radius);
+		reach.add(rad);
+		mExtents[node].setMax(mExtents[node], reach);
+	}
+
+	void growRoot(const LLVector4a& pos, F32 radius)
+	{
+		while (!(mSizes[0][0] > radius && isInside(0, pos)))
+		{
+			LLVector4a old_center = mCenters[0];
+			LLVector4a size = mSizes[0];
+
+			// Move the center toward the data by one half size, the old
+			// cell becomes one octant of the doubled one.
+			LLVector4Logical gt = pos.greaterThan(old_center);
+			LLVector4a up, down;
+			up = _mm_and_ps(size, gt);
+			down = _mm_andnot_ps(gt, size);
+			LLVector4a new_center = old_center;
+			new_center.add(up);
+			new_center.sub(down);
+
+			LLVector4a new_size;
+			new_size.setAdd(size, size);
+
+			if (isEmpty(0))
+			{
+				mCenters[0] = new_center;
+				mSizes[0] = new_size;
+				continue;
+			}
+
+			// Push the current root contents down into a new child.
+			U32 block = allocBlock(0, new_center, size);
+			U32 octant = getOctant(old_center, new_center);
+			U32 child = block + octant;
+			moveNode(0, child);
+
+			mCenters[0] = new_center;
+			mSizes[0] = new_size;
+			mNodes[0].mFirstChild = block;
+			mNodes[0].mChildMask = 1 << octant;
+			++mNodeCount;
+
+			// Loose extent of the root relative to its new center.
+			LLVector4a offset;
+			offset.setSub(old_center, new_center);
+			offset.setAbs(offset);
+			LLVector4a reach;
+			reach.setAdd(offset, mExtents[child]);
+			mExtents[0] = reach;
+		}
+	}
+
+	U32 getOrCreateChild(U32 node, U8 octant)
+	{
+		if (mNodes[node].mFirstChild == INVALID)
+		{
+			LLVector4a half_size;
+			half_size.setMul(mSizes[node], 0.5f);
+			U32 block = allocBlock(node, mCenters[node], half_size);
+			mNodes[node].mFirstChild = block;
+		}
+		U32 child = mNodes[node].mFirstChild + octant;
+		if (!(mNodes[node].mChildMask & (1 << octant)))
+		{
+			// Unused slots of a block may be stale, pruned or left behind
+			// when moveNode() handed the block to another parent.
+			mNodes[child] = Node(node, octant);
+			mExtents[child] = LLVector4a::getZero();
+			mNodes[node].mChildMask |= 1 << octant;
+			++mNodeCount;
+		}
+		return child;
+	}
+
+	// Allocates eight children of a cell centered at parent_center, each
+	// with half size child_size.
+	U32 allocBlock(U32 parent, const LLVector4a& parent_center, const LLVector4a& child_size)
+	{
+		// The arguments may point into the arrays about to grow.
+		LLVector4a center = parent_center;
+		LLVector4a size = child_size;
+
+		U32 block;
+		if (!mFreeBlocks.empty())
+		{
+			block = mFreeBlocks.back();
+			mFreeBlocks.pop_back();
+		}
+		else
+		{
+			block = mNodes.size();
+			mNodes.resize(block + 8, Node(INVALID, 255));
+			mCenters.resize(block + 8);
+			mSizes.resize(block + 8);
+			mExtents.resize(block + 8);
+		}
+
+		for (U32 i = 0; i < 8; ++i)
+		{
+			mNodes[block + i] = Node(parent, i);
+
+			LLVector4a offset(i & 1 ? size[0] : -size[0],
+							  i & 2 ? size[1] : -size[1],
+							  i & 4 ? size[2] : -size[2]);
+			mCenters[block + i].setAdd(center, offset);
+			mSizes[block + i] = size;
+			mExtents[block + i] = LLVector4a::getZero();
+		}
+		return block;
+	}
+
+	void freeBlock(U32 block)
+	{
+		mFreeBlocks.push_back(block);
+	}
+
+	// Moves the elements, children and extent of src to dst, which keeps its
+	// own parent, octant, center and size.
+	void moveNode(U32 src, U32 dst)
+	{
+		Node& from = mNodes[src];
+		Node& to = mNodes[dst];
+		to.mFirstChild = from.mFirstChild;
+		to.mChildMask = from.mChildMask;
+		to.mFirstElement = from.mFirstElement;
+		to.mElementCount = from.mElementCount;
+		mExtents[dst] = mExtents[src];
+
+		for (U32 e = to.mFirstElement; e != INVALID; e = mElements[e].mNext)
+		{
+			mElements[e].mNode = dst;
+		}
+		for (U32 i = 0; i < 8; ++i)
+		{
+			if (to.mChildMask & (1 << i))
+			{
+				mNodes[to.mFirstChild + i].mParent = dst;
+			}
+		}
+
+		from.mFirstChild = INVALID;
+		from.mChildMask = 0;
+		from.mFirstElement = INVALID;
+		from.mElementCount = 0;
+	}
+
+	// Recomputes loose extents bottom up, returns the extent of node.
+	const LLVector4a& updateExtents(U32 node)
+	{
+		LLVector4a extent = LLVector4a::getZero();
+		const Node& n = mNodes[node];
+
+		for (U32 e = n.mFirstElement; e != INVALID; e = mElements[e].mNext)
+		{
+			LLVector4a reach;
+			reach.setSub(mElementBounds[e], mCenters[node]);
+			reach.setAbs(reach);
+			LLVector4a rad;
+			rad.splat<3>(mElementBounds[e]);
+			reach.add(rad);
+			extent.setMax(extent, reach);
+		}
+
+		for (U32 i = 0; i < 8; ++i)
+		{
+			if (n.mChildMask & (1 << i))
+			{
+				U32 child = n.mFirstChild + i;
+				LLVector4a reach;
+				reach.setSub(mCenters[child], mCenters[node]);
+				reach.setAbs(reach);
+				reach.add(updateExtents(child));
+				extent.setMax(extent, reach);
+			}
+		}
+
+		mExtents[node] = extent;
+		return mExtents[node];
+	}
+
+	U32 allocElement()
+	{
+		U32 handle = mFirstFreeElement;
+		if (handle != INVALID)
+		{
+			mFirstFreeElement = mElements[handle].mNode;
+			mElements[handle] = Element();
+		}
+		else
+		{
+			handle = mElements.size();
+			mElements.push_back(Element());
+			mElementBounds.resize(handle + 1);
+		}
+		return handle;
+	}
+
+	void freeElement(U32 handle)
+	{
+		mElements[handle] = Element();
+		mElements[handle].mNode = mFirstFreeElement;
+		mFirstFreeElement = handle;
+	}
+
+	void linkElement(U32 handle, U32 node)
+	{
+		Element& element = mElements[handle];
+		Node& n = mNodes[node];
+		element.mNode = node;
+		element.mPrev = INVALID;
+		element.mNext = n.mFirstElement;
+		if (n.mFirstElement != INVALID)
+		{
+			mElements[n.mFirstElement].mPrev = handle;
+		}
+		n.mFirstElement = handle;
+		++n.mElementCount;
+	}
+
+	void unlinkElement(U32 handle)
+	{
+		Element& element = mElements[handle];
+		Node& n = mNodes[element.mNode];
+		if (element.mPrev != INVALID)
+		{
+			mElements[element.mPrev].mNext = element.mNext;
+		}
+		else
+		{
+			n.mFirstElement = element.mNext;
+		}
+		if (element.mNext != INVALID)
+		{
+			mElements[element.mNext].mPrev = element.mPrev;
+		}
+		--n.mElementCount;
+	}
+
+	std::vector<Node>				mNodes;
+	LLAlignedArray<LLVector4a, 64>	mCenters;
+	LLAlignedArray<LLVector4a, 64>	mSizes;		// cell half size
+	LLAlignedArray<LLVector4a, 64>	mExtents;	// loose half size around mCenters covering the subtree
+	std::vector<U32>				mFreeBlocks;
+
+	std::vector<Element>			mElements;
+	LLAlignedArray<LLVector4a, 64>	mElementBounds;	// position group, bin radius in w
+	U32								mFirstFreeElement;
+
+	U32	mElementCount;
+	U32	mNodeCount;
+	U32	mLeafCapacity;
+	F32	mMinSize;
+};
+
+#endif // LL_LLLINEAROCTREE_H
@@ -0,0 +1,126 @@
+/** 
+ * @file llskinningjob.cpp
+ * @brief Software skinning of rigged volume faces.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmath.h"
+#include "llskinningjob.h"
+
+#include "llmatrix4a.h"
+#include "llvector4a.h"
+
+// Weighted sum of the four palette entries a vertex is rigged to.
+static inline void blend_joints(const LLMatrix4a* palette, const S32* joints, const LLVector4a& weights, LLMatrix4a& res)
+{
+	const LLMatrix4a& m0 = palette[joints[0]];
+	const LLMatrix4a& m1 = palette[joints[1]];
+	const LLMatrix4a& m2 = palette[joints[2]];
+	const LLMatrix4a& m3 = palette[joints[3]];
+
+	LLVector4a w0 = _mm_shuffle_ps(weights, weights, _MM_SHUFFLE(0, 0, 0, 0));
+	LLVector4a w1 = _mm_shuffle_ps(weights, weights, _MM_SHUFFLE(1, 1, 1, 1));
+	LLVector4a w2 = _mm_shuffle_ps(weights, weights, _MM_SHUFFLE(2, 2, 2, 2));
+	LLVector4a w3 = _mm_shuffle_ps(weights, weights, _MM_SHUFFLE(3, 3, 3, 3));
+
+	for (U32 row = 0; row < 4; ++row)
+	{
+		LLVector4a a;
+		LLVector4a b;
+		a.setMul(m0.mMatrix[row], w0);
+		b.setMul(m1.mMatrix[row], w1);
+		a.add(b);
+		b.setMul(m2.mMatrix[row], w2);
+		a.add(b);
+		b.setMul(m3.mMatrix[row], w3);
+		res.mMatrix[row].setAdd(a, b);
+	}
+}
+
+LLSkinningJob::LLSkinningJob()
+:	mPalette(NULL),
+	mJointCount(0),
+	mWeights(NULL),
+	mPositions(NULL),
+	mNormals(NULL),
+	mOutPositions(NULL),
+	mOutNormals(NULL),
+	mVertexCount(0)
+{
+}
+
+//static
+void LLSkinningJob::buildPalette(const LLMatrix4a& bind_shape, const LLMatrix4a* joints, U32 count, LLMatrix4a* palette)
+{
+	for (U32 i = 0; i < count; ++i)
+	{
+		matMul(bind_shape, joints[i], palette[i]);
+	}
+}
+
+void LLSkinningJob::run(U32 begin, U32 end) const
+{
+	llassert(mPalette && mJointCount > 0);
+	llassert(mWeights && mPositions && mOutPositions);
+	llassert(end <= mVertexCount);
+
+	const bool do_normals = mNormals && mOutNormals;
+
+	LLVector4a one;
+	one.splat(1.f);
+	LLVector4a max_joint;
+	max_joint.splat((F32)(mJointCount - 1));
+
+	LL_ALIGN_16(S32 joints[4]);
+	LLMatrix4a mat;
+	for (U32 i = begin; i < end; ++i)
+	{
+		// Weights are never negative once scrubbed, so truncating gives the
+		// joint index and what is left over the raw weight.
+		const LLVector4a& packed = mWeights[i];
+		LLVector4a joint = _mm_cvtepi32_ps(_mm_cvttps_epi32(packed));
+		LLVector4a weight;
+		weight.setSub(packed, joint);
+
+		LLVector4a sum;
+		sum.setAllDot4(weight, one);
+		weight.div(sum);
+
+		joint.setMax(joint, LLVector4a::getZero());
+		joint.setMin(joint, max_joint);
+		_mm_store_si128((__m128i*)joints, _mm_cvttps_epi32(joint));
+
+		blend_joints(mPalette, joints, weight, mat);
+		mat.affineTransform(mPositions[i], mOutPositions[i]);
+
+		if (do_normals)
+		{
+			LLVector4a normal;
+			mat.rotate(mNormals[i], normal);
+			normal.normalize3fast();
+			mOutNormals[i] = normal;
+		}
+	}
+}
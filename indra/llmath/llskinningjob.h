@@ -0,0 +1,61 @@
+/** 
+ * @file llskinningjob.h
+ * @brief Software skinning of rigged volume faces.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSKINNINGJOB_H
+#define LL_LLSKINNINGJOB_H
+
+class LLMatrix4a;
+class LLVector4a;
+
+// Skins the positions and normals of one rigged face. The palette has the
+// bind shape matrix folded into every joint matrix (see buildPalette()), so
+// each vertex costs one weighted blend of four matrices and one transform.
+//
+// Vertices are independent and only plain memory is touched, so disjoint
+// ranges of a large face may run on different threads as long as every
+// array outlives the job.
+class LLSkinningJob
+{
+public:
+	LLSkinningJob();
+
+	// palette[i] = bind_shape followed by joints[i], for count joints.
+	static void buildPalette(const LLMatrix4a& bind_shape, const LLMatrix4a* joints, U32 count, LLMatrix4a* palette);
+
+	void run() const { run(0, mVertexCount); }
+	void run(U32 begin, U32 end) const;
+
+	const LLMatrix4a*	mPalette;
+	U32					mJointCount;	// matrices in mPalette, joint indices are clamped to it
+	const LLVector4a*	mWeights;		// joint index in the integer part, weight in the fraction
+	const LLVector4a*	mPositions;
+	const LLVector4a*	mNormals;		// NULL to skip normals
+	LLVector4a*			mOutPositions;
+	LLVector4a*			mOutNormals;	// NULL to skip normals
+	U32					mVertexCount;
+};
+
+#endif // LL_LLSKINNINGJOB_H
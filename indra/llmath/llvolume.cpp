@@ -682,7 +682,8 @@ LLProfile::Face* LLProfile::addHole(const LLProfileParams& params, BOOL flat, F3
 
 	Face *face = addFace(mTotalOut, mTotal-mTotalOut,0,LL_FACE_INNER_SIDE, flat);
 
-	static LLAlignedArray<LLVector4a,64> pt;
+	// per thread, volumes may be generated on LLVolumeMgr's worker pool
+	static thread_local LLAlignedArray<LLVector4a,64> pt;
 	pt.resize(mTotal) ;
 
 	for (S32 i=mTotalOut;i<mTotal;i++)
@@ -2037,7 +2038,7 @@ LLProfile::~LLProfile()
 }
 
 
-S32 LLVolume::sNumMeshPoints = 0;
+LLAtomicS32 LLVolume::sNumMeshPoints(0);
 
 LLVolume::LLVolume(const LLVolumeParams &params, const F32 detail, const BOOL generate_single_face, const BOOL is_unique)
 	: mParams(params)
@@ -2368,7 +2369,7 @@ bool LLVolumeFace::VertexData::compareNormal(const LLVolumeFace::VertexData& rhs
 	return retval;
 }
 
-bool LLVolume::unpackVolumeFaces(std::istream& is, S32 size)
+bool LLVolume::unpackVolumeFaces(std::istream& is, S32 size, index_order_list_t* index_orders)
 {
 	//input stream is now pointing at a zlib compressed block of LLSD
 	//decompress block
@@ -2693,7 +2694,7 @@ bool LLVolume::unpackVolumeFaces(std::istream& is, S32 size)
 		}
 	}
 
-	if (!cacheOptimize())
+	if (!cacheOptimize(index_orders))
 	{
 		// Out of memory?
 		LL_WARNS() << "Failed to optimize!" << LL_ENDL;
@@ -2734,11 +2735,16 @@ void LLVolume::copyVolumeFaces(const LLVolume* volume)
 	mSculptLevel = 0;
 }
 
-bool LLVolume::cacheOptimize()
+bool LLVolume::cacheOptimize(index_order_list_t* orders)
 {
+	if (orders)
+	{
+		orders->resize(mVolumeFaces.size());
+	}
+
 	for (S32 i = 0; i < mVolumeFaces.size(); ++i)
 	{
-		if (!mVolumeFaces[i].cacheOptimize())
+		if (!mVolumeFaces[i].cacheOptimize(orders ? &(*orders)[i] : NULL))
 		{
 			return false;
 		}
@@ -5007,402 +5013,235 @@ void LLVolumeFace::optimize(F32 angle_cutoff)
 
 }
 
-class LLVCacheTriangleData;
+// Triangle reordering for the post transform vertex cache, after Sander,
+// Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and
+// Reduced Overdraw" (Tipsify). Triangles are emitted in fans around one
+// vertex at a time, and the next fan is picked among the vertices just
+// emitted that will still be in a FIFO cache of VertexCacheSize entries.
+// Every vertex and triangle is visited a bounded number of times, so the
+// cost is linear in the size of the face.
+const S32 VertexCacheSize = 32;
 
-class LLVCacheVertexData
+static bool tipsify_indices(const U16* indices, U32 num_indices, U32 num_vertices, U16* out)
 {
-public:
-	S32 mIdx;
-	S32 mCacheTag;
-	F64 mScore;
-	U32 mActiveTriangles;
-	std::vector<LLVCacheTriangleData*> mTriangles;
-
-	LLVCacheVertexData()
-	{
-		mCacheTag = -1;
-		mScore = 0.0;
-		mActiveTriangles = 0;
-		mIdx = -1;
-	}
-};
+	U32 num_triangles = num_indices / 3;
 
-class LLVCacheTriangleData
-{
-public:
-	bool mActive;
-	F64 mScore;
-	LLVCacheVertexData* mVertex[3];
+	std::vector<U32> live;				// triangles not yet emitted, per vertex
+	std::vector<U32> first_triangle;	// per vertex range in vertex_triangles
+	std::vector<U32> vertex_triangles;	// triangles using each vertex
+	std::vector<S32> cache_time;		// when each vertex last entered the cache
+	std::vector<U8> emitted;
+	std::vector<U16> dead_end;			// recently emitted vertices, to restart from
+	std::vector<U16> candidates;		// vertices of the current fan
 
-	LLVCacheTriangleData()
+	try
 	{
-		mActive = true;
-		mScore = 0.0;
-		mVertex[0] = mVertex[1] = mVertex[2] = NULL;
+		live.resize(num_vertices, 0);
+		first_triangle.resize(num_vertices + 1, 0);
+		vertex_triangles.resize(num_triangles * 3);
+		cache_time.resize(num_vertices, 0);
+		emitted.resize(num_triangles, 0);
+		dead_end.reserve(num_triangles * 3);
+		candidates.reserve(64);
 	}
-
-	void complete()
+	catch (std::bad_alloc&)
 	{
-		mActive = false;
-		for (S32 i = 0; i < 3; ++i)
-		{
-			if (mVertex[i])
-			{
-				llassert(mVertex[i]->mActiveTriangles > 0);
-				mVertex[i]->mActiveTriangles--;
-			}
-		}
+		LL_WARNS("LLVOLUME") << "Resize failed" << LL_ENDL;
+		return false;
 	}
 
-	bool operator<(const LLVCacheTriangleData& rhs) const
-	{ //highest score first
-		return rhs.mScore < mScore;
+	for (U32 i = 0; i < num_triangles * 3; ++i)
+	{
+		live[indices[i]]++;
 	}
-};
-
-const F64 FindVertexScore_CacheDecayPower = 1.5;
-const F64 FindVertexScore_LastTriScore = 0.75;
-const F64 FindVertexScore_ValenceBoostScale = 2.0;
-const F64 FindVertexScore_ValenceBoostPower = 0.5;
-const U32 MaxSizeVertexCache = 32;
-const F64 FindVertexScore_Scaler = 1.0/(MaxSizeVertexCache-3);
-
-F64 find_vertex_score(LLVCacheVertexData& data)
-{
-	F64 score = -1.0;
-
-	score = 0.0;
 
-	S32 cache_idx = data.mCacheTag;
-
-	if (cache_idx < 0)
+	// first_triangle[v] starts out at the end of the range of v and is
+	// walked back to its start while filling it in.
+	U32 offset = 0;
+	for (U32 v = 0; v < num_vertices; ++v)
 	{
-		//not in cache
+		offset += live[v];
+		first_triangle[v] = offset;
 	}
-	else
+	first_triangle[num_vertices] = offset;
+
+	for (U32 i = 0; i < num_triangles * 3; ++i)
 	{
-		if (cache_idx < 3)
-		{ //vertex was in the last triangle
-			score = FindVertexScore_LastTriScore;
-		}
-		else
-		{ //more points for being higher in the cache
-				score = 1.0-((cache_idx-3)*FindVertexScore_Scaler);
-				score = pow(score, FindVertexScore_CacheDecayPower);
-		}
+		vertex_triangles[--first_triangle[indices[i]]] = i / 3;
 	}
 
-	//bonus points for having low valence
-	F64 valence_boost = pow((F64)data.mActiveTriangles, -FindVertexScore_ValenceBoostPower);
-	score += FindVertexScore_ValenceBoostScale * valence_boost;
-
-	return score;
-}
-
-class LLVCacheFIFO
-{
-public:
-	LLVCacheVertexData* mCache[MaxSizeVertexCache];
-	U32 mMisses;
+	S32 time = VertexCacheSize + 1;
+	U32 cursor = 0;
+	U32 out_count = 0;
+	S32 fan = indices[0];
 
-	LLVCacheFIFO()
+	while (fan >= 0)
 	{
-		mMisses = 0;
-		for (U32 i = 0; i < MaxSizeVertexCache; ++i)
-		{
-			mCache[i] = NULL;
-		}
-	}
+		candidates.clear();
 
-	void addVertex(LLVCacheVertexData* data)
-	{
-		if (data->mCacheTag == -1)
+		for (U32 i = first_triangle[fan], end = first_triangle[fan + 1]; i < end; ++i)
 		{
-			mMisses++;
-
-			S32 end = MaxSizeVertexCache-1;
-
-			if (mCache[end])
+			U32 tri = vertex_triangles[i];
+			if (emitted[tri])
 			{
-				mCache[end]->mCacheTag = -1;
+				continue;
 			}
+			emitted[tri] = 1;
 
-			for (S32 i = end; i > 0; --i)
+			for (U32 k = 0; k < 3; ++k)
 			{
-				mCache[i] = mCache[i-1];
-				if (mCache[i])
-				{
-					mCache[i]->mCacheTag = i;
+				U16 v = indices[tri * 3 + k];
+				out[out_count++] = v;
+				dead_end.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+
+				if (time - cache_time[v] > VertexCacheSize)
+				{ //cache miss, vertex goes to the front of the FIFO
+					cache_time[v] = time++;
 				}
 			}
-
-			mCache[0] = data;
-			data->mCacheTag = 0;
 		}
-	}
-};
-
-class LLVCacheLRU
-{
-public:
-	LLVCacheVertexData* mCache[MaxSizeVertexCache+3];
 
-	LLVCacheTriangleData* mBestTriangle;
-	
-	U32 mMisses;
-
-	LLVCacheLRU()
-	{
-		for (U32 i = 0; i < MaxSizeVertexCache+3; ++i)
+		// Prefer the vertex that entered the cache earliest but will stay
+		// in it while its remaining triangles are emitted.
+		fan = -1;
+		S32 best_priority = -1;
+		for (std::vector<U16>::const_iterator iter = candidates.begin(); iter != candidates.end(); ++iter)
 		{
-			mCache[i] = NULL;
-		}
-
-		mBestTriangle = NULL;
-		mMisses = 0;
-	}
+			U16 v = *iter;
+			if (live[v] > 0)
+			{
+				S32 priority = 0;
+				if (time - cache_time[v] + 2 * (S32)live[v] <= VertexCacheSize)
+				{
+					priority = time - cache_time[v];
+				}
 
-	void addVertex(LLVCacheVertexData* data)
-	{
-		S32 end = MaxSizeVertexCache+2;
-		if (data->mCacheTag != -1)
-		{ //just moving a vertex to the front of the cache
-			end = data->mCacheTag;
-		}
-		else
-		{
-			mMisses++;
-			if (mCache[end])
-			{ //adding a new vertex, vertex at end of cache falls off
-				mCache[end]->mCacheTag = -1;
+				if (priority > best_priority)
+				{
+					best_priority = priority;
+					fan = v;
+				}
 			}
 		}
 
-		for (S32 i = end; i > 0; --i)
-		{ //adjust cache pointers and tags
-			mCache[i] = mCache[i-1];
-
-			if (mCache[i])
+		if (fan < 0)
+		{ //dead end, restart from the most recently emitted vertex with triangles left
+			while (!dead_end.empty())
 			{
-				mCache[i]->mCacheTag = i;			
+				U16 v = dead_end.back();
+				dead_end.pop_back();
+				if (live[v] > 0)
+				{
+					fan = v;
+					break;
+				}
 			}
 		}
 
-		mCache[0] = data;
-		mCache[0]->mCacheTag = 0;
-	}
-
-	void addTriangle(LLVCacheTriangleData* data)
-	{
-		addVertex(data->mVertex[0]);
-		addVertex(data->mVertex[1]);
-		addVertex(data->mVertex[2]);
-	}
-
-	void updateScores()
-	{
-		LLVCacheVertexData** data_iter = mCache+MaxSizeVertexCache;
-		LLVCacheVertexData** end_data = mCache+MaxSizeVertexCache+3;
-
-		while(data_iter != end_data)
-		{
-			LLVCacheVertexData* data = *data_iter++;
-			//trailing 3 vertices aren't actually in the cache for scoring purposes
-			if (data)
+		if (fan < 0)
+		{ //nothing nearby, take the next vertex in index order
+			while (cursor < num_vertices && live[cursor] == 0)
 			{
-				data->mCacheTag = -1;
+				++cursor;
 			}
-		}
-
-		data_iter = mCache;
-		end_data = mCache+MaxSizeVertexCache;
-
-		while (data_iter != end_data)
-		{ //update scores of vertices in cache
-			LLVCacheVertexData* data = *data_iter++;
-			if (data)
+			if (cursor < num_vertices)
 			{
-				data->mScore = find_vertex_score(*data);
+				fan = cursor;
 			}
 		}
+	}
 
-		mBestTriangle = NULL;
-		//update triangle scores
-		data_iter = mCache;
-		end_data = mCache+MaxSizeVertexCache+3;
+	llassert(out_count == num_triangles * 3);
 
-		while (data_iter != end_data)
-		{
-			LLVCacheVertexData* data = *data_iter++;
-			if (data)
-			{
-				for (std::vector<LLVCacheTriangleData*>::iterator iter = data->mTriangles.begin(), end_iter = data->mTriangles.end(); iter != end_iter; ++iter)
-				{
-					LLVCacheTriangleData* tri = *iter;
-					if (tri->mActive)
-					{
-						tri->mScore = tri->mVertex[0]->mScore;
-						tri->mScore += tri->mVertex[1]->mScore;
-						tri->mScore += tri->mVertex[2]->mScore;
+	// A trailing partial triangle, if any, stays where it was.
+	for (U32 i = num_triangles * 3; i < num_indices; ++i)
+	{
+		out[i] = indices[i];
+	}
 
-						if (!mBestTriangle || mBestTriangle->mScore < tri->mScore)
-						{
-							mBestTriangle = tri;
-						}
-					}
-				}
-			}
-		}
+	return true;
+}
+
+// Order independent fingerprint of the triangles in an index list.
+static U64 hash_triangles(const U16* indices, U32 num_indices)
+{
+	U64 sum = 0;
+	U64 mix = 0;
+	for (U32 i = 0; i + 2 < num_indices; i += 3)
+	{
+		U64 key = (U64)indices[i] | ((U64)indices[i + 1] << 16) | ((U64)indices[i + 2] << 32);
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdULL;
+		key ^= key >> 33;
+		key *= 0xc4ceb9fe1a85ec53ULL;
+		key ^= key >> 33;
+		sum += key;
+		mix ^= key;
+	}
+	return sum ^ (mix << 1);
+}
+
+bool LLVolumeFace::isTriangleOrder(const std::vector<U16>& order) const
+{
+	if (order.size() != mNumIndices)
+	{
+		return false;
+	}
 
-		//knock trailing 3 vertices off the cache
-		data_iter = mCache+MaxSizeVertexCache;
-		end_data = mCache+MaxSizeVertexCache+3;
-		while (data_iter != end_data)
+	for (U32 i = 0; i < mNumIndices; ++i)
+	{
+		if (order[i] >= mNumVertices)
 		{
-			LLVCacheVertexData* data = *data_iter;
-			if (data)
-			{
-				llassert(data->mCacheTag == -1);
-				*data_iter = NULL;
-			}
-			++data_iter;
+			return false;
 		}
 	}
-};
 
+	return hash_triangles(&order[0], mNumIndices) == hash_triangles(mIndices, mNumIndices);
+}
 
-bool LLVolumeFace::cacheOptimize()
-{ //optimize for vertex cache according to Forsyth method: 
-  // http://home.comcast.net/~tom_forsyth/papers/fast_vert_cache_opt.html
+bool LLVolumeFace::cacheOptimize(std::vector<U16>* order)
+{ //reorder triangles for the post-TnL vertex cache, then vertices for the pre-TnL cache
 	
 	llassert(!mOptimized);
 	mOptimized = TRUE;
 
-	LLVCacheLRU cache;
-	
 	if (mNumVertices < 3 || mNumIndices < 3)
 	{ //nothing to do
 		return true;
 	}
 
-	//mapping of vertices to triangles and indices
-	std::vector<LLVCacheVertexData> vertex_data;
-
-	//mapping of triangles do vertices
-	std::vector<LLVCacheTriangleData> triangle_data;
-
-	try
-	{
-		triangle_data.resize(mNumIndices / 3);
-		vertex_data.resize(mNumVertices);
+	if (order && isTriangleOrder(*order))
+	{ //already optimized this face before
+		memcpy(mIndices, &(*order)[0], mNumIndices * sizeof(U16));
 	}
-	catch (std::bad_alloc&)
+	else
 	{
-		LL_WARNS("LLVOLUME") << "Resize failed" << LL_ENDL;
-		return false;
-	}
-
-	for (U32 i = 0; i < mNumIndices; i++)
-	{ //populate vertex data and triangle data arrays
-		U16 idx = mIndices[i];
-		U32 tri_idx = i/3;
+		std::vector<U16> new_indices;
 
-		vertex_data[idx].mTriangles.push_back(&(triangle_data[tri_idx]));
-		vertex_data[idx].mIdx = idx;
-		triangle_data[tri_idx].mVertex[i%3] = &(vertex_data[idx]);
-	}
-
-	/*F32 pre_acmr = 1.f;
-	//measure cache misses from before rebuild
-	{
-		LLVCacheFIFO test_cache;
-		for (U32 i = 0; i < mNumIndices; ++i)
+		try
 		{
-			test_cache.addVertex(&vertex_data[mIndices[i]]);
+			new_indices.resize(mNumIndices);
 		}
-
-		for (U32 i = 0; i < mNumVertices; i++)
+		catch (std::bad_alloc&)
 		{
-			vertex_data[i].mCacheTag = -1;
+			LL_WARNS("LLVOLUME") << "Resize failed" << LL_ENDL;
+			return false;
 		}
 
-		pre_acmr = (F32) test_cache.mMisses/(mNumIndices/3);
-	}*/
-
-	for (U32 i = 0; i < mNumVertices; i++)
-	{ //initialize score values (no cache -- might try a fifo cache here)
-		LLVCacheVertexData& data = vertex_data[i];
-
-		data.mScore = find_vertex_score(data);
-		data.mActiveTriangles = data.mTriangles.size();
-
-		for (U32 j = 0; j < data.mActiveTriangles; ++j)
+		if (!tipsify_indices(mIndices, mNumIndices, mNumVertices, &new_indices[0]))
 		{
-			data.mTriangles[j]->mScore += data.mScore;
+			return false;
 		}
-	}
 
-	//sort triangle data by score
-	std::sort(triangle_data.begin(), triangle_data.end());
+		memcpy(mIndices, &new_indices[0], mNumIndices * sizeof(U16));
 
-	std::vector<U16> new_indices;
-
-	LLVCacheTriangleData* tri;
-
-	//prime pump by adding first triangle to cache;
-	tri = &(triangle_data[0]);
-	cache.addTriangle(tri);
-	new_indices.push_back(tri->mVertex[0]->mIdx);
-	new_indices.push_back(tri->mVertex[1]->mIdx);
-	new_indices.push_back(tri->mVertex[2]->mIdx);
-	tri->complete();
-
-	U32 breaks = 0;
-	for (U32 i = 1; i < mNumIndices/3; ++i)
-	{
-		cache.updateScores();
-		tri = cache.mBestTriangle;
-		if (!tri)
+		if (order)
 		{
-			breaks++;
-			for (U32 j = 0; j < triangle_data.size(); ++j)
-			{
-				if (triangle_data[j].mActive)
-				{
-					tri = &(triangle_data[j]);
-					break;
-				}
-			}
-		}	
-		
-		cache.addTriangle(tri);
-		new_indices.push_back(tri->mVertex[0]->mIdx);
-		new_indices.push_back(tri->mVertex[1]->mIdx);
-		new_indices.push_back(tri->mVertex[2]->mIdx);
-		tri->complete();
-	}
-
-	for (U32 i = 0; i < mNumIndices; ++i)
-	{
-		mIndices[i] = new_indices[i];
-	}
-
-	/*F32 post_acmr = 1.f;
-	//measure cache misses from after rebuild
-	{
-		LLVCacheFIFO test_cache;
-		for (U32 i = 0; i < mNumVertices; i++)
-		{
-			vertex_data[i].mCacheTag = -1;
+			order->swap(new_indices);
 		}
-
-		for (U32 i = 0; i < mNumIndices; ++i)
-		{
-			test_cache.addVertex(&vertex_data[mIndices[i]]);
-		}
-		
-		post_acmr = (F32) test_cache.mMisses/(mNumIndices/3);
-	}*/
+	}
 
 	//optimize for pre-TnL cache
 	
@@ -5506,9 +5345,6 @@ bool LLVolumeFace::cacheOptimize()
 	mWeights = wght;    
 	mTangents = binorm;
 
-	//std::string result = llformat("ACMR pre/post: %.3f/%.3f  --  %d triangles %d breaks", pre_acmr, post_acmr, mNumIndices/3, breaks);
-	//LL_INFOS() << result << LL_ENDL;
-
 	return true;
 }
 
@@ -6741,7 +6577,7 @@ BOOL LLVolumeFace::createSide(LLVolume* volume, BOOL partial_build)
 
 	LLVector4a* norm = mNormals;
 
-	static LLAlignedArray<LLVector4a, 64> triangle_normals;
+	static thread_local LLAlignedArray<LLVector4a, 64> triangle_normals;
 	triangle_normals.resize(count);
 	LLVector4a* output = triangle_normals.mArray;
 	LLVector4a* end_output = output+count;
@@ -54,6 +54,7 @@ class LLVolumeTriangle;
 #include "llstrider.h"
 #include "v4coloru.h"
 #include "llrefcount.h"
+#include "llatomic.h"
 #include "llpointer.h"
 #include "llfile.h"
 #include "llalignedarray.h"
@@ -903,7 +904,14 @@ public:
 	};
 
 	void optimize(F32 angle_cutoff = 2.f);
-	bool cacheOptimize();
+
+	// Reorders triangles for the post transform vertex cache, then vertices
+	// by first use. If order holds the triangle order of an earlier run over
+	// the same face it is used instead of optimizing again, otherwise the
+	// new order is stored in it. Indices in order refer to the vertices as
+	// they were before optimizing.
+	bool cacheOptimize(std::vector<U16>* order = NULL);
+	bool isTriangleOrder(const std::vector<U16>& order) const;
 
 	void createOctree(F32 scaler = 0.25f, const LLVector4a& center = LLVector4a(0,0,0), const LLVector4a& size = LLVector4a(0.5f,0.5f,0.5f));
 
@@ -1054,7 +1062,7 @@ public:
 	LLFaceID generateFaceMask();
 
 	BOOL isFaceMaskValid(LLFaceID face_mask);
-	static S32 sNumMeshPoints;
+	static LLAtomicS32 sNumMeshPoints;
 
 	friend std::ostream& operator<<(std::ostream &s, const LLVolume &volume);
 	friend std::ostream& operator<<(std::ostream &s, const LLVolume *volumep);		// HACK to bypass Windoze confusion over 
@@ -1072,7 +1080,10 @@ public:
 	void copyVolumeFaces(const LLVolume* volume);
 	void copyFacesTo(std::vector<LLVolumeFace> &faces) const;
 	void copyFacesFrom(const std::vector<LLVolumeFace> &faces);
-	bool cacheOptimize();
+
+	// Triangle orders from LLVolumeFace::cacheOptimize(), one per face.
+	typedef std::vector<std::vector<U16> > index_order_list_t;
+	bool cacheOptimize(index_order_list_t* orders = NULL);
 
 private:
 	void sculptGenerateMapVertices(U16 sculpt_width, U16 sculpt_height, S8 sculpt_components, const U8* sculpt_data, U8 sculpt_type);
@@ -1086,7 +1097,9 @@ protected:
 	BOOL generate();
 	void createVolumeFaces();
 public:
-	virtual bool unpackVolumeFaces(std::istream& is, S32 size);
+	// index_orders, if given, holds triangle orders saved from an earlier
+	// unpack of the same data and receives the orders actually used.
+	virtual bool unpackVolumeFaces(std::istream& is, S32 size, index_order_list_t* index_orders = NULL);
 
 	virtual void setMeshAssetLoaded(BOOL loaded);
 	virtual BOOL isMeshAssetLoaded();
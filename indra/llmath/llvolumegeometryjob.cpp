@@ -0,0 +1,157 @@
+/** 
+ * @file llvolumegeometryjob.cpp
+ * @brief Volume face to vertex buffer copy that can run off the main thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llvolumegeometryjob.h"
+
+#include "llmatrix4a.h"
+#include "llvector4a.h"
+#include "llvolume.h"
+
+LLVolumeFaceGeometryJob::LLVolumeFaceGeometryJob()
+:	mFace(NULL),
+	mIndices(NULL),
+	mIndexOffset(0),
+	mPositions(NULL),
+	mPositionCount(0),
+	mTextureIndex(0),
+	mNormals(NULL),
+	mTangents(NULL)
+{
+}
+
+void LLVolumeFaceGeometryJob::run() const
+{
+	llassert(mFace);
+	const LLVolumeFace& vf = *mFace;
+	S32 num_vertices = vf.mNumVertices;
+
+	if (mIndices)
+	{
+		S32 num_indices = vf.mNumIndices;
+		__m128i* dst = (__m128i*) mIndices;
+		const __m128i* src = (const __m128i*) vf.mIndices;
+		__m128i offset = _mm_set1_epi16(mIndexOffset);
+
+		S32 end = num_indices/8;
+		for (S32 i = 0; i < end; i++)
+		{
+			__m128i res = _mm_add_epi16(src[i], offset);
+			_mm_storeu_si128(dst++, res);
+		}
+
+		U16* idx = (U16*) dst;
+		for (S32 i = end*8; i < num_indices; ++i)
+		{
+			*idx++ = vf.mIndices[i]+mIndexOffset;
+		}
+	}
+
+	if (mPositions)
+	{
+		llassert(num_vertices > 0);
+
+		LLMatrix4a mat_vert;
+		mat_vert.loadu(mVertexMatrix);
+
+		// The texture index rides in w as raw integer bits.
+		F32 val = 0.f;
+		S32* vp = (S32*) &val;
+		*vp = mTextureIndex;
+
+		LLVector4a tex_idx;
+		tex_idx.set(0,0,0,val);
+
+		LLVector4Logical mask;
+		mask.clear();
+		mask.setElement<3>();
+
+		const LLVector4a* src = vf.mPositions;
+		const LLVector4a* end = src+num_vertices;
+		F32* dst = mPositions;
+		F32* end_f32 = dst+mPositionCount*4;
+
+		LLVector4a res;
+		LLVector4a tmp;
+		while (src < end)
+		{
+			mat_vert.affineTransform(*src++, res);
+			tmp.setSelectWithMask(mask, tex_idx, res);
+			tmp.store4a(dst);
+			dst += 4;
+		}
+
+		while (dst < end_f32)
+		{
+			res.store4a(dst);
+			dst += 4;
+		}
+	}
+
+	if (mNormals || mTangents)
+	{
+		LLMatrix4a mat_normal;
+		mat_normal.loadu(mNormalMatrix);
+
+		if (mNormals)
+		{
+			const LLVector4a* src = vf.mNormals;
+			const LLVector4a* end = src+num_vertices;
+			F32* dst = mNormals;
+			while (src < end)
+			{
+				LLVector4a normal;
+				mat_normal.rotate(*src++, normal);
+				normal.store4a(dst);
+				dst += 4;
+			}
+		}
+
+		if (mTangents)
+		{
+			llassert(vf.mTangents);
+
+			LLVector4Logical mask;
+			mask.clear();
+			mask.setElement<3>();
+
+			const LLVector4a* src = vf.mTangents;
+			const LLVector4a* end = src+num_vertices;
+			F32* dst = mTangents;
+			while (src < end)
+			{
+				LLVector4a tangent_out;
+				mat_normal.rotate(*src, tangent_out);
+				tangent_out.normalize3fast();
+				tangent_out.setSelectWithMask(mask, *src, tangent_out);
+				tangent_out.store4a(dst);
+				src++;
+				dst += 4;
+			}
+		}
+	}
+}
@@ -0,0 +1,60 @@
+/** 
+ * @file llvolumegeometryjob.h
+ * @brief Volume face to vertex buffer copy that can run off the main thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVOLUMEGEOMETRYJOB_H
+#define LL_LLVOLUMEGEOMETRYJOB_H
+
+#include "m3math.h"
+#include "m4math.h"
+
+class LLVolumeFace;
+
+// Writes the indices, positions, normals and tangents of one volume face
+// into vertex buffer memory. Only plain memory is touched, so once the main
+// thread has mapped the destinations any thread may run the job, as long as
+// the buffers stay mapped and the volume stays alive until it is done.
+class LLVolumeFaceGeometryJob
+{
+public:
+	LLVolumeFaceGeometryJob();
+
+	bool empty() const { return !mIndices && !mPositions && !mNormals && !mTangents; }
+	void run() const;
+
+	const LLVolumeFace*	mFace;
+	LLMatrix4			mVertexMatrix;
+	LLMatrix3			mNormalMatrix;
+
+	U16*	mIndices;		// NULL to skip
+	U16		mIndexOffset;	// added to every index
+	F32*	mPositions;		// NULL to skip, 4 floats per vertex
+	S32		mPositionCount;	// vertices reserved at mPositions, the tail repeats the last one
+	S32		mTextureIndex;	// stored in w of every position
+	F32*	mNormals;		// NULL to skip
+	F32*	mTangents;		// NULL to skip, the face must have tangents
+};
+
+#endif // LL_LLVOLUMEGEOMETRYJOB_H
@@ -27,6 +27,13 @@
 
 #include "llvolumemgr.h"
 #include "llvolume.h"
+#include "llatomic.h"
+#include "llthreadpool.h"
+#include "lltimer.h"
+#include "lltrace.h"
+
+#include <condition_variable>
+#include <mutex>
 
 
 const F32 BASE_THRESHOLD = 0.03f;
@@ -40,11 +47,30 @@ F32 LLVolumeLODGroup::mDetailThresholds[NUM_LODS] = {BASE_THRESHOLD,
 //static
 F32 LLVolumeLODGroup::mDetailScales[NUM_LODS] = {1.f, 1.5f, 2.5f, 4.f};
 
+static LLAtomicS32 sPendingBuilds(0);
+
+static LLTrace::SampleStatHandle<> sVolumeBuildQueue("volumebuildqueue", "Volume LODs waiting for or being built on the thread pool");
+static LLTrace::EventStatHandle<F64Milliseconds> sVolumeBuildLatency("volumebuildlatency", "Time from an asynchronous volume LOD request until the LOD is ready");
+
+// A volume LOD being generated on the thread pool. Shared between the group
+// and the job, so either can go away first.
+struct LLVolumeLODGroup::PendingLOD
+{
+	PendingLOD() : mDone(false), mRequestTime(LLTimer::getTotalSeconds()) {}
+
+	std::mutex				mMutex;
+	std::condition_variable	mCondition;
+	LLPointer<LLVolume>		mVolume;
+	bool					mDone;
+	F64						mRequestTime;
+};
+
 
 //============================================================================
 
 LLVolumeMgr::LLVolumeMgr()
-:	mDataMutex(NULL)
+:	mDataMutex(NULL),
+	mThreadPool(NULL)
 {
 	// the LLMutex magic interferes with easy unit testing,
 	// so you now must manually call useMutex() to use it
@@ -112,6 +138,33 @@ LLVolume* LLVolumeMgr::refVolume(const LLVolumeParams &volume_params, const S32
 	return volgroupp->refLOD(detail);
 }
 
+bool LLVolumeMgr::requestVolume(const LLVolumeParams &volume_params, const S32 detail)
+{
+	if (!mThreadPool || volume_params.isSculpt())
+	{
+		return true;
+	}
+
+	bool ready = true;
+	if (mDataMutex)
+	{
+		mDataMutex->lock();
+	}
+	volume_lod_group_map_t::iterator iter = mVolumeLODGroups.find(&volume_params);
+	if (iter != mVolumeLODGroups.end())
+	{
+		// Held under the data mutex, unrefVolume() may delete the group otherwise.
+		ready = iter->second->requestLOD(detail, mThreadPool);
+	}
+	if (mDataMutex)
+	{
+		mDataMutex->unlock();
+	}
+
+	sample(sVolumeBuildQueue, (F64)LLVolumeLODGroup::getPendingBuilds());
+	return ready;
+}
+
 // virtual
 LLVolumeLODGroup* LLVolumeMgr::getGroup( const LLVolumeParams& volume_params ) const
 {
@@ -262,6 +315,14 @@ LLVolumeLODGroup::~LLVolumeLODGroup()
 	{
 		llassert_always(mLODRefs[i] == 0);
 	}
+	// Builds still in flight finish into their PendingLOD and are dropped
+	// with it.
+}
+
+//static
+S32 LLVolumeLODGroup::getPendingBuilds()
+{
+	return sPendingBuilds.CurrentValue();
 }
 
 // Called from LLVolumeMgr::cleanup
@@ -293,6 +354,11 @@ LLVolume* LLVolumeLODGroup::refLOD(const S32 detail)
 	mAccessCount[detail]++;
 	
 	mRefs++;
+	if (mVolumeLODs[detail].isNull() && mPendingLODs[detail])
+	{
+		// Cheaper to wait for the pool than to build the same volume twice.
+		adoptPendingLOD(detail, true);
+	}
 	if (mVolumeLODs[detail].isNull())
 	{
 		mVolumeLODs[detail] = new LLVolume(mVolumeParams, mDetailScales[detail]);
@@ -324,6 +390,74 @@ BOOL LLVolumeLODGroup::derefLOD(LLVolume *volumep)
 	return FALSE;
 }
 
+bool LLVolumeLODGroup::requestLOD(const S32 detail, LLThreadPool* pool)
+{
+	llassert(detail >=0 && detail < NUM_LODS);
+	if (mVolumeLODs[detail].notNull())
+	{
+		return true;
+	}
+
+	if (mPendingLODs[detail])
+	{
+		adoptPendingLOD(detail, false);
+		return mVolumeLODs[detail].notNull();
+	}
+
+	if (!pool || !pool->getThreadCount())
+	{
+		return true;
+	}
+
+	std::shared_ptr<PendingLOD> pending = std::make_shared<PendingLOD>();
+	mPendingLODs[detail] = pending;
+	sPendingBuilds++;
+
+	LLVolumeParams params = mVolumeParams;
+	F32 scale = mDetailScales[detail];
+	pool->post([pending, params, scale]()
+			   {
+				   // LLRefCount is not atomic, only take the reference under the lock.
+				   LLVolume* volume = new LLVolume(params, scale);
+				   {
+					   std::lock_guard<std::mutex> lock(pending->mMutex);
+					   pending->mVolume = volume;
+					   pending->mDone = true;
+				   }
+				   sPendingBuilds--;
+				   pending->mCondition.notify_all();
+			   });
+	return false;
+}
+
+void LLVolumeLODGroup::adoptPendingLOD(const S32 detail, bool wait)
+{
+	std::shared_ptr<PendingLOD> pending = mPendingLODs[detail];
+	LLPointer<LLVolume> volume;
+	{
+		std::unique_lock<std::mutex> lock(pending->mMutex);
+		if (wait)
+		{
+			pending->mCondition.wait(lock, [&pending]() { return pending->mDone; });
+		}
+		else if (!pending->mDone)
+		{
+			return;
+		}
+		volume = pending->mVolume;
+		pending->mVolume = NULL;
+	}
+	mPendingLODs[detail].reset();
+
+	if (!wait)
+	{
+		// Waits in refLOD() happen wherever the caller is, only report the
+		// requests that completed on their own.
+		record(sVolumeBuildLatency, F64Seconds(LLTimer::getTotalSeconds() - pending->mRequestTime));
+	}
+	mVolumeLODs[detail] = volume;
+}
+
 S32 LLVolumeLODGroup::getDetailFromTan(const F32 tan_angle)
 {
 	S32 i = 0;
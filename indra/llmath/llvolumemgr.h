@@ -28,6 +28,7 @@
 #define LL_LLVOLUMEMGR_H
 
 #include <map>
+#include <memory>
 
 #include "llvolume.h"
 #include "llpointer.h"
@@ -35,6 +36,7 @@
 
 class LLVolumeParams;
 class LLVolumeLODGroup;
+class LLThreadPool;
 
 class LLVolumeLODGroup
 {
@@ -57,6 +59,9 @@ public:
 
 	LLVolume* refLOD(const S32 detail);
 	BOOL derefLOD(LLVolume *volumep);
+	// Starts building detail on pool unless it is already there. Returns
+	// true once refLOD(detail) no longer has to build it itself.
+	bool requestLOD(const S32 detail, LLThreadPool* pool);
 	S32 getNumRefs() const { return mRefs; }
 	
 	const LLVolumeParams* getVolumeParams() const { return &mVolumeParams; };
@@ -64,7 +69,15 @@ public:
 	F32	dump();
 	friend std::ostream& operator<<(std::ostream& s, const LLVolumeLODGroup& volgroup);
 
+	// Builds queued by requestLOD() that have not finished yet.
+	static S32 getPendingBuilds();
+
 protected:
+	struct PendingLOD;
+
+	// Moves a finished build into mVolumeLODs, or waits for it when wait is set.
+	void adoptPendingLOD(const S32 detail, bool wait);
+
 	LLVolumeParams mVolumeParams;
 
 	S32 mRefs;
@@ -73,6 +86,7 @@ protected:
 	static F32 mDetailThresholds[NUM_LODS];
 	static F32 mDetailScales[NUM_LODS];
 	S32		mAccessCount[NUM_LODS];
+	std::shared_ptr<PendingLOD> mPendingLODs[NUM_LODS];
 };
 
 class LLVolumeMgr
@@ -90,10 +104,19 @@ public:
 	virtual LLVolume *refVolume(const LLVolumeParams &volume_params, const S32 detail);
 	virtual void unrefVolume(LLVolume *volumep);
 
+	// Non blocking counterpart of refVolume() for LOD switches: returns true
+	// when refVolume() can hand out that LOD right away, otherwise queues it
+	// on the thread pool and returns false until it is built. Always true
+	// without a thread pool, for volumes nobody holds and for sculpts and
+	// meshes, whose LODs are filled in elsewhere.
+	bool requestVolume(const LLVolumeParams &volume_params, const S32 detail);
+
 	void dump();
 
 	// manually call this for mutex magic
 	void useMutex();
+	// build LODs asked for through requestVolume() on pool, NULL to stop
+	void useThreadPool(LLThreadPool* pool) { mThreadPool = pool; }
 
 	friend std::ostream& operator<<(std::ostream& s, const LLVolumeMgr& volume_mgr);
 
@@ -107,6 +130,7 @@ protected:
 	volume_lod_group_map_t mVolumeLODGroups;
 
 	LLMutex* mDataMutex;
+	LLThreadPool* mThreadPool;
 };
 
 #endif // LL_LLVOLUMEMGR_H
@@ -0,0 +1,175 @@
+/**
+ * @file lllinearoctree_test.cpp
+ * @brief LLLinearOctree test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llmath.h"
+#include "../lllinearoctree.h"
+
+#include <set>
+
+#include "../test/lltut.h"
+
+namespace
+{
+	struct TestElement
+	{
+		const LLVector4a& getPositionGroup() const	{ return mPosition; }
+		F32 getBinRadius() const					{ return mRadius; }
+
+		LLVector4a	mPosition;
+		F32			mRadius;
+		U32			mHandle;
+	};
+
+	void set_camera(LLCamera& camera, const LLVector3& origin, const LLVector3& target)
+	{
+		camera.lookAt(origin, target);
+		LLVector3 at = camera.getAtAxis();
+		LLVector3 left = camera.getLeftAxis();
+		LLVector3 up = camera.getUpAxis();
+
+		LLVector3 frust[8];
+		frust[0] = origin + at * 0.1f + left * 0.1f - up * 0.1f;
+		frust[1] = origin + at * 0.1f - left * 0.1f - up * 0.1f;
+		frust[2] = origin + at * 0.1f - left * 0.1f + up * 0.1f;
+		frust[3] = origin + at * 0.1f + left * 0.1f + up * 0.1f;
+		frust[4] = origin + at * 128.f + left * 96.f - up * 96.f;
+		frust[5] = origin + at * 128.f - left * 96.f - up * 96.f;
+		frust[6] = origin + at * 128.f - left * 96.f + up * 96.f;
+		frust[7] = origin + at * 128.f + left * 96.f + up * 96.f;
+		camera.calcAgentFrustumPlanes(frust);
+	}
+}
+
+namespace tut
+{
+	struct linearoctree_data
+	{
+		linearoctree_data()
+		{
+			gOctreeMinSize = 0.01f;
+			gOctreeMaxCapacity = 128;
+
+			U32 seed = 12345;
+			mElements.resize(5000);
+			for (size_t i = 0; i < mElements.size(); ++i)
+			{
+				seed = seed * 1664525 + 1013904223;
+				mElements[i].mPosition.set((F32)((seed >> 4) & 0x1ff), (F32)((seed >> 13) & 0xff), 20.f + (F32)((seed >> 21) & 0x7f));
+				mElements[i].mRadius = 0.05f + (F32)((seed >> 8) & 0xf) * (F32)(1 << ((seed >> 28) % 4)) * 0.25f;
+				mElements[i].mHandle = LLLinearOctree<TestElement>::INVALID;
+			}
+		}
+
+		std::vector<TestElement> mElements;
+	};
+	typedef test_group<linearoctree_data> linearoctree_test;
+	typedef linearoctree_test::object linearoctree_object;
+	tut::linearoctree_test linearoctree_testcase("LLLinearOctree");
+
+	template<> template<>
+	void linearoctree_object::test<1>()
+	{
+		set_test_name("insert, remove and balance");
+
+		LLLinearOctree<TestElement> tree(LLVector4a(128.f, 128.f, 128.f), LLVector4a(16.f, 16.f, 16.f));
+		for (size_t i = 0; i < mElements.size(); ++i)
+		{
+			mElements[i].mHandle = tree.insert(&mElements[i]);
+			ensure("inserted", mElements[i].mHandle != LLLinearOctree<TestElement>::INVALID);
+		}
+		ensure_equals("element count", tree.getElementCount(), (U32)mElements.size());
+		ensure("root grew around the elements", tree.getSize()[0] >= 256.f);
+		ensure_equals("handle lookup", tree.getElement(mElements[7].mHandle), &mElements[7]);
+
+		for (size_t i = 0; i < mElements.size(); i += 2)
+		{
+			ensure("removed", tree.remove(mElements[i].mHandle));
+		}
+		ensure("double remove fails", !tree.remove(mElements[0].mHandle));
+		ensure_equals("count after removal", tree.getElementCount(), (U32)mElements.size() / 2);
+
+		tree.balance();
+		for (size_t i = 1; i < mElements.size(); i += 2)
+		{
+			ensure("removed after balance", tree.remove(mElements[i].mHandle));
+		}
+		ensure_equals("empty", tree.getElementCount(), 0U);
+		ensure_equals("only the root left", tree.getNodeCount(), 1U);
+	}
+
+	template<> template<>
+	void linearoctree_object::test<2>()
+	{
+		set_test_name("traversals find every intersecting element");
+
+		LLLinearOctree<TestElement> tree(LLVector4a(128.f, 128.f, 128.f), LLVector4a(128.f, 128.f, 128.f));
+		for (size_t i = 0; i < mElements.size(); ++i)
+		{
+			mElements[i].mHandle = tree.insert(&mElements[i]);
+		}
+		for (size_t i = 0; i < mElements.size(); i += 3)
+		{
+			tree.remove(mElements[i].mHandle);
+			mElements[i].mHandle = LLLinearOctree<TestElement>::INVALID;
+		}
+		tree.balance();
+
+		LLCamera camera;
+		set_camera(camera, LLVector3(128.f, 20.f, 40.f), LLVector3(200.f, 180.f, 30.f));
+
+		std::set<const TestElement*> culled;
+		tree.cullFrustum(camera, [&culled](TestElement* element) { culled.insert(element); });
+
+		LLVector4a start(0.f, 0.f, 0.f);
+		LLVector4a end(300.f, 250.f, 150.f);
+		std::set<const TestElement*> hit;
+		tree.intersectRay(start, end, [&hit](TestElement* element) { hit.insert(element); });
+
+		for (size_t i = 0; i < mElements.size(); ++i)
+		{
+			const TestElement& element = mElements[i];
+			bool present = element.mHandle != LLLinearOctree<TestElement>::INVALID;
+			LLVector4a radius;
+			radius.splat(element.mRadius);
+			if (!present)
+			{
+				ensure("removed element not culled", !culled.count(&element));
+				ensure("removed element not hit", !hit.count(&element));
+				continue;
+			}
+			if (camera.AABBInFrustum(element.mPosition, radius))
+			{
+				ensure("visible element culled", culled.count(&element) == 1);
+			}
+			if (LLLineSegmentBoxIntersect(start, end, element.mPosition, radius))
+			{
+				ensure("intersected element hit", hit.count(&element) == 1);
+			}
+		}
+	}
+}
@@ -0,0 +1,205 @@
+/**
+ * @file llskinningjob_test.cpp
+ * @brief LLSkinningJob test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llmath.h"
+#include "../llmatrix4a.h"
+#include "../llquaternion.h"
+#include "../llskinningjob.h"
+
+#include <vector>
+
+#include "../test/lltut.h"
+
+namespace
+{
+	const U32 NUM_JOINTS = 24;
+	const U32 NUM_VERTICES = 1000;
+
+	void make_matrix(LLMatrix4a& res, U32 seed)
+	{
+		LLQuaternion rot;
+		rot.setQuat((F32)(seed % 360) * DEG_TO_RAD, (F32)(seed % 7) - 3.f, 1.f, (F32)(seed % 5) - 2.f);
+		LLVector3 pos((F32)(seed % 11) * 0.1f, (F32)(seed % 13) * -0.1f, (F32)(seed % 17) * 0.05f);
+		LLVector3 scale(1.f, 1.f + (F32)(seed % 3) * 0.1f, 1.f);
+		LLMatrix4 mat;
+		mat.initAll(scale, rot, pos);
+		res.loadu(mat);
+	}
+
+	// The blend getPerVertexSkinMatrix() does, applied after the bind shape
+	// matrix the way the viewer skinned before the palette was folded.
+	void reference_skin(const LLMatrix4a& bind_shape, const LLMatrix4a* joints, const LLVector4a& packed,
+						const LLVector4a& pos, const LLVector4a& normal, LLVector4a& out_pos, LLVector4a& out_normal)
+	{
+		S32 idx[4];
+		F32 w[4];
+		F32 scale = 0.f;
+		for (U32 k = 0; k < 4; ++k)
+		{
+			F32 f = packed[k];
+			idx[k] = llclamp((S32)floorf(f), (S32)0, (S32)NUM_JOINTS - 1);
+			w[k] = f - floorf(f);
+			scale += w[k];
+		}
+
+		LLMatrix4a final_mat;
+		final_mat.clear();
+		for (U32 k = 0; k < 4; ++k)
+		{
+			LLMatrix4a src;
+			src.setMul(joints[idx[k]], w[k] / scale);
+			final_mat.add(src);
+		}
+
+		LLVector4a t;
+		bind_shape.affineTransform(pos, t);
+		final_mat.affineTransform(t, out_pos);
+
+		LLMatrix4a bind = bind_shape;
+		bind.rotate(normal, t);
+		final_mat.rotate(t, out_normal);
+		out_normal.normalize3fast();
+	}
+}
+
+namespace tut
+{
+	struct skinningjob_data
+	{
+		skinningjob_data()
+		:	mWeights(NUM_VERTICES),
+			mPositions(NUM_VERTICES),
+			mNormals(NUM_VERTICES),
+			mOutPositions(NUM_VERTICES),
+			mOutNormals(NUM_VERTICES)
+		{
+			make_matrix(mBindShape, 1000);
+			for (U32 i = 0; i < NUM_JOINTS; ++i)
+			{
+				make_matrix(mJoints[i], i * 37 + 5);
+			}
+
+			U32 seed = 12345;
+			for (U32 i = 0; i < NUM_VERTICES; ++i)
+			{
+				seed = seed * 1664525 + 1013904223;
+				mPositions[i].set((F32)((seed >> 4) & 0xff) / 128.f - 1.f, (F32)((seed >> 12) & 0xff) / 128.f - 1.f, (F32)((seed >> 20) & 0xff) / 128.f);
+				mNormals[i].set((F32)((seed >> 8) & 0xf) - 7.5f, (F32)((seed >> 16) & 0xf) - 7.5f, 1.f);
+				mNormals[i].normalize3fast();
+
+				// Up to four influences, the first one always set, joint
+				// indices past the palette get clamped.
+				F32 w[4];
+				for (U32 k = 0; k < 4; ++k)
+				{
+					seed = seed * 1664525 + 1013904223;
+					U32 joint = (seed >> 8) % (NUM_JOINTS + 2);
+					F32 weight = (k == 0 || (seed & 1)) ? 0.05f + (F32)((seed >> 20) & 0xff) / 300.f : 0.f;
+					w[k] = (F32)joint + weight;
+				}
+				mWeights[i].set(w[0], w[1], w[2], w[3]);
+			}
+
+			LLSkinningJob::buildPalette(mBindShape, mJoints, NUM_JOINTS, mPalette);
+		}
+
+		LLSkinningJob makeJob()
+		{
+			LLSkinningJob job;
+			job.mPalette = mPalette;
+			job.mJointCount = NUM_JOINTS;
+			job.mWeights = &mWeights[0];
+			job.mPositions = &mPositions[0];
+			job.mNormals = &mNormals[0];
+			job.mOutPositions = &mOutPositions[0];
+			job.mOutNormals = &mOutNormals[0];
+			job.mVertexCount = NUM_VERTICES;
+			return job;
+		}
+
+		LLMatrix4a	mBindShape;
+		LLMatrix4a	mJoints[NUM_JOINTS];
+		LLMatrix4a	mPalette[NUM_JOINTS];
+		std::vector<LLVector4a> mWeights;
+		std::vector<LLVector4a> mPositions;
+		std::vector<LLVector4a> mNormals;
+		std::vector<LLVector4a> mOutPositions;
+		std::vector<LLVector4a> mOutNormals;
+	};
+	typedef test_group<skinningjob_data> skinningjob_test;
+	typedef skinningjob_test::object skinningjob_object;
+	tut::skinningjob_test skinningjob_testcase("LLSkinningJob");
+
+	template<> template<>
+	void skinningjob_object::test<1>()
+	{
+		set_test_name("matches bind shape then blended joint transform");
+
+		makeJob().run();
+		for (U32 i = 0; i < NUM_VERTICES; ++i)
+		{
+			LLVector4a pos;
+			LLVector4a normal;
+			reference_skin(mBindShape, mJoints, mWeights[i], mPositions[i], mNormals[i], pos, normal);
+			for (U32 k = 0; k < 3; ++k)
+			{
+				ensure_approximately_equals("position", mOutPositions[i][k], pos[k], 12);
+				// normalize3fast() is only good to about 1e-3.
+				ensure_approximately_equals("normal", mOutNormals[i][k], normal[k], 8);
+			}
+		}
+	}
+
+	template<> template<>
+	void skinningjob_object::test<2>()
+	{
+		set_test_name("ranges skin independently");
+
+		LLSkinningJob job = makeJob();
+		job.run();
+		std::vector<LLVector4a> whole(mOutPositions);
+
+		for (U32 i = 0; i < NUM_VERTICES; ++i)
+		{
+			mOutPositions[i].clear();
+		}
+		// Out of order and uneven, the way a thread pool hands them out.
+		job.run(600, NUM_VERTICES);
+		job.run(0, 17);
+		job.run(17, 600);
+		for (U32 i = 0; i < NUM_VERTICES; ++i)
+		{
+			ensure("range output identical", mOutPositions[i].equals3(whole[i]));
+		}
+
+		job.mNormals = NULL;
+		job.mOutNormals = NULL;
+		job.run();
+		ensure("positions without normals", mOutPositions[NUM_VERTICES - 1].equals3(whole[NUM_VERTICES - 1]));
+	}
+}
@@ -0,0 +1,209 @@
+/**
+ * @file llpacketcapture.cpp
+ * @brief Recording and playback of raw inbound datagrams.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llpacketcapture.h"
+
+static const char CAPTURE_MAGIC[8] = { 'L', 'L', 'P', 'K', 'T', 'C', 'A', 'P' };
+static const U32 CAPTURE_VERSION = 1;
+
+struct LLPacketCaptureRecord
+{
+	F64 mTimestamp;
+	U32 mSenderIP;
+	U32 mSenderPort;
+	U32 mReceivingIP;
+	U32 mSize;
+};
+
+///////////////////////////////////////////////////////////
+// LLPacketCaptureWriter
+///////////////////////////////////////////////////////////
+
+LLPacketCaptureWriter::LLPacketCaptureWriter()
+:	mFile(NULL),
+	mPacketCount(0)
+{
+}
+
+LLPacketCaptureWriter::~LLPacketCaptureWriter()
+{
+	close();
+}
+
+BOOL LLPacketCaptureWriter::open(const std::string& filename)
+{
+	close();
+
+	mFile = LLFile::fopen(filename, "wb");		/* Flawfinder: ignore */
+	if (!mFile)
+	{
+		LL_WARNS("Messaging") << "Unable to open packet capture file " << filename << LL_ENDL;
+		return FALSE;
+	}
+
+	if (fwrite(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC), 1, mFile) != 1
+		|| fwrite(&CAPTURE_VERSION, sizeof(CAPTURE_VERSION), 1, mFile) != 1)
+	{
+		LL_WARNS("Messaging") << "Unable to write packet capture header to " << filename << LL_ENDL;
+		close();
+		return FALSE;
+	}
+
+	mPacketCount = 0;
+	mTimer.reset();
+	LL_INFOS("Messaging") << "Capturing inbound packets to " << filename << LL_ENDL;
+	return TRUE;
+}
+
+void LLPacketCaptureWriter::close()
+{
+	if (mFile)
+	{
+		LL_INFOS("Messaging") << "Packet capture closed after " << mPacketCount << " packets" << LL_ENDL;
+		fclose(mFile);
+		mFile = NULL;
+	}
+}
+
+void LLPacketCaptureWriter::writePacket(U32 sender_ip, U32 sender_port, U32 receiving_ip, const char* datap, S32 size)
+{
+	if (!mFile || size <= 0)
+	{
+		return;
+	}
+
+	LLPacketCaptureRecord record;
+	record.mTimestamp = mTimer.getElapsedTimeF64();
+	record.mSenderIP = sender_ip;
+	record.mSenderPort = sender_port;
+	record.mReceivingIP = receiving_ip;
+	record.mSize = (U32)size;
+
+	if (fwrite(&record, sizeof(record), 1, mFile) != 1
+		|| fwrite(datap, size, 1, mFile) != 1)
+	{
+		// Disk full or similar, don't keep spamming the log every packet.
+		LL_WARNS("Messaging") << "Packet capture write failed, stopping capture" << LL_ENDL;
+		close();
+		return;
+	}
+	++mPacketCount;
+}
+
+///////////////////////////////////////////////////////////
+// LLPacketCaptureReader
+///////////////////////////////////////////////////////////
+
+LLPacketCaptureReader::LLPacketCaptureReader()
+:	mFile(NULL),
+	mTimestamp(0.0),
+	mSenderIP(0),
+	mSenderPort(0),
+	mReceivingIP(0)
+{
+}
+
+LLPacketCaptureReader::~LLPacketCaptureReader()
+{
+	close();
+}
+
+BOOL LLPacketCaptureReader::open(const std::string& filename)
+{
+	close();
+
+	mFile = LLFile::fopen(filename, "rb");		/* Flawfinder: ignore */
+	if (!mFile)
+	{
+		LL_WARNS("Messaging") << "Unable to open packet capture file " << filename << LL_ENDL;
+		return FALSE;
+	}
+
+	char magic[sizeof(CAPTURE_MAGIC)];
+	U32 version = 0;
+	if (fread(magic, sizeof(magic), 1, mFile) != 1
+		|| fread(&version, sizeof(version), 1, mFile) != 1
+		|| memcmp(magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0
+		|| version != CAPTURE_VERSION)
+	{
+		LL_WARNS("Messaging") << filename << " is not a version " << CAPTURE_VERSION
+							  << " packet capture file" << LL_ENDL;
+		close();
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void LLPacketCaptureReader::close()
+{
+	if (mFile)
+	{
+		fclose(mFile);
+		mFile = NULL;
+	}
+}
+
+void LLPacketCaptureReader::rewind()
+{
+	if (mFile)
+	{
+		fseek(mFile, sizeof(CAPTURE_MAGIC) + sizeof(CAPTURE_VERSION), SEEK_SET);
+	}
+}
+
+S32 LLPacketCaptureReader::readPacket(char* datap, S32 max_size)
+{
+	if (!mFile)
+	{
+		return 0;
+	}
+
+	LLPacketCaptureRecord record;
+	if (fread(&record, sizeof(record), 1, mFile) != 1)
+	{
+		return 0;
+	}
+
+	if (record.mSize == 0 || record.mSize > (U32)max_size)
+	{
+		LL_WARNS("Messaging") << "Corrupt packet capture record of size " << record.mSize << LL_ENDL;
+		return 0;
+	}
+
+	if (fread(datap, record.mSize, 1, mFile) != 1)
+	{
+		// Truncated file, most likely the viewer died mid-capture.
+		return 0;
+	}
+
+	mTimestamp = record.mTimestamp;
+	mSenderIP = record.mSenderIP;
+	mSenderPort = record.mSenderPort;
+	mReceivingIP = record.mReceivingIP;
+	return (S32)record.mSize;
+}
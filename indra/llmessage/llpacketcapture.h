@@ -0,0 +1,92 @@
+/**
+ * @file llpacketcapture.h
+ * @brief Recording and playback of raw inbound datagrams, so that the
+ * message handling paths can be benchmarked without a live simulator.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLPACKETCAPTURE_H
+#define LL_LLPACKETCAPTURE_H
+
+#include "llfile.h"
+#include "lltimer.h"
+
+// Capture file layout:
+//   header : "LLPKTCAP" magic, U32 version
+//   record : F64 seconds since capture start, U32 sender ip, U32 sender port,
+//            U32 receiving interface ip, U32 size, <size> bytes of datagram
+// Values are stored in host byte order; datagram payloads are stored exactly
+// as they came off the wire (zero-coded, with appended acks).
+
+class LLPacketCaptureWriter
+{
+public:
+	LLPacketCaptureWriter();
+	~LLPacketCaptureWriter();
+
+	BOOL open(const std::string& filename);
+	void close();
+	BOOL isOpen() const							{ return mFile != NULL; }
+
+	void writePacket(U32 sender_ip, U32 sender_port, U32 receiving_ip, const char* datap, S32 size);
+
+	U32 getPacketCount() const					{ return mPacketCount; }
+
+private:
+	LLFILE*	mFile;
+	LLTimer	mTimer;
+	U32		mPacketCount;
+};
+
+class LLPacketCaptureReader
+{
+public:
+	LLPacketCaptureReader();
+	~LLPacketCaptureReader();
+
+	BOOL open(const std::string& filename);
+	void close();
+	BOOL isOpen() const							{ return mFile != NULL; }
+
+	// Read the next record into datap, which must hold at least max_size
+	// bytes. Returns the datagram size, or 0 at end of file or on error.
+	S32 readPacket(char* datap, S32 max_size);
+
+	// Rewind to the first record.
+	void rewind();
+
+	// Values of the record last returned by readPacket().
+	F64 getTimestamp() const					{ return mTimestamp; }
+	U32 getSenderIP() const						{ return mSenderIP; }
+	U32 getSenderPort() const					{ return mSenderPort; }
+	U32 getReceivingIP() const					{ return mReceivingIP; }
+
+private:
+	LLFILE*	mFile;
+	F64		mTimestamp;
+	U32		mSenderIP;
+	U32		mSenderPort;
+	U32		mReceivingIP;
+};
+
+#endif
@@ -153,11 +153,30 @@ S32 LLPacketRing::receiveFromRing (S32 socket, char *datap)
 	return packet_size;
 }
 
+///////////////////////////////////////////////////////////
+S32 LLPacketRing::receiveFromReplay(char *datap)
+{
+	S32 packet_size = mReplayReader.readPacket(datap, NET_BUFFER_SIZE);
+	if (packet_size)
+	{
+		mLastSender.set(mReplayReader.getSenderIP(), mReplayReader.getSenderPort());
+		mLastReceivingIF.set(mReplayReader.getReceivingIP(), INVALID_PORT);
+		mActualBitsIn += packet_size * 8;
+	}
+	return packet_size;
+}
+
 ///////////////////////////////////////////////////////////
 S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 {
 	S32 packet_size = 0;
 
+	if (mReplayReader.isOpen())
+	{
+		// Replaying a capture, the socket is not touched at all.
+		return receiveFromReplay(datap);
+	}
+
 	// If using the throttle, simulate a limited size input buffer.
 	if (mUseInThrottle)
 	{
@@ -267,6 +286,12 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 		}
 	}
 
+	if (packet_size && mCaptureWriter.isOpen())
+	{
+		mCaptureWriter.writePacket(mLastSender.getAddress(), mLastSender.getPort(),
+								   mLastReceivingIF.getAddress(), datap, packet_size);
+	}
+
 	return packet_size;
 }
 
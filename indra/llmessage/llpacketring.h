@@ -32,6 +32,7 @@
 
 #include "llhost.h"
 #include "llpacketbuffer.h"
+#include "llpacketcapture.h"
 #include "llproxy.h"
 #include "llthrottle.h"
 #include "net.h"
@@ -55,6 +56,17 @@ public:
 
 	BOOL sendPacket(int h_socket, char * send_buffer, S32 buf_size, LLHost host);
 
+	// Record every datagram handed out by receivePacket() to a capture file.
+	BOOL startCapture(const std::string& filename)	{ return mCaptureWriter.open(filename); }
+	void stopCapture()								{ mCaptureWriter.close(); }
+	BOOL isCapturing() const						{ return mCaptureWriter.isOpen(); }
+
+	// Feed receivePacket() from a capture file instead of the socket.
+	// receivePacket() returns 0 once the capture has been exhausted.
+	BOOL startReplay(const std::string& filename)	{ return mReplayReader.open(filename); }
+	void stopReplay()								{ mReplayReader.close(); }
+	BOOL isReplaying() const						{ return mReplayReader.isOpen(); }
+
 	inline LLHost getLastSender();
 	inline LLHost getLastReceivingInterface();
 
@@ -83,7 +95,12 @@ protected:
 	LLHost mLastSender;
 	LLHost mLastReceivingIF;
 
+	LLPacketCaptureWriter mCaptureWriter;
+	LLPacketCaptureReader mReplayReader;
+
 private:
+	S32 receiveFromReplay(char *datap);
+
 	BOOL sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host);
 };
 
@@ -2537,6 +2537,31 @@ void LLMessageSystem::stopLogging()
 	}
 }
 
+BOOL LLMessageSystem::startPacketCapture(const std::string& filename)
+{
+	return mPacketRing.startCapture(filename);
+}
+
+void LLMessageSystem::stopPacketCapture()
+{
+	mPacketRing.stopCapture();
+}
+
+BOOL LLMessageSystem::startPacketReplay(const std::string& filename)
+{
+	if (!mPacketRing.startReplay(filename))
+	{
+		return FALSE;
+	}
+	LL_INFOS("Messaging") << "Replaying inbound packets from " << filename << LL_ENDL;
+	return TRUE;
+}
+
+void LLMessageSystem::stopPacketReplay()
+{
+	mPacketRing.stopReplay();
+}
+
 void LLMessageSystem::summarizeLogs(std::ostream& str)
 {
  	std::string buffer;
@@ -2636,6 +2661,7 @@ void end_messaging_system(bool print_summary)
 	if (gMessageSystem)
 	{
 		gMessageSystem->stopLogging();
+		gMessageSystem->stopPacketCapture();
 
 		if (print_summary)
 		{
@@ -225,6 +225,8 @@ private:
 	message_template_number_map_t	mMessageNumbers;
 
 public:
+	const message_template_name_map_t& getMessageTemplates() const { return mMessageTemplates; }
+
 	S32					mSystemVersionMajor;
 	S32					mSystemVersionMinor;
 	S32					mSystemVersionPatch;
@@ -664,6 +666,11 @@ public:
 	void stopLogging();						// flush and close file
 	void summarizeLogs(std::ostream& str);	// log statistics
 
+	BOOL startPacketCapture(const std::string& filename);	// record raw inbound datagrams to filename
+	void stopPacketCapture();								// flush and close capture file
+	BOOL startPacketReplay(const std::string& filename);	// receive datagrams from a capture instead of the socket
+	void stopPacketReplay();
+
 	S32		getReceiveSize() const;
 	S32		getReceiveCompressedSize() const { return mIncomingCompressedSize; }
 	S32		getReceiveBytes() const;
@@ -1079,6 +1079,7 @@ S32 LLPrimitive::packTEField(U8 *cur_ptr, U8 *data_ptr, U8 data_size, U8 last_fa
 	return (S32)(cur_ptr - start_loc);
 }
 
+// static
 S32 LLPrimitive::unpackTEField(U8 *cur_ptr, U8 *buffer_end, U8 *data_ptr, U8 data_size, U8 face_count, EMsgVariableType type)
 {
 	U8 *start_loc = cur_ptr;
@@ -1298,9 +1299,6 @@ BOOL LLPrimitive::packTEMessage(LLDataPacker &dp) const
 S32 LLPrimitive::parseTEMessage(LLMessageSystem* mesgsys, char const* block_name, const S32 block_num, LLTEContents& tec)
 {
 	S32 retval = 0;
-   // temp buffer for material ID processing
-   // data will end up in tec.material_id[]	
-   U8 material_data[LLTEContents::MAX_TES*16];
 
 	if (block_num < 0)
 	{
@@ -1329,6 +1327,18 @@ S32 LLPrimitive::parseTEMessage(LLMessageSystem* mesgsys, char const* block_name
 	
 
 	tec.face_count = llmin((U32)getNumTEs(),(U32)LLTEContents::MAX_TES);
+	parseTEBuffer(tec);
+
+	retval = 1;
+	return retval;
+}
+
+// static
+void LLPrimitive::parseTEBuffer(LLTEContents& tec)
+{
+	// temp buffer for material ID processing
+	// data will end up in tec.material_id[]
+	U8 material_data[LLTEContents::MAX_TES*16];
 
 	U8 *cur_ptr = tec.packed_buffer;
 	cur_ptr += unpackTEField(cur_ptr, tec.packed_buffer+tec.size, (U8 *)tec.image_data, 16, tec.face_count, MVT_LLUUID);
@@ -1365,10 +1375,7 @@ S32 LLPrimitive::parseTEMessage(LLMessageSystem* mesgsys, char const* block_name
 	{
 		tec.material_ids[i].set(&material_data[i * 16]);
 	}
-	
-	retval = 1;
-	return retval;
-	}
+}
 	
 S32 LLPrimitive::applyParsedTEMessage(LLTEContents& tec)
 {
@@ -1407,6 +1414,71 @@ S32 LLPrimitive::applyParsedTEMessage(LLTEContents& tec)
 	return retval;
 }
 
+// static
+U32 LLPrimitive::getTEBufferFaceCount(const LLTEContents& tec)
+{
+	// field sizes in the order parseTEBuffer() unpacks them
+	static const U8 field_sizes[] = { 16, 4, 4, 4, 2, 2, 2, 1, 1, 1, 16 };
+
+	const U8 *cur_ptr = tec.packed_buffer;
+	const U8 *buffer_end = tec.packed_buffer + tec.size;
+	U32 face_count = 1;
+	for (U32 field = 0; field < LL_ARRAY_SIZE(field_sizes) && cur_ptr < buffer_end; field++)
+	{
+		cur_ptr += field_sizes[field];
+		while ((cur_ptr < buffer_end) && (*cur_ptr != 0))
+		{
+			U64 i = 0;
+			while (*cur_ptr & 0x80)
+			{
+				i |= ((*cur_ptr++) & 0x7F);
+				i = i << 7;
+			}
+			i |= *cur_ptr++;
+
+			// one face past the highest face named by the exception
+			U32 last_face = 0;
+			for (i >>= 1; i; i >>= 1)
+			{
+				last_face++;
+			}
+			face_count = llmax(face_count, last_face + 2);
+			cur_ptr += field_sizes[field];
+		}
+		cur_ptr++;
+	}
+	return llmin(face_count, (U32)LLTEContents::MAX_TES);
+}
+
+S32 LLPrimitive::applyParsedTEBuffer(LLTEContents& tec)
+{
+	U32 face_count = llmin((U32)getNumTEs(),(U32)LLTEContents::MAX_TES);
+	if (tec.face_count == 0)
+	{
+		return 0;
+	}
+
+	// Faces past the decoded ones have no exceptions, so they take the
+	// defaults left in the last decoded face.
+	U32 last = tec.face_count - 1;
+	for (U32 i = tec.face_count; i < face_count; i++)
+	{
+		memcpy(tec.image_data + i*16, tec.image_data + last*16, 16);	/* Flawfinder: ignore */
+		memcpy(tec.colors + i*4, tec.colors + last*4, 4);	/* Flawfinder: ignore */
+		tec.scale_s[i] = tec.scale_s[last];
+		tec.scale_t[i] = tec.scale_t[last];
+		tec.offset_s[i] = tec.offset_s[last];
+		tec.offset_t[i] = tec.offset_t[last];
+		tec.image_rot[i] = tec.image_rot[last];
+		tec.bump[i] = tec.bump[last];
+		tec.media_flags[i] = tec.media_flags[last];
+		tec.glow[i] = tec.glow[last];
+		tec.material_ids[i] = tec.material_ids[last];
+	}
+	tec.face_count = face_count;
+	return applyParsedTEMessage(tec);
+}
+
 S32 LLPrimitive::unpackTEMessage(LLMessageSystem* mesgsys, char const* block_name, const S32 block_num)
 {
 	LLTEContents tec;
@@ -423,12 +423,21 @@ public:
 
 	void copyTEs(const LLPrimitive *primitive);
 	S32 packTEField(U8 *cur_ptr, U8 *data_ptr, U8 data_size, U8 last_face_index, EMsgVariableType type) const;
-	S32 unpackTEField(U8 *cur_ptr, U8 *buffer_end, U8 *data_ptr, U8 data_size, U8 face_count, EMsgVariableType type);
+	static S32 unpackTEField(U8 *cur_ptr, U8 *buffer_end, U8 *data_ptr, U8 data_size, U8 face_count, EMsgVariableType type);
 	BOOL packTEMessage(LLMessageSystem *mesgsys) const;
 	BOOL packTEMessage(LLDataPacker &dp) const;
 	S32 unpackTEMessage(LLMessageSystem* mesgsys, char const* block_name, const S32 block_num); // Variable num of blocks
 	BOOL unpackTEMessage(LLDataPacker &dp);
 	S32 parseTEMessage(LLMessageSystem* mesgsys, char const* block_name, const S32 block_num, LLTEContents& tec);
+	// Decodes tec.packed_buffer for tec.face_count faces. Touches no primitive
+	// state, so it may run off the main thread.
+	static void parseTEBuffer(LLTEContents& tec);
+	// Number of faces parseTEBuffer() has to decode so that every exception
+	// in tec.packed_buffer is covered and the last face holds the defaults.
+	static U32 getTEBufferFaceCount(const LLTEContents& tec);
+	// Applies contents decoded by parseTEBuffer(), widened or clamped to this
+	// primitive's face count.
+	S32 applyParsedTEBuffer(LLTEContents& tec);
 	S32 applyParsedTEMessage(LLTEContents& tec);
 	
 #ifdef CHECK_FOR_FINITE
@@ -38,7 +38,8 @@ LLFontBitmapCache::LLFontBitmapCache()
 	mMaxCharWidth(0),
 	mMaxCharHeight(0),
 	mCurrentOffsetX(1),
-	mCurrentOffsetY(1)
+	mCurrentOffsetY(1),
+	mGeneration(0)
 {
 }
 
@@ -177,5 +178,6 @@ void LLFontBitmapCache::reset()
 	mBitmapNum = -1;
 	mCurrentOffsetX = 1;
 	mCurrentOffsetY = 1;
+	++mGeneration;
 }
 
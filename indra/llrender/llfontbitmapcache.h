@@ -57,6 +57,9 @@ public:
 	S32 getBitmapWidth() const { return mBitmapWidth; }
 	S32 getBitmapHeight() const { return mBitmapHeight; }
 
+	// Bumped by reset(), when every glyph position in the bitmaps is lost.
+	U32 getGeneration() const { return mGeneration; }
+
 private:
 	S32 mNumComponents;
 	S32 mBitmapWidth;
@@ -66,6 +69,7 @@ private:
 	S32 mMaxCharHeight;
 	S32 mCurrentOffsetX;
 	S32 mCurrentOffsetY;
+	U32 mGeneration;
 	std::vector<LLPointer<LLImageRaw> >	mImageRawVec;
 	std::vector<LLPointer<LLImageGL> > mImageGLVec;
 };
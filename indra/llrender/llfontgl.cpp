@@ -64,6 +64,9 @@ std::string LLFontGL::sAppDir;
 LLColor4 LLFontGL::sShadowColor(0.f, 0.f, 0.f, 1.f);
 LLFontRegistry* LLFontGL::sFontRegistry = NULL;
 
+LLTrace::CountStatHandle<> LLFontGL::sGlyphLookups("fontglyphlookups", "Glyph lookups made laying out text runs");
+LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > LLFontGL::sTextRunCacheHitRate("fonttextrunhits", "Text runs drawn from the laid out run cache");
+
 LLCoordGL LLFontGL::sCurOrigin;
 F32 LLFontGL::sCurDepth;
 std::vector<std::pair<LLCoordGL, F32> > LLFontGL::sOriginStack;
@@ -72,6 +75,7 @@ const F32 PAD_UVY = 0.5f; // half of vertical padding between glyphs in the glyp
 const F32 DROP_SHADOW_SOFT_STRENGTH = 0.3f;
 
 LLFontGL::LLFontGL()
+:	mTextRunGeneration(0)
 {
 }
 
@@ -161,8 +165,6 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 
 	gGL.getTexUnit(0)->enable(LLTexUnit::TT_TEXTURE);
 
-	S32 scaled_max_pixels = max_pixels == S32_MAX ? S32_MAX : llceil((F32)max_pixels * sScaleX);
-
 	// determine which style flags need to be added programmatically by stripping off the
 	// style bits that are drawn by the underlying Freetype font
 	U8 style_to_add = (style | mFontDescriptor.getStyle()) & ~mFontFreetype->getStyle();
@@ -189,8 +191,6 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 	// and is correctly occluded.
 	gGL.translatef(0.f,0.f,sCurDepth);
 
-	S32 chars_drawn = 0;
-	S32 i;
 	S32 length;
 
 	if (-1 == max_chars)
@@ -202,17 +202,232 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 		length = llmin((S32)wstr.length() - begin_offset, max_chars );
 	}
 
-	F32 cur_x, cur_y, cur_render_x, cur_render_y;
-
  	// Not guaranteed to be set correctly
 	gGL.setSceneBlendType(LLRender::BT_ALPHA);
 	
-	cur_x = ((F32)x * sScaleX) + origin.mV[VX];
-	cur_y = ((F32)y * sScaleY) + origin.mV[VY];
+	F32 pen_x = ((F32)x * sScaleX) + origin.mV[VX];
+	F32 pen_y = ((F32)y * sScaleY) + origin.mV[VY];
+
+	// The run is laid out relative to the whole pixel below the pen, so the
+	// same text drawn at another integral position reuses it.
+	TextRunKey key;
+	if (length > 0)
+	{
+		key.mText.assign(wstr, begin_offset, length + 1);
+	}
+	key.mLength = llmax(0, length);
+	key.mMaxPixels = max_pixels == S32_MAX ? S32_MAX : llceil((F32)max_pixels * sScaleX);
+	key.mScaleX = sScaleX;
+	key.mScaleY = sScaleY;
+	key.mFracX = pen_x - floorf(pen_x);
+	key.mFracY = pen_y - floorf(pen_y);
+	key.mHAlign = (U8)halign;
+	key.mVAlign = (U8)valign;
+	key.mUseEllipses = use_ellipses && max_chars >= 0;
+	pen_x = floorf(pen_x);
+	pen_y = floorf(pen_y);
+
+	const TextRun& run = getTextRun(wstr, begin_offset, key);
+	const LLFontBitmapCache* font_bitmap_cache = mFontFreetype->getFontBitmapCache();
+
+	const S32 GLYPH_BATCH_SIZE = 30;
+	LLVector3 vertices[GLYPH_BATCH_SIZE * 4];
+	LLVector2 uvs[GLYPH_BATCH_SIZE * 4];
+	LLColor4U colors[GLYPH_BATCH_SIZE * 4];
+
+	LLColor4U text_color(color);
+
+	S32 bitmap_num = -1;
+	S32 glyph_count = 0;
+	for (std::vector<TextRunGlyph>::const_iterator it = run.mGlyphs.begin(), end_it = run.mGlyphs.end(); it != end_it; ++it)
+	{
+		// Per-glyph bitmap texture.
+		if (it->mBitmapNum != bitmap_num)
+		{
+			// Actually draw the queued glyphs before switching their texture;
+			// otherwise the queued glyphs will be taken from wrong textures.
+			if (glyph_count > 0)
+			{
+				gGL.begin(LLRender::QUADS);
+				{
+					gGL.vertexBatchPreTransformed(vertices, uvs, colors, glyph_count * 4);
+				}
+				gGL.end();
+				glyph_count = 0;
+			}
+
+			bitmap_num = it->mBitmapNum;
+			LLImageGL *font_image = font_bitmap_cache->getImageGL(bitmap_num);
+			gGL.getTexUnit(0)->bind(font_image);
+		}
+
+		if (glyph_count >= GLYPH_BATCH_SIZE)
+		{
+			gGL.begin(LLRender::QUADS);
+			{
+				gGL.vertexBatchPreTransformed(vertices, uvs, colors, glyph_count * 4);
+			}
+			gGL.end();
+
+			glyph_count = 0;
+		}
+
+		LLRectf screen_rect(it->mScreenRect);
+		screen_rect.translate(pen_x, pen_y);
+		drawGlyph(glyph_count, vertices, uvs, colors, screen_rect, it->mUVRect, text_color, style_to_add, shadow, drop_shadow_strength);
+	}
+
+	gGL.begin(LLRender::QUADS);
+	{
+		gGL.vertexBatchPreTransformed(vertices, uvs, colors, glyph_count * 4);
+	}
+	gGL.end();
+
+	// Drawing the ellipses below may evict the run, so take what we need now.
+	F32 start_x = pen_x + run.mStartX;
+	F32 cur_x = pen_x + run.mEndX;
+	F32 cur_y = pen_y + run.mEndY;
+	S32 chars_drawn = run.mCharsDrawn;
+	BOOL draw_ellipses = run.mDrawEllipses;
+
+	if (right_x)
+	{
+		*right_x = (cur_x - origin.mV[VX]) / sScaleX;
+	}
+
+	//FIXME: add underline as glyph?
+	if (style_to_add & UNDERLINE)
+	{
+		F32 descender = (F32)llfloor(mFontFreetype->getDescenderHeight());
+
+		gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+		gGL.begin(LLRender::LINES);
+		gGL.vertex2f(start_x, cur_y - descender);
+		gGL.vertex2f(cur_x, cur_y - descender);
+		gGL.end();
+	}
+
+	if (draw_ellipses)
+	{
+		
+		// recursively render ellipses at end of string
+		// we've already reserved enough room
+		gGL.pushUIMatrix();
+		renderUTF8(std::string("..."), 
+				0,
+				(cur_x - origin.mV[VX]) / sScaleX, (F32)y,
+				color,
+				LEFT, valign,
+				style_to_add,
+				shadow,
+				S32_MAX, max_pixels,
+				right_x,
+				FALSE); 
+		gGL.popUIMatrix();
+	}
+
+	gGL.popUIMatrix();
+
+	return chars_drawn;
+}
+
+bool LLFontGL::TextRunKey::operator<(const TextRunKey& rhs) const
+{
+	if (mLength != rhs.mLength)
+	{
+		return mLength < rhs.mLength;
+	}
+	if (mMaxPixels != rhs.mMaxPixels)
+	{
+		return mMaxPixels < rhs.mMaxPixels;
+	}
+	if (mScaleX != rhs.mScaleX)
+	{
+		return mScaleX < rhs.mScaleX;
+	}
+	if (mScaleY != rhs.mScaleY)
+	{
+		return mScaleY < rhs.mScaleY;
+	}
+	if (mFracX != rhs.mFracX)
+	{
+		return mFracX < rhs.mFracX;
+	}
+	if (mFracY != rhs.mFracY)
+	{
+		return mFracY < rhs.mFracY;
+	}
+	if (mHAlign != rhs.mHAlign)
+	{
+		return mHAlign < rhs.mHAlign;
+	}
+	if (mVAlign != rhs.mVAlign)
+	{
+		return mVAlign < rhs.mVAlign;
+	}
+	if (mUseEllipses != rhs.mUseEllipses)
+	{
+		return rhs.mUseEllipses;
+	}
+	return mText < rhs.mText;
+}
+
+// Runs per font; UI text is mostly redrawn unchanged from frame to frame.
+const U32 TEXT_RUN_CACHE_SIZE = 256;
+// Longer runs (chat history, notecards) are laid out every time.
+const U32 MAX_CACHED_TEXT_RUN_LENGTH = 256;
+
+const LLFontGL::TextRun& LLFontGL::getTextRun(const LLWString& wstr, S32 begin_offset, const TextRunKey& key) const
+{
+	U32 generation = mFontFreetype->getFontBitmapCache()->getGeneration();
+	if (generation != mTextRunGeneration)
+	{
+		// Glyphs moved in or out of the bitmaps, every cached uv is stale.
+		mTextRuns.clear();
+		mTextRunLRU.clear();
+		mTextRunGeneration = generation;
+	}
+
+	text_run_map_t::iterator it = mTextRuns.find(key);
+	if (it != mTextRuns.end())
+	{
+		mTextRunLRU.splice(mTextRunLRU.begin(), mTextRunLRU, it->second.mLRU);
+		record(sTextRunCacheHitRate, LLUnits::Ratio::fromValue(1));
+		return it->second;
+	}
+	record(sTextRunCacheHitRate, LLUnits::Ratio::fromValue(0));
+
+	if (key.mText.size() > MAX_CACHED_TEXT_RUN_LENGTH)
+	{
+		layoutTextRun(wstr, begin_offset, key, mUncachedTextRun);
+		return mUncachedTextRun;
+	}
+
+	if (mTextRuns.size() >= TEXT_RUN_CACHE_SIZE)
+	{
+		mTextRuns.erase(mTextRunLRU.back());
+		mTextRunLRU.pop_back();
+	}
+
+	it = mTextRuns.insert(std::make_pair(key, TextRun())).first;
+	mTextRunLRU.push_front(it);
+	it->second.mLRU = mTextRunLRU.begin();
+	layoutTextRun(wstr, begin_offset, key, it->second);
+	return it->second;
+}
+
+void LLFontGL::layoutTextRun(const LLWString& wstr, S32 begin_offset, const TextRunKey& key, TextRun& run) const
+{
+	S32 length = key.mLength;
+	S32 scaled_max_pixels = key.mMaxPixels;
+	S32 lookups = 0;
+
+	F32 cur_x = key.mFracX;
+	F32 cur_y = key.mFracY;
 
 	// Offset y by vertical alignment.
 	// use unscaled font metrics here
-	switch (valign)
+	switch (key.mVAlign)
 	{
 	case TOP:
 		cur_y -= llceil(mFontFreetype->getAscenderHeight());
@@ -230,59 +445,54 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 		break;
 	}
 
-	switch (halign)
+	switch (key.mHAlign)
 	{
 	case LEFT:
 		break;
 	case RIGHT:
-	  	cur_x -= llmin(scaled_max_pixels, ll_round(getWidthF32(wstr.c_str(), begin_offset, length) * sScaleX));
+	  	cur_x -= llmin(scaled_max_pixels, ll_round(getWidthF32(wstr.c_str(), begin_offset, length) * key.mScaleX));
+		lookups += length;
 		break;
 	case HCENTER:
-	    cur_x -= llmin(scaled_max_pixels, ll_round(getWidthF32(wstr.c_str(), begin_offset, length) * sScaleX)) / 2;
+	    cur_x -= llmin(scaled_max_pixels, ll_round(getWidthF32(wstr.c_str(), begin_offset, length) * key.mScaleX)) / 2;
+		lookups += length;
 		break;
 	default:
 		break;
 	}
 
-	cur_render_y = cur_y;
-	cur_render_x = cur_x;
+	F32 cur_render_x = cur_x;
+	F32 cur_render_y = cur_y;
 
-	F32 start_x = (F32)ll_round(cur_x);
-
-	const LLFontBitmapCache* font_bitmap_cache = mFontFreetype->getFontBitmapCache();
-
-	F32 inv_width = 1.f / font_bitmap_cache->getBitmapWidth();
-	F32 inv_height = 1.f / font_bitmap_cache->getBitmapHeight();
-
-	const S32 LAST_CHARACTER = LLFontFreetype::LAST_CHAR_FULL;
-
-
-	BOOL draw_ellipses = FALSE;
-	if (use_ellipses)
+	run.mStartX = (F32)ll_round(cur_x);
+	run.mDrawEllipses = FALSE;
+	if (key.mUseEllipses)
 	{
 		// check for too long of a string
-		S32 string_width = ll_round(getWidthF32(wstr.c_str(), begin_offset, max_chars) * sScaleX);
+		S32 string_width = ll_round(getWidthF32(wstr.c_str(), begin_offset, length) * key.mScaleX);
+		lookups += length;
 		if (string_width > scaled_max_pixels)
 		{
 			// use four dots for ellipsis width to generate padding
 			const LLWString dots(utf8str_to_wstring(std::string("....")));
 			scaled_max_pixels = llmax(0, scaled_max_pixels - ll_round(getWidthF32(dots.c_str())));
-			draw_ellipses = TRUE;
+			run.mDrawEllipses = TRUE;
 		}
 	}
 
-	const LLFontGlyphInfo* next_glyph = NULL;
+	const LLFontBitmapCache* font_bitmap_cache = mFontFreetype->getFontBitmapCache();
 
-	const S32 GLYPH_BATCH_SIZE = 30;
-	LLVector3 vertices[GLYPH_BATCH_SIZE * 4];
-	LLVector2 uvs[GLYPH_BATCH_SIZE * 4];
-	LLColor4U colors[GLYPH_BATCH_SIZE * 4];
+	F32 inv_width = 1.f / font_bitmap_cache->getBitmapWidth();
+	F32 inv_height = 1.f / font_bitmap_cache->getBitmapHeight();
 
-	LLColor4U text_color(color);
+	const S32 LAST_CHARACTER = LLFontFreetype::LAST_CHAR_FULL;
 
-	S32 bitmap_num = -1;
-	S32 glyph_count = 0;
-	for (i = begin_offset; i < begin_offset + length; i++)
+	const LLFontGlyphInfo* next_glyph = NULL;
+
+	run.mGlyphs.clear();
+	run.mGlyphs.reserve(length);
+	run.mCharsDrawn = 0;
+	for (S32 i = begin_offset; i < begin_offset + length; i++)
 	{
 		llwchar wch = wstr[i];
 
@@ -291,65 +501,36 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 		if(!fgi)
 		{
 			fgi = mFontFreetype->getGlyphInfo(wch);
+			++lookups;
 		}
 		if (!fgi)
 		{
 			LL_ERRS() << "Missing Glyph Info" << LL_ENDL;
 			break;
 		}
-		// Per-glyph bitmap texture.
-		S32 next_bitmap_num = fgi->mBitmapNum;
-		if (next_bitmap_num != bitmap_num)
-		{
-			// Actually draw the queued glyphs before switching their texture;
-			// otherwise the queued glyphs will be taken from wrong textures.
-			if (glyph_count > 0)
-			{
-				gGL.begin(LLRender::QUADS);
-				{
-					gGL.vertexBatchPreTransformed(vertices, uvs, colors, glyph_count * 4);
-				}
-				gGL.end();
-				glyph_count = 0;
-			}
 
-			bitmap_num = next_bitmap_num;
-			LLImageGL *font_image = font_bitmap_cache->getImageGL(bitmap_num);
-			gGL.getTexUnit(0)->bind(font_image);
-		}
-	
-		if ((start_x + scaled_max_pixels) < (cur_x + fgi->mXBearing + fgi->mWidth))
+		if ((run.mStartX + scaled_max_pixels) < (cur_x + fgi->mXBearing + fgi->mWidth))
 		{
 			// Not enough room for this character.
 			break;
 		}
 
+		TextRunGlyph glyph;
+		glyph.mBitmapNum = fgi->mBitmapNum;
 		// Draw the text at the appropriate location
 		//Specify vertices and texture coordinates
-		LLRectf uv_rect((fgi->mXBitmapOffset) * inv_width,
+		glyph.mUVRect.set((fgi->mXBitmapOffset) * inv_width,
 				(fgi->mYBitmapOffset + fgi->mHeight + PAD_UVY) * inv_height,
 				(fgi->mXBitmapOffset + fgi->mWidth) * inv_width,
 				(fgi->mYBitmapOffset - PAD_UVY) * inv_height);
 		// snap glyph origin to whole screen pixel
-		LLRectf screen_rect((F32)ll_round(cur_render_x + (F32)fgi->mXBearing),
+		glyph.mScreenRect.set((F32)ll_round(cur_render_x + (F32)fgi->mXBearing),
 				    (F32)ll_round(cur_render_y + (F32)fgi->mYBearing),
 				    (F32)ll_round(cur_render_x + (F32)fgi->mXBearing) + (F32)fgi->mWidth,
 				    (F32)ll_round(cur_render_y + (F32)fgi->mYBearing) - (F32)fgi->mHeight);
-		
-		if (glyph_count >= GLYPH_BATCH_SIZE)
-		{
-			gGL.begin(LLRender::QUADS);
-			{
-				gGL.vertexBatchPreTransformed(vertices, uvs, colors, glyph_count * 4);
-			}
-			gGL.end();
+		run.mGlyphs.push_back(glyph);
 
-			glyph_count = 0;
-		}
-
-		drawGlyph(glyph_count, vertices, uvs, colors, screen_rect, uv_rect, text_color, style_to_add, shadow, drop_shadow_strength);
-
-		chars_drawn++;
+		run.mCharsDrawn++;
 		cur_x += fgi->mXAdvance;
 		cur_y += fgi->mYAdvance;
 
@@ -358,6 +539,7 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 		{
 			// Kern this puppy.
 			next_glyph = mFontFreetype->getGlyphInfo(next_char);
+			++lookups;
 			cur_x += mFontFreetype->getXKerning(fgi, next_glyph);
 		}
 
@@ -372,52 +554,9 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 		cur_render_y = cur_y;
 	}
 
-	gGL.begin(LLRender::QUADS);
-	{
-		gGL.vertexBatchPreTransformed(vertices, uvs, colors, glyph_count * 4);
-	}
-	gGL.end();
-
-
-	if (right_x)
-	{
-		*right_x = (cur_x - origin.mV[VX]) / sScaleX;
-	}
-
-	//FIXME: add underline as glyph?
-	if (style_to_add & UNDERLINE)
-	{
-		F32 descender = (F32)llfloor(mFontFreetype->getDescenderHeight());
-
-		gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
-		gGL.begin(LLRender::LINES);
-		gGL.vertex2f(start_x, cur_y - descender);
-		gGL.vertex2f(cur_x, cur_y - descender);
-		gGL.end();
-	}
-
-	if (draw_ellipses)
-	{
-		
-		// recursively render ellipses at end of string
-		// we've already reserved enough room
-		gGL.pushUIMatrix();
-		renderUTF8(std::string("..."), 
-				0,
-				(cur_x - origin.mV[VX]) / sScaleX, (F32)y,
-				color,
-				LEFT, valign,
-				style_to_add,
-				shadow,
-				S32_MAX, max_pixels,
-				right_x,
-				FALSE); 
-		gGL.popUIMatrix();
-	}
-
-	gGL.popUIMatrix();
-
-	return chars_drawn;
+	run.mEndX = cur_x;
+	run.mEndY = cur_y;
+	add(sGlyphLookups, lookups);
 }
 
 S32 LLFontGL::render(const LLWString &text, S32 begin_offset, F32 x, F32 y, const LLColor4 &color) const
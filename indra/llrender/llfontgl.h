@@ -33,8 +33,12 @@
 #include "llimagegl.h"
 #include "llpointer.h"
 #include "llrect.h"
+#include "lltrace.h"
 #include "v2math.h"
 
+#include <list>
+#include <map>
+
 class LLColor4;
 // Key used to request a font.
 class LLFontDescriptor;
@@ -212,6 +216,10 @@ public:
 	static BOOL sDisplayFont ;
 	static std::string sAppDir;			// For loading fonts
 
+	// Text run cache statistics, reported per frame by the viewer.
+	static LLTrace::CountStatHandle<> sGlyphLookups;
+	static LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > sTextRunCacheHitRate;
+
 private:
 	friend class LLFontRegistry;
 	friend class LLTextBillboard;
@@ -223,6 +231,56 @@ private:
 	LLFontDescriptor mFontDescriptor;
 	LLPointer<LLFontFreetype> mFontFreetype;
 
+	// A laid out run of text: the glyph quads render() would emit, relative
+	// to the whole pixel below the starting pen position. Color, style and
+	// shadow are applied when the quads are emitted, so they are not part of
+	// the key. Runs stay valid until the font's glyph bitmaps are reset.
+	struct TextRunKey
+	{
+		bool operator<(const TextRunKey& rhs) const;
+
+		LLWString	mText;			// the drawn characters plus the one they kern against
+		S32			mLength;
+		S32			mMaxPixels;
+		F32			mScaleX;
+		F32			mScaleY;
+		F32			mFracX;			// sub pixel part of the starting pen position
+		F32			mFracY;
+		U8			mHAlign;
+		U8			mVAlign;
+		bool		mUseEllipses;
+	};
+
+	struct TextRunGlyph
+	{
+		LLRectf		mScreenRect;
+		LLRectf		mUVRect;
+		S32			mBitmapNum;
+	};
+
+	struct TextRun;
+	typedef std::map<TextRunKey, TextRun> text_run_map_t;
+	typedef std::list<text_run_map_t::iterator> text_run_lru_t;
+
+	struct TextRun
+	{
+		std::vector<TextRunGlyph>	mGlyphs;
+		F32							mStartX;
+		F32							mEndX;
+		F32							mEndY;
+		S32							mCharsDrawn;
+		BOOL						mDrawEllipses;
+		text_run_lru_t::iterator	mLRU;
+	};
+
+	const TextRun& getTextRun(const LLWString& wstr, S32 begin_offset, const TextRunKey& key) const;
+	void layoutTextRun(const LLWString& wstr, S32 begin_offset, const TextRunKey& key, TextRun& run) const;
+
+	mutable text_run_map_t	mTextRuns;
+	mutable text_run_lru_t	mTextRunLRU;
+	mutable TextRun			mUncachedTextRun;	// scratch layout for runs too long to cache
+	mutable U32				mTextRunGeneration;
+
 	void renderQuad(LLVector3* vertex_out, LLVector2* uv_out, LLColor4U* colors_out, const LLRectf& screen_rect, const LLRectf& uv_rect, const LLColor4U& color, F32 slant_amt) const;
 	void drawGlyph(S32& glyph_count, LLVector3* vertex_out, LLVector2* uv_out, LLColor4U* colors_out, const LLRectf& screen_rect, const LLRectf& uv_rect, const LLColor4U& color, U8 style, ShadowType shadow, F32 drop_shadow_fade) const;
 
@@ -268,6 +268,20 @@ PFNGLTRANSFORMFEEDBACKVARYINGSPROC glTransformFeedbackVaryings = NULL;
 PFNGLBINDBUFFERRANGEPROC glBindBufferRange = NULL;
 PFNGLBINDBUFFERBASEPROC glBindBufferBase = NULL;
 
+//GL_ARB_multi_draw_indirect (4.3 core)
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glMultiDrawElementsIndirect = NULL;
+
+//GL_ARB_get_program_binary (4.1 core)
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri = NULL;
+
+//GL_KHR_parallel_shader_compile
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR = NULL;
+
+//GL_ARB_buffer_storage (4.4 core)
+PFNGLBUFFERSTORAGEPROC glBufferStorage = NULL;
+
 //GL_ARB_debug_output
 PFNGLDEBUGMESSAGECONTROLARBPROC glDebugMessageControlARB = NULL;
 PFNGLDEBUGMESSAGEINSERTARBPROC glDebugMessageInsertARB = NULL;
@@ -425,6 +439,7 @@ LLGLManager::LLGLManager() :
 	mNumTextureUnits(1),
 	mHasMipMapGeneration(FALSE),
 	mHasCompressedTextures(FALSE),
+	mHasTextureCompressionS3TC(FALSE),
 	mHasFramebufferObject(FALSE),
 	mMaxSamples(0),
 	mHasBlendFuncSeparate(FALSE),
@@ -446,6 +461,11 @@ LLGLManager::LLGLManager() :
 	mHasTextureRectangle(FALSE),
 	mHasTextureMultisample(FALSE),
 	mHasTransformFeedback(FALSE),
+	mHasMultiDrawIndirect(FALSE),
+	mHasProgramBinary(FALSE),
+	mHasParallelShaderCompile(FALSE),
+	mHasPixelBufferObject(FALSE),
+	mHasBufferStorage(FALSE),
 	mMaxSampleMaskWords(0),
 	mMaxColorTextureSamples(0),
 	mMaxDepthTextureSamples(0),
@@ -996,6 +1016,7 @@ void LLGLManager::initExtensions()
 # else
 	mHasCompressedTextures = FALSE;
 # endif // GL_ARB_texture_compression
+	mHasTextureCompressionS3TC = FALSE;
 # ifdef GL_ARB_vertex_buffer_object
 	mHasVertexBufferObject = TRUE;
 # else
@@ -1041,6 +1062,7 @@ void LLGLManager::initExtensions()
 	mHasCubeMap = ExtensionExists("GL_ARB_texture_cube_map", gGLHExts.mSysExts);
 	mHasARBEnvCombine = ExtensionExists("GL_ARB_texture_env_combine", gGLHExts.mSysExts);
 	mHasCompressedTextures = glh_init_extensions("GL_ARB_texture_compression");
+	mHasTextureCompressionS3TC = mHasCompressedTextures && ExtensionExists("GL_EXT_texture_compression_s3tc", gGLHExts.mSysExts);
 	mHasOcclusionQuery = ExtensionExists("GL_ARB_occlusion_query", gGLHExts.mSysExts);
 	mHasTimerQuery = ExtensionExists("GL_ARB_timer_query", gGLHExts.mSysExts);
 	mHasOcclusionQuery2 = ExtensionExists("GL_ARB_occlusion_query2", gGLHExts.mSysExts);
@@ -1085,8 +1107,17 @@ void LLGLManager::initExtensions()
 	mHasDebugOutput = ExtensionExists("GL_ARB_debug_output", gGLHExts.mSysExts);
 	mHasTransformFeedback = mGLVersion >= 4.f ? TRUE : FALSE;
 #if !LL_DARWIN
+	mHasMultiDrawIndirect = (mDriverVersionMajor > 4 || (mDriverVersionMajor == 4 && mDriverVersionMinor >= 3)) ||
+							(ExtensionExists("GL_ARB_multi_draw_indirect", gGLHExts.mSysExts) && ExtensionExists("GL_ARB_draw_indirect", gGLHExts.mSysExts));
+	mHasProgramBinary = (mDriverVersionMajor > 4 || (mDriverVersionMajor == 4 && mDriverVersionMinor >= 1)) ||
+						ExtensionExists("GL_ARB_get_program_binary", gGLHExts.mSysExts);
+	mHasParallelShaderCompile = ExtensionExists("GL_KHR_parallel_shader_compile", gGLHExts.mSysExts) ||
+								ExtensionExists("GL_ARB_parallel_shader_compile", gGLHExts.mSysExts);
+	mHasBufferStorage = (mDriverVersionMajor > 4 || (mDriverVersionMajor == 4 && mDriverVersionMinor >= 4)) ||
+						ExtensionExists("GL_ARB_buffer_storage", gGLHExts.mSysExts);
 	mHasPointParameters = !mIsATI && ExtensionExists("GL_ARB_point_parameters", gGLHExts.mSysExts);
 #endif
+	mHasPixelBufferObject = mGLVersion >= 2.1f || ExtensionExists("GL_ARB_pixel_buffer_object", gGLHExts.mSysExts);
 	mHasShaderObjects = ExtensionExists("GL_ARB_shader_objects", gGLHExts.mSysExts) && (LLRender::sGLCoreProfile || ExtensionExists("GL_ARB_shading_language_100", gGLHExts.mSysExts));
 	mHasVertexShader = ExtensionExists("GL_ARB_vertex_program", gGLHExts.mSysExts) && ExtensionExists("GL_ARB_vertex_shader", gGLHExts.mSysExts)
 		&& (LLRender::sGLCoreProfile || ExtensionExists("GL_ARB_shading_language_100", gGLHExts.mSysExts));
@@ -1103,6 +1134,7 @@ void LLGLManager::initExtensions()
 		mHasDepthClamp = FALSE;
 		mHasARBEnvCombine = FALSE;
 		mHasCompressedTextures = FALSE;
+		mHasTextureCompressionS3TC = FALSE;
 		mHasVertexBufferObject = FALSE;
 		mHasFramebufferObject = FALSE;
 		mHasDrawBuffers = FALSE;
@@ -1113,6 +1145,11 @@ void LLGLManager::initExtensions()
 		mHasCubeMap = FALSE;
 		mHasOcclusionQuery = FALSE;
 		mHasPointParameters = FALSE;
+		mHasMultiDrawIndirect = FALSE;
+		mHasProgramBinary = FALSE;
+		mHasParallelShaderCompile = FALSE;
+		mHasPixelBufferObject = FALSE;
+		mHasBufferStorage = FALSE;
 		mHasShaderObjects = FALSE;
 		mHasVertexShader = FALSE;
 		mHasFragmentShader = FALSE;
@@ -1333,6 +1370,45 @@ void LLGLManager::initExtensions()
 		glBindBufferRange = (PFNGLBINDBUFFERRANGEPROC) GLH_EXT_GET_PROC_ADDRESS("glBindBufferRange");
 		glBindBufferBase = (PFNGLBINDBUFFERBASEPROC) GLH_EXT_GET_PROC_ADDRESS("glBindBufferBase");
 	}
+	if (mHasMultiDrawIndirect)
+	{
+		glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC) GLH_EXT_GET_PROC_ADDRESS("glMultiDrawElementsIndirect");
+		if (!glMultiDrawElementsIndirect)
+		{
+			mHasMultiDrawIndirect = FALSE;
+		}
+	}
+	if (mHasProgramBinary)
+	{
+		glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC) GLH_EXT_GET_PROC_ADDRESS("glGetProgramBinary");
+		glProgramBinary = (PFNGLPROGRAMBINARYPROC) GLH_EXT_GET_PROC_ADDRESS("glProgramBinary");
+		glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC) GLH_EXT_GET_PROC_ADDRESS("glProgramParameteri");
+		if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri)
+		{
+			mHasProgramBinary = FALSE;
+		}
+	}
+	if (mHasParallelShaderCompile)
+	{
+		// the ARB entry point has the same signature
+		glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC) GLH_EXT_GET_PROC_ADDRESS("glMaxShaderCompilerThreadsKHR");
+		if (!glMaxShaderCompilerThreadsKHR)
+		{
+			glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC) GLH_EXT_GET_PROC_ADDRESS("glMaxShaderCompilerThreadsARB");
+		}
+		if (!glMaxShaderCompilerThreadsKHR)
+		{
+			mHasParallelShaderCompile = FALSE;
+		}
+	}
+	if (mHasBufferStorage)
+	{
+		glBufferStorage = (PFNGLBUFFERSTORAGEPROC) GLH_EXT_GET_PROC_ADDRESS("glBufferStorage");
+		if (!glBufferStorage)
+		{
+			mHasBufferStorage = FALSE;
+		}
+	}
 	if (mHasDebugOutput)
 	{
 		glDebugMessageControlARB = (PFNGLDEBUGMESSAGECONTROLARBPROC) GLH_EXT_GET_PROC_ADDRESS("glDebugMessageControlARB");
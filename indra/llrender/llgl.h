@@ -83,6 +83,7 @@ public:
 	S32	 mNumTextureUnits;
 	BOOL mHasMipMapGeneration;
 	BOOL mHasCompressedTextures;
+	BOOL mHasTextureCompressionS3TC;
 	BOOL mHasFramebufferObject;
 	S32 mMaxSamples;
 	BOOL mHasBlendFuncSeparate;
@@ -107,6 +108,11 @@ public:
 	BOOL mHasTextureRectangle;
 	BOOL mHasTextureMultisample;
 	BOOL mHasTransformFeedback;
+	BOOL mHasMultiDrawIndirect;
+	BOOL mHasProgramBinary;
+	BOOL mHasParallelShaderCompile;
+	BOOL mHasPixelBufferObject;
+	BOOL mHasBufferStorage;
 	S32 mMaxSampleMaskWords;
 	S32 mMaxColorTextureSamples;
 	S32 mMaxDepthTextureSamples;
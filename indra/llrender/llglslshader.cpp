@@ -31,6 +31,7 @@
 #include "llshadermgr.h"
 #include "llfile.h"
 #include "llrender.h"
+#include "lltimer.h"
 #include "llvertexbuffer.h"
 
 #if LL_DARWIN
@@ -306,6 +307,7 @@ void LLGLSLShader::readProfileQuery(U32 count, U32 mode)
 
 LLGLSLShader::LLGLSLShader()
     : mProgramObject(0), 
+      mProgramFromCache(false),
       mAttributeMask(0),
       mTotalUniformSize(0),
       mActiveTextureChannels(0), 
@@ -313,7 +315,11 @@ LLGLSLShader::LLGLSLShader()
       mShaderGroup(SG_DEFAULT), 
       mUniformsDirty(FALSE),
       mTimerQuery(0),
-      mSamplesQuery(0)
+      mSamplesQuery(0),
+      mPending(false),
+      mLinkSubmitted(false),
+      mPendingAttributes(NULL),
+      mPendingUniforms(NULL)
 
 {
     
@@ -335,6 +341,13 @@ void LLGLSLShader::unloadInternal()
 {
     sInstances.erase(this);
 
+    if (mPending)
+    {
+        LLShaderMgr::instance()->cancelPendingShader(this);
+        mPending = false;
+    }
+    mLinkSubmitted = false;
+
     stop_glerror();
     mAttribute.clear();
     mTexture.clear();
@@ -379,6 +392,27 @@ BOOL LLGLSLShader::createShader(std::vector<LLStaticHashedString> * attributes,
                                 std::vector<LLStaticHashedString> * uniforms,
                                 U32 varying_count,
                                 const char** varyings)
+{
+    // transform feedback programs are rare, keep them synchronous
+    bool deferred = LLShaderMgr::instance()->isBatchingShaders() && varying_count == 0;
+    return loadProgram(attributes, uniforms, varying_count, varyings, deferred);
+}
+
+BOOL LLGLSLShader::finishShader()
+{
+    if (!mPending)
+    {
+        return TRUE;
+    }
+    mPending = false;
+    return finishProgram(TRUE, true, 0, NULL);
+}
+
+BOOL LLGLSLShader::loadProgram(std::vector<LLStaticHashedString> * attributes,
+                               std::vector<LLStaticHashedString> * uniforms,
+                               U32 varying_count,
+                               const char** varyings,
+                               bool deferred)
 {
     unloadInternal();
 
@@ -394,6 +428,11 @@ BOOL LLGLSLShader::createShader(std::vector<LLStaticHashedString> * attributes,
     llassert_always(!mShaderFiles.empty());
     BOOL success = TRUE;
 
+    LLShaderMgr* shader_mgr = LLShaderMgr::instance();
+    mLoadTimer.reset();
+    mPendingAttributes = attributes;
+    mPendingUniforms = uniforms;
+
     // Create program
     mProgramObject = glCreateProgramObjectARB();
     
@@ -401,27 +440,43 @@ BOOL LLGLSLShader::createShader(std::vector<LLStaticHashedString> * attributes,
     // work-around missing mix(vec3,vec3,bvec3)
     mDefines["OLD_SELECT"] = "1";
 #endif
-    
-    //compile new source
-    vector< pair<string,GLenum> >::iterator fileIter = mShaderFiles.begin();
-    for ( ; fileIter != mShaderFiles.end(); fileIter++ )
+
+    // attachShaderFeatures may change the channel count, our own stages use the one we were given
+    S32 texture_index_channels = mFeatures.mIndexedTextureChannels;
+
+    // Attach existing objects
+    if (!shader_mgr->attachShaderFeatures(this))
+    {
+        return FALSE;
+    }
+
+    mCacheKey = shader_mgr->getProgramCacheKey(this, texture_index_channels, varying_count, varyings);
+    mProgramFromCache = !mCacheKey.empty() && shader_mgr->loadProgramBinary(this, mCacheKey);
+
+    if (!mProgramFromCache)
     {
-        GLhandleARB shaderhandle = LLShaderMgr::instance()->loadShaderFile((*fileIter).first, mShaderLevel, (*fileIter).second, &mDefines, mFeatures.mIndexedTextureChannels);
-        LL_DEBUGS("ShaderLoading") << "SHADER FILE: " << (*fileIter).first << " mShaderLevel=" << mShaderLevel << LL_ENDL;
-        if (shaderhandle)
+        //compile new source
+        vector< pair<string,GLenum> >::iterator fileIter = mShaderFiles.begin();
+        for ( ; fileIter != mShaderFiles.end(); fileIter++ )
         {
-            attachObject(shaderhandle);
+            GLhandleARB shaderhandle = shader_mgr->loadShaderFile((*fileIter).first, mShaderLevel, (*fileIter).second, &mDefines, texture_index_channels, deferred);
+            LL_DEBUGS("ShaderLoading") << "SHADER FILE: " << (*fileIter).first << " mShaderLevel=" << mShaderLevel << LL_ENDL;
+            if (shaderhandle)
+            {
+                attachObject(shaderhandle);
+            }
+            else
+            {
+                success = FALSE;
+            }
         }
-        else
+
+#if !LL_DARWIN
+        if (!mCacheKey.empty())
         {
-            success = FALSE;
+            glProgramParameteri(mProgramObject, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         }
-    }
-
-    // Attach existing objects
-    if (!LLShaderMgr::instance()->attachShaderFeatures(this))
-    {
-        return FALSE;
+#endif
     }
 
     if (gGLManager.mGLSLVersionMajor < 2 && gGLManager.mGLSLVersionMinor < 3)
@@ -431,31 +486,73 @@ BOOL LLGLSLShader::createShader(std::vector<LLStaticHashedString> * attributes,
     }
 
 #ifdef GL_INTERLEAVED_ATTRIBS
-    if (varying_count > 0 && varyings)
+    if (varying_count > 0 && varyings && !mProgramFromCache)
     {
         glTransformFeedbackVaryings(mProgramObject, varying_count, varyings, GL_INTERLEAVED_ATTRIBS);
     }
 #endif
 
+    if (success && !mProgramFromCache)
+    {
+        //before linking, make sure reserved attributes always have consistent locations
+        for (U32 i = 0; i < shader_mgr->mReservedAttribs.size(); i++)
+        {
+            const char* name = shader_mgr->mReservedAttribs[i].c_str();
+            glBindAttribLocationARB(mProgramObject, i, (const GLcharARB *) name);
+        }
+
+        glLinkProgramARB(mProgramObject);
+        mLinkSubmitted = true;
+
+        if (deferred)
+        { //leave the driver compiling and linking, statuses are read in finishShader
+            mPending = true;
+            shader_mgr->addPendingShader(this);
+            return TRUE;
+        }
+    }
+
+    return finishProgram(success, deferred, varying_count, varyings);
+}
+
+BOOL LLGLSLShader::finishProgram(BOOL success, bool deferred, U32 varying_count, const char** varyings)
+{
+    LLShaderMgr* shader_mgr = LLShaderMgr::instance();
+
     // Map attributes and uniforms
     if (success)
     {
-        success = mapAttributes(attributes);
+        success = mapAttributes(mPendingAttributes);
     }
     if (success)
     {
-        success = mapUniforms(uniforms);
+        success = mapUniforms(mPendingUniforms);
+    }
+    if (success && !mProgramFromCache && !mCacheKey.empty())
+    {
+        shader_mgr->saveProgramBinary(this, mCacheKey);
+    }
+    if (success)
+    {
+        // for a deferred program this includes the time spent on the rest of the batch
+        shader_mgr->recordProgramLoad(this, mProgramFromCache, mLoadTimer.getElapsedTimeF64());
     }
     if( !success )
     {
         LL_SHADER_LOADING_WARNS() << "Failed to link shader: " << mName << LL_ENDL;
 
+        if (deferred)
+        { //compile errors were not checked, build it again the slow way to get the level fallbacks
+            LL_SHADER_LOADING_WARNS() << "Rebuilding deferred shader " << mName << " at shader level " << mShaderLevel << LL_ENDL;
+            return loadProgram(mPendingAttributes, mPendingUniforms, varying_count, varyings, false);
+        }
+
         // Try again using a lower shader level;
         if (mShaderLevel > 0)
         {
             LL_SHADER_LOADING_WARNS() << "Failed to link using shader level " << mShaderLevel << " trying again using shader level " << (mShaderLevel - 1) << LL_ENDL;
             mShaderLevel--;
-            return createShader(attributes,uniforms);
+            return loadProgram(mPendingAttributes, mPendingUniforms, varying_count, varyings, false);
         }
     }
     else if (mFeatures.mIndexedTextureChannels > 0)
@@ -540,15 +637,12 @@ void LLGLSLShader::attachObjects(GLhandleARB* objects, S32 count)
 
 BOOL LLGLSLShader::mapAttributes(const std::vector<LLStaticHashedString> * attributes)
 {
-    //before linking, make sure reserved attributes always have consistent locations
-    for (U32 i = 0; i < LLShaderMgr::instance()->mReservedAttribs.size(); i++)
+    BOOL res = TRUE;
+    if (!mProgramFromCache)
     {
-        const char* name = LLShaderMgr::instance()->mReservedAttribs[i].c_str();
-        glBindAttribLocationARB(mProgramObject, i, (const GLcharARB *) name);
+        //wait for the link loadProgram submitted
+        res = link();
     }
-    
-    //link the program
-    BOOL res = link();
 
     mAttribute.clear();
     U32 numAttributes = (attributes == NULL) ? 0 : attributes->size();
@@ -877,7 +971,16 @@ BOOL LLGLSLShader::mapUniforms(const vector<LLStaticHashedString> * uniforms)
 
 BOOL LLGLSLShader::link(BOOL suppress_errors)
 {
-    BOOL success = LLShaderMgr::instance()->linkProgramObject(mProgramObject, suppress_errors);
+    BOOL success;
+    if (mLinkSubmitted)
+    {
+        mLinkSubmitted = false;
+        success = LLShaderMgr::instance()->checkLinkStatus(mProgramObject, suppress_errors);
+    }
+    else
+    {
+        success = LLShaderMgr::instance()->linkProgramObject(mProgramObject, suppress_errors);
+    }
 
     if (!success && !suppress_errors)
     {
@@ -889,6 +992,11 @@ BOOL LLGLSLShader::link(BOOL suppress_errors)
 
 void LLGLSLShader::bind()
 {
+    if (mPending)
+    {
+        LLShaderMgr::instance()->finishPendingShader(this);
+    }
+
     gGL.flush();
     if (gGLManager.mHasShaderObjects)
     {
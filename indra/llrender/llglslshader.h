@@ -30,6 +30,7 @@
 #include "llgl.h"
 #include "llrender.h"
 #include "llstaticstringtable.h"
+#include "lltimer.h"
 
 class LLShaderFeatures
 {
@@ -102,6 +103,9 @@ public:
 						std::vector<LLStaticHashedString> * uniforms,
 						U32 varying_count = 0,
 						const char** varyings = NULL);
+	// Reads back the statuses of a program createShader left compiling in a
+	// shader batch, see LLShaderMgr::beginShaderBatch
+	BOOL finishShader();
     BOOL attachFragmentObject(std::string object);
     BOOL attachVertexObject(std::string object);
 	void attachObject(GLhandleARB object);
@@ -175,6 +179,7 @@ public:
 	U32 mLightHash;
 
 	GLhandleARB mProgramObject;
+	bool mProgramFromCache; // linked from a cached program binary, nothing left to link
 #if LL_RELEASE_WITH_DEBUG_INFO
 	struct attr_name
 	{
@@ -221,6 +226,19 @@ public:
 
 private:
 	void unloadInternal();
+	BOOL loadProgram(std::vector<LLStaticHashedString> * attributes,
+					std::vector<LLStaticHashedString> * uniforms,
+					U32 varying_count,
+					const char** varyings,
+					bool deferred);
+	BOOL finishProgram(BOOL success, bool deferred, U32 varying_count, const char** varyings);
+
+	bool mPending; // compile and link submitted in a shader batch, not checked yet
+	bool mLinkSubmitted;
+	std::vector<LLStaticHashedString>* mPendingAttributes;
+	std::vector<LLStaticHashedString>* mPendingUniforms;
+	std::string mCacheKey;
+	LLTimer mLoadTimer;
 };
 
 //UI shader (declared here so llui_libtest will link properly)
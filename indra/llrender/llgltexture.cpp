@@ -164,11 +164,11 @@ BOOL LLGLTexture::createGLTexture()
 	return mGLTexturep->createGLTexture() ;
 }
 
-BOOL LLGLTexture::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename, BOOL to_create, S32 category)
+BOOL LLGLTexture::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename, BOOL to_create, S32 category, bool allow_async)
 {
 	llassert(mGLTexturep.notNull()) ;	
 
-	BOOL ret = mGLTexturep->createGLTexture(discard_level, imageraw, usename, to_create, category) ;
+	BOOL ret = mGLTexturep->createGLTexture(discard_level, imageraw, usename, to_create, category, allow_async) ;
 
 	if(ret)
 	{
@@ -222,6 +222,11 @@ S32 LLGLTexture::getDiscardLevel() const
 	llassert(mGLTexturep.notNull()) ;
 	return mGLTexturep->getDiscardLevel() ;
 }
+S32 LLGLTexture::getUploadDiscardLevel() const
+{
+	llassert(mGLTexturep.notNull()) ;
+	return mGLTexturep->getUploadDiscardLevel() ;
+}
 S8  LLGLTexture::getComponents() const 
 { 
 	llassert(mGLTexturep.notNull()) ;
@@ -307,6 +312,13 @@ LLTexUnit::eTextureAddressMode LLGLTexture::getAddressMode(void) const
 	return mGLTexturep->getAddressMode() ;
 }
 
+S32 LLGLTexture::getCategory() const
+{
+	llassert(mGLTexturep.notNull()) ;
+
+	return mGLTexturep->getCategory() ;
+}
+
 S32Bytes LLGLTexture::getTextureMemory() const
 {
 	llassert(mGLTexturep.notNull()) ;
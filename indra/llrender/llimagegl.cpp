@@ -34,10 +34,14 @@
 #include "llerror.h"
 #include "llfasttimer.h"
 #include "llimage.h"
+#include "llimagedxt.h"
+#include "llimageglthread.h"
+#include "lltimer.h"
 
 #include "llmath.h"
 #include "llgl.h"
 #include "llglslshader.h"
+#include "llgltexture.h"
 #include "llrender.h"
 
 //----------------------------------------------------------------------------
@@ -54,6 +58,7 @@ U32 LLImageGL::sBindCount				= 0;
 S32Bytes LLImageGL::sGlobalTextureMemory(0);
 S32Bytes LLImageGL::sBoundTextureMemory(0);
 S32Bytes LLImageGL::sCurBoundTextureMemory(0);
+S32Bytes LLImageGL::sCompressedTextureSavings(0);
 S32 LLImageGL::sCount					= 0;
 
 BOOL LLImageGL::sGlobalUseAnisotropic	= FALSE;
@@ -61,6 +66,10 @@ F32 LLImageGL::sLastFrameTime			= 0.f;
 BOOL LLImageGL::sAllowReadBackRaw       = FALSE ;
 LLImageGL* LLImageGL::sDefaultGLTexture = NULL ;
 bool LLImageGL::sCompressTextures = false;
+U32 LLImageGL::sUITextureGeneration = 0;
+
+LLTrace::CountStatHandle<F64Megabytes> LLImageGL::sUploadedData("textureuploaddata", "Texture data uploaded to GL");
+LLTrace::CountStatHandle<F64Seconds> LLImageGL::sMainThreadUploadTime("textureuploadtime", "Main thread time spent creating GL textures");
 
 std::set<LLImageGL*> LLImageGL::sImageList;
 
@@ -456,6 +465,7 @@ void LLImageGL::init(BOOL usemipmaps)
 	mNeedsAlphaAndPickMask = TRUE ;
 	mAlphaStride = 0 ;
 	mAlphaOffset = 0 ;
+	mAlphaScanApplied = false;
 
 	mGLTextureCreated = FALSE ;
 	mTexName = 0;
@@ -468,6 +478,11 @@ void LLImageGL::init(BOOL usemipmaps)
 	mTexelsInGLTexture = 0 ;
 
 	mAllowCompression = true;
+	mCompressionSavings = (S32Bytes)0;
+
+	mUploadPending = false;
+	mUploadSerial = 0;
+	mUploadDiscardLevel = -1;
 	
 	mTarget = GL_TEXTURE_2D;
 	mBindTarget = LLTexUnit::TT_TEXTURE;
@@ -1330,7 +1345,7 @@ BOOL LLImageGL::createGLTexture()
 }
 
 static LLTrace::BlockTimerStatHandle FTM_CREATE_GL_TEXTURE2("createGLTexture(raw)");
-BOOL LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename/*=0*/, BOOL to_create, S32 category)
+BOOL LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename/*=0*/, BOOL to_create, S32 category, bool allow_async)
 {
 	LL_RECORD_BLOCK_TIME(FTM_CREATE_GL_TEXTURE2);
 	if (gGLManager.mIsDisabled)
@@ -1428,8 +1443,19 @@ BOOL LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S
 	}
 
 	setCategory(category);
- 	const U8* rawdata = imageraw->getData();
-	return createGLTexture(discard_level, rawdata, FALSE, usename);
+
+	if (allow_async && usename == 0 && canUploadAsync())
+	{
+		queueUpload(discard_level, imageraw);
+		return TRUE;
+	}
+
+ 	// setImage() skips its own alpha analysis when the decoder already did it
+	mAlphaScanApplied = applyAlphaScan(imageraw);
+	const U8* rawdata = imageraw->getData();
+	BOOL res = createGLTexture(discard_level, rawdata, FALSE, usename);
+	mAlphaScanApplied = false;
+	return res;
 }
 
 static LLTrace::BlockTimerStatHandle FTM_CREATE_GL_TEXTURE3("createGLTexture3(data)");
@@ -1438,6 +1464,7 @@ BOOL LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, BOOL data_
 	LL_RECORD_BLOCK_TIME(FTM_CREATE_GL_TEXTURE3);
 	llassert(data_in);
 	stop_glerror();
+	LLTimer upload_timer;
 
 	if (discard_level < 0)
 	{
@@ -1446,10 +1473,17 @@ BOOL LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, BOOL data_
 	}
 	discard_level = llclamp(discard_level, 0, (S32)mMaxDiscardLevel);
 
+	// Anything still in flight would overwrite this data when it lands
+	cancelUpload();
+
 	if (mTexName != 0 && discard_level == mCurrentDiscardLevel)
 	{
 		// This will only be true if the size has not changed
-		return setImage(data_in, data_hasmips);
+		BOOL res = setImage(data_in, data_hasmips);
+		noteContentsChanged();
+		add(sUploadedData, F64Bytes(getMipBytes(discard_level)));
+		add(sMainThreadUploadTime, F64Seconds(upload_timer.getElapsedTimeF64()));
+		return res;
 	}
 	
 	U32 old_name = mTexName;
@@ -1529,9 +1563,424 @@ BOOL LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, BOOL data_
 	claimMem(mTextureMemory);
 	sGlobalTextureMemory += mTextureMemory;
 	mTexelsInGLTexture = getWidth() * getHeight() ;
+	updateCompressionSavings();
+	noteContentsChanged();
 
 	// mark this as bound at this point, so we don't throw it out immediately
 	mLastBindTime = sLastFrameTime;
+
+	add(sUploadedData, F64Bytes(mTextureMemory.value()));
+	add(sMainThreadUploadTime, F64Seconds(upload_timer.getElapsedTimeF64()));
+	return TRUE;
+}
+
+static LLTrace::BlockTimerStatHandle FTM_CREATE_GL_TEXTURE_COMPRESSED("createGLTexture(compressed)");
+BOOL LLImageGL::createGLTextureCompressed(S32 discard_level, const LLImageRaw* imageraw, LLImageDXT* compressed, S32 category)
+{
+	LL_RECORD_BLOCK_TIME(FTM_CREATE_GL_TEXTURE_COMPRESSED);
+	if (gGLManager.mIsDisabled || !gGLManager.mHasCompressedTextures || !gGLManager.mHasTextureCompressionS3TC ||
+		mHasExplicitFormat || mTarget != GL_TEXTURE_2D)
+	{
+		return FALSE;
+	}
+
+	if (!imageraw || imageraw->isBufferInvalid() || !compressed || !compressed->getData() ||
+		compressed->getWidth() != imageraw->getWidth() || compressed->getHeight() != imageraw->getHeight())
+	{
+		return FALSE;
+	}
+
+	LLGLenum format;
+	switch (compressed->getFileFormat())
+	{
+	case LLImageDXT::FORMAT_DXR1:
+		format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		break;
+	case LLImageDXT::FORMAT_DXR5:
+		format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		break;
+	default:
+		return FALSE;
+	}
+
+	if (discard_level < 0)
+	{
+		llassert(mCurrentDiscardLevel >= 0);
+		discard_level = mCurrentDiscardLevel;
+	}
+
+	S32 raw_w = imageraw->getWidth();
+	S32 raw_h = imageraw->getHeight();
+	if (!setSize(raw_w << discard_level, raw_h << discard_level, imageraw->getComponents(), discard_level))
+	{
+		LL_WARNS() << "Trying to create a texture with incorrect dimensions!" << LL_ENDL;
+		return FALSE;
+	}
+	mGLTextureCreated = false;
+	setCategory(category);
+
+	// setImage() can not look at compressed blocks, so the alpha and pick
+	// masks come from the raw pixels before the formats change
+	mFormatPrimary = imageraw->getComponents() == 4 ? GL_RGBA : GL_RGB;
+	mFormatType = GL_UNSIGNED_BYTE;
+	mFormatSwapBytes = FALSE;
+	calcAlphaChannelOffsetAndStride();
+	if (!applyAlphaScan(imageraw))
+	{
+		analyzeAlpha(imageraw->getData(), raw_w, raw_h);
+		updatePickMask(raw_w, raw_h, imageraw->getData());
+	}
+
+	mFormatPrimary = format;
+	mFormatInternal = format;
+
+	// DXR files store the largest mip last, which is what setImage() expects
+	const U8* data = compressed->getData() + compressed->getMipOffset(0);
+	if (!createGLTexture(discard_level, data, TRUE))
+	{
+		return FALSE;
+	}
+
+	// Respecifying the current name in place keeps the memory figure of
+	// the uncompressed texture it replaced
+	S32Bytes bytes = (S32Bytes)getMipBytes(discard_level);
+	if (bytes != mTextureMemory)
+	{
+		sGlobalTextureMemory -= mTextureMemory;
+		disclaimMem(mTextureMemory);
+		mTextureMemory = bytes;
+		claimMem(mTextureMemory);
+		sGlobalTextureMemory += mTextureMemory;
+		updateCompressionSavings();
+	}
+	return TRUE;
+}
+
+void LLImageGL::updateCompressionSavings()
+{
+	S32 bits = 0;
+	if (mTexName != 0 && !mHasExplicitFormat)
+	{
+		switch (mFormatPrimary)
+		{
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+			bits = 4;
+			break;
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			bits = 8;
+			break;
+		default:
+			break;
+		}
+	}
+
+	S32Bytes savings(0);
+	if (bits)
+	{
+		savings = S32Bytes(mTextureMemory.value() / bits * (mComponents * 8 - bits));
+	}
+	sCompressedTextureSavings += savings - mCompressionSavings;
+	mCompressionSavings = savings;
+}
+
+void LLImageGL::noteContentsChanged()
+{
+	if (mCategory == LLGLTexture::BOOST_UI || mCategory == LLGLTexture::BOOST_ICON || mCategory == LLGLTexture::BOOST_PREVIEW)
+	{
+		++sUITextureGeneration;
+	}
+}
+
+bool LLImageGL::canUploadAsync() const
+{
+	if (!LLImageGLThread::sInstance || mTarget != GL_TEXTURE_2D || mFormatSwapBytes)
+	{
+		return false;
+	}
+
+	// Mip generation and core profile format conversion need to happen
+	// where the data is, so those stay on the main thread.
+	if (mUseMipMaps && (!gGLManager.mHasMipMapGeneration || (LLRender::sGLCoreProfile && !glGenerateMipmap)))
+	{
+		return false;
+	}
+	if (LLRender::sGLCoreProfile && (mFormatPrimary == GL_ALPHA || mFormatPrimary == GL_LUMINANCE || mFormatPrimary == GL_LUMINANCE_ALPHA))
+	{
+		return false;
+	}
+	if (mFormatType != GL_UNSIGNED_BYTE)
+	{
+		return false;
+	}
+
+	switch (mFormatPrimary)
+	{
+	case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+	case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+	case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+		return false;
+	default:
+		return true;
+	}
+}
+
+void LLImageGL::queueUpload(S32 discard_level, const LLImageRaw* imageraw)
+{
+	discard_level = llclamp(discard_level, 0, (S32)mMaxDiscardLevel);
+
+	cancelUpload();
+	mUploadPending = true;
+
+	LLImageGLUpload* upload = new LLImageGLUpload();
+	upload->mImage = this;
+	upload->mRawImage = const_cast<LLImageRaw*>(imageraw);
+	upload->mSerial = mUploadSerial;
+	upload->mData = imageraw->getData();
+	upload->mWidth = imageraw->getWidth();
+	upload->mHeight = imageraw->getHeight();
+	upload->mBytes = imageraw->getDataSize();
+	upload->mTarget = mTarget;
+	upload->mFormatInternal = mFormatInternal;
+	upload->mFormatPrimary = mFormatPrimary;
+	upload->mFormatType = mFormatType;
+	upload->mGenerateMips = mUseMipMaps;
+	upload->mMaxLevel = mUseMipMaps ? mMaxDiscardLevel - discard_level : 0;
+	upload->mDiscardLevel = discard_level;
+	upload->mAllowCompression = mAllowCompression;
+
+	// mCurrentDiscardLevel keeps describing mTexName until finishUpload()
+	mUploadDiscardLevel = discard_level;
+	mLastBindTime = sLastFrameTime;
+
+	LLImageGLThread::sInstance->post(upload);
+}
+
+void LLImageGL::cancelUpload()
+{
+	if (mUploadPending)
+	{
+		// The finished texture will be thrown away by finishUpload()
+		mUploadPending = false;
+		++mUploadSerial;
+		mUploadDiscardLevel = -1;
+	}
+}
+
+static LLTrace::BlockTimerStatHandle FTM_FINISH_UPLOAD("finishUpload");
+void LLImageGL::finishUpload(LLImageGLUpload* upload)
+{
+	LL_RECORD_BLOCK_TIME(FTM_FINISH_UPLOAD);
+	if (!mUploadPending || upload->mSerial != mUploadSerial)
+	{
+		if (upload->mTexName)
+		{
+			LLImageGL::deleteTextures(1, &upload->mTexName);
+		}
+		return;
+	}
+	mUploadPending = false;
+
+	if (!upload->mTexName)
+	{
+		// Fall back to creating it here, under a new name
+		mCurrentDiscardLevel = -1;
+		createGLTexture(upload->mDiscardLevel, upload->mRawImage->getData());
+		return;
+	}
+
+	LLTimer upload_timer;
+	U32 old_name = mTexName;
+	mTexName = upload->mTexName;
+	mCurrentDiscardLevel = upload->mDiscardLevel;
+	mHasMipMaps = upload->mGenerateMips;
+	mMipLevels = mHasMipMaps ? wpo2(llmax(upload->mWidth, upload->mHeight)) : 0;
+	if (mHasMipMaps)
+	{
+		mFilterOption = LLTexUnit::TFO_ANISOTROPIC;
+	}
+	mTexOptionsDirty = true;
+	mGLTextureCreated = true;
+
+	if (!applyAlphaScan(upload->mRawImage))
+	{
+		analyzeAlpha(upload->mData, upload->mWidth, upload->mHeight);
+		updatePickMask(upload->mWidth, upload->mHeight, upload->mData);
+	}
+
+	if (old_name != 0)
+	{
+		sGlobalTextureMemory -= mTextureMemory;
+		LLImageGL::deleteTextures(1, &old_name);
+		stop_glerror();
+	}
+
+	disclaimMem(mTextureMemory);
+	mTextureMemory = (S32Bytes)getMipBytes(mCurrentDiscardLevel);
+	claimMem(mTextureMemory);
+	sGlobalTextureMemory += mTextureMemory;
+	updateCompressionSavings();
+	mTexelsInGLTexture = getWidth() * getHeight() ;
+	noteContentsChanged();
+
+	add(sUploadedData, F64Bytes(upload->mBytes));
+	add(sMainThreadUploadTime, F64Seconds(upload_timer.getElapsedTimeF64()));
+}
+
+static LLTrace::BlockTimerStatHandle FTM_SCALE_DOWN("scaleDown");
+BOOL LLImageGL::scaleDown(S32 desired_discard)
+{
+	LL_RECORD_BLOCK_TIME(FTM_SCALE_DOWN);
+	if (mTarget != GL_TEXTURE_2D || mTexName == 0 || mUploadPending || !mHasMipMaps || gGLManager.mIsDisabled)
+	{
+		return FALSE;
+	}
+
+	desired_discard = llmin(desired_discard, (S32)mMaxDiscardLevel);
+	if (desired_discard <= mCurrentDiscardLevel)
+	{
+		return FALSE;
+	}
+
+	S32 first_level = desired_discard - mCurrentDiscardLevel;
+	S32 num_levels = mMaxDiscardLevel - desired_discard + 1;
+
+	GLenum error;
+	while ((error = glGetError()) != GL_NO_ERROR)
+	{
+		LL_WARNS() << "GL Error happens before scaling texture down. Error code: " << error << LL_ENDL;
+	}
+
+	gGL.getTexUnit(0)->unbind(mBindTarget);
+	llverify(gGL.getTexUnit(0)->bindManual(mBindTarget, mTexName));
+
+	LLGLint is_compressed = 0;
+	LLGLint internal_format = mFormatInternal;
+	glGetTexLevelParameteriv(mTarget, first_level, GL_TEXTURE_COMPRESSED, &is_compressed);
+	glGetTexLevelParameteriv(mTarget, first_level, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
+
+	// Sizes of the levels we keep, as the driver actually stores them
+	std::vector<S32> widths, heights, offsets, sizes;
+	S32 total_bytes = 0;
+	for (S32 i = 0; i < num_levels; ++i)
+	{
+		LLGLint w = 0;
+		LLGLint h = 0;
+		glGetTexLevelParameteriv(mTarget, first_level + i, GL_TEXTURE_WIDTH, &w);
+		glGetTexLevelParameteriv(mTarget, first_level + i, GL_TEXTURE_HEIGHT, &h);
+		if (w == 0 || h == 0)
+		{
+			break;
+		}
+
+		LLGLint bytes = 0;
+		if (is_compressed)
+		{
+			glGetTexLevelParameteriv(mTarget, first_level + i, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &bytes);
+		}
+		else
+		{
+			bytes = dataFormatBytes(mFormatPrimary, w, h);
+		}
+		widths.push_back(w);
+		heights.push_back(h);
+		offsets.push_back(total_bytes);
+		sizes.push_back(bytes);
+		total_bytes += (bytes + 3) & ~3;
+	}
+	num_levels = widths.size();
+	if (num_levels == 0 || total_bytes == 0)
+	{
+		gGL.getTexUnit(0)->unbind(mBindTarget);
+		return FALSE;
+	}
+
+	// Go through a buffer object when we can so the copy never leaves the GPU
+	LLGLuint buffer = 0;
+	std::vector<U8> client_data;
+	if (gGLManager.mHasPixelBufferObject)
+	{
+		glGenBuffersARB(1, &buffer);
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER, buffer);
+		glBufferDataARB(GL_PIXEL_PACK_BUFFER, total_bytes, NULL, GL_STREAM_COPY_ARB);
+	}
+	else
+	{
+		client_data.resize(total_bytes);
+	}
+	std::vector<GLvoid*> level_data(num_levels);
+	for (S32 i = 0; i < num_levels; ++i)
+	{
+		level_data[i] = buffer ? (GLvoid*)(size_t)offsets[i] : (GLvoid*)&client_data[offsets[i]];
+	}
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	for (S32 i = 0; i < num_levels; ++i)
+	{
+		if (is_compressed)
+		{
+			glGetCompressedTexImageARB(mTarget, first_level + i, level_data[i]);
+		}
+		else
+		{
+			glGetTexImage(mTarget, first_level + i, mFormatPrimary, mFormatType, level_data[i]);
+		}
+	}
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	if (buffer)
+	{
+		glBindBufferARB(GL_PIXEL_PACK_BUFFER, 0);
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, buffer);
+	}
+
+	U32 new_name = 0;
+	LLImageGL::generateTextures(1, &new_name);
+	gGL.getTexUnit(0)->unbind(mBindTarget);
+	llverify(gGL.getTexUnit(0)->bindManual(mBindTarget, new_name));
+	glTexParameteri(mTarget, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(mTarget, GL_TEXTURE_MAX_LEVEL, num_levels - 1);
+	for (S32 i = 0; i < num_levels; ++i)
+	{
+		if (is_compressed)
+		{
+			glCompressedTexImage2DARB(mTarget, i, internal_format, widths[i], heights[i], 0, sizes[i], level_data[i]);
+		}
+		else
+		{
+			glTexImage2D(mTarget, i, internal_format, widths[i], heights[i], 0, mFormatPrimary, mFormatType, level_data[i]);
+		}
+	}
+
+	if (buffer)
+	{
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, 0);
+		glDeleteBuffersARB(1, &buffer);
+	}
+	gGL.getTexUnit(0)->unbind(mBindTarget);
+
+	if ((error = glGetError()) != GL_NO_ERROR)
+	{
+		LL_WARNS() << "GL error " << error << " scaling texture down to discard " << desired_discard << LL_ENDL;
+		LLImageGL::deleteTextures(1, &new_name);
+		return FALSE;
+	}
+
+	sGlobalTextureMemory -= mTextureMemory;
+	LLImageGL::deleteTextures(1, &mTexName);
+	mTexName = new_name;
+	mCurrentDiscardLevel = desired_discard;
+	mMipLevels = wpo2(llmax(widths[0], heights[0]));
+	mTexOptionsDirty = true;
+
+	disclaimMem(mTextureMemory);
+	mTextureMemory = (S32Bytes)getMipBytes(mCurrentDiscardLevel);
+	claimMem(mTextureMemory);
+	sGlobalTextureMemory += mTextureMemory;
+	updateCompressionSavings();
+	mTexelsInGLTexture = getWidth() * getHeight() ;
 	return TRUE;
 }
 
@@ -1658,6 +2107,7 @@ void LLImageGL::deleteDeadTextures()
 		
 void LLImageGL::destroyGLTexture()
 {
+	cancelUpload();
 	if (mTexName != 0)
 	{
 		if(mTextureMemory != S32Bytes(0))
@@ -1671,6 +2121,7 @@ void LLImageGL::destroyGLTexture()
 		mCurrentDiscardLevel = -1 ; //invalidate mCurrentDiscardLevel.
 		mTexName = 0;		
 		mGLTextureCreated = FALSE ;
+		updateCompressionSavings();
 	}	
 }
 
@@ -1683,6 +2134,7 @@ void LLImageGL::forceToInvalidateGLTexture()
 	}
 	else
 	{
+		cancelUpload();
 		mCurrentDiscardLevel = -1 ; //invalidate mCurrentDiscardLevel.
 	}
 }
@@ -1908,103 +2360,12 @@ void LLImageGL::calcAlphaChannelOffsetAndStride()
 
 void LLImageGL::analyzeAlpha(const void* data_in, U32 w, U32 h)
 {
-	if(sSkipAnalyzeAlpha || !mNeedsAlphaAndPickMask)
+	if(sSkipAnalyzeAlpha || !mNeedsAlphaAndPickMask || mAlphaScanApplied)
 	{
 		return ;
 	}
 
-	U32 length = w * h;
-	U32 alphatotal = 0;
-	
-	U32 sample[16];
-	memset(sample, 0, sizeof(U32)*16);
-
-	// generate histogram of quantized alpha.
-	// also add-in the histogram of a 2x2 box-sampled version.  The idea is
-	// this will mid-skew the data (and thus increase the chances of not
-	// being used as a mask) from high-frequency alpha maps which
-	// suffer the worst from aliasing when used as alpha masks.
-	if (w >= 2 && h >= 2)
-	{
-		llassert(w%2 == 0);
-		llassert(h%2 == 0);
-		const GLubyte* rowstart = ((const GLubyte*) data_in) + mAlphaOffset;
-		for (U32 y = 0; y < h; y+=2)
-		{
-			const GLubyte* current = rowstart;
-			for (U32 x = 0; x < w; x+=2)
-			{
-				const U32 s1 = current[0];
-				alphatotal += s1;
-				const U32 s2 = current[w * mAlphaStride];
-				alphatotal += s2;
-				current += mAlphaStride;
-				const U32 s3 = current[0];
-				alphatotal += s3;
-				const U32 s4 = current[w * mAlphaStride];
-				alphatotal += s4;
-				current += mAlphaStride;
-
-				++sample[s1/16];
-				++sample[s2/16];
-				++sample[s3/16];
-				++sample[s4/16];
-
-				const U32 asum = (s1+s2+s3+s4);
-				alphatotal += asum;
-				sample[asum/(16*4)] += 4;
-			}
-			
-			
-			rowstart += 2 * w * mAlphaStride;
-		}
-		length *= 2; // we sampled everything twice, essentially
-	}
-	else
-	{
-		const GLubyte* current = ((const GLubyte*) data_in) + mAlphaOffset;
-		for (U32 i = 0; i < length; i++)
-		{
-			const U32 s1 = *current;
-			alphatotal += s1;
-			++sample[s1/16];
-			current += mAlphaStride;
-		}
-	}
-	
-	// if more than 1/16th of alpha samples are mid-range, this
-	// shouldn't be treated as a 1-bit mask
-
-	// also, if all of the alpha samples are clumped on one half
-	// of the range (but not at an absolute extreme), then consider
-	// this to be an intentional effect and don't treat as a mask.
-
-	U32 midrangetotal = 0;
-	for (U32 i = 2; i < 13; i++)
-	{
-		midrangetotal += sample[i];
-	}
-	U32 lowerhalftotal = 0;
-	for (U32 i = 0; i < 8; i++)
-	{
-		lowerhalftotal += sample[i];
-	}
-	U32 upperhalftotal = 0;
-	for (U32 i = 8; i < 16; i++)
-	{
-		upperhalftotal += sample[i];
-	}
-
-	if (midrangetotal > length/48 || // lots of midrange, or
-	    (lowerhalftotal == length && alphatotal != 0) || // all close to transparent but not all totally transparent, or
-	    (upperhalftotal == length && alphatotal != 255*length)) // all close to opaque but not all totally opaque
-	{
-		mIsMask = FALSE; // not suitable for masking
-	}
-	else
-	{
-		mIsMask = TRUE;
-	}
+	mIsMask = LLImageRaw::isAlphaMask((const U8*) data_in + mAlphaOffset, w, h, mAlphaStride);
 }
 
 //----------------------------------------------------------------------------
@@ -2013,8 +2374,7 @@ U32 LLImageGL::createPickMask(S32 pWidth, S32 pHeight)
 	U32 pick_width = pWidth/2 + 1;
 	U32 pick_height = pHeight/2 + 1;
 
-	U32 size = pick_width * pick_height;
-	size = (size + 7) / 8; // pixelcount-to-bits
+	U32 size = LLImageRaw::pickMaskSize(pWidth, pHeight);
 	mPickMask = new U8[size];
 	claimMem(size);
 	mPickMaskWidth = pick_width - 1;
@@ -2041,7 +2401,7 @@ void LLImageGL::freePickMask()
 //----------------------------------------------------------------------------
 void LLImageGL::updatePickMask(S32 width, S32 height, const U8* data_in)
 {
-	if(!mNeedsAlphaAndPickMask)
+	if(!mNeedsAlphaAndPickMask || mAlphaScanApplied)
 	{
 		return ;
 	}
@@ -2056,32 +2416,39 @@ void LLImageGL::updatePickMask(S32 width, S32 height, const U8* data_in)
         return;
     }
 
-#ifdef SHOW_ASSERT
-	const U32 pickSize = createPickMask(width, height);
-#else // SHOW_ASSERT
 	createPickMask(width, height);
-#endif // SHOW_ASSERT
+	LLImageRaw::buildPickMask(data_in, width, height, mPickMask);
+}
 
-	U32 pick_bit = 0;
-	
-	for (S32 y = 0; y < height; y += 2)
+// Takes the mask flag and pick mask from LLImageRaw::scanAlpha() instead of
+// reading the pixels again. Returns FALSE if there is no scan or it does not
+// fit this texture's format.
+BOOL LLImageGL::applyAlphaScan(const LLImageRaw* imageraw)
+{
+	const LLImageRaw::AlphaScan* scan = imageraw ? imageraw->getAlphaScan() : NULL;
+	if (!scan)
 	{
-		for (S32 x = 0; x < width; x += 2)
-		{
-			U8 alpha = data_in[(y*width+x)*4+3];
-
-			if (alpha > 32)
-			{
-				U32 pick_idx = pick_bit/8;
-				U32 pick_offset = pick_bit%8;
-				llassert(pick_idx < pickSize);
+		return FALSE;
+	}
+	if (!mNeedsAlphaAndPickMask)
+	{
+		return TRUE;
+	}
+	if (mFormatType != GL_UNSIGNED_BYTE || mAlphaStride != 4 || mAlphaOffset != 3 ||
+		((mFormatPrimary != GL_RGBA) && (mFormatPrimary != GL_SRGB_ALPHA)))
+	{
+		return FALSE;
+	}
 
-				mPickMask[pick_idx] |= 1 << pick_offset;
-			}
-			
-			++pick_bit;
-		}
+	if (!sSkipAnalyzeAlpha)
+	{
+		mIsMask = scan->mIsMask;
 	}
+
+	freePickMask();
+	U32 size = createPickMask(scan->mWidth, scan->mHeight);
+	memcpy(mPickMask, &scan->mPickMask[0], llmin(size, (U32)scan->mPickMask.size()));	/* Flawfinder: ignore */
+	return TRUE;
 }
 
 BOOL LLImageGL::getMask(const LLVector2 &tc)
@@ -38,6 +38,8 @@
 
 #include "llrender.h"
 class LLTextureAtlas ;
+class LLImageDXT;
+struct LLImageGLUpload;
 #define BYTES_TO_MEGA_BYTES(x) ((x) >> 20)
 #define MEGA_BYTES_TO_BYTES(x) ((x) << 20)
 
@@ -104,9 +106,16 @@ public:
 	static void setManualImage(U32 target, S32 miplevel, S32 intformat, S32 width, S32 height, U32 pixformat, U32 pixtype, const void *pixels, bool allow_compression = true);
 
 	BOOL createGLTexture() ;
+	// allow_async lets the texture be created on LLImageGLThread when one is
+	// running; the old GL name stays bound until the upload is finished.
 	BOOL createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename = 0, BOOL to_create = TRUE,
-		S32 category = sMaxCategories-1);
+		S32 category = sMaxCategories-1, bool allow_async = false);
 	BOOL createGLTexture(S32 discard_level, const U8* data, BOOL data_hasmips = FALSE, S32 usename = 0);
+	// Uploads the mips of a DXR1 or DXR5 image made from imageraw by
+	// LLImageDXT::compress(). imageraw is only read for the alpha and pick
+	// masks. Returns FALSE without touching the texture if S3TC can not be used.
+	BOOL createGLTextureCompressed(S32 discard_level, const LLImageRaw* imageraw, LLImageDXT* compressed,
+		S32 category = sMaxCategories-1);
 	void setImage(const LLImageRaw* imageraw);
 	BOOL setImage(const U8* data_in, BOOL data_hasmips = FALSE);
 	BOOL setSubImage(const LLImageRaw* imageraw, S32 x_pos, S32 y_pos, S32 width, S32 height, BOOL force_fast_update = FALSE);
@@ -115,9 +124,20 @@ public:
 	
 	// Read back a raw image for this discard level, if it exists
 	BOOL readBackRaw(S32 discard_level, LLImageRaw* imageraw, bool compressed_ok) const;
+	// Replace the texture with one starting at desired_discard, copied on the
+	// GPU from the mip levels it already has. Returns FALSE if there are none.
+	BOOL scaleDown(S32 desired_discard);
 	void destroyGLTexture();
 	void forceToInvalidateGLTexture();
 
+	bool isUploadPending() const { return mUploadPending; }
+	// Level the texture will be at once a pending upload is in, so it is
+	// not requested again meanwhile. getDiscardLevel() is the level of the
+	// texture that binds now.
+	S32  getUploadDiscardLevel() const { return mUploadPending ? mUploadDiscardLevel : mCurrentDiscardLevel; }
+	// Called by LLImageGLThread on the main thread once the upload's fence has passed
+	void finishUpload(LLImageGLUpload* upload);
+
 	void setExplicitFormat(LLGLint internal_format, LLGLenum primary_format, LLGLenum type_format = 0, BOOL swap_bytes = FALSE);
 	void setComponents(S8 ncomponents) { mComponents = ncomponents; }
 
@@ -153,6 +173,7 @@ public:
 	void setUseMipMaps(BOOL usemips) { mUseMipMaps = usemips; }	
 
 	void updatePickMask(S32 width, S32 height, const U8* data_in);
+	BOOL applyAlphaScan(const LLImageRaw* imageraw);
 	BOOL getMask(const LLVector2 &tc);
 
 	void checkTexSize(bool forced = false) const ;
@@ -192,6 +213,13 @@ private:
 	U32 createPickMask(S32 pWidth, S32 pHeight);
 	void freePickMask();
 
+	bool canUploadAsync() const;
+	void queueUpload(S32 discard_level, const LLImageRaw* imageraw);
+	void cancelUpload();
+	void updateCompressionSavings();
+	// Lets cached UI drawing know a texture it may show has changed
+	void noteContentsChanged();
+
 	LLPointer<LLImageRaw> mSaveData; // used for destroyGL/restoreGL
 	U8* mPickMask;  //downsampled bitmap approximation of alpha channel.  NULL if no alpha channel
 	U16 mPickMaskWidth;
@@ -204,6 +232,7 @@ private:
 	BOOL mNeedsAlphaAndPickMask;
 	S8   mAlphaStride ;
 	S8   mAlphaOffset ;
+	bool mAlphaScanApplied;	// analyzeAlpha() and updatePickMask() are done already
 
 	bool     mGLTextureCreated ;
 	LLGLuint mTexName;
@@ -216,6 +245,11 @@ private:
 	U32      mTexelsInGLTexture;
 
 	bool mAllowCompression;
+	S32Bytes mCompressionSavings;	// memory saved by block compression
+
+	bool mUploadPending;	// a new texture is being created on LLImageGLThread
+	U32  mUploadSerial;		// bumped whenever a pending upload becomes stale
+	S8   mUploadDiscardLevel;	// level of the pending upload
 
 protected:
 	LLGLenum mTarget;		// Normally GL_TEXTURE2D, sometimes something else (ex. cube maps)
@@ -250,12 +284,17 @@ public:
 	static S32Bytes sGlobalTextureMemory;	// Tracks main memory texmem
 	static S32Bytes sBoundTextureMemory;	// Tracks bound texmem for last completed frame
 	static S32Bytes sCurBoundTextureMemory;		// Tracks bound texmem for current frame
+	static S32Bytes sCompressedTextureSavings;	// Tracks texmem saved by block compressed textures
 	static U32 sBindCount;					// Tracks number of texture binds for current frame
 	static U32 sUniqueCount;				// Tracks number of unique texture binds for current frame
 	static BOOL sGlobalUseAnisotropic;
 	static LLImageGL* sDefaultGLTexture ;	
 	static BOOL sAutomatedTest;
 	static bool sCompressTextures;			//use GL texture compression
+	static U32 sUITextureGeneration;		// Bumped when a UI, icon or preview texture gets new contents
+
+	static LLTrace::CountStatHandle<F64Megabytes> sUploadedData;				// texture data sent to GL
+	static LLTrace::CountStatHandle<F64Seconds> sMainThreadUploadTime;		// main thread time spent creating textures
 #if DEBUG_MISS
 	BOOL mMissed; // Missed on last bind?
 	BOOL getMissed() const { return mMissed; };
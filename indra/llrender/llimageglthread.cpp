@@ -0,0 +1,363 @@
+/**
+ * @file llimageglthread.cpp
+ * @brief Texture upload thread with its own shared GL context
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimageglthread.h"
+
+#include "llimage.h"
+#include "llrender.h"
+#include "lltimer.h"
+#include "llwindow.h"
+
+// Size of the pixel unpack ring. Textures larger than half of it are read
+// from client memory instead so one big image can not stall the ring.
+static const U32 STAGING_BUFFER_SIZE = 32 * 1024 * 1024;
+static const U32 STAGING_ALIGNMENT = 256;
+
+LLImageGLThread* LLImageGLThread::sInstance = NULL;
+
+//static
+void LLImageGLThread::initClass(LLWindow* window)
+{
+	if (sInstance || !window)
+	{
+		return;
+	}
+
+	void* context = window->createSharedContext();
+	if (!context)
+	{
+		LL_INFOS() << "No shared GL context, textures will be uploaded on the main thread" << LL_ENDL;
+		return;
+	}
+
+	sInstance = new LLImageGLThread(window, context);
+	sInstance->start();
+	LL_INFOS() << "Started texture upload thread" << LL_ENDL;
+}
+
+//static
+void LLImageGLThread::cleanupClass()
+{
+	if (!sInstance)
+	{
+		return;
+	}
+
+	// The worker drains its queue before it exits
+	sInstance->shutdown();
+	sInstance->finishReady(true);
+
+	sInstance->mWindow->destroySharedContext(sInstance->mContext);
+	delete sInstance;
+	sInstance = NULL;
+}
+
+//static
+void LLImageGLThread::updateClass()
+{
+	if (sInstance)
+	{
+		sInstance->finishReady(false);
+	}
+}
+
+LLImageGLThread::LLImageGLThread(LLWindow* window, void* context)
+:	LLThread("Texture upload"),
+	mWindow(window),
+	mContext(context),
+	mStagingBuffer(0),
+	mStagingMapped(NULL),
+	mStagingHead(0)
+{
+}
+
+LLImageGLThread::~LLImageGLThread()
+{
+	llassert(mQueue.empty() && mDone.empty() && mFenced.empty());
+}
+
+void LLImageGLThread::post(LLImageGLUpload* upload)
+{
+	lockData();
+	mQueue.push_back(upload);
+	wakeLocked();
+	unlockData();
+}
+
+bool LLImageGLThread::runCondition()
+{
+	return !mQueue.empty();
+}
+
+void LLImageGLThread::run()
+{
+	mWindow->makeContextCurrent(mContext);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	createStagingBuffer();
+
+	while (true)
+	{
+		checkPause();
+
+		lockData();
+		if (mQueue.empty())
+		{
+			unlockData();
+			if (isQuitting())
+			{
+				break;
+			}
+			continue;
+		}
+		LLImageGLUpload* upload = mQueue.front();
+		mQueue.pop_front();
+		unlockData();
+
+		this->upload(upload);
+
+		LLMutexLock lock(&mDoneMutex);
+		mDone.push_back(upload);
+	}
+
+	destroyStagingBuffer();
+	glFinish();
+	mWindow->makeContextCurrent(NULL);
+}
+
+void LLImageGLThread::createStagingBuffer()
+{
+	if (!gGLManager.mHasPixelBufferObject || !gGLManager.mHasMapBufferRange)
+	{
+		return;
+	}
+
+#ifdef GL_ARB_map_buffer_range
+	glGenBuffersARB(1, &mStagingBuffer);
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, mStagingBuffer);
+#if !LL_DARWIN
+	if (gGLManager.mHasBufferStorage)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, STAGING_BUFFER_SIZE, NULL, flags);
+		mStagingMapped = (U8*) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, STAGING_BUFFER_SIZE, flags);
+		if (!mStagingMapped)
+		{
+			LL_WARNS() << "Could not map texture staging buffer" << LL_ENDL;
+			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, 0);
+			glDeleteBuffersARB(1, &mStagingBuffer);
+			mStagingBuffer = 0;
+			return;
+		}
+	}
+	else
+#endif
+	{
+		glBufferDataARB(GL_PIXEL_UNPACK_BUFFER, STAGING_BUFFER_SIZE, NULL, GL_STREAM_DRAW_ARB);
+	}
+	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, 0);
+#endif
+}
+
+void LLImageGLThread::destroyStagingBuffer()
+{
+	for (std::deque<RingRange>::iterator iter = mStagingInFlight.begin(); iter != mStagingInFlight.end(); ++iter)
+	{
+		iter->mFence->wait();
+		delete iter->mFence;
+	}
+	mStagingInFlight.clear();
+
+	if (mStagingBuffer)
+	{
+		if (mStagingMapped)
+		{
+			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, mStagingBuffer);
+			glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER);
+			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, 0);
+			mStagingMapped = NULL;
+		}
+		glDeleteBuffersARB(1, &mStagingBuffer);
+		mStagingBuffer = 0;
+	}
+}
+
+S32 LLImageGLThread::reserveStaging(U32 bytes)
+{
+	if (!mStagingBuffer || bytes > STAGING_BUFFER_SIZE / 2)
+	{
+		return -1;
+	}
+
+	U32 begin = (mStagingHead + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+	if (begin + bytes > STAGING_BUFFER_SIZE)
+	{
+		begin = 0;
+	}
+	U32 end = begin + bytes;
+
+	// Wait for any earlier upload still reading this part of the ring, and
+	// retire the ones the GPU is already done with.
+	std::deque<RingRange>::iterator iter = mStagingInFlight.begin();
+	while (iter != mStagingInFlight.end())
+	{
+		bool overlaps = iter->mBegin < end && begin < iter->mEnd;
+		if (overlaps)
+		{
+			iter->mFence->wait();
+		}
+		if (overlaps || iter->mFence->isCompleted())
+		{
+			delete iter->mFence;
+			iter = mStagingInFlight.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	mStagingHead = end;
+	return (S32) begin;
+}
+
+void LLImageGLThread::upload(LLImageGLUpload* upload)
+{
+	LLTimer timer;
+
+	glGenTextures(1, &upload->mTexName);
+	glBindTexture(upload->mTarget, upload->mTexName);
+	glTexParameteri(upload->mTarget, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(upload->mTarget, GL_TEXTURE_MAX_LEVEL, upload->mMaxLevel);
+
+	const void* pixels = upload->mData;
+	S32 offset = reserveStaging(upload->mBytes);
+#ifdef GL_ARB_map_buffer_range
+	if (offset >= 0)
+	{
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, mStagingBuffer);
+		U8* dst = mStagingMapped;
+		if (dst)
+		{
+			dst += offset;
+		}
+		else
+		{
+			dst = (U8*) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, offset, upload->mBytes,
+										 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		}
+
+		if (dst)
+		{
+			memcpy(dst, upload->mData, upload->mBytes);
+			if (!mStagingMapped)
+			{
+				glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER);
+			}
+			pixels = (const void*) (size_t) offset;
+		}
+		else
+		{
+			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, 0);
+			offset = -1;
+		}
+	}
+#endif
+
+	if (upload->mGenerateMips && !LLRender::sGLCoreProfile)
+	{
+		glTexParameteri(upload->mTarget, GL_GENERATE_MIPMAP, GL_TRUE);
+	}
+
+	LLImageGL::setManualImage(upload->mTarget, 0, upload->mFormatInternal, upload->mWidth, upload->mHeight,
+							  upload->mFormatPrimary, upload->mFormatType, pixels, upload->mAllowCompression);
+
+	if (upload->mGenerateMips && LLRender::sGLCoreProfile)
+	{
+		glGenerateMipmap(upload->mTarget);
+	}
+
+	if (offset >= 0)
+	{
+		glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, 0);
+		RingRange range;
+		range.mBegin = offset;
+		range.mEnd = offset + upload->mBytes;
+		range.mFence = new LLGLSyncFence();
+		range.mFence->placeFence();
+		mStagingInFlight.push_back(range);
+	}
+	glBindTexture(upload->mTarget, 0);
+
+	if (glGetError() != GL_NO_ERROR)
+	{
+		LL_WARNS() << "Texture upload failed on the upload thread" << LL_ENDL;
+		glDeleteTextures(1, &upload->mTexName);
+		upload->mTexName = 0;
+	}
+
+	if (gGLManager.mHasSync)
+	{
+		upload->mFence.placeFence();
+		// Make sure the commands reach the GPU before the main context waits on them
+		glFlush();
+	}
+	else
+	{
+		glFinish();
+	}
+
+	upload->mSeconds = timer.getElapsedTimeF64();
+}
+
+void LLImageGLThread::finishReady(bool wait)
+{
+	{
+		LLMutexLock lock(&mDoneMutex);
+		mFenced.insert(mFenced.end(), mDone.begin(), mDone.end());
+		mDone.clear();
+	}
+
+	std::list<LLImageGLUpload*>::iterator iter = mFenced.begin();
+	while (iter != mFenced.end())
+	{
+		LLImageGLUpload* upload = *iter;
+		if (wait)
+		{
+			upload->mFence.wait();
+		}
+		else if (!upload->mFence.isCompleted())
+		{
+			++iter;
+			continue;
+		}
+
+		upload->mImage->finishUpload(upload);
+		delete upload;
+		iter = mFenced.erase(iter);
+	}
+}
@@ -0,0 +1,144 @@
+/**
+ * @file llimageglthread.h
+ * @brief Texture upload thread with its own shared GL context
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEGLTHREAD_H
+#define LL_LLIMAGEGLTHREAD_H
+
+#include "llthread.h"
+#include "llmutex.h"
+#include "llgl.h"
+#include "llimagegl.h"
+
+#include <deque>
+#include <list>
+
+class LLImageRaw;
+class LLWindow;
+
+//============================================================================
+// One texture handed to the upload thread.
+//
+// The image and raw data are referenced from the main thread only; the
+// worker reads the plain fields below and fills in the results.
+struct LLImageGLUpload
+{
+	LLImageGLUpload()
+	:	mSerial(0), mData(NULL), mWidth(0), mHeight(0), mBytes(0), mTarget(0),
+		mFormatInternal(0), mFormatPrimary(0), mFormatType(0), mMaxLevel(0),
+		mDiscardLevel(0), mGenerateMips(false), mAllowCompression(true),
+		mTexName(0), mSeconds(0.0)
+	{}
+
+	LLPointer<LLImageGL>		mImage;
+	LLPointer<LLImageRaw>		mRawImage;	// must not be modified until the upload is finished
+	U32							mSerial;	// LLImageGL::mUploadSerial when queued
+
+	const U8*	mData;
+	S32			mWidth;
+	S32			mHeight;
+	S32			mBytes;
+	LLGLenum	mTarget;
+	LLGLint		mFormatInternal;
+	LLGLenum	mFormatPrimary;
+	LLGLenum	mFormatType;
+	S32			mMaxLevel;
+	S32			mDiscardLevel;
+	bool		mGenerateMips;
+	bool		mAllowCompression;
+
+	// Written by the upload thread
+	LLGLuint		mTexName;	// 0 if the upload failed
+	LLGLSyncFence	mFence;		// signaled when the texture may be used from the main context
+	F64				mSeconds;
+};
+
+//============================================================================
+// Creates textures on a second GL context shared with the window's.
+//
+// Decoded pixels are copied into a ring of pixel unpack buffers (persistently
+// mapped when GL_ARB_buffer_storage is available) and the texture image calls
+// are made from the worker, so the main thread never waits on the driver
+// copy. Finished textures are fenced; updateClass() hands them back to their
+// LLImageGL once the fence has passed, which only swaps the GL name in.
+class LLImageGLThread : public LLThread
+{
+public:
+	// Creates the shared context on the main thread. Does nothing if the
+	// window can not provide one; uploads then stay synchronous.
+	static void initClass(LLWindow* window);
+	// Blocks until every queued upload is finished and handed back.
+	static void cleanupClass();
+	// Call once a frame from the main thread.
+	static void updateClass();
+
+	static LLImageGLThread* sInstance;
+
+	void post(LLImageGLUpload* upload);
+
+protected:
+	LLImageGLThread(LLWindow* window, void* context);
+	virtual ~LLImageGLThread();
+
+	/*virtual*/ void run();
+	/*virtual*/ bool runCondition();
+
+private:
+	struct RingRange
+	{
+		U32				mBegin;
+		U32				mEnd;
+		LLGLSyncFence*	mFence;
+	};
+
+	void createStagingBuffer();
+	void destroyStagingBuffer();
+	// Returns the ring offset to stage bytes at, or -1 if the
+	// upload should read client memory instead.
+	S32 reserveStaging(U32 bytes);
+	void upload(LLImageGLUpload* upload);
+	void finishReady(bool wait);
+
+	LLWindow*	mWindow;
+	void*		mContext;
+
+	// Guarded by mDataLock
+	std::deque<LLImageGLUpload*> mQueue;
+
+	// Written by the worker, drained by the main thread
+	LLMutex								mDoneMutex;
+	std::vector<LLImageGLUpload*>		mDone;
+
+	// Main thread only
+	std::list<LLImageGLUpload*>			mFenced;
+
+	// Worker only
+	LLGLuint				mStagingBuffer;
+	U8*						mStagingMapped;	// persistent mapping, or NULL
+	U32						mStagingHead;
+	std::deque<RingRange>	mStagingInFlight;
+};
+
+#endif // LL_LLIMAGEGLTHREAD_H
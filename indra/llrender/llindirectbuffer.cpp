@@ -0,0 +1,135 @@
+/** 
+ * @file llindirectbuffer.cpp
+ * @brief LLIndirectBuffer implementation
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llindirectbuffer.h"
+#include "llglheaders.h"
+#include "llgl.h"
+
+U32 LLIndirectBuffer::sGLBound = 0;
+
+LLIndirectBuffer::LLIndirectBuffer()
+:	mGLBuffer(0),
+	mCapacity(0),
+	mDirtyStart(0),
+	mDirtyEnd(0)
+{
+}
+
+LLIndirectBuffer::~LLIndirectBuffer()
+{
+	if (mGLBuffer)
+	{
+		if (sGLBound == mGLBuffer)
+		{
+			sGLBound = 0;
+		}
+		glDeleteBuffersARB(1, &mGLBuffer);
+		mGLBuffer = 0;
+	}
+}
+
+void LLIndirectBuffer::setCommands(const command_list_t& commands)
+{
+	U32 count = commands.size();
+	U32 first = 0;
+	U32 last = count;
+
+	if (count == mCommands.size())
+	{ //only the changed span needs to go back to GL
+		while (first < count && !memcmp(&commands[first], &mCommands[first], sizeof(Command)))
+		{
+			++first;
+		}
+		while (last > first && !memcmp(&commands[last-1], &mCommands[last-1], sizeof(Command)))
+		{
+			--last;
+		}
+		if (first == last)
+		{
+			return;
+		}
+	}
+
+	mCommands = commands;
+
+	if (mDirtyStart < mDirtyEnd)
+	{
+		first = llmin(first, mDirtyStart);
+		last = llmax(last, mDirtyEnd);
+	}
+	mDirtyStart = first;
+	mDirtyEnd = llmin(last, count);
+}
+
+bool LLIndirectBuffer::bind()
+{
+	if (mCommands.empty())
+	{
+		return false;
+	}
+
+	if (!mGLBuffer)
+	{
+		glGenBuffersARB(1, &mGLBuffer);
+	}
+
+	if (sGLBound != mGLBuffer)
+	{
+		glBindBufferARB(GL_DRAW_INDIRECT_BUFFER, mGLBuffer);
+		sGLBound = mGLBuffer;
+	}
+
+	flush();
+	return true;
+}
+
+//static
+void LLIndirectBuffer::unbind()
+{
+	if (sGLBound)
+	{
+		glBindBufferARB(GL_DRAW_INDIRECT_BUFFER, 0);
+		sGLBound = 0;
+	}
+}
+
+void LLIndirectBuffer::flush()
+{
+	U32 count = mCommands.size();
+	if (count > mCapacity)
+	{ //grow, uploading everything
+		glBufferDataARB(GL_DRAW_INDIRECT_BUFFER, count * sizeof(Command), &mCommands[0], GL_STATIC_DRAW_ARB);
+		mCapacity = count;
+	}
+	else if (mDirtyStart < mDirtyEnd)
+	{
+		glBufferSubDataARB(GL_DRAW_INDIRECT_BUFFER, mDirtyStart * sizeof(Command),
+							(mDirtyEnd - mDirtyStart) * sizeof(Command), &mCommands[mDirtyStart]);
+	}
+	mDirtyStart = mDirtyEnd = 0;
+}
@@ -0,0 +1,80 @@
+/** 
+ * @file llindirectbuffer.h
+ * @brief LLIndirectBuffer wrapper for GL draw indirect command buffers
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINDIRECTBUFFER_H
+#define LL_LLINDIRECTBUFFER_H
+
+#include "llrefcount.h"
+#include <vector>
+
+//============================================================================
+// Command list for glMultiDrawElementsIndirect.
+//
+// Commands are kept on the CPU and uploaded lazily on bind(), so they may be
+// set from anywhere on the main thread. Only the span of commands that
+// changed since the last upload is sent to GL; the buffer is reallocated
+// only when it has to grow.
+class LLIndirectBuffer : public LLRefCount
+{
+public:
+	// Matches the GL DrawElementsIndirectCommand layout.
+	struct Command
+	{
+		U32 mCount;
+		U32 mInstanceCount;
+		U32 mFirstIndex;
+		S32 mBaseVertex;
+		U32 mBaseInstance;
+	};
+	typedef std::vector<Command> command_list_t;
+
+	LLIndirectBuffer();
+
+	void setCommands(const command_list_t& commands);
+	const command_list_t& getCommands() const	{ return mCommands; }
+	U32 getNumCommands() const					{ return mCommands.size(); }
+
+	// Make this the bound GL_DRAW_INDIRECT_BUFFER, uploading any pending
+	// commands first. Returns false if there is nothing to draw.
+	bool bind();
+
+	static void unbind();
+
+protected:
+	~LLIndirectBuffer();
+
+	void flush();
+
+	command_list_t mCommands;
+	U32 mGLBuffer;
+	U32 mCapacity;		// commands allocated in mGLBuffer
+	U32 mDirtyStart;	// [mDirtyStart, mDirtyEnd) needs uploading
+	U32 mDirtyEnd;
+
+	static U32 sGLBound;
+};
+
+#endif // LL_LLINDIRECTBUFFER_H
@@ -1112,6 +1112,7 @@ LLRender::LLRender()
 	mCurrBlendAlphaSFactor = BF_UNDEF;
 	mCurrBlendColorDFactor = BF_UNDEF;
 	mCurrBlendAlphaDFactor = BF_UNDEF;
+	mAccumulateAlpha = false;
 
 	mMatrixMode = LLRender::MM_MODELVIEW;
 	
@@ -1144,7 +1145,8 @@ void LLRender::init()
 
 	llassert_always(mBuffer.isNull()) ;
 	stop_glerror();
-	mBuffer = new LLVertexBuffer(immediate_mask, 0);
+	//rewritten from the start on every flush, so it can be drawn from the stream ring
+	mBuffer = new LLVertexBuffer(immediate_mask, 0, true);
 	mBuffer->allocateBuffer(4096, 0, TRUE);
 	mBuffer->getVertexStrider(mVerticesp);
 	mBuffer->getTexCoord0Strider(mTexcoordsp);
@@ -1772,6 +1774,11 @@ void LLRender::blendFunc(eBlendFactor sfactor, eBlendFactor dfactor)
 {
 	llassert(sfactor < BF_UNDEF);
 	llassert(dfactor < BF_UNDEF);
+	if (mAccumulateAlpha)
+	{
+		blendFunc(sfactor, dfactor, BF_ONE, BF_ONE_MINUS_SOURCE_ALPHA);
+		return;
+	}
 	if (mCurrBlendColorSFactor != sfactor || mCurrBlendColorDFactor != dfactor ||
 	    mCurrBlendAlphaSFactor != sfactor || mCurrBlendAlphaDFactor != dfactor)
 	{
@@ -1810,6 +1817,19 @@ void LLRender::blendFunc(eBlendFactor color_sfactor, eBlendFactor color_dfactor,
 	}
 }
 
+void LLRender::setAccumulateAlpha(bool accumulate)
+{
+	accumulate = accumulate && gGLManager.mHasBlendFuncSeparate;
+	if (mAccumulateAlpha != accumulate)
+	{
+		mAccumulateAlpha = accumulate;
+		if (mCurrBlendColorSFactor != BF_UNDEF)
+		{ // reapply the current color blend with the new alpha blend
+			blendFunc(mCurrBlendColorSFactor, mCurrBlendColorDFactor);
+		}
+	}
+}
+
 LLTexUnit* LLRender::getTexUnit(U32 index)
 {
 	if (index < mTexUnits.size())
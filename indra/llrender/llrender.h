@@ -428,6 +428,7 @@ public:
 
 	void setColorMask(bool writeColor, bool writeAlpha);
 	void setColorMask(bool writeColorR, bool writeColorG, bool writeColorB, bool writeAlpha);
+	bool getAlphaMask() const { return mCurrColorMask[3]; }
 	void setSceneBlendType(eBlendType type);
 
 	void setAlphaRejectSettings(eCompareFunc func, F32 value = 0.01f);
@@ -438,6 +439,12 @@ public:
 	void blendFunc(eBlendFactor color_sfactor, eBlendFactor color_dfactor,
 		       eBlendFactor alpha_sfactor, eBlendFactor alpha_dfactor);
 
+	// While set, the single blend func above keeps alpha as coverage
+	// (source + dest * (1 - source alpha)), so an offscreen target drawn
+	// this way holds premultiplied color and can be composited later with
+	// blendFunc(BF_ONE, BF_ONE_MINUS_SOURCE_ALPHA).
+	void setAccumulateAlpha(bool accumulate);
+
 	LLLightState* getLight(U32 index);
 	void setAmbientLightColor(const LLColor4& color);
 	
@@ -496,6 +503,7 @@ private:
 	eBlendFactor mCurrBlendColorDFactor;
 	eBlendFactor mCurrBlendAlphaSFactor;
 	eBlendFactor mCurrBlendAlphaDFactor;
+	bool		mAccumulateAlpha;
 
 	F32				mMaxAnisotropy;
 
@@ -0,0 +1,181 @@
+/**
+ * @file llrendertargetpool.cpp
+ * @brief Pool of transient render targets shared between render passes
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llrendertargetpool.h"
+
+// Frames a target may sit unused before it is freed. Long enough that
+// a pass that skips a frame now and then does not reallocate.
+static const U32 IDLE_FRAMES = 8;
+
+static U32 estimate_bytes(U32 resx, U32 resy, U32 color_fmt, bool depth)
+{
+	U32 bytes_per_pixel = 0;
+	switch (color_fmt)
+	{
+	case 0:
+		break;
+	case GL_RGBA16:
+	case GL_RGBA16F_ARB:
+		bytes_per_pixel = 8;
+		break;
+	case GL_RGBA12:
+		bytes_per_pixel = 6;
+		break;
+	default:
+		bytes_per_pixel = 4;
+		break;
+	}
+	if (depth)
+	{
+		bytes_per_pixel += 4;
+	}
+	return resx * resy * bytes_per_pixel;
+}
+
+LLRenderTargetPool::LLRenderTargetPool()
+:	mFrame(0),
+	mBytesAllocated(0)
+{
+}
+
+LLRenderTargetPool::~LLRenderTargetPool()
+{
+	while (!mTargets.empty())
+	{
+		freeEntry(mTargets.size() - 1);
+	}
+}
+
+LLRenderTarget* LLRenderTargetPool::acquire(U32 resx, U32 resy, U32 color_fmt, bool depth, bool stencil,
+											LLTexUnit::eTextureType usage, bool use_fbo)
+{
+	for (U32 i = 0; i < mTargets.size(); ++i)
+	{
+		Entry& entry = mTargets[i];
+		if (!entry.mHeld &&
+			entry.mResX == resx && entry.mResY == resy &&
+			entry.mColorFormat == color_fmt &&
+			entry.mDepth == depth && entry.mStencil == stencil &&
+			entry.mUsage == usage && entry.mUseFBO == use_fbo)
+		{
+			entry.mHeld = true;
+			entry.mLastFrame = mFrame;
+			return entry.mTarget;
+		}
+	}
+
+	LLRenderTarget* target = new LLRenderTarget();
+	if (!target->allocate(resx, resy, color_fmt, depth, stencil, usage, use_fbo))
+	{
+		LL_WARNS() << "Could not allocate " << resx << "x" << resy << " render target" << LL_ENDL;
+		delete target;
+		return NULL;
+	}
+
+	Entry entry;
+	entry.mTarget = target;
+	entry.mResX = resx;
+	entry.mResY = resy;
+	entry.mColorFormat = color_fmt;
+	entry.mDepth = depth;
+	entry.mStencil = stencil;
+	entry.mUseFBO = use_fbo;
+	entry.mUsage = usage;
+	entry.mHeld = true;
+	entry.mLastFrame = mFrame;
+	entry.mBytes = estimate_bytes(resx, resy, color_fmt, depth);
+	mTargets.push_back(entry);
+	mBytesAllocated += entry.mBytes;
+
+	return target;
+}
+
+void LLRenderTargetPool::release(LLRenderTarget* target)
+{
+	if (!target)
+	{
+		return;
+	}
+
+	for (U32 i = 0; i < mTargets.size(); ++i)
+	{
+		if (mTargets[i].mTarget == target)
+		{
+			llassert(mTargets[i].mHeld);
+			mTargets[i].mHeld = false;
+			return;
+		}
+	}
+
+	LL_WARNS() << "Released a render target that is not from this pool" << LL_ENDL;
+}
+
+void LLRenderTargetPool::nextFrame()
+{
+	++mFrame;
+
+	U32 i = 0;
+	while (i < mTargets.size())
+	{
+		if (!mTargets[i].mHeld && mFrame - mTargets[i].mLastFrame > IDLE_FRAMES)
+		{
+			freeEntry(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void LLRenderTargetPool::flush()
+{
+	U32 i = 0;
+	while (i < mTargets.size())
+	{
+		if (!mTargets[i].mHeld)
+		{
+			freeEntry(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void LLRenderTargetPool::freeEntry(U32 index)
+{
+	Entry& entry = mTargets[index];
+	llassert(!entry.mHeld);
+	mBytesAllocated -= entry.mBytes;
+	delete entry.mTarget;
+
+	mTargets[index] = mTargets.back();
+	mTargets.pop_back();
+}
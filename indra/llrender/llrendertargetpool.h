@@ -0,0 +1,91 @@
+/**
+ * @file llrendertargetpool.h
+ * @brief Pool of transient render targets shared between render passes
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLRENDERTARGETPOOL_H
+#define LL_LLRENDERTARGETPOOL_H
+
+#include "llrendertarget.h"
+
+#include <vector>
+
+//============================================================================
+// Hands out render targets that are only needed for part of a frame.
+//
+// Targets are matched by resolution, color format, depth, stencil and usage.
+// Once a pass gives its target back, the next pass asking for the same
+// description gets the same GL objects, so passes whose targets are never
+// alive at the same time share memory. Targets that nobody asked for in
+// the last few frames are freed, so a pass that stops running (a debug
+// view, an effect turned off) gives its memory back without any cleanup of
+// its own, and a resize only reallocates what is still in use.
+class LLRenderTargetPool
+{
+public:
+	LLRenderTargetPool();
+	~LLRenderTargetPool();
+
+	// Returns an allocated target that nobody else holds, or NULL if the
+	// allocation failed. Contents are undefined.
+	LLRenderTarget* acquire(U32 resx, U32 resy, U32 color_fmt, bool depth, bool stencil,
+							LLTexUnit::eTextureType usage = LLTexUnit::TT_TEXTURE, bool use_fbo = false);
+
+	// Gives a target from acquire() back. Safe to call with NULL.
+	void release(LLRenderTarget* target);
+
+	// Call once a frame. Frees targets idle for a few frames.
+	void nextFrame();
+
+	// Frees every target that is not held, e.g. when the screen is resized.
+	void flush();
+
+	// Estimated GL memory of every target in the pool, held or not
+	U32 getBytesAllocated() const { return mBytesAllocated; }
+	U32 getTargetCount() const { return mTargets.size(); }
+
+private:
+	struct Entry
+	{
+		LLRenderTarget*			mTarget;
+		U32						mResX;
+		U32						mResY;
+		U32						mColorFormat;
+		bool					mDepth;
+		bool					mStencil;
+		bool					mUseFBO;
+		LLTexUnit::eTextureType	mUsage;
+		bool					mHeld;
+		U32						mLastFrame;	// mFrame when last acquired
+		U32						mBytes;
+	};
+
+	void freeEntry(U32 index);
+
+	std::vector<Entry>	mTargets;
+	U32					mFrame;
+	U32					mBytesAllocated;
+};
+
+#endif // LL_LLRENDERTARGETPOOL_H
@@ -27,7 +27,11 @@
 #include "linden_common.h"
 #include "llshadermgr.h"
 #include "llrender.h"
+#include "lldir.h"
 #include "llfile.h"
+#include "llmd5.h"
+
+#include <algorithm>
 
 #if LL_DARWIN
 #include "OpenGL/OpenGL.h"
@@ -41,7 +45,32 @@ using std::string;
 
 LLShaderMgr * LLShaderMgr::sInstance = NULL;
 
+// we can't have any lines longer than 1024 characters 
+// or any shaders longer than 4096 lines... deal - DaveP
+const U32 MAX_EXTRA_CODE_LINES = 1024;
+const U32 MAX_SHADER_CODE_LINES = 4096 + MAX_EXTRA_CODE_LINES;
+
+// Program cache files start with this header, followed by the binary.
+const U32 PROGRAM_CACHE_MAGIC = 0x42505f4c;	// "L_PB"
+const U32 PROGRAM_CACHE_VERSION = 1;
+const U32 PROGRAM_CACHE_MAX_SIZE = 64 * 1024 * 1024;
+
+struct ProgramCacheHeader
+{
+	U32 mMagic;
+	U32 mVersion;
+	S32 mShaderLevel;
+	U32 mFormat;
+	U32 mSize;
+};
+
 LLShaderMgr::LLShaderMgr()
+:	mProgramsCompiled(0),
+	mProgramsFromCache(0),
+	mProgramCompileSeconds(0.0),
+	mProgramCacheSeconds(0.0),
+	mBatchingShaders(false),
+	mShaderBatchFailed(false)
 {
 }
 
@@ -599,40 +628,23 @@ void LLShaderMgr::dumpObjectLog(GLhandleARB ret, BOOL warns, const std::string&
 	}
  }
 
-GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_level, GLenum type, boost::unordered_map<std::string, std::string>* defines, S32 texture_index_channels)
+static void hash_shader_source(LLMD5& hash, GLenum type, GLuint shader_code_count, GLcharARB** shader_code_text)
 {
-
-// endsure work-around for missing GLSL funcs gets propogated to feature shader files (e.g. srgbF.glsl)
-#if LL_DARWIN
-    if (defines)
-    {
-        (*defines)["OLD_SELECT"] = "1";
-    }
-#endif
-
-	GLenum error = GL_NO_ERROR;
-	if (gDebugGL)
-	{
-		error = glGetError();
-		if (error != GL_NO_ERROR)
-		{
-			LL_SHADER_LOADING_WARNS() << "GL ERROR entering loadShaderFile(): " << error << LL_ENDL;
-		}
-	}
-	
-	if (filename.empty()) 
+	hash.update(llformat("type %d\n", type));
+	for (GLuint i = 0; i < shader_code_count; i++)
 	{
-		return 0;
+		hash.update((const unsigned char*) shader_code_text[i], (U32) strlen(shader_code_text[i]));
 	}
+}
 
+GLuint LLShaderMgr::readShaderSource(const std::string& filename, S32 shader_level, GLenum type, boost::unordered_map<std::string, std::string>* defines, S32 texture_index_channels, GLcharARB** shader_code_text, std::string& open_file_name)
+{
 
-	//read in from file
 	LLFILE* file = NULL;
 
 	S32 try_gpu_class = shader_level;
 	S32 gpu_class;
 
-    std::string open_file_name;
 	//find the most relevant file
 	for (gpu_class = try_gpu_class; gpu_class > 0; gpu_class--)
 	{	//search from the current gpu class down to class 1 to find the most relevant shader
@@ -670,13 +682,10 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 		return 0;
 	}
 
-	//we can't have any lines longer than 1024 characters 
-	//or any shaders longer than 4096 lines... deal - DaveP
     GLcharARB buff[1024];
-    GLcharARB *extra_code_text[1024];
-    GLcharARB *shader_code_text[4096 + LL_ARRAY_SIZE(extra_code_text)] = { NULL };
+    GLcharARB *extra_code_text[MAX_EXTRA_CODE_LINES];
     GLuint extra_code_count = 0, shader_code_count = 0;
-    BOOST_STATIC_ASSERT(LL_ARRAY_SIZE(extra_code_text) < LL_ARRAY_SIZE(shader_code_text));
+    BOOST_STATIC_ASSERT(MAX_EXTRA_CODE_LINES < MAX_SHADER_CODE_LINES);
     
     
 	S32 major_version = gGLManager.mGLSLVersionMajor;
@@ -894,7 +903,7 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 	GLuint out_of_extra_block_counter = 0, start_shader_code = shader_code_count, file_lines_count = 0;
 	
 	while(NULL != fgets((char *)buff, 1024, file)
-		  && shader_code_count < (LL_ARRAY_SIZE(shader_code_text) - LL_ARRAY_SIZE(extra_code_text)))
+		  && shader_code_count < (MAX_SHADER_CODE_LINES - MAX_EXTRA_CODE_LINES))
 	{
 		file_lines_count++;
 
@@ -916,7 +925,7 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 		  
 			//copy extra code
 			for(GLuint n = 0; n < extra_code_count
-				&& shader_code_count < (LL_ARRAY_SIZE(shader_code_text) - LL_ARRAY_SIZE(extra_code_text)); ++n)
+				&& shader_code_count < (MAX_SHADER_CODE_LINES - MAX_EXTRA_CODE_LINES); ++n)
 			{
 				shader_code_text[shader_code_count++] = extra_code_text[n];
 			}
@@ -964,6 +973,43 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 
 	fclose(file);
 
+	return shader_code_count;
+}
+
+GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shader_level, GLenum type, boost::unordered_map<std::string, std::string>* defines, S32 texture_index_channels, BOOL defer_status)
+{
+
+// endsure work-around for missing GLSL funcs gets propogated to feature shader files (e.g. srgbF.glsl)
+#if LL_DARWIN
+    if (defines)
+    {
+        (*defines)["OLD_SELECT"] = "1";
+    }
+#endif
+
+	GLenum error = GL_NO_ERROR;
+	if (gDebugGL)
+	{
+		error = glGetError();
+		if (error != GL_NO_ERROR)
+		{
+			LL_SHADER_LOADING_WARNS() << "GL ERROR entering loadShaderFile(): " << error << LL_ENDL;
+		}
+	}
+	
+	if (filename.empty()) 
+	{
+		return 0;
+	}
+
+	std::string open_file_name;
+	GLcharARB *shader_code_text[MAX_SHADER_CODE_LINES] = { NULL };
+	GLuint shader_code_count = readShaderSource(filename, shader_level, type, defines, texture_index_channels, shader_code_text, open_file_name);
+	if (!shader_code_count)
+	{
+		return 0;
+	}
+
 	//create shader object
 	GLhandleARB ret = glCreateShaderObjectARB(type);
 	if (gDebugGL)
@@ -1001,9 +1047,12 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 		
 	if (error == GL_NO_ERROR)
 	{
-		//check for errors
+		//check for errors, a deferred caller reads the status later with isShaderCompiled
 		GLint success = GL_TRUE;
-		glGetObjectParameterivARB(ret, GL_OBJECT_COMPILE_STATUS_ARB, &success);
+		if (!defer_status)
+		{
+			glGetObjectParameterivARB(ret, GL_OBJECT_COMPILE_STATUS_ARB, &success);
+		}
 		if (gDebugGL || success == GL_FALSE)
 		{
 			error = glGetError();
@@ -1023,6 +1072,16 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 	}
 	stop_glerror();
 
+	if (ret)
+	{
+		LLMD5 hash;
+		hash_shader_source(hash, type, shader_code_count, shader_code_text);
+		hash.finalize();
+		char digest[33];
+		hash.hex_digest(digest);
+		mShaderObjectHashes[ret] = digest;
+	}
+
 	//free memory
 	for (GLuint i = 0; i < shader_code_count; i++)
 	{
@@ -1039,7 +1098,6 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
         else if (type == GL_FRAGMENT_SHADER_ARB) {
             mFragmentShaderObjects[filename] = ret;
         }
-		shader_level = try_gpu_class;
 	}
 	else
 	{
@@ -1053,10 +1111,214 @@ GLhandleARB LLShaderMgr::loadShaderFile(const std::string& filename, S32 & shade
 	return ret;
 }
 
+//============================================================================
+// Program binary cache
+
+std::string LLShaderMgr::getProgramCacheKey(const LLGLSLShader* shader, S32 texture_index_channels, U32 varying_count, const char** varyings)
+{
+	if (mProgramCacheDir.empty() || !gGLManager.mHasProgramBinary)
+	{
+		return std::string();
+	}
+
+	LLMD5 hash;
+	hash.update(llformat("version %d\n", PROGRAM_CACHE_VERSION));
+	// binaries only load on the driver that made them
+	hash.update(gGLManager.mGLVendor + "\n" + gGLManager.mGLRenderer + "\n" + gGLManager.mGLVersionString + "\n");
+
+	// the program's own stages, preprocessed the way loadShaderFile will
+	boost::unordered_map<std::string, std::string> defines(shader->mDefines);
+	for (vector< pair<string, GLenum> >::const_iterator iter = shader->mShaderFiles.begin(); iter != shader->mShaderFiles.end(); ++iter)
+	{
+		std::string open_file_name;
+		GLcharARB *shader_code_text[MAX_SHADER_CODE_LINES] = { NULL };
+		GLuint shader_code_count = readShaderSource(iter->first, shader->mShaderLevel, iter->second, &defines, texture_index_channels, shader_code_text, open_file_name);
+		if (!shader_code_count)
+		{
+			return std::string();
+		}
+		hash_shader_source(hash, iter->second, shader_code_count, shader_code_text);
+		for (GLuint i = 0; i < shader_code_count; i++)
+		{
+			free(shader_code_text[i]);
+		}
+	}
+
+	// the shared feature objects attachShaderFeatures picked
+	GLhandleARB obj[1024];
+	GLsizei count = 0;
+	glGetAttachedObjectsARB(shader->mProgramObject, 1024, &count, obj);
+	std::vector<std::string> object_hashes;
+	for (GLsizei i = 0; i < count; i++)
+	{
+		std::map<GLhandleARB, std::string>::const_iterator found = mShaderObjectHashes.find(obj[i]);
+		if (found == mShaderObjectHashes.end())
+		{
+			return std::string();
+		}
+		object_hashes.push_back(found->second);
+	}
+	std::sort(object_hashes.begin(), object_hashes.end());
+	for (U32 i = 0; i < object_hashes.size(); i++)
+	{
+		hash.update(object_hashes[i] + "\n");
+	}
+
+	std::vector<pair<string, string> > sorted_defines(defines.begin(), defines.end());
+	std::sort(sorted_defines.begin(), sorted_defines.end());
+	for (U32 i = 0; i < sorted_defines.size(); i++)
+	{
+		hash.update("define " + sorted_defines[i].first + " " + sorted_defines[i].second + "\n");
+	}
+	hash.update(llformat("channels %d\n", texture_index_channels));
+
+	// attribute locations and transform feedback are fixed at link time
+	for (U32 i = 0; i < mReservedAttribs.size(); i++)
+	{
+		hash.update("attrib " + mReservedAttribs[i] + "\n");
+	}
+	for (U32 i = 0; i < varying_count; i++)
+	{
+		hash.update(std::string("varying ") + varyings[i] + "\n");
+	}
+
+	hash.finalize();
+	char digest[33];
+	hash.hex_digest(digest);
+	return std::string(digest);
+}
+
+BOOL LLShaderMgr::loadProgramBinary(LLGLSLShader* shader, const std::string& key)
+{
+#if LL_DARWIN
+	return FALSE;
+#else
+	std::string filename = gDirUtilp->add(mProgramCacheDir, key + ".bin");
+	LLFILE* file = LLFile::fopen(filename, "rb");
+	if (!file)
+	{
+		return FALSE;
+	}
+
+	ProgramCacheHeader header;
+	std::vector<U8> binary;
+	bool valid = fread(&header, sizeof(header), 1, file) == 1
+				 && header.mMagic == PROGRAM_CACHE_MAGIC
+				 && header.mVersion == PROGRAM_CACHE_VERSION
+				 && header.mSize > 0
+				 && header.mSize <= PROGRAM_CACHE_MAX_SIZE;
+	if (valid)
+	{
+		binary.resize(header.mSize);
+		valid = fread(&binary[0], 1, header.mSize, file) == header.mSize;
+	}
+	fclose(file);
+
+	GLint success = GL_FALSE;
+	if (valid)
+	{
+		stop_glerror();
+		glProgramBinary(shader->mProgramObject, header.mFormat, &binary[0], header.mSize);
+		glGetObjectParameterivARB(shader->mProgramObject, GL_OBJECT_LINK_STATUS_ARB, &success);
+		// a rejected binary raises an error on some drivers, it is not one here
+		glGetError();
+	}
+
+	if (success == GL_FALSE)
+	{
+		// driver update or corrupt file, the caller compiles and replaces it
+		LL_DEBUGS("ShaderLoading") << "Discarding cached program for " << shader->mName << LL_ENDL;
+		LLFile::remove(filename);
+		return FALSE;
+	}
+
+	shader->mShaderLevel = header.mShaderLevel;
+	return TRUE;
+#endif
+}
+
+void LLShaderMgr::saveProgramBinary(const LLGLSLShader* shader, const std::string& key)
+{
+#if !LL_DARWIN
+	GLint length = 0;
+	glGetObjectParameterivARB(shader->mProgramObject, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0 || (U32) length > PROGRAM_CACHE_MAX_SIZE)
+	{
+		glGetError();
+		return;
+	}
+
+	std::vector<U8> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(shader->mProgramObject, length, &length, &format, &binary[0]);
+	if (glGetError() != GL_NO_ERROR || length <= 0)
+	{
+		return;
+	}
+
+	LLFile::mkdir(mProgramCacheDir);
+
+	ProgramCacheHeader header;
+	header.mMagic = PROGRAM_CACHE_MAGIC;
+	header.mVersion = PROGRAM_CACHE_VERSION;
+	header.mShaderLevel = shader->mShaderLevel;
+	header.mFormat = format;
+	header.mSize = length;
+
+	// write to a temporary so a crash never leaves a truncated entry behind
+	std::string filename = gDirUtilp->add(mProgramCacheDir, key + ".bin");
+	std::string temp_name = filename + ".tmp";
+	LLFILE* file = LLFile::fopen(temp_name, "wb");
+	if (!file)
+	{
+		return;
+	}
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1
+				   && fwrite(&binary[0], 1, length, file) == (size_t) length;
+	fclose(file);
+
+	LLFile::remove(filename, ENOENT);
+	if (!written || LLFile::rename(temp_name, filename) != 0)
+	{
+		LL_WARNS("ShaderLoading") << "Failed to write program cache entry for " << shader->mName << LL_ENDL;
+		LLFile::remove(temp_name);
+	}
+#endif
+}
+
+void LLShaderMgr::resetProgramLoadStats()
+{
+	mProgramsCompiled = 0;
+	mProgramsFromCache = 0;
+	mProgramCompileSeconds = 0.0;
+	mProgramCacheSeconds = 0.0;
+}
+
+void LLShaderMgr::recordProgramLoad(const LLGLSLShader* shader, bool from_cache, F64 seconds)
+{
+	if (from_cache)
+	{
+		++mProgramsFromCache;
+		mProgramCacheSeconds += seconds;
+	}
+	else
+	{
+		++mProgramsCompiled;
+		mProgramCompileSeconds += seconds;
+	}
+	LL_DEBUGS("ShaderLoading") << shader->mName << (from_cache ? " loaded from program cache in " : " compiled in ")
+							   << llformat("%.2f ms", seconds * 1000.0) << LL_ENDL;
+}
+
 BOOL LLShaderMgr::linkProgramObject(GLhandleARB obj, BOOL suppress_errors) 
 {
-	//check for errors
 	glLinkProgramARB(obj);
+	return checkLinkStatus(obj, suppress_errors);
+}
+
+BOOL LLShaderMgr::checkLinkStatus(GLhandleARB obj, BOOL suppress_errors)
+{
+	//check for errors
 	GLint success = GL_TRUE;
 	glGetObjectParameterivARB(obj, GL_OBJECT_LINK_STATUS_ARB, &success);
 	if (!suppress_errors && success == GL_FALSE) 
@@ -1133,6 +1395,68 @@ BOOL LLShaderMgr::validateProgramObject(GLhandleARB obj)
 	return success;
 }
 
+BOOL LLShaderMgr::isShaderCompiled(GLhandleARB obj)
+{
+	GLint success = GL_TRUE;
+	glGetObjectParameterivARB(obj, GL_OBJECT_COMPILE_STATUS_ARB, &success);
+	return success == GL_TRUE;
+}
+
+void LLShaderMgr::beginShaderBatch()
+{
+	if (gGLManager.mHasParallelShaderCompile)
+	{
+		// let the driver pick how many threads to use
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+	}
+	mBatchingShaders = true;
+	mShaderBatchFailed = false;
+}
+
+BOOL LLShaderMgr::finishShaderBatch()
+{
+	mBatchingShaders = false;
+	while (!mPendingShaders.empty())
+	{
+		finishPendingShader(mPendingShaders.front());
+	}
+	BOOL success = !mShaderBatchFailed;
+	mShaderBatchFailed = false;
+	return success;
+}
+
+void LLShaderMgr::addPendingShader(LLGLSLShader* shader)
+{
+	mPendingShaders.push_back(shader);
+}
+
+BOOL LLShaderMgr::finishPendingShader(LLGLSLShader* shader)
+{
+	std::vector<LLGLSLShader*>::iterator iter = std::find(mPendingShaders.begin(), mPendingShaders.end(), shader);
+	if (iter == mPendingShaders.end())
+	{
+		return TRUE;
+	}
+	mPendingShaders.erase(iter);
+
+	BOOL success = shader->finishShader();
+	if (!success)
+	{
+		LL_WARNS("ShaderLoading") << "Failed to finish deferred shader " << shader->mName << LL_ENDL;
+		mShaderBatchFailed = true;
+	}
+	return success;
+}
+
+void LLShaderMgr::cancelPendingShader(LLGLSLShader* shader)
+{
+	std::vector<LLGLSLShader*>::iterator iter = std::find(mPendingShaders.begin(), mPendingShaders.end(), shader);
+	if (iter != mPendingShaders.end())
+	{
+		mPendingShaders.erase(iter);
+	}
+}
+
 //virtual
 void LLShaderMgr::initAttribsAndUniforms()
 {
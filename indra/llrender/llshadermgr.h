@@ -261,8 +261,46 @@ public:
 	void dumpObjectLog(GLhandleARB ret, BOOL warns = TRUE, const std::string& filename = "");
     void dumpShaderSource(U32 shader_code_count, GLcharARB** shader_code_text);
 	BOOL	linkProgramObject(GLhandleARB obj, BOOL suppress_errors = FALSE);
+	// Link status of a program whose glLinkProgramARB was already issued
+	BOOL	checkLinkStatus(GLhandleARB obj, BOOL suppress_errors = FALSE);
 	BOOL	validateProgramObject(GLhandleARB obj);
-	GLhandleARB loadShaderFile(const std::string& filename, S32 & shader_level, GLenum type, boost::unordered_map<std::string, std::string>* defines = NULL, S32 texture_index_channels = -1);
+	// With defer_status the compile is only submitted: the status is not
+	// read and a failure does not fall back to a lower shader level.
+	GLhandleARB loadShaderFile(const std::string& filename, S32 & shader_level, GLenum type, boost::unordered_map<std::string, std::string>* defines = NULL, S32 texture_index_channels = -1, BOOL defer_status = FALSE);
+	BOOL	isShaderCompiled(GLhandleARB obj);
+
+	// While a batch is open LLGLSLShader::createShader submits the compiles
+	// and link of a program and returns TRUE without waiting for the driver,
+	// so its compiler threads work on many programs at once. The statuses
+	// are read when the shader is first bound or the batch is finished;
+	// a program that failed is then rebuilt synchronously.
+	void	beginShaderBatch();
+	BOOL	finishShaderBatch(); // FALSE if any program in the batch failed
+	bool	isBatchingShaders() const { return mBatchingShaders; }
+	void	addPendingShader(LLGLSLShader* shader);
+	BOOL	finishPendingShader(LLGLSLShader* shader);
+	void	cancelPendingShader(LLGLSLShader* shader);
+
+	// Linked program binaries are kept in dir (created on demand), named by a
+	// hash of everything that goes into the program. Empty disables the cache.
+	void setProgramCacheDir(const std::string& dir) { mProgramCacheDir = dir; }
+
+	// Key for shader's program, or empty when the cache is off or a stage
+	// is missing. Call with the shader features already attached.
+	std::string getProgramCacheKey(const LLGLSLShader* shader, S32 texture_index_channels, U32 varying_count, const char** varyings);
+	// Links shader's program from the cached binary, restoring the shader
+	// level it was built with. Stale binaries are removed.
+	BOOL loadProgramBinary(LLGLSLShader* shader, const std::string& key);
+	void saveProgramBinary(const LLGLSLShader* shader, const std::string& key);
+
+	// Where programs came from since the last reset, for the startup report.
+	void resetProgramLoadStats();
+	void recordProgramLoad(const LLGLSLShader* shader, bool from_cache, F64 seconds);
+
+	U32 mProgramsCompiled;
+	U32 mProgramsFromCache;
+	F64 mProgramCompileSeconds;
+	F64 mProgramCacheSeconds;
 
 	// Implemented in the application to actually point to the shader directory.
 	virtual std::string getShaderDirPrefix(void) = 0; // Pure Virtual
@@ -284,6 +322,20 @@ public:
 	std::map<std::string, std::string> mDefinitions;
 
 protected:
+	// Reads filename for the best gpu class at or below shader_level into
+	// shader_code_text (MAX_SHADER_CODE_LINES lines, freed by the caller)
+	// with the version, defines and indexed texture lookup prepended.
+	// Returns the line count, 0 when no file was found.
+	GLuint readShaderSource(const std::string& filename, S32 shader_level, GLenum type, boost::unordered_map<std::string, std::string>* defines, S32 texture_index_channels, GLcharARB** shader_code_text, std::string& open_file_name);
+
+	// Source hash of every shader object loadShaderFile compiled
+	std::map<GLhandleARB, std::string> mShaderObjectHashes;
+
+	std::string mProgramCacheDir;
+
+	std::vector<LLGLSLShader*> mPendingShaders;
+	bool mBatchingShaders;
+	bool mShaderBatchFailed;
 
 	// our parameter manager singleton instance
 	static LLShaderMgr * sInstance;
@@ -31,6 +31,7 @@
 #include "llvertexbuffer.h"
 // #include "llrender.h"
 #include "llglheaders.h"
+#include "llindirectbuffer.h"
 #include "llrender.h"
 #include "llvector4a.h"
 #include "llshadermgr.h"
@@ -79,6 +80,9 @@ U32 vbo_block_index(U32 size)
 
 const U32 LL_VBO_POOL_SEED_COUNT = vbo_block_index(LL_VBO_POOL_MAX_SEED_SIZE);
 
+//a segment (1/8th) of the ring is the most one streamed buffer can take
+const U32 LL_VBO_STREAM_RING_SIZE = 4*1024*1024;
+
 
 //============================================================================
 
@@ -88,6 +92,7 @@ LLVBOPool LLVertexBuffer::sDynamicVBOPool(GL_DYNAMIC_DRAW_ARB, GL_ARRAY_BUFFER_A
 LLVBOPool LLVertexBuffer::sDynamicCopyVBOPool(GL_DYNAMIC_COPY_ARB, GL_ARRAY_BUFFER_ARB);
 LLVBOPool LLVertexBuffer::sStreamIBOPool(GL_STREAM_DRAW_ARB, GL_ELEMENT_ARRAY_BUFFER_ARB);
 LLVBOPool LLVertexBuffer::sDynamicIBOPool(GL_DYNAMIC_DRAW_ARB, GL_ELEMENT_ARRAY_BUFFER_ARB);
+LLVBORing LLVertexBuffer::sStreamVBORing(GL_ARRAY_BUFFER_ARB);
 
 U32 LLVBOPool::sBytesPooled = 0;
 U32 LLVBOPool::sIndexBytesPooled = 0;
@@ -117,6 +122,10 @@ bool LLVertexBuffer::sMapped = false;
 bool LLVertexBuffer::sUseStreamDraw = true;
 bool LLVertexBuffer::sUseVAO = false;
 bool LLVertexBuffer::sPreferStreamDraw = false;
+bool LLVertexBuffer::sUseStreamRing = true;
+
+LLTrace::CountStatHandle<F64Kilobytes> LLVertexBuffer::sStreamedData("vbostreameddata", "Vertex data copied into the stream ring");
+LLTrace::CountStatHandle<> LLVertexBuffer::sStreamFenceWaits("vbostreamfencewaits", "Times the stream ring waited for the GPU before reusing a segment");
 
 
 U32 LLVBOPool::genBuffer()
@@ -332,6 +341,130 @@ void LLVBOPool::cleanup()
 }
 
 
+LLVBORing::LLVBORing(U32 vboType)
+: mType(vboType), mName(0), mSize(0), mSegmentSize(0), mMapped(NULL), mHead(0), mSegment(0)
+{
+}
+
+bool LLVBORing::init(U32 size)
+{
+	if (mName)
+	{
+		return true;
+	}
+
+#if !LL_DARWIN
+#ifdef GL_ARB_map_buffer_range
+	if (!gGLManager.mHasBufferStorage || !gGLManager.mHasMapBufferRange || !gGLManager.mHasSync)
+	{
+		return false;
+	}
+
+	LLVertexBuffer::unbind();
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffersARB(1, &mName);
+	glBindBufferARB(mType, mName);
+	glBufferStorage(mType, size, NULL, flags);
+	mMapped = (U8*) glMapBufferRange(mType, 0, size, flags);
+	glBindBufferARB(mType, 0);
+
+	if (!mMapped)
+	{
+		LL_WARNS() << "Could not map vertex stream ring, streamed buffers will use glBufferSubData" << LL_ENDL;
+		glDeleteBuffersARB(1, &mName);
+		mName = 0;
+		return false;
+	}
+
+	mSize = size;
+	mSegmentSize = size / NUM_SEGMENTS;
+
+	//start past a full lap so nothing allocated from an earlier ring is drawable
+	mHead = (mHead / mSize + 2) * mSize;
+	mSegment = mHead / mSegmentSize;
+
+	return true;
+#endif
+#endif
+	return false;
+}
+
+void LLVBORing::cleanup()
+{
+	if (!mName)
+	{
+		return;
+	}
+
+	LLVertexBuffer::unbind();
+
+	glBindBufferARB(mType, mName);
+	glUnmapBufferARB(mType);
+	glBindBufferARB(mType, 0);
+	glDeleteBuffersARB(1, &mName);
+
+#ifdef GL_ARB_sync
+	//the ring is static, so its fences would otherwise be deleted after the context is gone
+	for (U32 i = 0; i < NUM_SEGMENTS; ++i)
+	{
+		if (mFences[i].mSync)
+		{
+			glDeleteSync(mFences[i].mSync);
+			mFences[i].mSync = 0;
+		}
+	}
+#endif
+
+	mName = 0;
+	mMapped = NULL;
+}
+
+volatile U8* LLVBORing::allocate(U32 bytes, U32& offset, U64& position)
+{
+	if (!mName || bytes > mSegmentSize)
+	{
+		return NULL;
+	}
+
+	U64 begin = (mHead + 0x3F) & ~((U64) 0x3F);
+	if (begin % mSize + bytes > mSize)
+	{ //wrap around to the start of the ring
+		begin += mSize - begin % mSize;
+	}
+	U64 end = begin + bytes;
+
+	U64 last_segment = (end - 1) / mSegmentSize;
+	while (mSegment < last_segment)
+	{
+		++mSegment;
+
+		//data may be drawn until the head leaves the segment after the one it was
+		//written to (see isDrawable), so that is when the segment gets its fence
+		mFences[(mSegment - 2) % NUM_SEGMENTS].placeFence();
+		glFlush();
+
+		//make sure the GPU is done with this segment's previous lap
+		LLGLSyncFence& fence = mFences[mSegment % NUM_SEGMENTS];
+		if (!fence.isCompleted())
+		{
+			add(LLVertexBuffer::sStreamFenceWaits, 1);
+			fence.wait();
+		}
+	}
+
+	mHead = end;
+	offset = (U32) (begin % mSize);
+	position = begin;
+
+	return mMapped + offset;
+}
+
+bool LLVBORing::isDrawable(U64 position) const
+{
+	return mName && position / mSegmentSize + 1 >= mSegment;
+}
+
 //NOTE: each component must be AT LEAST 4 bytes in size to avoid a performance penalty on AMD hardware
 const S32 LLVertexBuffer::sTypeSize[LLVertexBuffer::TYPE_MAX] =
 {
@@ -736,7 +869,7 @@ void LLVertexBuffer::drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indi
 			LL_ERRS() << "Wrong index buffer bound." << LL_ENDL;
 		}
 
-		if (mGLBuffer != sGLRenderBuffer)
+		if (getBoundName() != sGLRenderBuffer)
 		{
 			LL_ERRS() << "Wrong vertex buffer bound." << LL_ENDL;
 		}
@@ -773,6 +906,75 @@ void LLVertexBuffer::drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indi
 	placeFence();
 }
 
+void LLVertexBuffer::drawMultiIndirect(U32 mode, LLIndirectBuffer* commands, U32 first, U32 count, U32 index_count) const
+{
+#if !LL_DARWIN
+	llassert(useVBOs() && mAlignedIndexOffset == 0);
+	llassert(!LLGLSLShader::sNoFixedFunction || LLGLSLShader::sCurBoundShaderPtr != NULL);
+	mMappable = false;
+	gGL.syncMatrices();
+
+	if (mGLArray)
+	{
+		if (mGLArray != sGLRenderArray)
+		{
+			LL_ERRS() << "Wrong vertex array bound." << LL_ENDL;
+		}
+	}
+	else
+	{
+		if (mGLIndices != sGLRenderIndices)
+		{
+			LL_ERRS() << "Wrong index buffer bound." << LL_ENDL;
+		}
+
+		if (getBoundName() != sGLRenderBuffer)
+		{
+			LL_ERRS() << "Wrong vertex buffer bound." << LL_ENDL;
+		}
+	}
+
+	if (mode >= LLRender::NUM_MODES)
+	{
+		LL_ERRS() << "Invalid draw mode: " << mode << LL_ENDL;
+		return;
+	}
+
+	if (first + count > commands->getNumCommands())
+	{
+		LL_ERRS() << "Bad indirect draw range: [" << first << ", " << first+count << "]" << LL_ENDL;
+	}
+
+	if (gDebugGL)
+	{
+		const LLIndirectBuffer::command_list_t& list = commands->getCommands();
+		for (U32 i = first; i < first+count; ++i)
+		{
+			if (list[i].mFirstIndex + list[i].mCount > (U32) mNumIndices)
+			{
+				LL_ERRS() << "Indirect command out of index buffer range." << LL_ENDL;
+			}
+		}
+	}
+
+	if (!commands->bind())
+	{
+		return;
+	}
+
+	stop_glerror();
+	LLGLSLShader::startProfile();
+	glMultiDrawElementsIndirect(sGLMode[mode], GL_UNSIGNED_SHORT,
+		(GLvoid*) (first * sizeof(LLIndirectBuffer::Command)), count, 0);
+	LLGLSLShader::stopProfile(index_count, mode);
+	stop_glerror();
+
+	placeFence();
+#else
+	LL_ERRS() << "Multi draw indirect is not supported on this platform." << LL_ENDL;
+#endif
+}
+
 void LLVertexBuffer::draw(U32 mode, U32 count, U32 indices_offset) const
 {
 	llassert(!LLGLSLShader::sNoFixedFunction || LLGLSLShader::sCurBoundShaderPtr != NULL);
@@ -800,7 +1002,7 @@ void LLVertexBuffer::draw(U32 mode, U32 count, U32 indices_offset) const
 			LL_ERRS() << "Wrong index buffer bound." << LL_ENDL;
 		}
 
-		if (mGLBuffer != sGLRenderBuffer)
+		if (getBoundName() != sGLRenderBuffer)
 		{
 			LL_ERRS() << "Wrong vertex buffer bound." << LL_ENDL;
 		}
@@ -844,7 +1046,7 @@ void LLVertexBuffer::drawArrays(U32 mode, U32 first, U32 count) const
 	}
 	else
 	{
-		if (mGLBuffer != sGLRenderBuffer || useVBOs() != sVBOActive)
+		if (getBoundName() != sGLRenderBuffer || useVBOs() != sVBOActive)
 		{
 			LL_ERRS() << "Wrong vertex buffer bound." << LL_ENDL;
 		}
@@ -875,6 +1077,11 @@ void LLVertexBuffer::initClass(bool use_vbo, bool no_vbo_mapping)
 {
 	sEnableVBOs = use_vbo && gGLManager.mHasVertexBufferObject;
 	sDisableVBOMapping = sEnableVBOs && no_vbo_mapping;
+
+	if (sEnableVBOs && sUseStreamDraw && sUseStreamRing)
+	{
+		sStreamVBORing.init(LL_VBO_STREAM_RING_SIZE);
+	}
 }
 
 //static 
@@ -917,6 +1124,8 @@ void LLVertexBuffer::cleanupClass()
 	sStreamVBOPool.cleanup();
 	sDynamicVBOPool.cleanup();
 	sDynamicCopyVBOPool.cleanup();
+
+	sStreamVBORing.cleanup();
 }
 
 //----------------------------------------------------------------------------
@@ -963,7 +1172,7 @@ S32 LLVertexBuffer::determineUsage(S32 usage)
 	return ret_usage;
 }
 
-LLVertexBuffer::LLVertexBuffer(U32 typemask, S32 usage) 
+LLVertexBuffer::LLVertexBuffer(U32 typemask, S32 usage, bool streamed) 
 :	LLTrace::MemTrackable<LLVertexBuffer>("LLVertexBuffer"),
 	LLRefCount(),
 
@@ -974,7 +1183,7 @@ LLVertexBuffer::LLVertexBuffer(U32 typemask, S32 usage)
 	mSize(0),
 	mIndicesSize(0),
 	mTypeMask(typemask),
-	mUsage(LLVertexBuffer::determineUsage(usage)),
+	mUsage(LLVertexBuffer::determineUsage(streamed && sStreamVBORing.isActive() ? GL_STREAM_DRAW_ARB : usage)),
 	mGLBuffer(0),
 	mGLIndices(0),
 	mGLArray(0),
@@ -986,15 +1195,22 @@ LLVertexBuffer::LLVertexBuffer(U32 typemask, S32 usage)
 	mIndexLocked(false),
 	mFinal(false),
 	mEmpty(true),
+	mStreamed(false),
+	mStreamOnRing(false),
+	mStreamUploaded(true),
 	mMappable(false),
+	mStreamVerts(0),
+	mStreamPosition(0),
 	mFence(NULL)
 {
 	mMappable = (mUsage == GL_DYNAMIC_DRAW_ARB && !sDisableVBOMapping);
+	mStreamed = (streamed && mUsage == GL_STREAM_DRAW_ARB);
 
 	//zero out offsets
 	for (U32 i = 0; i < TYPE_MAX; i++)
 	{
 		mOffsets[i] = 0;
+		mStreamOffsets[i] = 0;
 	}
 
 	sCount++;
@@ -1196,6 +1412,10 @@ bool LLVertexBuffer::createGLBuffer(U32 size)
 	bool sucsess = true;
 
 	mEmpty = true;
+	mStreamOnRing = false;
+	mStreamUploaded = true;
+	mStreamVerts = 0;
+	mStreamPosition = 0;
 
 	mMappedDataUsingVBOs = useVBOs();
 	
@@ -1368,8 +1588,8 @@ bool LLVertexBuffer::allocateBuffer(S32 nverts, S32 nindices, bool create)
 		//actually allocate space for the vertex buffer if using VBO mapping
 		flush(); //unmap
 
-		if (gGLManager.mHasVertexArrayObject && useVBOs() && sUseVAO)
-		{
+		if (gGLManager.mHasVertexArrayObject && useVBOs() && sUseVAO && !mStreamed)
+		{ //streamed buffers move around sStreamVBORing, so they can't keep a VAO
 #if GL_ARB_vertex_array_object
 			mGLArray = getVAOName();
 #endif
@@ -1924,12 +2144,27 @@ void LLVertexBuffer::unmapBuffer()
 	if (mMappedData && mVertexLocked)
 	{
 		LL_RECORD_BLOCK_TIME(FTM_VBO_UNMAP);
+		mStreamOnRing = false;
 		bindGLBuffer(true);
 		updated_all = mIndexLocked; //both vertex and index buffers done updating
 
 		if(!mMappable)
 		{
-			if (!mMappedVertexRegions.empty())
+			if (mStreamed && sStreamVBORing.isActive())
+			{ //copied into the ring by setBuffer, only remember how much was written
+				mStreamVerts = mMappedVertexRegions.empty() ? mNumVerts : 0;
+				for (U32 i = 0; i < mMappedVertexRegions.size(); ++i)
+				{
+					const MappedRegion& region = mMappedVertexRegions[i];
+					mStreamVerts = llmax(mStreamVerts, region.mIndex >= 0 ? region.mIndex + region.mCount : mNumVerts);
+				}
+				mStreamVerts = llmin(mStreamVerts, mNumVerts);
+				mStreamPosition = 0;
+				mStreamUploaded = false;
+
+				mMappedVertexRegions.clear();
+			}
+			else if (!mMappedVertexRegions.empty())
 			{
 				stop_glerror();
 				for (U32 i = 0; i < mMappedVertexRegions.size(); ++i)
@@ -2234,12 +2469,13 @@ bool LLVertexBuffer::bindGLBuffer(bool force_bind)
 
 	bool ret = false;
 
-	if (useVBOs() && (force_bind || (mGLBuffer && (mGLBuffer != sGLRenderBuffer || !sVBOActive))))
+	U32 name = getBoundName();
+	if (useVBOs() && (force_bind || (name && (name != sGLRenderBuffer || !sVBOActive))))
 	{
 		//LL_RECORD_BLOCK_TIME(FTM_BIND_GL_BUFFER);
 		
-		glBindBufferARB(GL_ARRAY_BUFFER_ARB, mGLBuffer);
-		sGLRenderBuffer = mGLBuffer;
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB, name);
+		sGLRenderBuffer = name;
 		sBindCount++;
 		sVBOActive = true;
 
@@ -2284,6 +2520,68 @@ void LLVertexBuffer::flush()
 	}
 }
 
+static LLTrace::BlockTimerStatHandle FTM_VBO_STREAM_RING("VBO Stream Ring");
+
+void LLVertexBuffer::streamToRing()
+{
+	mStreamOnRing = false;
+
+	if (sStreamVBORing.isDrawable(mStreamPosition))
+	{ //still in the ring from an earlier draw
+		mStreamOnRing = true;
+		return;
+	}
+
+	if (sStreamVBORing.isActive() && mStreamVerts > 0)
+	{
+		LL_RECORD_BLOCK_TIME(FTM_VBO_STREAM_RING);
+
+		U32 bytes = 0;
+		for (U32 i = 0; i < TYPE_TEXTURE_INDEX; ++i)
+		{
+			if (mTypeMask & (1 << i))
+			{
+				bytes += (sTypeSize[i]*mStreamVerts + 0xF) & ~0xF;
+			}
+		}
+
+		U32 offset = 0;
+		volatile U8* dst = sStreamVBORing.allocate(bytes, offset, mStreamPosition);
+		if (dst)
+		{
+			for (U32 i = 0; i < TYPE_TEXTURE_INDEX; ++i)
+			{
+				if (mTypeMask & (1 << i))
+				{
+					U32 length = sTypeSize[i]*mStreamVerts;
+					memcpy((U8*) dst, (U8*) mMappedData + mOffsets[i], length);
+					mStreamOffsets[i] = offset;
+
+					length = (length + 0xF) & ~0xF;
+					dst += length;
+					offset += length;
+				}
+			}
+			mStreamOffsets[TYPE_TEXTURE_INDEX] = mStreamOffsets[TYPE_VERTEX] + 12;
+
+			add(sStreamedData, F64Bytes(bytes));
+			mStreamOnRing = true;
+			return;
+		}
+	}
+
+	mStreamPosition = 0;
+
+	if (!mStreamUploaded)
+	{ //too big for the ring or the ring went away, use this buffer's own storage
+		bindGLBuffer(true);
+		stop_glerror();
+		glBufferSubDataARB(GL_ARRAY_BUFFER_ARB, 0, getSize(), (U8*) mMappedData);
+		stop_glerror();
+		mStreamUploaded = true;
+	}
+}
+
 // bind for transform feedback (quick 'n dirty)
 void LLVertexBuffer::bindForFeedback(U32 channel, U32 type, U32 index, U32 count)
 {
@@ -2299,6 +2597,11 @@ void LLVertexBuffer::setBuffer(U32 data_mask)
 {
 	flush();
 
+	if (mStreamed)
+	{
+		streamToRing();
+	}
+
 	//set up pointers if the data mask is different ...
 	bool setup = (sLastMask != data_mask);
 
@@ -2373,14 +2676,15 @@ void LLVertexBuffer::setBuffer(U32 data_mask)
 			const bool bindBuffer = bindGLBuffer();
 			const bool bindIndices = bindGLIndices();
 			
-			setup = setup || bindBuffer || bindIndices;
+			//... or streamed data may have moved
+			setup = setup || bindBuffer || bindIndices || mStreamed;
 		}
 
 		if (gDebugGL && !mGLArray)
 		{
 			GLint buff;
 			glGetIntegerv(GL_ARRAY_BUFFER_BINDING_ARB, &buff);
-			if ((GLuint)buff != mGLBuffer)
+			if ((GLuint)buff != getBoundName())
 			{
 				if (gDebugSession)
 				{
@@ -2471,6 +2775,13 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 {
 	stop_glerror();
 	volatile U8* base = useVBOs() ? (U8*) mAlignedOffset : mMappedData;
+	const S32* offsets = mOffsets;
+
+	if (mStreamOnRing)
+	{
+		base = NULL;
+		offsets = mStreamOffsets;
+	}
 
 	if (gDebugGL && ((data_mask & mTypeMask) != data_mask))
 	{
@@ -2490,50 +2801,50 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 		if (data_mask & MAP_NORMAL)
 		{
 			S32 loc = TYPE_NORMAL;
-			void* ptr = (void*)(base + mOffsets[TYPE_NORMAL]);
+			void* ptr = (void*)(base + offsets[TYPE_NORMAL]);
 			glVertexAttribPointerARB(loc, 3, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_NORMAL], ptr);
 		}
 		if (data_mask & MAP_TEXCOORD3)
 		{
 			S32 loc = TYPE_TEXCOORD3;
-			void* ptr = (void*)(base + mOffsets[TYPE_TEXCOORD3]);
+			void* ptr = (void*)(base + offsets[TYPE_TEXCOORD3]);
 			glVertexAttribPointerARB(loc,2,GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD3], ptr);
 		}
 		if (data_mask & MAP_TEXCOORD2)
 		{
 			S32 loc = TYPE_TEXCOORD2;
-			void* ptr = (void*)(base + mOffsets[TYPE_TEXCOORD2]);
+			void* ptr = (void*)(base + offsets[TYPE_TEXCOORD2]);
 			glVertexAttribPointerARB(loc,2,GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD2], ptr);
 		}
 		if (data_mask & MAP_TEXCOORD1)
 		{
 			S32 loc = TYPE_TEXCOORD1;
-			void* ptr = (void*)(base + mOffsets[TYPE_TEXCOORD1]);
+			void* ptr = (void*)(base + offsets[TYPE_TEXCOORD1]);
 			glVertexAttribPointerARB(loc,2,GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD1], ptr);
 		}
 		if (data_mask & MAP_TANGENT)
 		{
 			S32 loc = TYPE_TANGENT;
-			void* ptr = (void*)(base + mOffsets[TYPE_TANGENT]);
+			void* ptr = (void*)(base + offsets[TYPE_TANGENT]);
 			glVertexAttribPointerARB(loc, 4,GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TANGENT], ptr);
 		}
 		if (data_mask & MAP_TEXCOORD0)
 		{
 			S32 loc = TYPE_TEXCOORD0;
-			void* ptr = (void*)(base + mOffsets[TYPE_TEXCOORD0]);
+			void* ptr = (void*)(base + offsets[TYPE_TEXCOORD0]);
 			glVertexAttribPointerARB(loc,2,GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD0], ptr);
 		}
 		if (data_mask & MAP_COLOR)
 		{
 			S32 loc = TYPE_COLOR;
 			//bind emissive instead of color pointer if emissive is present
-			void* ptr = (data_mask & MAP_EMISSIVE) ? (void*)(base + mOffsets[TYPE_EMISSIVE]) : (void*)(base + mOffsets[TYPE_COLOR]);
+			void* ptr = (data_mask & MAP_EMISSIVE) ? (void*)(base + offsets[TYPE_EMISSIVE]) : (void*)(base + offsets[TYPE_COLOR]);
 			glVertexAttribPointerARB(loc, 4, GL_UNSIGNED_BYTE, GL_TRUE, LLVertexBuffer::sTypeSize[TYPE_COLOR], ptr);
 		}
 		if (data_mask & MAP_EMISSIVE)
 		{
 			S32 loc = TYPE_EMISSIVE;
-			void* ptr = (void*)(base + mOffsets[TYPE_EMISSIVE]);
+			void* ptr = (void*)(base + offsets[TYPE_EMISSIVE]);
 			glVertexAttribPointerARB(loc, 4, GL_UNSIGNED_BYTE, GL_TRUE, LLVertexBuffer::sTypeSize[TYPE_EMISSIVE], ptr);
 
 			if (!(data_mask & MAP_COLOR))
@@ -2545,19 +2856,19 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 		if (data_mask & MAP_WEIGHT)
 		{
 			S32 loc = TYPE_WEIGHT;
-			void* ptr = (void*)(base + mOffsets[TYPE_WEIGHT]);
+			void* ptr = (void*)(base + offsets[TYPE_WEIGHT]);
 			glVertexAttribPointerARB(loc, 1, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_WEIGHT], ptr);
 		}
 		if (data_mask & MAP_WEIGHT4)
 		{
 			S32 loc = TYPE_WEIGHT4;
-			void* ptr = (void*)(base+mOffsets[TYPE_WEIGHT4]);
+			void* ptr = (void*)(base+offsets[TYPE_WEIGHT4]);
 			glVertexAttribPointerARB(loc, 4, GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_WEIGHT4], ptr);
 		}
 		if (data_mask & MAP_CLOTHWEIGHT)
 		{
 			S32 loc = TYPE_CLOTHWEIGHT;
-			void* ptr = (void*)(base + mOffsets[TYPE_CLOTHWEIGHT]);
+			void* ptr = (void*)(base + offsets[TYPE_CLOTHWEIGHT]);
 			glVertexAttribPointerARB(loc, 4, GL_FLOAT, GL_TRUE,  LLVertexBuffer::sTypeSize[TYPE_CLOTHWEIGHT], ptr);
 		}
 		if (data_mask & MAP_TEXTURE_INDEX && 
@@ -2565,14 +2876,14 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 		{
 #if !LL_DARWIN
 			S32 loc = TYPE_TEXTURE_INDEX;
-			void *ptr = (void*) (base + mOffsets[TYPE_VERTEX] + 12);
+			void *ptr = (void*) (base + offsets[TYPE_VERTEX] + 12);
 			glVertexAttribIPointer(loc, 1, GL_UNSIGNED_INT, LLVertexBuffer::sTypeSize[TYPE_VERTEX], ptr);
 #endif
 		}
 		if (data_mask & MAP_VERTEX)
 		{
 			S32 loc = TYPE_VERTEX;
-			void* ptr = (void*)(base + mOffsets[TYPE_VERTEX]);
+			void* ptr = (void*)(base + offsets[TYPE_VERTEX]);
 			glVertexAttribPointerARB(loc, 3,GL_FLOAT, GL_FALSE, LLVertexBuffer::sTypeSize[TYPE_VERTEX], ptr);
 		}	
 	}	
@@ -2580,43 +2891,43 @@ void LLVertexBuffer::setupVertexBuffer(U32 data_mask)
 	{
 		if (data_mask & MAP_NORMAL)
 		{
-			glNormalPointer(GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_NORMAL], (void*)(base + mOffsets[TYPE_NORMAL]));
+			glNormalPointer(GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_NORMAL], (void*)(base + offsets[TYPE_NORMAL]));
 		}
 		if (data_mask & MAP_TEXCOORD3)
 		{
 			glClientActiveTextureARB(GL_TEXTURE3_ARB);
-			glTexCoordPointer(2,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD3], (void*)(base + mOffsets[TYPE_TEXCOORD3]));
+			glTexCoordPointer(2,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD3], (void*)(base + offsets[TYPE_TEXCOORD3]));
 			glClientActiveTextureARB(GL_TEXTURE0_ARB);
 		}
 		if (data_mask & MAP_TEXCOORD2)
 		{
 			glClientActiveTextureARB(GL_TEXTURE2_ARB);
-			glTexCoordPointer(2,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD2], (void*)(base + mOffsets[TYPE_TEXCOORD2]));
+			glTexCoordPointer(2,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD2], (void*)(base + offsets[TYPE_TEXCOORD2]));
 			glClientActiveTextureARB(GL_TEXTURE0_ARB);
 		}
 		if (data_mask & MAP_TEXCOORD1)
 		{
 			glClientActiveTextureARB(GL_TEXTURE1_ARB);
-			glTexCoordPointer(2,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD1], (void*)(base + mOffsets[TYPE_TEXCOORD1]));
+			glTexCoordPointer(2,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD1], (void*)(base + offsets[TYPE_TEXCOORD1]));
 			glClientActiveTextureARB(GL_TEXTURE0_ARB);
 		}
 		if (data_mask & MAP_TANGENT)
 		{
 			glClientActiveTextureARB(GL_TEXTURE2_ARB);
-			glTexCoordPointer(4,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TANGENT], (void*)(base + mOffsets[TYPE_TANGENT]));
+			glTexCoordPointer(4,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TANGENT], (void*)(base + offsets[TYPE_TANGENT]));
 			glClientActiveTextureARB(GL_TEXTURE0_ARB);
 		}
 		if (data_mask & MAP_TEXCOORD0)
 		{
-			glTexCoordPointer(2,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD0], (void*)(base + mOffsets[TYPE_TEXCOORD0]));
+			glTexCoordPointer(2,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_TEXCOORD0], (void*)(base + offsets[TYPE_TEXCOORD0]));
 		}
 		if (data_mask & MAP_COLOR)
 		{
-			glColorPointer(4, GL_UNSIGNED_BYTE, LLVertexBuffer::sTypeSize[TYPE_COLOR], (void*)(base + mOffsets[TYPE_COLOR]));
+			glColorPointer(4, GL_UNSIGNED_BYTE, LLVertexBuffer::sTypeSize[TYPE_COLOR], (void*)(base + offsets[TYPE_COLOR]));
 		}
 		if (data_mask & MAP_VERTEX)
 		{
-			glVertexPointer(3,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_VERTEX], (void*)(base + 0));
+			glVertexPointer(3,GL_FLOAT, LLVertexBuffer::sTypeSize[TYPE_VERTEX], (void*)(base + offsets[TYPE_VERTEX]));
 		}	
 	}
 
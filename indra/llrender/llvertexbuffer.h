@@ -41,6 +41,8 @@
 
 #define LL_MAX_VERTEX_ATTRIB_LOCATION 64
 
+class LLIndirectBuffer;
+
 //============================================================================
 // NOTES
 // Threading:
@@ -91,6 +93,43 @@ public:
 
 };
 
+//============================================================================
+// persistently mapped ring for vertex data that is rewritten before it is drawn
+// (see LLVertexBuffer's streamed constructor argument).  Space is handed out in
+// order; the ring is split into segments and a segment is only written again
+// once the fence placed behind it has passed.
+class LLVBORing
+{
+public:
+	enum { NUM_SEGMENTS = 8 };
+
+	LLVBORing(U32 vboType);
+
+	const U32 mType;
+
+	//create and map the buffer, returns false if GL_ARB_buffer_storage is not available
+	bool init(U32 size);
+	void cleanup();
+	bool isActive() const					{ return mName != 0; }
+	U32 getName() const						{ return mName; }
+
+	//reserve bytes of the ring, returns the mapped memory or NULL if bytes is larger
+	//than a segment. offset and position are set to where the data will live.
+	volatile U8* allocate(U32 bytes, U32& offset, U64& position);
+
+	//true if data allocated at position may still be drawn from
+	bool isDrawable(U64 position) const;
+
+private:
+	U32 mName;
+	U32 mSize;
+	U32 mSegmentSize;
+	volatile U8* mMapped;
+	U64 mHead;
+	U64 mSegment; //segment mHead is in
+	LLGLSyncFence mFences[NUM_SEGMENTS];
+};
+
 
 //============================================================================
 // base class 
@@ -127,6 +166,7 @@ public:
 	static LLVBOPool sDynamicCopyVBOPool;
 	static LLVBOPool sStreamIBOPool;
 	static LLVBOPool sDynamicIBOPool;
+	static LLVBORing sStreamVBORing;
 	
 	static std::list<U32> sAvailableVAOName;
 	static U32 sCurVAOName;
@@ -134,6 +174,7 @@ public:
 	static bool	sUseStreamDraw;
 	static bool sUseVAO;
 	static bool	sPreferStreamDraw;
+	static bool sUseStreamRing;
 
 	static void seedPools();
 
@@ -221,9 +262,14 @@ protected:
 	bool	updateNumVerts(S32 nverts);
 	bool	updateNumIndices(S32 nindices); 
 	void	unmapBuffer();
+	void	streamToRing();
+	U32		getBoundName() const			{ return mStreamOnRing ? sStreamVBORing.getName() : mGLBuffer; }
 		
 public:
-	LLVertexBuffer(U32 typemask, S32 usage);
+	// streamed buffers are copied into sStreamVBORing when they are set for
+	// rendering.  Only the vertices written since the last draw are kept, so
+	// they must be rewritten from index 0 before every draw.
+	LLVertexBuffer(U32 typemask, S32 usage, bool streamed = false);
 	
 	// map for data access
 	volatile U8*		mapVertexBuffer(S32 type, S32 index, S32 count, bool map_range);
@@ -284,6 +330,10 @@ public:
 	void drawArrays(U32 mode, U32 offset, U32 count) const;
 	void drawRange(U32 mode, U32 start, U32 end, U32 count, U32 indices_offset) const;
 
+	// Draw commands [first, first+count) of an indirect buffer built against
+	// this buffer's indices. index_count is only used for profiling.
+	void drawMultiIndirect(U32 mode, LLIndirectBuffer* commands, U32 first, U32 count, U32 index_count) const;
+
 	//for debugging, validate data in given range is valid
 	void validateRange(U32 start, U32 end, U32 count, U32 offset) const;
 
@@ -314,11 +364,18 @@ protected:
 	U32		mIndexLocked : 1;			// if true, index buffer is being or has been written to in client memory
 	U32		mFinal : 1;			// if true, buffer can not be mapped again
 	U32		mEmpty : 1;			// if true, client buffer is empty (or NULL). Old values have been discarded.	
+	U32		mStreamed : 1;			// if true, vertices are drawn from sStreamVBORing when it is active
+	U32		mStreamOnRing : 1;		// if true, the last setBuffer bound sStreamVBORing
+	U32		mStreamUploaded : 1;	// if true, mGLBuffer holds the vertices last written
 	
 	mutable bool	mMappable;     // if true, use memory mapping to upload data (otherwise doublebuffer and use glBufferSubData)
 
 	S32		mOffsets[TYPE_MAX];
 
+	S32		mStreamOffsets[TYPE_MAX];	// offsets into sStreamVBORing
+	S32		mStreamVerts;				// vertices written since the last draw
+	U64		mStreamPosition;			// ring position of the last copy
+
 	std::vector<MappedRegion> mMappedVertexRegions;
 	std::vector<MappedRegion> mMappedIndexRegions;
 
@@ -355,6 +412,9 @@ public:
 	static U32 sIndexCount;
 	static U32 sBindCount;
 	static U32 sSetCount;
+
+	static LLTrace::CountStatHandle<F64Kilobytes> sStreamedData;
+	static LLTrace::CountStatHandle<> sStreamFenceWaits;
 };
 
 
@@ -61,7 +61,7 @@ public:
 
 	virtual void setValue(const LLSD& value);
 
-	void			setForeground(BOOL b)		{ mForeground = b; }
+	void			setForeground(BOOL b)		{ mForeground = b; invalidateRenderCache(); }
 	BOOL			getForeground() const		{ return mForeground; }
 	void			setMaxTitleWidth(S32 max_width) {mMaxTitleWidth = llmin(max_width, mMaxTitleWidth); }
 	S32				getMaxTitleWidth() const { return mMaxTitleWidth; }
@@ -1367,6 +1367,8 @@ void LLFloater::setFocus( BOOL b )
 		}
 	}
 	updateTransparency(b ? TT_ACTIVE : TT_INACTIVE);
+	// title bar and default button borders follow focus
+	invalidateRenderCache();
 }
 
 // virtual
@@ -1408,6 +1410,7 @@ void LLFloater::setForeground(BOOL front)
 		}
 
 		setBackgroundOpaque( front ); 
+		invalidateRenderCache();
 	}
 }
 
@@ -1917,7 +1920,7 @@ void LLFloater::draw()
 	else
 	{
 		// don't call LLPanel::draw() since we've implemented custom background rendering
-		LLView::draw();
+		drawChildrenCached();
 	}
 
 	// update tearoff button for torn off floaters
@@ -342,6 +342,8 @@ void LLFolderViewItem::addToFolder(LLFolderViewFolder* folder)
 // makes sure that this view and its children are the right size.
 S32 LLFolderViewItem::arrange( S32* width, S32* height )
 {
+	invalidateRenderCache();
+
 	// Only indent deeper items in hierarchy
 	mIndentation = (getParentFolder())
 		? getParentFolder()->getIndentation() + mLocalIndentation
@@ -422,7 +424,11 @@ BOOL LLFolderViewItem::changeSelection(LLFolderViewItem* selection, BOOL selecte
 
 void LLFolderViewItem::deselectItem(void)
 {
-	mIsSelected = FALSE;
+	if (mIsSelected)
+	{
+		mIsSelected = FALSE;
+		invalidateRenderCache();
+	}
 }
 
 void LLFolderViewItem::selectItem(void)
@@ -431,6 +437,7 @@ void LLFolderViewItem::selectItem(void)
 	{
 		mIsSelected = TRUE;
 		getViewModelItem()->selectItem();
+		invalidateRenderCache();
 	}
 }
 
@@ -550,7 +557,7 @@ BOOL LLFolderViewItem::handleHover( S32 x, S32 y, MASK mask )
 {
 	static LLCachedControl<S32> drag_and_drop_threshold(*LLUI::getInstance()->mSettingGroups["config"],"DragAndDropDistanceThreshold", 3);
 
-	mIsMouseOverTitle = (y > (getRect().getHeight() - mItemHeight));
+	setMouseOverTitle(y > (getRect().getHeight() - mItemHeight));
 
 	if( hasMouseCapture() && isMovable() )
 	{
@@ -635,7 +642,16 @@ BOOL LLFolderViewItem::handleMouseUp( S32 x, S32 y, MASK mask )
 
 void LLFolderViewItem::onMouseLeave(S32 x, S32 y, MASK mask)
 {
-	mIsMouseOverTitle = false;
+	setMouseOverTitle(false);
+}
+
+void LLFolderViewItem::setMouseOverTitle(bool over)
+{
+	if (mIsMouseOverTitle != over)
+	{
+		mIsMouseOverTitle = over;
+		invalidateRenderCache();
+	}
 }
 
 BOOL LLFolderViewItem::handleDragAndDrop(S32 x, S32 y, MASK mask, BOOL drop,
@@ -1896,7 +1912,7 @@ BOOL LLFolderViewFolder::handleRightMouseDown( S32 x, S32 y, MASK mask )
 
 BOOL LLFolderViewFolder::handleHover(S32 x, S32 y, MASK mask)
 {
-	mIsMouseOverTitle = (y > (getRect().getHeight() - mItemHeight));
+	setMouseOverTitle(y > (getRect().getHeight() - mItemHeight));
 
 	BOOL handled = LLView::handleHover(x, y, mask);
 
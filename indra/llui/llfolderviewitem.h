@@ -151,6 +151,8 @@ protected:
 	virtual bool isFadeItem();
 	virtual bool isFlashing() { return false; }
 	virtual void setFlashState(bool) { }
+	// hover highlight of the title row
+	void setMouseOverTitle(bool over);
 
 	static LLFontGL* getLabelFontForStyle(U8 style);
 
@@ -211,7 +213,7 @@ public:
 
 	void setUnselected() { mIsSelected = FALSE; }
 
-	void setIsCurSelection(BOOL select) { mIsCurSelection = select; }
+	void setIsCurSelection(BOOL select) { mIsCurSelection = select; invalidateRenderCache(); }
 
 	BOOL getIsCurSelection() { return mIsCurSelection; }
 
@@ -72,7 +72,7 @@ public:
 
 	std::string	getImageName() const;
 
-	void			setColor(const LLColor4& color) { mColor = color; }
+	void			setColor(const LLColor4& color) { mColor = color; invalidateRenderCache(); }
 	void			setImage(LLPointer<LLUIImage> image) { mImagep = image; }
 	const LLPointer<LLUIImage> getImage() { return mImagep; }
 	
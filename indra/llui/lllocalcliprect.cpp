@@ -30,6 +30,9 @@
 #include "llui.h"
 
 /*static*/ std::stack<LLRect> LLScreenClipRect::sClipRectStack;
+/*static*/ std::stack<LLRect> LLScreenClipRect::sOnscreenClipRectStack;
+/*static*/ S32 LLScreenClipRect::sOriginX = 0;
+/*static*/ S32 LLScreenClipRect::sOriginY = 0;
 
 
 LLScreenClipRect::LLScreenClipRect(const LLRect& rect, BOOL enabled)
@@ -88,14 +91,35 @@ void LLScreenClipRect::updateScissorRegion()
 	LLRect rect = sClipRectStack.top();
 	stop_glerror();
 	S32 x,y,w,h;
-	x = llfloor(rect.mLeft * LLUI::getScaleFactor().mV[VX]);
-	y = llfloor(rect.mBottom * LLUI::getScaleFactor().mV[VY]);
+	x = llfloor(rect.mLeft * LLUI::getScaleFactor().mV[VX]) - sOriginX;
+	y = llfloor(rect.mBottom * LLUI::getScaleFactor().mV[VY]) - sOriginY;
 	w = llmax(0, llceil(rect.getWidth() * LLUI::getScaleFactor().mV[VX])) + 1;
 	h = llmax(0, llceil(rect.getHeight() * LLUI::getScaleFactor().mV[VY])) + 1;
 	glScissor( x,y,w,h );
 	stop_glerror();
 }
 
+//static
+void LLScreenClipRect::beginOffscreen(S32 origin_x, S32 origin_y)
+{
+	llassert(sOnscreenClipRectStack.empty());
+	gGL.flush();
+	sOnscreenClipRectStack.swap(sClipRectStack);
+	sOriginX = origin_x;
+	sOriginY = origin_y;
+}
+
+//static
+void LLScreenClipRect::endOffscreen()
+{
+	llassert(sClipRectStack.empty());
+	gGL.flush();
+	sClipRectStack.swap(sOnscreenClipRectStack);
+	sOriginX = 0;
+	sOriginY = 0;
+	updateScissorRegion();
+}
+
 //---------------------------------------------------------------------------
 // LLLocalClipRect
 //---------------------------------------------------------------------------
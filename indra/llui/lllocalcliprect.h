@@ -41,6 +41,12 @@ public:
 	LLScreenClipRect(const LLRect& rect, BOOL enabled = TRUE);
 	virtual ~LLScreenClipRect();
 
+	// UI drawn into an offscreen target starts with no clip rects, and its
+	// scissor boxes are relative to the target, whose origin is at the given
+	// window pixel. Must be paired with endOffscreen().
+	static void beginOffscreen(S32 origin_x, S32 origin_y);
+	static void endOffscreen();
+
 private:
 	static void pushClipRect(const LLRect& rect);
 	static void popClipRect();
@@ -51,6 +57,9 @@ private:
 	BOOL			mEnabled;
 
 	static std::stack<LLRect> sClipRectStack;
+	static std::stack<LLRect> sOnscreenClipRectStack;	// saved by beginOffscreen()
+	static S32		sOriginX;
+	static S32		sOriginY;
 };
 
 class LLLocalClipRect : public LLScreenClipRect
@@ -33,6 +33,11 @@
 
 #include "llfocusmgr.h"
 #include "llfontgl.h"
+#include "llgl.h"
+#include "llimagegl.h"
+#include "lllocalcliprect.h"
+#include "llrender.h"
+#include "llrendertarget.h"
 #include "llrect.h"
 #include "llerror.h"
 #include "lldir.h"
@@ -51,6 +56,10 @@
 
 static LLDefaultChildRegistry::Register<LLPanel> r1("panel", &LLPanel::fromXML);
 LLPanel::factory_stack_t	LLPanel::sFactoryStack;
+std::set<LLPanel*>			LLPanel::sRenderCachePanels;
+bool						LLPanel::sDrawingRenderCache = false;
+
+static LLTrace::BlockTimerStatHandle FTM_RENDER_UI_CACHE("UI Cache Render");
 
 
 // Compiler optimization, generate extern template
@@ -85,7 +94,8 @@ LLPanel::Params::Params()
 	class_name("class"),
 	help_topic("help_topic"),
 	visible_callback("visible_callback"),
-	accepts_badge("accepts_badge")
+	accepts_badge("accepts_badge"),
+	cache_render("cache_render", false)
 {
 	addSynonym(background_visible, "bg_visible");
 	addSynonym(has_border, "border_visible");
@@ -111,7 +121,11 @@ LLPanel::LLPanel(const LLPanel::Params& p)
 	mCommitCallbackRegistrar(false),
 	mEnableCallbackRegistrar(false),
 	mXMLFilename(p.filename),
-	mVisibleSignal(NULL)
+	mVisibleSignal(NULL),
+	mCacheRender(p.cache_render),
+	mRenderCache(NULL),
+	mRenderCacheAlpha(1.f),
+	mRenderCacheTextureGeneration(0)
 	// *NOTE: Be sure to also change LLPanel::initFromParams().  We have too
 	// many classes derived from LLPanel to retrofit them all to pass in params.
 {
@@ -123,6 +137,7 @@ LLPanel::LLPanel(const LLPanel::Params& p)
 
 LLPanel::~LLPanel()
 {
+	releaseRenderCache();
 	delete mVisibleSignal;
 }
 
@@ -237,7 +252,197 @@ void LLPanel::draw()
 
 	updateDefaultBtn();
 
-	LLView::draw();
+	drawChildrenCached();
+}
+
+void LLPanel::setCacheRender(bool cache)
+{
+	mCacheRender = cache;
+	if (!cache)
+	{
+		releaseRenderCache();
+	}
+}
+
+//static
+void LLPanel::destroyRenderCaches()
+{
+	while (!sRenderCachePanels.empty())
+	{
+		(*sRenderCachePanels.begin())->releaseRenderCache();
+	}
+}
+
+void LLPanel::releaseRenderCache()
+{
+	if (mRenderCache)
+	{
+		delete mRenderCache;
+		mRenderCache = NULL;
+		sRenderCachePanels.erase(this);
+		invalidateRenderCache();
+	}
+}
+
+void LLPanel::drawChildrenCached()
+{
+	static LLUICachedControl<bool> use_render_cache("UIRenderCache", false);
+	static LLUICachedControl<F32> render_cache_max_age("UIRenderCacheMaxAge", 0.f);
+
+	if (sDrawingRenderCache)
+	{
+		// nested cached panels are part of the outer panel's cache
+		LLView::draw();
+		return;
+	}
+
+	if (!mCacheRender || !use_render_cache || LLView::sDebugRects
+		|| !gGLManager.mHasFramebufferObject || !gGLManager.mHasBlendFuncSeparate)
+	{
+		releaseRenderCache();
+		LLView::draw();
+		return;
+	}
+
+	// Hover highlights, carets and focus borders change without invalidating
+	// anything, so draw live while the user works in this panel and cache
+	// again on the first frame after.
+	S32 mouse_x, mouse_y;
+	LLUI::getInstance()->getMousePositionLocal(this, &mouse_x, &mouse_y);
+	if (pointInView(mouse_x, mouse_y)
+		|| gFocusMgr.childHasKeyboardFocus(this)
+		|| gFocusMgr.childHasMouseCapture(this))
+	{
+		invalidateRenderCache();
+		LLView::draw();
+		return;
+	}
+
+	LLRect screen_rect = calcScreenRect();
+	const LLVector2& scale = LLUI::getScaleFactor();
+	F32 alpha = getDrawContext().mAlpha * getCurrentTransparency();
+	if (!mRenderCache
+		|| isRenderCacheDirty()
+		|| screen_rect != mRenderCacheRect
+		|| scale != mRenderCacheScale
+		|| alpha != mRenderCacheAlpha
+		// a texture the panel may show, such as an avatar icon, has loaded
+		|| LLImageGL::sUITextureGeneration != mRenderCacheTextureGeneration
+		|| mRenderCacheTimer.getElapsedTimeF32() >= render_cache_max_age)
+	{
+		if (!updateRenderCache(screen_rect))
+		{
+			LLView::draw();
+			return;
+		}
+		mRenderCacheRect = screen_rect;
+		mRenderCacheScale = scale;
+		mRenderCacheAlpha = alpha;
+		mRenderCacheTextureGeneration = LLImageGL::sUITextureGeneration;
+		mRenderCacheTimer.reset();
+	}
+
+	drawRenderCache(screen_rect);
+}
+
+bool LLPanel::updateRenderCache(const LLRect& screen_rect)
+{
+	LL_RECORD_BLOCK_TIME(FTM_RENDER_UI_CACHE);
+
+	// Window pixels covered by the panel
+	const LLVector2& scale = LLUI::getScaleFactor();
+	S32 left = llfloor(screen_rect.mLeft * scale.mV[VX]);
+	S32 bottom = llfloor(screen_rect.mBottom * scale.mV[VY]);
+	S32 width = llceil(screen_rect.mRight * scale.mV[VX]) - left;
+	S32 height = llceil(screen_rect.mTop * scale.mV[VY]) - bottom;
+	if (width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	if (!mRenderCache)
+	{
+		mRenderCache = new LLRenderTarget();
+		sRenderCachePanels.insert(this);
+	}
+	if (mRenderCache->getWidth() != (U32) width || mRenderCache->getHeight() != (U32) height)
+	{
+		if (!mRenderCache->allocate(width, height, GL_RGBA, false, false, LLTexUnit::TT_TEXTURE, true))
+		{
+			LL_WARNS() << "Could not allocate render cache for panel " << getName() << LL_ENDL;
+			mCacheRender = false;
+			releaseRenderCache();
+			return false;
+		}
+	}
+
+	// Anything already queued, like this panel's background, belongs on screen
+	gGL.flush();
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	bool alpha_mask = gGL.getAlphaMask();
+
+	mRenderCache->bindTarget();
+	// Same transform as on screen, shifted so the panel lands at the origin
+	glViewport(viewport[0] - left, viewport[1] - bottom, viewport[2], viewport[3]);
+	LLScreenClipRect::beginOffscreen(left - viewport[0], bottom - viewport[1]);
+	{
+		LLGLDisable scissor(GL_SCISSOR_TEST);
+		gGL.setColorMask(true, true);
+		glClearColor(0.f, 0.f, 0.f, 0.f);
+		mRenderCache->clear();
+		// Children blend over transparent black, keep the result premultiplied
+		gGL.setAccumulateAlpha(true);
+
+		// Children outside the UI dirty rect would be skipped
+		LLRect& dirty_rect = LLUI::getInstance()->mDirtyRect;
+		LLRect saved_dirty_rect = dirty_rect;
+		dirty_rect.unionWith(screen_rect);
+
+		sDrawingRenderCache = true;
+		LLView::draw();
+		sDrawingRenderCache = false;
+
+		dirty_rect = saved_dirty_rect;
+		gGL.setAccumulateAlpha(false);
+		gGL.setColorMask(true, alpha_mask);
+	}
+	LLScreenClipRect::endOffscreen();
+	mRenderCache->flush();
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+	clearRenderCacheDirty();
+	return true;
+}
+
+void LLPanel::drawRenderCache(const LLRect& screen_rect)
+{
+	// The cache covers whole pixels, so its corners are a little outside
+	// the panel when the UI is scaled
+	const LLVector2& scale = LLUI::getScaleFactor();
+	F32 left = (F32) llfloor(screen_rect.mLeft * scale.mV[VX]) / scale.mV[VX] - screen_rect.mLeft;
+	F32 bottom = (F32) llfloor(screen_rect.mBottom * scale.mV[VY]) / scale.mV[VY] - screen_rect.mBottom;
+	F32 right = left + (F32) mRenderCache->getWidth() / scale.mV[VX];
+	F32 top = bottom + (F32) mRenderCache->getHeight() / scale.mV[VY];
+
+	mRenderCache->bindTexture(0, 0, LLTexUnit::TFO_POINT);
+	gGL.blendFunc(LLRender::BF_ONE, LLRender::BF_ONE_MINUS_SOURCE_ALPHA);
+	gGL.color4f(1.f, 1.f, 1.f, 1.f);
+	gGL.begin(LLRender::QUADS);
+	{
+		gGL.texCoord2f(0.f, 1.f);
+		gGL.vertex2f(left, top);
+		gGL.texCoord2f(0.f, 0.f);
+		gGL.vertex2f(left, bottom);
+		gGL.texCoord2f(1.f, 0.f);
+		gGL.vertex2f(right, bottom);
+		gGL.texCoord2f(1.f, 1.f);
+		gGL.vertex2f(right, top);
+	}
+	gGL.end();
+	gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+	gGL.setSceneBlendType(LLRender::BT_ALPHA);
 }
 
 void LLPanel::updateDefaultBtn()
@@ -357,6 +562,10 @@ BOOL LLPanel::handleKeyHere( KEY key, MASK mask )
 void LLPanel::onVisibilityChange ( BOOL new_visibility )
 {
 	LLUICtrl::onVisibilityChange ( new_visibility );
+	if (!new_visibility)
+	{
+		releaseRenderCache();
+	}
 	if (mVisibleSignal)
 		(*mVisibleSignal)(this, LLSD(new_visibility) ); // Pass BOOL as LLSD
 }
@@ -498,6 +707,7 @@ void LLPanel::initFromParams(const LLPanel::Params& p)
 	mBgAlphaImageOverlay = p.bg_alpha_image_overlay;
 
 	setAcceptsBadge(p.accepts_badge);
+	setCacheRender(p.cache_render);
 }
 
 static LLTrace::BlockTimerStatHandle FTM_PANEL_SETUP("Panel Setup");
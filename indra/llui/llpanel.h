@@ -36,14 +36,18 @@
 #include "lluistring.h"
 #include "v4color.h"
 #include "llbadgeholder.h"
+#include "llframetimer.h"
+#include "v2math.h"
 #include <list>
 #include <queue>
+#include <set>
 
 const S32 LLPANEL_BORDER_WIDTH = 1;
 const BOOL BORDER_YES = TRUE;
 const BOOL BORDER_NO = FALSE;
 
 class LLButton;
+class LLRenderTarget;
 class LLUIImage;
 
 /*
@@ -92,6 +96,8 @@ public:
 		Optional<CommitCallbackParam> visible_callback;
 
 		Optional<bool>			accepts_badge;
+
+		Optional<bool>			cache_render;
 		
 		Params();
 	};
@@ -220,6 +226,14 @@ public:
 	
 	boost::signals2::connection setVisibleCallback( const commit_signal_t::slot_type& cb );
 
+	// Draw children through an offscreen copy that is only redrawn when a
+	// view under this panel is invalidated. Needs UIRenderCache to be on.
+	void			setCacheRender(bool cache);
+	bool			getCacheRender() const { return mCacheRender; }
+
+	// Frees every panel's render cache, call before the GL context goes away
+	static void		destroyRenderCaches();
+
 protected:
 	// Override to set not found list
 	LLButton*		getDefaultButton() { return mDefaultBtn; }
@@ -235,8 +249,15 @@ protected:
 
 	// for setting the xml filename when building panel in context dependent cases
 	std::string		mXMLFilename;
+
+	// LLView::draw(), from the render cache when possible
+	void			drawChildrenCached();
 	
 private:
+	bool			updateRenderCache(const LLRect& screen_rect);
+	void			drawRenderCache(const LLRect& screen_rect);
+	void			releaseRenderCache();
+
 	BOOL			mBgVisible;				// any background at all?
 	BOOL			mBgOpaque;				// use opaque color or image
 	LLUIColor		mBgOpaqueColor;
@@ -252,6 +273,17 @@ private:
 	typedef std::map<std::string, std::string> ui_string_map_t;
 	ui_string_map_t	mUIStrings;
 
+	bool			mCacheRender;
+	LLRenderTarget*	mRenderCache;
+	LLRect			mRenderCacheRect;		// screen rect the cache was drawn at
+	LLVector2		mRenderCacheScale;
+	F32				mRenderCacheAlpha;
+	U32				mRenderCacheTextureGeneration;	// LLImageGL::sUITextureGeneration when drawn
+	LLFrameTimer	mRenderCacheTimer;
+
+	static std::set<LLPanel*> sRenderCachePanels;
+	static bool		sDrawingRenderCache;
+
 
 }; // end class LLPanel
 
@@ -505,6 +505,7 @@ void LLScrollListCtrl::reshape( S32 width, S32 height, BOOL called_from_parent )
 
 void LLScrollListCtrl::updateLayout()
 {
+	invalidateRenderCache();
 	static LLUICachedControl<S32> scrollbar_size ("UIScrollbarSize", 0);
 	// reserve room for column headers, if needed
 	S32 heading_size = (mDisplayColumnHeaders ? mHeadingHeight : 0);
@@ -1007,6 +1008,7 @@ void LLScrollListCtrl::mouseOverHighlightNthItem(S32 target_index)
 	if (mHighlightedItem != target_index)
 	{
 		mHighlightedItem = target_index;
+		invalidateRenderCache();
 	}
 }
 
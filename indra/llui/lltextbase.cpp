@@ -1264,6 +1264,7 @@ void LLTextBase::setColor( const LLColor4& c )
 {
 	mFgColor = c;
 	mStyleDirty = true;
+	invalidateRenderCache();
 }
 
 //virtual 
@@ -2226,6 +2227,7 @@ void LLTextBase::needsReflow(S32 index)
 {
 	LL_DEBUGS() << "reflow on object " << (void*)this << " index = " << mReflowIndex << ", new index = " << index << LL_ENDL;
 	mReflowIndex = llmin(mReflowIndex, index);
+	invalidateRenderCache();
 }
 
 void LLTextBase::appendLineBreakSegment(const LLStyle::Params& style_params)
@@ -435,6 +435,7 @@ BOOL LLUICtrl::isCtrl() const
 void LLUICtrl::setValue(const LLSD& value)
 {
     mViewModel->setValue(value);
+    invalidateRenderCache();
 }
 
 //virtual
@@ -1033,7 +1034,11 @@ F32 LLUICtrl::getCurrentTransparency()
 
 void LLUICtrl::setTransparencyType(ETypeTransparency type)
 {
-	mTransparencyType = type;
+	if (type != mTransparencyType)
+	{
+		mTransparencyType = type;
+		invalidateRenderCache();
+	}
 }
 
 boost::signals2::connection LLUICtrl::setCommitCallback(const CommitCallbackParam& cb)
@@ -136,6 +136,7 @@ LLView::LLView(const LLView::Params& p)
 :	LLTrace::MemTrackable<LLView>("LLView"),
 	mVisible(p.visible),
 	mInDraw(false),
+	mRenderCacheDirty(true),
 	mName(p.name),
 	mParentView(NULL),
 	mReshapeFlags(FOLLOWS_NONE),
@@ -306,6 +307,7 @@ bool LLView::addChild(LLView* child, S32 tab_group)
 
 	child->mParentView = this;
 	updateBoundingRect();
+	invalidateRenderCache();
 	mLastTabGroup = tab_group;
 	return true;
 }
@@ -343,6 +345,7 @@ void LLView::removeChild(LLView* child)
 		LL_WARNS() << "\"" << child->getName() << "\" is not a child of " << getName() << LL_ENDL;
 	}
 	updateBoundingRect();
+	invalidateRenderCache();
 }
 
 BOOL LLView::isInVisibleChain() const
@@ -440,7 +443,11 @@ BOOL LLView::canFocusChildren() const
 //virtual
 void LLView::setEnabled(BOOL enabled)
 {
-	mEnabled = enabled;
+	if (mEnabled != enabled)
+	{
+		mEnabled = enabled;
+		invalidateRenderCache();
+	}
 }
 
 //virtual
@@ -589,6 +596,7 @@ void LLView::setVisible(BOOL visible)
 	if ( mVisible != visible )
 	{
 		mVisible = visible;
+		invalidateRenderCache();
 
 		// notify children of visibility change if root, or part of visible hierarchy
 		if (!getParent() || getParent()->isInVisibleChain())
@@ -645,6 +653,7 @@ void LLView::translate(S32 x, S32 y)
 {
 	mRect.translate(x, y);
 	updateBoundingRect();
+	invalidateRenderCache();
 }
 
 // virtual
@@ -1217,6 +1226,27 @@ void LLView::dirtyRect()
 	}
 
 	LLUI::getInstance()->dirtyRect(cur->calcScreenRect());
+	invalidateRenderCache();
+}
+
+void LLView::invalidateRenderCache()
+{
+	for (LLView* viewp = this; viewp && !viewp->mRenderCacheDirty; viewp = viewp->mParentView)
+	{
+		viewp->mRenderCacheDirty = true;
+	}
+}
+
+void LLView::clearRenderCacheDirty()
+{
+	mRenderCacheDirty = false;
+	BOOST_FOREACH(LLView* childp, mChildList)
+	{
+		if (childp)
+		{
+			childp->clearRenderCacheDirty();
+		}
+	}
 }
 
 //Draw a box for debugging.
@@ -1338,6 +1368,7 @@ void LLView::reshape(S32 width, S32 height, BOOL called_from_parent)
 		// adjust our rectangle
 		mRect.mRight = getRect().mLeft + width;
 		mRect.mTop = getRect().mBottom + height;
+		invalidateRenderCache();
 
 		// move child views according to reshape flags
 		BOOST_FOREACH(LLView* viewp, mChildList)
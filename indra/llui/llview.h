@@ -517,6 +517,11 @@ public:
 	virtual void	handleReshape(const LLRect& rect, bool by_user);
 	virtual void	dirtyRect();
 
+	// Marks this view and its ancestors as changed since a panel with a
+	// render cache last drew them (see LLPanel::setCacheRender())
+	void			invalidateRenderCache();
+	bool			isRenderCacheDirty() const	{ return mRenderCacheDirty; }
+
 	//send custom notification to LLView parent
 	virtual S32	notifyParent(const LLSD& info);
 
@@ -536,6 +541,7 @@ protected:
 	void			drawDebugRect();
 	void			drawChild(LLView* childp, S32 x_offset = 0, S32 y_offset = 0, BOOL force_draw = FALSE);
 	void			drawChildren();
+	void			clearRenderCacheDirty();
 	bool			visibleAndContains(S32 local_x, S32 local_Y);
 	bool			visibleEnabledAndContains(S32 local_x, S32 local_y);
 	void			logMouseEvent();
@@ -612,6 +618,7 @@ private:
 	BOOL		mLastVisible;
 
 	bool		mInDraw;
+	bool		mRenderCacheDirty;	// if set, every ancestor is set too
 
 	static LLWindow* sWindow;	// All root views must know about their window.
 
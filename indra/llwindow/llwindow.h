@@ -125,6 +125,15 @@ public:
 	virtual void bringToFront() = 0;
 	virtual void focusClient() { };		// this may not have meaning or be required on other platforms, therefore, it's not abstract
 	virtual void setOldResize(bool oldresize) { };
+
+	// GL contexts sharing objects with the window's context, for loading on
+	// other threads. Create and destroy them on the main thread, make one
+	// current on the thread that uses it (NULL releases it).
+	// createSharedContext returns NULL where sharing is not supported.
+	virtual void* createSharedContext() { return NULL; }
+	virtual void makeContextCurrent(void* context) {}
+	virtual void destroySharedContext(void* context) {}
+
 	// handy coordinate space conversion routines
 	// NB: screen to window and vice verse won't work on width/height coordinate pairs,
 	// as the conversion must take into account left AND right border widths, etc.
@@ -970,6 +970,27 @@ void LLWindowMacOSX::swapBuffers()
 	CGLFlushDrawable(mContext);
 }
 
+void* LLWindowMacOSX::createSharedContext()
+{
+	CGLContextObj context = NULL;
+	if (CGLCreateContext(CGLGetPixelFormat(mContext), mContext, &context) != kCGLNoError)
+	{
+		LL_WARNS("Window") << "Could not create a shared OpenGL context" << LL_ENDL;
+		return NULL;
+	}
+	return context;
+}
+
+void LLWindowMacOSX::makeContextCurrent(void* context)
+{
+	CGLSetCurrentContext((CGLContextObj) context);
+}
+
+void LLWindowMacOSX::destroySharedContext(void* context)
+{
+	CGLDestroyContext((CGLContextObj) context);
+}
+
 void LLWindowMacOSX::restoreGLContext()
 {
     CGLSetCurrentContext(mContext);
@@ -87,6 +87,9 @@ public:
 	/*virtual*/ void gatherInput();
 	/*virtual*/ void delayInputProcessing() {};
 	/*virtual*/ void swapBuffers();
+	/*virtual*/ void* createSharedContext();
+	/*virtual*/ void makeContextCurrent(void* context);
+	/*virtual*/ void destroySharedContext(void* context);
 	
 	// handy coordinate space conversion routines
 	/*virtual*/ BOOL convertCoords(LLCoordScreen from, LLCoordWindow *to);
@@ -3331,6 +3331,46 @@ void LLWindowWin32::swapBuffers()
 	SwapBuffers(mhDC);
 }
 
+void* LLWindowWin32::createSharedContext()
+{
+	HGLRC rc = 0;
+	if (wglCreateContextAttribsARB)
+	{ //same version and profile as the window's context
+		S32 major = (S32) gGLManager.mGLVersion;
+		S32 minor = ll_round((gGLManager.mGLVersion - (F32) major) * 10.f);
+		S32 attribs[] = 
+		{
+			WGL_CONTEXT_MAJOR_VERSION_ARB, major,
+			WGL_CONTEXT_MINOR_VERSION_ARB, minor,
+			WGL_CONTEXT_PROFILE_MASK_ARB,  LLRender::sGLCoreProfile ? WGL_CONTEXT_CORE_PROFILE_BIT_ARB : WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB,
+			WGL_CONTEXT_FLAGS_ARB, gDebugGL ? WGL_CONTEXT_DEBUG_BIT_ARB : 0,
+			0
+		};
+		rc = wglCreateContextAttribsARB(mhDC, mhRC, attribs);
+	}
+	else if ((rc = SafeCreateContext(mhDC)) && !wglShareLists(mhRC, rc))
+	{
+		wglDeleteContext(rc);
+		rc = 0;
+	}
+
+	if (!rc)
+	{
+		LL_WARNS("Window") << "Could not create a shared OpenGL context" << LL_ENDL;
+	}
+	return rc;
+}
+
+void LLWindowWin32::makeContextCurrent(void* context)
+{
+	wglMakeCurrent(context ? mhDC : NULL, (HGLRC) context);
+}
+
+void LLWindowWin32::destroySharedContext(void* context)
+{
+	wglDeleteContext((HGLRC) context);
+}
+
 
 //
 // LLSplashScreenImp
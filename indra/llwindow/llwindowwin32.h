@@ -84,6 +84,9 @@ public:
 	/*virtual*/ void delayInputProcessing();
 	/*virtual*/ void swapBuffers();
 	/*virtual*/ void restoreGLContext() {};
+	/*virtual*/ void* createSharedContext();
+	/*virtual*/ void makeContextCurrent(void* context);
+	/*virtual*/ void destroySharedContext(void* context);
 
 	// handy coordinate space conversion routines
 	/*virtual*/ BOOL convertCoords(LLCoordScreen from, LLCoordWindow *to);
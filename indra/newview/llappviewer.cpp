@@ -66,6 +66,7 @@
 #include "lldxhardware.h"
 #endif
 #include "lltexturestats.h"
+#include "llthreadpool.h"
 #include "lltrace.h"
 #include "lltracethreadrecorder.h"
 #include "llviewerwindow.h"
@@ -572,6 +573,7 @@ static void settings_to_globals()
 	LLRender::sGLCoreProfile = gSavedSettings.getBOOL("RenderGLCoreProfile");
 	LLRender::sNsightDebugSupport = gSavedSettings.getBOOL("RenderNsightDebugSupport");
 	LLVertexBuffer::sUseVAO = gSavedSettings.getBOOL("RenderUseVAO");
+	LLVertexBuffer::sUseStreamRing = gSavedSettings.getBOOL("RenderUseStreamRing");
 	LLImageGL::sGlobalUseAnisotropic	= gSavedSettings.getBOOL("RenderAnisotropic");
 	LLImageGL::sCompressTextures		= gSavedSettings.getBOOL("RenderCompressTextures");
 	LLVOVolume::sLODFactor				= llclamp(gSavedSettings.getF32("RenderVolumeLODFactor"), 0.01f, MAX_LOD_FACTOR);
@@ -2037,6 +2039,7 @@ bool LLAppViewer::cleanup()
 
 	SUBSYSTEM_CLEANUP(LLFilePickerThread);
 	SUBSYSTEM_CLEANUP(LLDirPickerThread);
+	SUBSYSTEM_CLEANUP(LLThreadPool);
 
 	//MUST happen AFTER SUBSYSTEM_CLEANUP(LLCurl)
 	delete sTextureCache;
@@ -2186,6 +2189,11 @@ bool LLAppViewer::initThreads()
 	LLVFSThread::initClass(enable_threads && false);
 	LLLFSThread::initClass(enable_threads && false);
 
+	// General purpose workers, sized from the CPU count unless overridden
+	LLThreadPool::initClass(gSavedSettings.getU32("ThreadPoolSize"));
+	// Volume LOD switches, the manager is gone before the pool shuts down
+	LLPrimitive::getVolumeManager()->useThreadPool(LLThreadPool::getInstance());
+
 	// Image decoding
 	LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true);
 	LLAppViewer::sTextureCache = new LLTextureCache(enable_threads && true);
@@ -4159,7 +4167,7 @@ U32 LLAppViewer::getObjectCacheVersion()
 {
 	// Viewer object cache version, change if object update
 	// format changes. JC
-	const U32 INDRA_OBJECT_CACHE_VERSION = 15;
+	const U32 INDRA_OBJECT_CACHE_VERSION = 16;
 
 	return INDRA_OBJECT_CACHE_VERSION;
 }
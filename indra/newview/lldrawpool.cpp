@@ -44,6 +44,7 @@
 #include "lldrawpoolwater.h"
 #include "llface.h"
 #include "llviewerobjectlist.h" // For debug listing.
+#include "llviewerstats.h"
 #include "pipeline.h"
 #include "llspatialpartition.h"
 #include "llviewercamera.h"
@@ -52,6 +53,7 @@
 #include "llglcommonfunc.h"
 
 S32 LLDrawPool::sNumDrawPools = 0;
+U32 LLRenderPass::sStatPoolType = 0;
 
 //=============================
 // Draw Pool Implementation
@@ -400,7 +402,8 @@ void LLRenderPass::renderGroup(LLSpatialGroup* group, U32 type, U32 mask, BOOL t
 	for (LLSpatialGroup::drawmap_elem_t::iterator k = draw_info.begin(); k != draw_info.end(); ++k)	
 	{
 		LLDrawInfo *pparams = *k;
-		if (pparams) {
+		if (pparams && !(LLPipeline::sMultiDrawIndirect && pparams->mIndirectMerged))
+		{ //merged batches are drawn by the indirect commands of an earlier batch
 			pushBatch(*pparams, mask, texture);
 		}
 	}
@@ -459,6 +462,76 @@ void LLRenderPass::applyModelMatrix(const LLDrawInfo& params)
 	}
 }
 
+void LLRenderPass::recordBatchState(const LLDrawInfo& params)
+{
+	// Only compared against, never dereferenced.
+	static const LLViewerTexture* last_texture = NULL;
+	static const LLVertexBuffer* last_buffer = NULL;
+
+	S32 changes = 0;
+	if (params.mModelMatrix != gGLLastMatrix)
+	{
+		++changes;
+	}
+	if (params.mTexture.get() != last_texture)
+	{
+		last_texture = params.mTexture.get();
+		++changes;
+	}
+	if (params.mVertexBuffer.get() != last_buffer)
+	{
+		last_buffer = params.mVertexBuffer.get();
+		++changes;
+	}
+
+	const U32 pool = sStatPoolType < LLDrawPool::NUM_POOL_TYPES ? sStatPoolType : 0;
+	add(LLStatViewer::RENDER_BATCHES, 1);
+	add(LLStatViewer::RENDER_POOL_BATCHES[pool], 1);
+	if (changes)
+	{
+		add(LLStatViewer::RENDER_STATE_CHANGES, changes);
+		add(LLStatViewer::RENDER_POOL_STATE_CHANGES[pool], changes);
+	}
+}
+
+// static
+void LLRenderPass::drawBatch(LLDrawInfo& params)
+{
+	if (params.mIndirectCount && LLPipeline::sMultiDrawIndirect && params.mGroup && params.mGroup->mIndirectBuffer.notNull())
+	{
+		params.mVertexBuffer->drawMultiIndirect(params.mDrawMode, params.mGroup->mIndirectBuffer, params.mIndirectFirst, params.mIndirectCount, params.mIndirectIndices);
+		gPipeline.addTrianglesDrawn(params.mIndirectIndices, params.mDrawMode);
+	}
+	else
+	{
+		params.mVertexBuffer->drawRange(params.mDrawMode, params.mStart, params.mEnd, params.mCount, params.mOffset);
+		gPipeline.addTrianglesDrawn(params.mCount, params.mDrawMode);
+	}
+}
+
+// static
+bool LLRenderPass::isOrderIndependent(U32 type)
+{
+	switch (type)
+	{
+	case PASS_POST_BUMP:
+	case PASS_MATERIAL_ALPHA:
+	case PASS_MATERIAL_ALPHA_EMISSIVE:
+	case PASS_SPECMAP_BLEND:
+	case PASS_SPECMAP_EMISSIVE:
+	case PASS_NORMMAP_BLEND:
+	case PASS_NORMMAP_EMISSIVE:
+	case PASS_NORMSPEC_BLEND:
+	case PASS_NORMSPEC_EMISSIVE:
+	case PASS_GLOW:
+	case PASS_ALPHA:
+	case PASS_ALPHA_INVISIBLE:
+		return false;
+	default:
+		return true;
+	}
+}
+
 void LLRenderPass::pushBatch(LLDrawInfo& params, U32 mask, BOOL texture, BOOL batch_textures)
 {
     if (!params.mCount)
@@ -466,6 +539,7 @@ void LLRenderPass::pushBatch(LLDrawInfo& params, U32 mask, BOOL texture, BOOL ba
         return;
     }
 
+	recordBatchState(params);
 	applyModelMatrix(params);
 
 	bool tex_setup = false;
@@ -514,8 +588,7 @@ void LLRenderPass::pushBatch(LLDrawInfo& params, U32 mask, BOOL texture, BOOL ba
 		LLGLEnableFunc stencil_test(GL_STENCIL_TEST, params.mSelected, &LLGLCommonFunc::selected_stencil_test);
 	
 		params.mVertexBuffer->setBuffer(mask);
-		params.mVertexBuffer->drawRange(params.mDrawMode, params.mStart, params.mEnd, params.mCount, params.mOffset);
-		gPipeline.addTrianglesDrawn(params.mCount, params.mDrawMode);
+		drawBatch(params);
 	}
 
 	if (tex_setup)
@@ -169,6 +169,18 @@ public:
 	void resetDrawOrders() { }
 
 	static void applyModelMatrix(const LLDrawInfo& params);
+	// Counts the batch and the texture, vertex buffer and transform changes
+	// since the previous one for the render stats. Call before binding.
+	static void recordBatchState(const LLDrawInfo& params);
+	// Draw pool type the batch stats are charged to, set by the pipeline
+	// while it renders a pool and 0 outside its pool loops.
+	static U32 sStatPoolType;
+	// Draw a batch whose vertex buffer is already set, through its group's
+	// indirect commands when it leads a run of merged batches.
+	static void drawBatch(LLDrawInfo& params);
+	// Render types whose batches may be drawn in any order. Blended passes
+	// must keep the order their groups were sorted into.
+	static bool isOrderIndependent(U32 type);
 	virtual void pushBatches(U32 type, U32 mask, BOOL texture = TRUE, BOOL batch_textures = FALSE);
 	virtual void pushMaskBatches(U32 type, U32 mask, BOOL texture = TRUE, BOOL batch_textures = FALSE);
 	virtual void pushBatch(LLDrawInfo& params, U32 mask, BOOL texture, BOOL batch_textures = FALSE);
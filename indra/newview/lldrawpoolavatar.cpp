@@ -28,6 +28,7 @@
 
 #include "lldrawpoolavatar.h"
 #include "llskinningutil.h"
+#include "llskinningjob.h"
 #include "llrender.h"
 
 #include "llvoavatar.h"
@@ -53,6 +54,7 @@
 #include "llviewerpartsim.h"
 #include "llviewercontrol.h" // for gSavedSettings
 #include "llviewertexturelist.h"
+#include "llthreadpool.h"
 
 static U32 sDataMask = LLDrawPoolAvatar::VERTEX_DATA_MASK;
 static U32 sBufferUsage = GL_STREAM_DRAW_ARB;
@@ -1829,6 +1831,10 @@ void LLDrawPoolAvatar::getRiggedGeometry(
 	buffer->flush();
 }
 
+// Vertices per slice handed to a worker when skinning on the CPU, rigged
+// mesh faces run from a few hundred to tens of thousands of vertices.
+const U32 SKINNING_JOB_GRAIN = 4096;
+
 void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(
     LLVOAvatar* avatar,
     LLFace* face,
@@ -1850,9 +1856,8 @@ void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(
 		return;
 	}
 
-    const U32 max_joints = LLSkinningUtil::getMaxJointCount();
-
 #if USE_SEPARATE_JOINT_INDICES_AND_WEIGHTS
+    const U32 max_joints = LLSkinningUtil::getMaxJointCount();
     #define CONDITION_WEIGHT(f) ((U8)llclamp((S32)f, (S32)0, (S32)max_joints-1))
     LLVector4a* just_weights = vol_face.mJustWeights;
     // we need to calculate the separated indices and store just the matrix weights for this vol...
@@ -1959,76 +1964,43 @@ void LLDrawPoolAvatar::updateRiggedFaceVertexBuffer(
 
 		LLVector4a* norm = has_normal ? (LLVector4a*) normal.get() : NULL;
 		
-		//build matrix palette
-		LLMatrix4a mat[LL_MAX_JOINTS_PER_MESH_OBJECT];
-        U32 count = LLSkinningUtil::getMeshJointCount(skin);
-        LLSkinningUtil::initSkinningMatrixPalette((LLMatrix4*)mat, count, skin, avatar);
+		//build matrix palette, with the bind shape matrix folded in so each
+		//vertex needs a single transform
+		U32 count = 0;
+		const LLMatrix4a* joints = LLSkinningUtil::getSkinningMatrixPalette(skin, avatar, count);
         LLSkinningUtil::checkSkinWeights(weights, buffer->getNumVerts(), skin);
 
 		LLMatrix4a bind_shape_matrix;
 		bind_shape_matrix.loadu(skin->mBindShapeMatrix);
 
-#if USE_SEPARATE_JOINT_INDICES_AND_WEIGHTS
-        U8* joint_indices_cursor = vol_face.mJointIndices;
-        // fast path with joint indices separate from weights
-        if (joint_indices_cursor)
-        {
-            LLMatrix4a src[4];
-		    for (U32 j = 0; j < buffer->getNumVerts(); ++j)
-		    {
-			    LLMatrix4a final_mat;
-                //LLMatrix4a final_mat_correct;
-
-                F32* jw = just_weights[j].getF32ptr();
-
-                LLSkinningUtil::getPerVertexSkinMatrixWithIndices(jw, joint_indices_cursor, mat, final_mat, src);                
-
-                joint_indices_cursor += 4;
-
-			    LLVector4a& v = vol_face.mPositions[j];
-
-			    LLVector4a t;
-			    LLVector4a dst;
-			    bind_shape_matrix.affineTransform(v, t);
-			    final_mat.affineTransform(t, dst);
-			    pos[j] = dst;
-
-			    if (norm)
-			    {
-				    LLVector4a& n = vol_face.mNormals[j];
-				    bind_shape_matrix.rotate(n, t);
-				    final_mat.rotate(t, dst);
-				    dst.normalize3fast();
-				    norm[j] = dst;
-			    }
-		    }
-        }
-        // slow path with joint indices calculated from weights
-        else
-#endif
-        {
-            for (U32 j = 0; j < buffer->getNumVerts(); ++j)
-		    {
-			    LLMatrix4a final_mat;
-                LLSkinningUtil::getPerVertexSkinMatrix(weights[j].getF32ptr(), mat, false, final_mat, max_joints);
-
-			    LLVector4a& v = vol_face.mPositions[j];
-			    LLVector4a t;
-			    LLVector4a dst;
-			    bind_shape_matrix.affineTransform(v, t);
-			    final_mat.affineTransform(t, dst);
-			    pos[j] = dst;
-
-			    if (norm)
-			    {
-				    LLVector4a& n = vol_face.mNormals[j];
-				    bind_shape_matrix.rotate(n, t);
-				    final_mat.rotate(t, dst);
-				    //dst.normalize3fast();
-				    norm[j] = dst;
-			    }
-		    }
-        }
+		LLMatrix4a palette[LL_MAX_JOINTS_PER_MESH_OBJECT];
+		LLSkinningJob::buildPalette(bind_shape_matrix, joints, count, palette);
+
+		LLSkinningJob job;
+		job.mPalette = palette;
+		job.mJointCount = count;
+		job.mWeights = weights;
+		job.mPositions = vol_face.mPositions;
+		job.mNormals = norm ? vol_face.mNormals : NULL;
+		job.mOutPositions = pos;
+		job.mOutNormals = norm;
+		job.mVertexCount = buffer->getNumVerts();
+
+		// Big meshes are split across the thread pool, smaller ones fit in a
+		// single grain and are skinned inline.
+		LLThreadPool* pool = LLThreadPool::getInstance();
+		if (pool)
+		{
+			pool->parallelFor(job.mVertexCount, SKINNING_JOB_GRAIN,
+				[&job](U32 begin, U32 end)
+				{
+					job.run(begin, end);
+				});
+		}
+		else
+		{
+			job.run();
+		}
 	}
 }
 
@@ -2175,9 +2147,8 @@ void LLDrawPoolAvatar::renderRigged(LLVOAvatar* avatar, U32 type, bool glow)
 			if (sShaderLevel > 0)
 			{
                 // upload matrix palette to shader
-				LLMatrix4a mat[LL_MAX_JOINTS_PER_MESH_OBJECT];
-				U32 count = LLSkinningUtil::getMeshJointCount(skin);
-                LLSkinningUtil::initSkinningMatrixPalette((LLMatrix4*)mat, count, skin, avatar);
+				U32 count = 0;
+				const LLMatrix4a* mat = LLSkinningUtil::getSkinningMatrixPalette(skin, avatar, count);
 
 				stop_glerror();
 
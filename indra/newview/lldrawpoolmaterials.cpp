@@ -135,29 +135,51 @@ void LLDrawPoolMaterials::renderDeferred(S32 pass)
 	LLCullResult::drawinfo_iterator begin = gPipeline.beginRenderMap(type);
 	LLCullResult::drawinfo_iterator end = gPipeline.endRenderMap(type);
 	
+	// The render map is sorted by material (see LLDrawInfo::getSortKey()),
+	// so only touch the material state that differs from the last batch.
+	const LLDrawInfo* last = NULL;
 	for (LLCullResult::drawinfo_iterator i = begin; i != end; ++i)
 	{
 		LLDrawInfo& params = **i;
 		
-		mShader->uniform4f(LLShaderMgr::SPECULAR_COLOR, params.mSpecColor.mV[0], params.mSpecColor.mV[1], params.mSpecColor.mV[2], params.mSpecColor.mV[3]);
-		mShader->uniform1f(LLShaderMgr::ENVIRONMENT_INTENSITY, params.mEnvIntensity);
+		if (!last || last->mSpecColor != params.mSpecColor)
+		{
+			mShader->uniform4f(LLShaderMgr::SPECULAR_COLOR, params.mSpecColor.mV[0], params.mSpecColor.mV[1], params.mSpecColor.mV[2], params.mSpecColor.mV[3]);
+		}
+		if (!last || last->mEnvIntensity != params.mEnvIntensity)
+		{
+			mShader->uniform1f(LLShaderMgr::ENVIRONMENT_INTENSITY, params.mEnvIntensity);
+		}
 		
 		if (params.mNormalMap)
 		{
 			params.mNormalMap->addTextureStats(params.mVSize);
-			bindNormalMap(params.mNormalMap);
+			if (!last || last->mNormalMap != params.mNormalMap)
+			{
+				bindNormalMap(params.mNormalMap);
+			}
 		}
 		
 		if (params.mSpecularMap)
 		{
 			params.mSpecularMap->addTextureStats(params.mVSize);
-			bindSpecularMap(params.mSpecularMap);
+			if (!last || last->mSpecularMap != params.mSpecularMap)
+			{
+				bindSpecularMap(params.mSpecularMap);
+			}
 		}
 		
-		mShader->setMinimumAlpha(params.mAlphaMaskCutoff);
-		mShader->uniform1f(LLShaderMgr::EMISSIVE_BRIGHTNESS, params.mFullbright ? 1.f : 0.f);
+		if (!last || last->mAlphaMaskCutoff != params.mAlphaMaskCutoff)
+		{
+			mShader->setMinimumAlpha(params.mAlphaMaskCutoff);
+		}
+		if (!last || last->mFullbright != params.mFullbright)
+		{
+			mShader->uniform1f(LLShaderMgr::EMISSIVE_BRIGHTNESS, params.mFullbright ? 1.f : 0.f);
+		}
 
 		pushBatch(params, mask, TRUE);
+		last = &params;
 	}
 }
 
@@ -173,6 +195,7 @@ void LLDrawPoolMaterials::bindNormalMap(LLViewerTexture* tex)
 
 void LLDrawPoolMaterials::pushBatch(LLDrawInfo& params, U32 mask, BOOL texture, BOOL batch_textures)
 {
+	recordBatchState(params);
 	applyModelMatrix(params);
 	
 	bool tex_setup = false;
@@ -225,8 +248,7 @@ void LLDrawPoolMaterials::pushBatch(LLDrawInfo& params, U32 mask, BOOL texture,
 	LLGLEnableFunc stencil_test(GL_STENCIL_TEST, params.mSelected, &LLGLCommonFunc::selected_stencil_test);
 
 	params.mVertexBuffer->setBuffer(mask);
-	params.mVertexBuffer->drawRange(params.mDrawMode, params.mStart, params.mEnd, params.mCount, params.mOffset);
-	gPipeline.addTrianglesDrawn(params.mCount, params.mDrawMode);
+	drawBatch(params);
 	if (tex_setup)
 	{
 		gGL.getTexUnit(0)->activate();
@@ -42,6 +42,7 @@
 
 class LLFacePool;
 class LLVolume;
+class LLVolumeFaceGeometryJob;
 class LLViewerTexture;
 class LLTextureEntry;
 class LLVertexProgram;
@@ -161,11 +162,15 @@ public:
 	//for volumes
 	void updateRebuildFlags();
 	bool canRenderAsMask(); // logic helper
+	// When job is given, indices, positions, normals and tangents are only
+	// mapped here and left for the caller to run the job before the vertex
+	// buffer is flushed.
 	BOOL getGeometryVolume(const LLVolume& volume,
 						const S32 &f,
 						const LLMatrix4& mat_vert, const LLMatrix3& mat_normal,
 						const U16 &index_offset,
-						bool force_rebuild = false);
+						bool force_rebuild = false,
+						LLVolumeFaceGeometryJob* job = NULL);
 
 	// For avatar
 	U16			 getGeometryAvatar(
@@ -374,6 +374,13 @@ const long UPLOAD_RETRY_LIMIT = 0L;
 // See wiki at https://wiki.secondlife.com/wiki/Mesh/Mesh_Asset_Format
 const S32 MAX_MESH_VERSION = 999;
 
+// Triangle orders from LLVolumeFace::cacheOptimize() are kept in the VFS next
+// to the mesh asset, one entry per mesh and LOD, so a cached LOD does not
+// have to be optimized again. Entries start with the magic number, the
+// version and the size of the LOD block they were made from.
+const U32 INDEX_ORDER_CACHE_MAGIC = 0x4c4c494f;	// 'LLIO'
+const U32 INDEX_ORDER_CACHE_VERSION = 1;
+
 U32 LLMeshRepository::sBytesReceived = 0;
 U32 LLMeshRepository::sMeshRequestCount = 0;
 U32 LLMeshRepository::sHTTPRequestCount = 0;
@@ -1874,6 +1881,108 @@ bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* dat
 	return true;
 }
 
+// VFS id of the triangle order entry for a mesh LOD. The salt only has to
+// keep these ids apart from the mesh asset ids.
+static LLUUID index_order_cache_id(const LLUUID& mesh_id, S32 lod)
+{
+	static const LLUUID salt("7d3f52c8-1a96-4e0b-b2c5-98e14a6f03d7");
+	LLUUID lod_salt = salt;
+	lod_salt.mData[0] ^= (U8)lod;
+	return mesh_id.combine(lod_salt);
+}
+
+static bool read_index_orders(const LLUUID& mesh_id, S32 lod, S32 data_size, LLVolume::index_order_list_t& orders)
+{
+	LLVFile file(gVFS, index_order_cache_id(mesh_id, lod), LLAssetType::AT_MESH);
+	S32 size = file.getSize();
+	if (size < (S32)(sizeof(U32) * 4))
+	{
+		return false;
+	}
+
+	std::vector<U8> buffer(size);
+	if (!file.read(&buffer[0], size) || file.getLastBytesRead() != size)
+	{
+		return false;
+	}
+	LLMeshRepository::sCacheBytesRead += size;
+	++LLMeshRepository::sCacheReads;
+
+	const U8* cur = &buffer[0];
+	const U8* end = cur + size;
+	U32 header[4];
+	memcpy(header, cur, sizeof(header));
+	cur += sizeof(header);
+	if (header[0] != INDEX_ORDER_CACHE_MAGIC ||
+		header[1] != INDEX_ORDER_CACHE_VERSION ||
+		header[2] != (U32)data_size)
+	{
+		return false;
+	}
+
+	// Faces are checked against the unpacked data in cacheOptimize(), only
+	// make sure nothing reads past the entry here.
+	orders.resize(header[3]);
+	for (U32 i = 0; i < header[3]; ++i)
+	{
+		U32 count = 0;
+		if (end - cur < (S32)sizeof(U32))
+		{
+			return false;
+		}
+		memcpy(&count, cur, sizeof(U32));
+		cur += sizeof(U32);
+
+		if ((U32)(end - cur) / sizeof(U16) < count)
+		{
+			return false;
+		}
+		orders[i].resize(count);
+		if (count)
+		{
+			memcpy(&orders[i][0], cur, count * sizeof(U16));
+		}
+		cur += count * sizeof(U16);
+	}
+
+	return true;
+}
+
+static void write_index_orders(const LLUUID& mesh_id, S32 lod, S32 data_size, const LLVolume::index_order_list_t& orders)
+{
+	S32 size = sizeof(U32) * 4;
+	for (U32 i = 0; i < orders.size(); ++i)
+	{
+		size += sizeof(U32) + orders[i].size() * sizeof(U16);
+	}
+
+	std::vector<U8> buffer(size);
+	U8* cur = &buffer[0];
+	U32 header[4] = { INDEX_ORDER_CACHE_MAGIC, INDEX_ORDER_CACHE_VERSION, (U32)data_size, (U32)orders.size() };
+	memcpy(cur, header, sizeof(header));
+	cur += sizeof(header);
+	for (U32 i = 0; i < orders.size(); ++i)
+	{
+		U32 count = orders[i].size();
+		memcpy(cur, &count, sizeof(U32));
+		cur += sizeof(U32);
+		if (count)
+		{
+			memcpy(cur, &orders[i][0], count * sizeof(U16));
+		}
+		cur += count * sizeof(U16);
+	}
+
+	LLVFile file(gVFS, index_order_cache_id(mesh_id, lod), LLAssetType::AT_MESH, LLVFile::WRITE);
+	if (file.getMaxSize() >= size || file.setMaxSize(size))
+	{
+		LLMeshRepository::sCacheBytesWritten += size;
+		++LLMeshRepository::sCacheWrites;
+
+		file.write(&buffer[0], size);
+	}
+}
+
 EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
 {
 	if (data == NULL || data_size == 0)
@@ -1894,8 +2003,20 @@ EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_p
 		return MESH_OUT_OF_MEMORY;
 	}
 
-	if (volume->unpackVolumeFaces(stream, data_size))
+	// Reuse the triangle orders from the last time this LOD was unpacked,
+	// and save them if they had to be computed.
+	const LLUUID& mesh_id = mesh_params.getSculptID();
+	LLVolume::index_order_list_t orders;
+	bool cached_orders = read_index_orders(mesh_id, lod, data_size, orders);
+	LLVolume::index_order_list_t used_orders(orders);
+
+	if (volume->unpackVolumeFaces(stream, data_size, &used_orders))
 	{
+		if (!cached_orders || used_orders != orders)
+		{
+			write_index_orders(mesh_id, lod, data_size, used_orders);
+		}
+
 		if (volume->getNumFaces() > 0)
 		{
 			LoadedMesh mesh(volume, mesh_params, lod);
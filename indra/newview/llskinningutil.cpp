@@ -33,6 +33,7 @@
 #include "llmeshrepository.h"
 #include "llvolume.h"
 #include "llrigginginfo.h"
+#include "llframetimer.h"
 
 #define DEBUG_SKINNING  LL_DEBUG
 #define MAT_USE_SSE     1
@@ -166,6 +167,55 @@ void LLSkinningUtil::initSkinningMatrixPalette(
     }
 }
 
+namespace
+{
+    struct SkinningPalette
+    {
+        SkinningPalette() : mCount(0), mFrame(0) {}
+
+        LLMatrix4a  mMatrix[LL_MAX_JOINTS_PER_MESH_OBJECT];
+        U32         mCount;
+        U32         mFrame;     // LLFrameTimer frame the palette was built in, 0 before the first build
+    };
+
+    typedef std::map<std::pair<const LLVOAvatar*, const LLMeshSkinInfo*>, SkinningPalette> skinning_palette_map_t;
+    skinning_palette_map_t sSkinningPalettes;
+    U32 sSkinningPaletteFrame = 0;
+}
+
+const LLMatrix4a* LLSkinningUtil::getSkinningMatrixPalette(const LLMeshSkinInfo* skin, LLVOAvatar* avatar, U32& count)
+{
+    // Frame numbers start at 1 here so that 0 can mean never built.
+    U32 frame = LLFrameTimer::getFrameCount() + 1;
+    if (frame != sSkinningPaletteFrame)
+    {
+        // Forget palettes nothing asked for last frame, the avatar or skin
+        // may be gone and their addresses reused.
+        for (skinning_palette_map_t::iterator it = sSkinningPalettes.begin(); it != sSkinningPalettes.end(); )
+        {
+            if (it->second.mFrame + 1 < frame)
+            {
+                it = sSkinningPalettes.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        sSkinningPaletteFrame = frame;
+    }
+
+    count = getMeshJointCount(skin);
+    SkinningPalette& palette = sSkinningPalettes[std::make_pair((const LLVOAvatar*)avatar, skin)];
+    if (palette.mFrame != frame || palette.mCount != count)
+    {
+        initSkinningMatrixPalette((LLMatrix4*)palette.mMatrix, count, skin, avatar);
+        palette.mCount = count;
+        palette.mFrame = frame;
+    }
+    return palette.mMatrix;
+}
+
 void LLSkinningUtil::checkSkinWeights(LLVector4a* weights, U32 num_vertices, const LLMeshSkinInfo* skin)
 {
 #if DEBUG_SKINNING
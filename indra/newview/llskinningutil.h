@@ -43,6 +43,10 @@ namespace LLSkinningUtil
     U32 getMeshJointCount(const LLMeshSkinInfo *skin);
     void scrubInvalidJoints(LLVOAvatar *avatar, LLMeshSkinInfo* skin);
     void initSkinningMatrixPalette(LLMatrix4* mat, S32 count, const LLMeshSkinInfo* skin, LLVOAvatar *avatar);
+    // Palette initSkinningMatrixPalette() builds for skin on avatar, computed
+    // at most once per frame and shared by every face, attachment and render
+    // pass using that skin. Stays valid until the end of the frame.
+    const LLMatrix4a* getSkinningMatrixPalette(const LLMeshSkinInfo* skin, LLVOAvatar* avatar, U32& count);
     void checkSkinWeights(LLVector4a* weights, U32 num_vertices, const LLMeshSkinInfo* skin);
     void scrubSkinWeights(LLVector4a* weights, U32 num_vertices, const LLMeshSkinInfo* skin);
     void getPerVertexSkinMatrix(F32* weights, LLMatrix4a* mat, bool handle_bad_scale, LLMatrix4a& final_mat, U32 max_joints);
@@ -54,6 +54,7 @@
 #include "lltextureatlas.h"
 #include "llviewershadermgr.h"
 #include "llcontrolavatar.h"
+#include "llradixsort.h"
 
 static LLTrace::BlockTimerStatHandle FTM_FRUSTUM_CULL("Frustum Culling");
 static LLTrace::BlockTimerStatHandle FTM_CULL_REBOUND("Cull Rebound Partition");
@@ -261,6 +262,113 @@ void LLSpatialGroup::clearDrawMap()
 	mDrawMap.clear();
 }
 
+// True if rhs can be drawn with lhs's state by the same indirect call.
+static bool can_share_indirect(const LLDrawInfo& lhs, const LLDrawInfo& rhs)
+{
+	return lhs.mVertexBuffer == rhs.mVertexBuffer &&
+		lhs.mDrawMode == rhs.mDrawMode &&
+		lhs.mTexture == rhs.mTexture &&
+		lhs.mTextureList == rhs.mTextureList &&
+		lhs.mTextureMatrix == rhs.mTextureMatrix &&
+		lhs.mModelMatrix == rhs.mModelMatrix &&
+		lhs.mMaterial == rhs.mMaterial &&
+		lhs.mMaterialID == rhs.mMaterialID &&
+		lhs.mShaderMask == rhs.mShaderMask &&
+		lhs.mFullbright == rhs.mFullbright &&
+		lhs.mBump == rhs.mBump &&
+		lhs.mShiny == rhs.mShiny &&
+		lhs.mParticle == rhs.mParticle &&
+		lhs.mSpecularMap == rhs.mSpecularMap &&
+		lhs.mNormalMap == rhs.mNormalMap &&
+		lhs.mSpecColor == rhs.mSpecColor &&
+		lhs.mEnvIntensity == rhs.mEnvIntensity &&
+		lhs.mAlphaMaskCutoff == rhs.mAlphaMaskCutoff &&
+		lhs.mDiffuseAlphaMode == rhs.mDiffuseAlphaMode &&
+		lhs.mHasGlow == rhs.mHasGlow &&
+		lhs.mBlendFuncSrc == rhs.mBlendFuncSrc &&
+		lhs.mBlendFuncDst == rhs.mBlendFuncDst &&
+		lhs.mSelected == rhs.mSelected;
+}
+
+static LLTrace::BlockTimerStatHandle FTM_BUILD_INDIRECT("Build Indirect Commands");
+
+void LLSpatialGroup::buildIndirectCommands()
+{
+	LL_RECORD_BLOCK_TIME(FTM_BUILD_INDIRECT);
+
+	LLIndirectBuffer::command_list_t commands;
+
+	for (draw_map_t::iterator i = mDrawMap.begin(); i != mDrawMap.end(); ++i)
+	{
+		drawmap_elem_t& draw_vec = i->second;
+		for (drawmap_elem_t::iterator j = draw_vec.begin(); j != draw_vec.end(); ++j)
+		{
+			LLDrawInfo* params = *j;
+			params->mIndirectFirst = 0;
+			params->mIndirectCount = 0;
+			params->mIndirectIndices = 0;
+			params->mIndirectMerged = false;
+			params->mIndirectExtents[0] = params->mExtents[0];
+			params->mIndirectExtents[1] = params->mExtents[1];
+		}
+
+		if (!LLRenderPass::isOrderIndependent(i->first))
+		{
+			continue;
+		}
+
+		for (U32 j = 0; j < draw_vec.size(); ++j)
+		{
+			LLDrawInfo* head = draw_vec[j];
+			if (head->mIndirectMerged || head->mVertexBuffer.isNull() || !head->mVertexBuffer->useVBOs())
+			{
+				continue;
+			}
+
+			U32 first = commands.size();
+			for (U32 k = j; k < draw_vec.size(); ++k)
+			{
+				LLDrawInfo* params = draw_vec[k];
+				if (k > j && (params->mIndirectMerged || !can_share_indirect(*head, *params)))
+				{
+					continue;
+				}
+
+				LLIndirectBuffer::Command cmd = { params->mCount, 1, params->mOffset, 0, 0 };
+				commands.push_back(cmd);
+				head->mIndirectIndices += params->mCount;
+				if (k > j)
+				{
+					params->mIndirectMerged = true;
+					head->mVSize = llmax(head->mVSize, params->mVSize);
+					head->mIndirectExtents[0].setMin(head->mIndirectExtents[0], params->mExtents[0]);
+					head->mIndirectExtents[1].setMax(head->mIndirectExtents[1], params->mExtents[1]);
+				}
+			}
+
+			if (commands.size() - first < 2)
+			{ //nothing to merge with, keep drawing it on its own
+				commands.resize(first);
+				head->mIndirectIndices = 0;
+				continue;
+			}
+
+			head->mIndirectFirst = first;
+			head->mIndirectCount = commands.size() - first;
+		}
+	}
+
+	if (!commands.empty() && mIndirectBuffer.isNull())
+	{
+		mIndirectBuffer = new LLIndirectBuffer();
+	}
+
+	if (mIndirectBuffer.notNull())
+	{ //reuses the GL buffer and only uploads commands that changed
+		mIndirectBuffer->setCommands(commands);
+	}
+}
+
 BOOL LLSpatialGroup::isHUDGroup() 
 {
 	return getSpatialPartition() && getSpatialPartition()->isHUDPartition() ; 
@@ -930,6 +1038,7 @@ void LLSpatialGroup::destroyGL(bool keep_occlusion)
 
 	mLastUpdateTime = gFrameTimeSeconds;
 	mVertexBuffer = NULL;
+	mIndirectBuffer = NULL;
 	mBufferMap.clear();
 
 	clearDrawMap();
@@ -1110,7 +1219,16 @@ public:
 	
 	virtual S32 frustumCheck(const LLViewerOctreeGroup* group)
 	{
-		S32 res = AABBInFrustumNoFarClipGroupBounds(group);
+		return frustumCheckBatched(group, AABBInFrustumNoFarClipGroupBounds(group));
+	}
+
+	virtual U32 getBatchedFrustumCheck() const
+	{
+		return BATCH_GROUP_BOUNDS_NO_FAR_CLIP;
+	}
+
+	virtual S32 frustumCheckBatched(const LLViewerOctreeGroup* group, S32 res)
+	{
 		if (res != 0)
 		{
 			res = llmin(res, AABBSphereIntersectGroupExtents(group));
@@ -1151,6 +1269,11 @@ public:
 		return AABBInFrustumNoFarClipGroupBounds(group);
 	}
 
+	virtual S32 frustumCheckBatched(const LLViewerOctreeGroup* group, S32 res)
+	{
+		return res;
+	}
+
 	virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group)
 	{
 		S32 res = AABBInFrustumNoFarClipObjectBounds(group);
@@ -1169,6 +1292,16 @@ public:
 		return AABBInFrustumGroupBounds(group);
 	}
 
+	virtual U32 getBatchedFrustumCheck() const
+	{
+		return BATCH_GROUP_BOUNDS;
+	}
+
+	virtual S32 frustumCheckBatched(const LLViewerOctreeGroup* group, S32 res)
+	{
+		return res;
+	}
+
 	virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group)
 	{
 		return AABBInFrustumObjectBounds(group);
@@ -4009,7 +4142,11 @@ LLDrawInfo::LLDrawInfo(U16 start, U16 end, U32 count, U32 offset,
 	mEnvIntensity(0.0f),
 	mAlphaMaskCutoff(0.5f),
 	mDiffuseAlphaMode(0),
-	mSelected(selected)
+	mSelected(selected),
+	mIndirectFirst(0),
+	mIndirectCount(0),
+	mIndirectIndices(0),
+	mIndirectMerged(false)
 {
 	mVertexBuffer->validateRange(mStart, mEnd, mCount, mOffset);
 	
@@ -4039,6 +4176,29 @@ void LLDrawInfo::validate()
 	mVertexBuffer->validateRange(mStart, mEnd, mCount, mOffset);
 }
 
+// Folds a pointer into a bits wide id. Different pointers may collide,
+// which only costs an extra state change, equal ones always match.
+static inline U64 sort_key_id(const void* ptr, U32 bits)
+{
+	U64 key = (U64)(uintptr_t)ptr;
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key & ((1ULL << bits) - 1);
+}
+
+U64 LLDrawInfo::getSortKey() const
+{
+	// 9 bits shader, 20 bits texture, 20 bits vertex buffer, 15 bits
+	// material and model matrix.
+	U64 shader = ((U64)(mShaderMask & 0xf) << 5) | (U64)(mBump & 0x1f);
+	U64 material = sort_key_id(mMaterial.get(), 15) ^ sort_key_id(mModelMatrix, 15);
+	return (shader << 55) |
+		   (sort_key_id(mTexture.get(), 20) << 35) |
+		   (sort_key_id(mVertexBuffer.get(), 20) << 15) |
+		   material;
+}
+
 LLVertexBuffer* LLGeometryManager::createVertexBuffer(U32 type_mask, U32 usage)
 {
 	return new LLVertexBuffer(type_mask, usage);
@@ -4291,6 +4451,30 @@ void LLCullResult::pushDrawInfo(U32 type, LLDrawInfo* draw_info)
 	mRenderMapEnd[type] = &(mRenderMap[type][mRenderMapSize[type]]);
 }
 
+void LLCullResult::sortRenderMap(U32 type)
+{
+	U32 count = mRenderMapSize[type];
+	if (count < 2)
+	{
+		return;
+	}
+
+	mSortItems.resize(count);
+	for (U32 i = 0; i < count; ++i)
+	{
+		LLDrawInfo* draw_info = mRenderMap[type][i];
+		mSortItems[i].mKey = draw_info ? draw_info->getSortKey() : 0;
+		mSortItems[i].mDrawInfo = draw_info;
+	}
+
+	ll_radix_sort(mSortItems, mSortScratch);
+
+	for (U32 i = 0; i < count; ++i)
+	{
+		mRenderMap[type][i] = mSortItems[i].mDrawInfo;
+	}
+}
+
 
 void LLCullResult::assertDrawMapsEmpty()
 {
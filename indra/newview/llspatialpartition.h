@@ -34,6 +34,7 @@
 #include "llpointer.h"
 #include "llrefcount.h"
 #include "llvertexbuffer.h"
+#include "llindirectbuffer.h"
 #include "llgltypes.h"
 #include "llcubemap.h"
 #include "lldrawpool.h"
@@ -81,7 +82,13 @@ public:
 
 	void validate();
 
+	// Packed shader (material shader mask and bump code), texture, vertex
+	// buffer and material/transform ids, most expensive state first, so
+	// batches that can share state sort next to each other.
+	U64 getSortKey() const;
+
 	LLVector4a mExtents[2];
+	LLVector4a mIndirectExtents[2];	// mExtents plus those of every batch merged into this one
 	
 	LLPointer<LLVertexBuffer> mVertexBuffer;
 	LLPointer<LLViewerTexture>     mTexture;
@@ -119,6 +126,10 @@ public:
 	F32  mAlphaMaskCutoff;
 	U8   mDiffuseAlphaMode;
 	bool mSelected;
+	U32  mIndirectFirst;	// first command of this batch in mGroup->mIndirectBuffer
+	U32  mIndirectCount;	// commands drawn with this batch, 0 if it is drawn on its own
+	U32  mIndirectIndices;	// indices drawn by those commands
+	bool mIndirectMerged;	// drawn by the indirect commands of another batch
 
 
 	struct CompareTexture
@@ -263,6 +274,9 @@ public:
 	BOOL isHUDGroup() ;
 	
 	void clearDrawMap();
+	// Merge opaque batches that share a vertex buffer and all draw state into
+	// runs drawn with one indirect call. Call after the draw map is rebuilt.
+	void buildIndirectCommands();
 	void validate();
 	void validateDrawMap();
 	
@@ -354,6 +368,7 @@ public:
 
 	U32 mBufferUsage;
 	draw_map_t mDrawMap;
+	LLPointer<LLIndirectBuffer> mIndirectBuffer; //commands for merged batches in mDrawMap
 	
 	F32 mDistance;
 	F32 mDepth;
@@ -516,6 +531,8 @@ public:
 	void pushDrawable(LLDrawable* drawable);
 	void pushBridge(LLSpatialBridge* bridge);
 	void pushDrawInfo(U32 type, LLDrawInfo* draw_info);
+	// Radix sorts a render map by LLDrawInfo::getSortKey().
+	void sortRenderMap(U32 type);
 	
 	U32 getVisibleGroupsSize()		{ return mVisibleGroupsSize; }
 	U32	getAlphaGroupsSize()		{ return mAlphaGroupsSize; }
@@ -530,6 +547,12 @@ private:
 
 	template <class T, class V> void pushBack(T &head, U32& count, V* val);
 
+	struct DrawSortItem
+	{
+		U64			mKey;
+		LLDrawInfo*	mDrawInfo;
+	};
+
 	U32					mVisibleGroupsSize;
 	U32					mAlphaGroupsSize;
 	U32					mOcclusionGroupsSize;
@@ -562,6 +585,9 @@ private:
 	U32					mRenderMapAllocated[LLRenderPass::NUM_RENDER_TYPES];
 	drawinfo_iterator mRenderMapEnd[LLRenderPass::NUM_RENDER_TYPES];
 
+	std::vector<DrawSortItem>	mSortItems;		// kept to avoid reallocating every frame
+	std::vector<DrawSortItem>	mSortScratch;
+
 };
 
 
@@ -35,6 +35,7 @@
 #include "lldir.h"
 #include "llhttpconstants.h"
 #include "llimage.h"
+#include "llimagedxt.h"
 #include "llimagej2c.h"
 #include "llimageworker.h"
 #include "llworkerthread.h"
@@ -71,6 +72,8 @@ LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > LLTextureFetch::sCacheH
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sCacheReadLatency("texture_cache_read_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexDecodeLatency("texture_decode_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexFetchLatency("texture_fetch_latency");
+LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexCompressTime("texture_compress_time", "Block compression time per megapixel");
+LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexDisplayLatency("texture_display_latency", "Time from a fetch request to its texture being created");
 
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -354,23 +357,38 @@ private:
 	public:
 
 		// Threads:  Ttf
-		DecodeResponder(LLTextureFetch* fetcher, const LLUUID& id, LLTextureFetchWorker* worker)
-			: mFetcher(fetcher), mID(id)
+		DecodeResponder(LLTextureFetch* fetcher, const LLUUID& id, LLTextureFetchWorker* worker, bool compress)
+			: mFetcher(fetcher), mID(id), mCompress(compress)
 		{
 		}
 
 		// Threads:  Tid
 		virtual void completed(bool success, LLImageRaw* raw, LLImageRaw* aux)
 		{
+			// Block compress here so the decode thread does the work
+			LLPointer<LLImageDXT> compressed;
+			F32 compress_time = 0.f;
+			if (success && mCompress && raw)
+			{
+				LLTimer timer;
+				compressed = new LLImageDXT();
+				if (!compressed->compress(raw))
+				{
+					compressed = NULL;
+				}
+				compress_time = timer.getElapsedTimeF32();
+			}
+
 			LLTextureFetchWorker* worker = mFetcher->getWorker(mID);
 			if (worker)
 			{
- 				worker->callbackDecoded(success, raw, aux);
+ 				worker->callbackDecoded(success, raw, aux, compressed, compress_time);
 			}
 		}
 	private:
 		LLTextureFetch* mFetcher;
 		LLUUID mID;
+		bool mCompress;
 	};
 
 	struct Compare
@@ -416,7 +434,7 @@ public:
 	void callbackCacheWrite(bool success);
 
 	// Threads:  Tid
-	void callbackDecoded(bool success, LLImageRaw* raw, LLImageRaw* aux);
+	void callbackDecoded(bool success, LLImageRaw* raw, LLImageRaw* aux, LLImageDXT* compressed, F32 compress_time);
 	
 	// Threads:  T*
 	void setGetStatus(LLCore::HttpStatus status, const std::string& reason)
@@ -560,6 +578,7 @@ private:
 	LLPointer<LLImageFormatted> mFormattedImage;
 	LLPointer<LLImageRaw>       mRawImage,
 								mAuxImage;
+	LLPointer<LLImageDXT>       mCompressedImage;	// block compressed mRawImage, if requested
 	FTType mFTType;
 	LLUUID mID;
 	LLHost mHost;
@@ -582,6 +601,7 @@ private:
     LLTimer mFetchTimer;
 	F32 mCacheReadTime; // time for cache read only
     F32 mDecodeTime;    // time for decode only
+    F32 mCompressTime;  // time for block compression only
     F32 mFetchTime;     // total time from req to finished fetch
 	LLTextureCache::handle_t    mCacheReadHandle,
 								mCacheWriteHandle;
@@ -596,6 +616,7 @@ private:
 	BOOL mDecoded;
 	BOOL mWritten;
 	BOOL mNeedsAux;
+	BOOL mNeedsCompression;
 	BOOL mHaveAllData;
 	BOOL mInLocalCache;
 	BOOL mInCache;
@@ -917,6 +938,7 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
 	  mDecodedDiscard(-1),
 	  mCacheReadTime(0.f),
 	  mDecodeTime(0.f),
+	  mCompressTime(0.f),
       mFetchTime(0.f),
 	  mCacheReadHandle(LLTextureCache::nullHandle()),
 	  mCacheWriteHandle(LLTextureCache::nullHandle()),
@@ -931,6 +953,7 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
 	  mDecoded(FALSE),
 	  mWritten(FALSE),
 	  mNeedsAux(FALSE),
+	  mNeedsCompression(FALSE),
 	  mHaveAllData(FALSE),
 	  mInLocalCache(FALSE),
 	  mInCache(FALSE),
@@ -1891,6 +1914,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
 
 		mRawImage = NULL;
 		mAuxImage = NULL;
+		mCompressedImage = NULL;
 		llassert_always(mFormattedImage.notNull());
 		S32 discard = mHaveAllData ? 0 : mLoadedDiscard;
 		U32 image_priority = LLWorkerThread::PRIORITY_NORMAL | mWorkPriority;
@@ -1899,7 +1923,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
 		LL_DEBUGS(LOG_TXT) << mID << ": Decoding. Bytes: " << mFormattedImage->getDataSize() << " Discard: " << discard
 						   << " All Data: " << mHaveAllData << LL_ENDL;
 		mDecodeHandle = mFetcher->mImageDecodeThread->decodeImage(mFormattedImage, image_priority, discard, mNeedsAux,
-																  new DecodeResponder(mFetcher, mID, this));
+																  new DecodeResponder(mFetcher, mID, this, mNeedsCompression));
 		// fall though
 	}
 	
@@ -2461,7 +2485,8 @@ void LLTextureFetchWorker::callbackCacheWrite(bool success)
 //////////////////////////////////////////////////////////////////////////////
 
 // Threads:  Tid
-void LLTextureFetchWorker::callbackDecoded(bool success, LLImageRaw* raw, LLImageRaw* aux)
+void LLTextureFetchWorker::callbackDecoded(bool success, LLImageRaw* raw, LLImageRaw* aux,
+										   LLImageDXT* compressed, F32 compress_time)
 {
 	LLMutexLock lock(&mWorkMutex);										// +Mw
 	if (mDecodeHandle == 0)
@@ -2482,6 +2507,8 @@ void LLTextureFetchWorker::callbackDecoded(bool success, LLImageRaw* raw, LLImag
 		llassert_always(raw);
 		mRawImage = raw;
 		mAuxImage = aux;
+		mCompressedImage = compressed;
+		mCompressTime = compress_time;
 		mDecodedDiscard = mFormattedImage->getDiscardLevel();
  		LL_DEBUGS(LOG_TXT) << mID << ": Decode Finished. Discard: " << mDecodedDiscard
 						   << " Raw Image: " << llformat("%dx%d",mRawImage->getWidth(),mRawImage->getHeight()) << LL_ENDL;
@@ -2645,7 +2672,7 @@ LLTextureFetch::~LLTextureFetch()
 }
 
 bool LLTextureFetch::createRequest(FTType f_type, const std::string& url, const LLUUID& id, const LLHost& host, F32 priority,
-								   S32 w, S32 h, S32 c, S32 desired_discard, bool needs_aux, bool can_use_http)
+								   S32 w, S32 h, S32 c, S32 desired_discard, bool needs_aux, bool compress, bool can_use_http)
 {
 	if(mFetcherLocked)
 	{
@@ -2727,6 +2754,7 @@ bool LLTextureFetch::createRequest(FTType f_type, const std::string& url, const
 		worker->lockWorkMutex();										// +Mw
 		worker->mActiveCount++;
 		worker->mNeedsAux = needs_aux;
+		worker->mNeedsCompression = compress;
 		worker->setImagePriority(priority);
 		worker->setDesiredDiscard(desired_discard, desired_size);
 		worker->setCanUseHTTP(can_use_http);
@@ -2755,6 +2783,7 @@ bool LLTextureFetch::createRequest(FTType f_type, const std::string& url, const
 		worker->lockWorkMutex();										// +Mw
 		worker->mActiveCount++;
 		worker->mNeedsAux = needs_aux;
+		worker->mNeedsCompression = compress;
 		worker->setCanUseHTTP(can_use_http) ;
 		worker->unlockWorkMutex();										// -Mw
 	}
@@ -2940,6 +2969,7 @@ LLTextureFetchWorker* LLTextureFetch::getWorker(const LLUUID& id)
 // Threads:  T*
 bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
 										LLPointer<LLImageRaw>& raw, LLPointer<LLImageRaw>& aux,
+										LLPointer<LLImageDXT>& compressed,
 										LLCore::HttpStatus& last_http_get_status)
 {
 	bool res = false;
@@ -2966,7 +2996,14 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
 			discard_level = worker->mDecodedDiscard;
 			raw = worker->mRawImage;
 			aux = worker->mAuxImage;
+			compressed = worker->mCompressedImage;
 			sample(sTexDecodeLatency, worker->mDecodeTime);
+			if (compressed.notNull() && raw.notNull())
+			{
+				F32 megapixels = raw->getWidth() * raw->getHeight() / 1000000.f;
+				sample(sTexCompressTime, F32Seconds(worker->mCompressTime / megapixels));
+				worker->mCompressTime = 0.f;
+			}
             sample(sTexFetchLatency, worker->mFetchTime);
             sample(sCacheReadLatency, worker->mCacheReadTime);
             worker->mCacheReadTimer.reset();
@@ -2987,6 +3024,7 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level,
 				discard_level = worker->mDecodedDiscard;
 				raw = worker->mRawImage;
 				aux = worker->mAuxImage;
+				compressed = worker->mCompressedImage;
 			}
 			worker->unlockWorkMutex();									// -Mw
 		}
@@ -46,6 +46,7 @@
 class LLViewerTexture;
 class LLTextureFetchWorker;
 class LLImageDecodeThread;
+class LLImageDXT;
 class LLHost;
 class LLViewerAssetStats;
 class LLTextureFetchDebugger;
@@ -76,7 +77,7 @@ public:
 
 	// Threads:  T* (but Tmain mostly)
 	bool createRequest(FTType f_type, const std::string& url, const LLUUID& id, const LLHost& host, F32 priority,
-					   S32 w, S32 h, S32 c, S32 discard, bool needs_aux, bool can_use_http);
+					   S32 w, S32 h, S32 c, S32 discard, bool needs_aux, bool compress, bool can_use_http);
 
 	// Requests that a fetch operation be deleted from the queue.
 	// If @cancel is true, also stops any I/O operations pending.
@@ -94,6 +95,7 @@ public:
 	// Threads:  T*
 	bool getRequestFinished(const LLUUID& id, S32& discard_level,
 							LLPointer<LLImageRaw>& raw, LLPointer<LLImageRaw>& aux,
+							LLPointer<LLImageDXT>& compressed,
 							LLCore::HttpStatus& last_http_get_status);
 
 	// Threads:  T*
@@ -312,6 +314,8 @@ public:
     static LLTrace::SampleStatHandle<F32Seconds> sCacheReadLatency;
     static LLTrace::SampleStatHandle<F32Seconds> sTexDecodeLatency;
     static LLTrace::SampleStatHandle<F32Seconds> sTexFetchLatency;
+    static LLTrace::SampleStatHandle<F32Seconds> sTexCompressTime;		// per megapixel
+    static LLTrace::SampleStatHandle<F32Seconds> sTexDisplayLatency;
     static LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > sCacheHitRate;
 
 private:
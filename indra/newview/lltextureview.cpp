@@ -549,12 +549,16 @@ void LLGLTexMemBar::draw()
     U32 texFetchLatMed = U32(recording.getMean(LLTextureFetch::sTexFetchLatency).value() * 1000.0f);
     U32 texFetchLatMax = U32(recording.getMax(LLTextureFetch::sTexFetchLatency).value() * 1000.0f);
 
-	text = llformat("GL Tot: %d/%d MB Bound: %d/%d MB FBO: %d MB Raw Tot: %d MB Bias: %.2f Cache: %.1f/%.1f MB",
+    U32 texCompressMed = U32(recording.getMean(LLTextureFetch::sTexCompressTime).value() * 1000.0f);
+    U32 texDisplayLatMed = U32(recording.getMean(LLTextureFetch::sTexDisplayLatency).value() * 1000.0f);
+
+	text = llformat("GL Tot: %d/%d MB Bound: %d/%d MB FBO: %d MB (Pool: %d MB) Raw Tot: %d MB Bias: %.2f Cache: %.1f/%.1f MB",
 					total_mem.value(),
 					max_total_mem.value(),
 					bound_mem.value(),
 					max_bound_mem.value(),
 					LLRenderTarget::sBytesAllocated/(1024*1024),
+					gPipeline.mTargetPool.getBytesAllocated()/(1024*1024),
 					LLImageRaw::sGlobalRawMemory >> 20,
 					discard_bias,
 					cache_usage,
@@ -564,6 +568,36 @@ void LLGLTexMemBar::draw()
 	LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*6,
 											 text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
+	// Texture budget, with the three categories using the most GL memory
+	const std::vector<S32Bytes>& cat_mem = gTextureList.getTextureMemByCategory();
+	std::vector<std::pair<S32, S32> > cat_order;
+	for (S32 i = 0; i < (S32)cat_mem.size(); ++i)
+	{
+		if (cat_mem[i] > S32Bytes(0))
+		{
+			cat_order.push_back(std::make_pair(cat_mem[i].value(), LLGLTexture::getCategoryFromIndex(i)));
+		}
+	}
+	std::sort(cat_order.rbegin(), cat_order.rend());
+	std::string cat_text;
+	for (S32 i = 0; i < llmin((S32)cat_order.size(), 3); ++i)
+	{
+		cat_text += llformat(" %d:%d", cat_order[i].second, cat_order[i].first >> 20);
+	}
+
+	color = total_mem > gTextureList.getTextureBudget() ? LLColor4::yellow : text_color;
+	color[VALPHA] = text_color[VALPHA];
+	text = llformat("Budget: %d/%d MB Down/Up: %u/%u Degraded: %d DXT Saved: %d MB Cat MB:%s",
+					total_mem.value(),
+					gTextureList.getTextureBudget().value(),
+					gTextureList.getBudgetDowngrades(),
+					gTextureList.getBudgetUpgrades(),
+					gTextureList.getBudgetDegradedCount(),
+					LLImageGL::sCompressedTextureSavings.value() >> 20,
+					cat_text.c_str());
+	LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*7,
+											 color, LLFontGL::LEFT, LLFontGL::TOP);
+
 	U32 cache_read(0U), cache_write(0U), res_wait(0U);
 	LLAppViewer::getTextureFetch()->getStateStats(&cache_read, &cache_write, &res_wait);
 	
@@ -580,7 +614,7 @@ void LLGLTexMemBar::draw()
 	LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*5,
 											 text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
-    text = llformat("CacheHitRate: %3.2f Read: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d",
+    text = llformat("CacheHitRate: %3.2f Read: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d DXT: %d ms/MP Display: %d",
                     cacheHitRate,
                     cacheReadLatMin,
                     cacheReadLatMed,
@@ -590,7 +624,9 @@ void LLGLTexMemBar::draw()
                     texDecodeLatMax,
                     texFetchLatMin,
                     texFetchLatMed,
-                    texFetchLatMax);
+                    texFetchLatMax,
+                    texCompressMed,
+                    texDisplayLatMed);
 
 	LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*4,
 											 text_color, LLFontGL::LEFT, LLFontGL::TOP);
@@ -674,7 +710,7 @@ BOOL LLGLTexMemBar::handleMouseDown(S32 x, S32 y, MASK mask)
 LLRect LLGLTexMemBar::getRequiredRect()
 {
 	LLRect rect;
-	rect.mTop = 78; //LLFontGL::getFontMonospace()->getLineHeight() * 6;
+	rect.mTop = 91; //LLFontGL::getFontMonospace()->getLineHeight() * 7;
 	return rect;
 }
 
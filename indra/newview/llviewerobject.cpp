@@ -711,6 +711,19 @@ void LLViewerObject::setNameValueList(const std::string& name_value_list)
 	}
 }
 
+void LLViewerObject::setNameValueList(const std::vector<std::string>& name_values)
+{
+	// Clear out the old
+	for_each(mNameValuePairs.begin(), mNameValuePairs.end(), DeletePairedPointer()) ;
+	mNameValuePairs.clear();
+
+	// Bring in the new
+	for (U32 i = 0; i < name_values.size(); ++i)
+	{
+		addNVPair(name_values[i]);
+	}
+}
+
 BOOL LLViewerObject::isAnySelected() const
 {
     bool any_selected = isSelected();
@@ -1097,6 +1110,142 @@ U32 LLViewerObject::checkMediaURL(const std::string &media_url)
     return retval;
 }
 
+LLDecodedObjectUpdate::LLDecodedObjectUpdate()
+:	mHasTEs(false),
+	mHasNameValues(false)
+{
+	mTEContents.size = 0;
+	mTEContents.face_count = 0;
+}
+
+LLDecodedObjectUpdate::~LLDecodedObjectUpdate()
+{
+	clear();
+}
+
+void LLDecodedObjectUpdate::clear()
+{
+	mHasTEs = false;
+	mTEContents.size = 0;
+	mTEContents.face_count = 0;
+	mExtraParamData.clear();
+	for (U32 i = 0; i < mExtraParams.size(); ++i)
+	{
+		delete mExtraParams[i].second;
+	}
+	mExtraParams.clear();
+	mHasNameValues = false;
+	mNameValueList.clear();
+	mNameValues.clear();
+}
+
+void LLDecodedObjectUpdate::extract(LLMessageSystem* mesgsys, S32 block_num, EObjectUpdateType update_type, bool compressed)
+{
+	clear();
+
+	if (!compressed && update_type == OUT_FULL)
+	{
+		S32 te_size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_TextureEntry);
+		if (te_size > 0)
+		{
+			mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_TextureEntry, mTEContents.packed_buffer, 0, block_num, LLTEContents::MAX_TE_BUFFER);
+			mTEContents.size = llmin(te_size, (S32)LLTEContents::MAX_TE_BUFFER);
+			mHasTEs = true;
+		}
+
+		S32 param_size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_ExtraParams);
+		if (param_size > 0)
+		{
+			mExtraParamData.resize(param_size);
+			mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_ExtraParams, &mExtraParamData[0], param_size, block_num);
+		}
+
+		S32 nv_size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_NameValue);
+		if (nv_size > 0)
+		{
+			mesgsys->getStringFast(_PREHASH_ObjectData, _PREHASH_NameValue, mNameValueList, block_num);
+			mHasNameValues = true;
+		}
+	}
+	else if (compressed && update_type == OUT_TERSE_IMPROVED)
+	{
+		// Terse updates carry the texture entries as packed binary data.
+		S32 te_size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_TextureEntry);
+		if (te_size > 0)
+		{
+			U8							tdpbuffer[1024];
+			LLDataPackerBinaryBuffer	tdp(tdpbuffer, 1024);
+			mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_TextureEntry, tdpbuffer, 0, block_num, 1024);
+
+			S32 size = 0;
+			if (tdp.unpackBinaryData(mTEContents.packed_buffer, size, "TextureEntry"))
+			{
+				mTEContents.size = size;
+				mHasTEs = (size > 0);
+			}
+			else
+			{
+				LL_WARNS() << "Bad texture entry block!  Abort!" << LL_ENDL;
+			}
+		}
+	}
+}
+
+void LLDecodedObjectUpdate::decode()
+{
+	if (mHasTEs)
+	{
+		// The face count is only known once the volume is set, so decode
+		// the faces the exceptions name and let the apply step widen or
+		// clamp the result.
+		mTEContents.face_count = LLPrimitive::getTEBufferFaceCount(mTEContents);
+		LLPrimitive::parseTEBuffer(mTEContents);
+	}
+
+	if (!mExtraParamData.empty())
+	{
+		LLDataPackerBinaryBuffer dp(&mExtraParamData[0], (S32)mExtraParamData.size());
+
+		U8 num_parameters;
+		dp.unpackU8(num_parameters, "num_params");
+		U8 param_block[MAX_OBJECT_PARAMS_SIZE];
+		for (U8 param=0; param<num_parameters; ++param)
+		{
+			U16 param_type;
+			S32 param_size;
+			dp.unpackU16(param_type, "param_type");
+			dp.unpackBinaryData(param_block, param_size, "param_data");
+			if (LLNetworkData::PARAMS_MESH == param_type)
+			{
+				param_type = LLNetworkData::PARAMS_SCULPT;
+			}
+			LLNetworkData* data = LLViewerObject::createNetworkData(param_type);
+			if (data)
+			{
+				LLDataPackerBinaryBuffer dp2(param_block, param_size);
+				data->unpack(dp2);
+				mExtraParams.push_back(extra_param_t(param_type, data));
+			}
+		}
+	}
+
+	if (mHasNameValues)
+	{
+		std::string::size_type length = mNameValueList.length();
+		std::string::size_type start = 0;
+		while (start < length)
+		{
+			std::string::size_type end = mNameValueList.find_first_of("\n", start);
+			if (end == std::string::npos) end = length;
+			if (end > start)
+			{
+				mNameValues.push_back(mNameValueList.substr(start, end - start));
+			}
+			start = end+1;
+		}
+	}
+}
+
 //extract spatial information from object update message
 //return parent_id
 //static
@@ -1119,7 +1268,8 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 					 void **user_data,
 					 U32 block_num,
 					 const EObjectUpdateType update_type,
-					 LLDataPacker *dp)
+					 LLDataPacker *dp,
+					 LLDecodedObjectUpdate* decoded)
 {
 	LL_DEBUGS_ONCE("SceneLoadTiming") << "Received viewer object data" << LL_ENDL;
 
@@ -1449,13 +1599,10 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				// ...new objects that should come in selected need to be added to the selected list
 				mCreateSelected = ((flags & FLAGS_CREATE_SELECTED) != 0);
 
-				// Set all name value pairs
-				S32 nv_size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_NameValue);
-				if (nv_size > 0)
+				// Set all name value pairs, split up by LLDecodedObjectUpdate
+				if (decoded && decoded->mHasNameValues)
 				{
-					std::string name_value_list;
-					mesgsys->getStringFast(_PREHASH_ObjectData, _PREHASH_NameValue, name_value_list, block_num);
-					setNameValueList(name_value_list);
+					setNameValueList(decoded->mNameValues);
 				}
 
 				// Clear out any existing generic data
@@ -1528,28 +1675,14 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 					iter->second->in_use = FALSE;
 				}
 
-				// Unpack extra parameters
-				S32 size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_ExtraParams);
-				if (size > 0)
+				// Apply extra parameters unpacked by LLDecodedObjectUpdate
+				if (decoded)
 				{
-					U8 *buffer = new U8[size];
-					mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_ExtraParams, buffer, size, block_num);
-					LLDataPackerBinaryBuffer dp(buffer, size);
-
-					U8 num_parameters;
-					dp.unpackU8(num_parameters, "num_params");
-					U8 param_block[MAX_OBJECT_PARAMS_SIZE];
-					for (U8 param=0; param<num_parameters; ++param)
+					for (U32 param = 0; param < decoded->mExtraParams.size(); ++param)
 					{
-						U16 param_type;
-						S32 param_size;
-						dp.unpackU16(param_type, "param_type");
-						dp.unpackBinaryData(param_block, param_size, "param_data");
-						//LL_INFOS() << "Param type: " << param_type << ", Size: " << param_size << LL_ENDL;
-						LLDataPackerBinaryBuffer dp2(param_block, param_size);
-						unpackParameterEntry(param_type, &dp2);
+						const LLDecodedObjectUpdate::extra_param_t& entry = decoded->mExtraParams[param];
+						applyParameterEntry(entry.first, entry.second);
 					}
-					delete[] buffer;
 				}
 
 				for (iter = mExtraParameterList.begin(); iter != mExtraParameterList.end(); ++iter)
@@ -5974,7 +6107,24 @@ bool LLViewerObject::unpackParameterEntry(U16 param_type, LLDataPacker *dp)
 	}
 }
 
-LLViewerObject::ExtraParameter* LLViewerObject::createNewParameterEntry(U16 param_type)
+bool LLViewerObject::applyParameterEntry(U16 param_type, const LLNetworkData* data)
+{
+	ExtraParameter* param = getExtraParameterEntryCreate(param_type);
+	if (param)
+	{
+		param->data->copy(*data);
+		param->in_use = TRUE;
+		parameterChanged(param_type, param->data, TRUE, false);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+// static
+LLNetworkData* LLViewerObject::createNetworkData(U16 param_type)
 {
 	LLNetworkData* new_block = NULL;
 	switch (param_type)
@@ -6011,6 +6161,12 @@ LLViewerObject::ExtraParameter* LLViewerObject::createNewParameterEntry(U16 para
 	  }
 	};
 
+	return new_block;
+}
+
+LLViewerObject::ExtraParameter* LLViewerObject::createNewParameterEntry(U16 param_type)
+{
+	LLNetworkData* new_block = createNetworkData(param_type);
 	if (new_block)
 	{
 		ExtraParameter* new_entry = new ExtraParameter;
@@ -81,6 +81,33 @@ typedef enum e_object_update_type
 } EObjectUpdateType;
 
 
+// Parts of an ObjectUpdate block that can be decoded without touching the
+// viewer object: texture entries, extra parameters and the name value list.
+// extract() copies the fields out of the message on the main thread and
+// decode() only works on that copy, so LLViewerObjectList runs it on the
+// thread pool. processUpdateMessage() applies the result on the main thread.
+struct LLDecodedObjectUpdate
+{
+	typedef std::pair<U16, LLNetworkData*> extra_param_t;
+
+	LLDecodedObjectUpdate();
+	~LLDecodedObjectUpdate();
+
+	void clear();
+	void extract(LLMessageSystem* mesgsys, S32 block_num, EObjectUpdateType update_type, bool compressed);
+	void decode();
+
+	bool						mHasTEs;
+	LLTEContents				mTEContents;
+
+	std::vector<U8>				mExtraParamData;
+	std::vector<extra_param_t>	mExtraParams;	// owned, deleted by clear()
+
+	bool						mHasNameValues;
+	std::string					mNameValueList;
+	std::vector<std::string>	mNameValues;
+};
+
 // callback typedef for inventory
 typedef void (*inventory_callback)(LLViewerObject*,
 								   LLInventoryObject::object_list_t*,
@@ -144,6 +171,10 @@ public:
 	static void initVOClasses();
 	static void cleanupVOClasses();
 
+	// Returns a new, default constructed block for the given extra parameter
+	// type, or NULL if the type is unknown. Thread safe.
+	static LLNetworkData* createNetworkData(U16 param_type);
+
 	void			addNVPair(const std::string& data);
 	BOOL			removeNVPair(const std::string& name);
 	LLNameValue*	getNVPair(const std::string& name) const;			// null if no name value pair by that name
@@ -168,7 +199,8 @@ public:
 										void **user_data,
 										U32 block_num,
 										const EObjectUpdateType update_type,
-										LLDataPacker *dp);
+										LLDataPacker *dp,
+										LLDecodedObjectUpdate* decoded = NULL);
 
 
 	virtual BOOL    isActive() const; // Whether this object needs to do an idleUpdate.
@@ -616,6 +648,7 @@ private:
 	ExtraParameter* getExtraParameterEntry(U16 param_type) const;
 	ExtraParameter* getExtraParameterEntryCreate(U16 param_type);
 	bool unpackParameterEntry(U16 param_type, LLDataPacker *dp);
+	bool applyParameterEntry(U16 param_type, const LLNetworkData* data);
 
     // This function checks to see if the given media URL has changed its version
     // and the update wasn't due to this agent's last action.
@@ -771,6 +804,7 @@ protected:
 	
 private:
 	void setNameValueList(const std::string& list);		// clears nv pairs and then individually adds \n separated NV pairs from \0 terminated string
+	void setNameValueList(const std::vector<std::string>& name_values);	// same, for a list split by LLDecodedObjectUpdate
 	void deleteTEImages(); // correctly deletes list of images
 	
 protected:
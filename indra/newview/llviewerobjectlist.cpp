@@ -80,6 +80,7 @@
 #include "llfloaterperms.h"
 #include "llvocache.h"
 #include "llcorehttputil.h"
+#include "llthreadpool.h"
 
 #include <algorithm>
 #include <iterator>
@@ -98,8 +99,8 @@ extern LLPipeline	gPipeline;
 
 // Statics for object lookup tables.
 U32						LLViewerObjectList::sSimulatorMachineIndex = 1; // Not zero deliberately, to speed up index check.
-std::map<U64, U32>		LLViewerObjectList::sIPAndPortToIndex;
-std::map<U64, LLUUID>	LLViewerObjectList::sIndexAndLocalIDToUUID;
+LLOpenHashMap<U64, U32>		LLViewerObjectList::sIPAndPortToIndex;
+LLOpenHashMap<U64, LLUUID>	LLViewerObjectList::sIndexAndLocalIDToUUID;
 
 LLViewerObjectList::LLViewerObjectList()
 {
@@ -118,9 +119,12 @@ LLViewerObjectList::~LLViewerObjectList()
 	destroy();
 }
 
+static void delete_update_headers();
+
 void LLViewerObjectList::destroy()
 {
 	killAllObjects();
+	delete_update_headers();
 
 	resetObjectBeacons();
 	mActiveObjects.clear();
@@ -137,17 +141,17 @@ void LLViewerObjectList::getUUIDFromLocal(LLUUID &id,
 {
 	U64 ipport = (((U64)ip) << 32) | (U64)port;
 
-	U32 index = sIPAndPortToIndex[ipport];
+	U32 index = sIPAndPortToIndex.get(ipport, 0);
 
 	if (!index)
 	{
 		index = sSimulatorMachineIndex++;
-		sIPAndPortToIndex[ipport] = index;
+		sIPAndPortToIndex.set(ipport, index);
 	}
 
 	U64	indexid = (((U64)index) << 32) | (U64)local_id;
 
-	id = get_if_there(sIndexAndLocalIDToUUID, indexid, LLUUID::null);
+	id = sIndexAndLocalIDToUUID.get(indexid, LLUUID::null);
 }
 
 U64 LLViewerObjectList::getIndex(const U32 local_id,
@@ -156,7 +160,7 @@ U64 LLViewerObjectList::getIndex(const U32 local_id,
 {
 	U64 ipport = (((U64)ip) << 32) | (U64)port;
 
-	U32 index = sIPAndPortToIndex[ipport];
+	U32 index = sIPAndPortToIndex.get(ipport, 0);
 
 	if (!index)
 	{
@@ -174,22 +178,22 @@ BOOL LLViewerObjectList::removeFromLocalIDTable(const LLViewerObject* objectp)
 		U32 ip = objectp->getRegion()->getHost().getAddress();
 		U32 port = objectp->getRegion()->getHost().getPort();
 		U64 ipport = (((U64)ip) << 32) | (U64)port;
-		U32 index = sIPAndPortToIndex[ipport];
+		U32 index = sIPAndPortToIndex.get(ipport, 0);
 		
 		// LL_INFOS() << "Removing object from table, local ID " << local_id << ", ip " << ip << ":" << port << LL_ENDL;
 		
 		U64	indexid = (((U64)index) << 32) | (U64)local_id;
 		
-		std::map<U64, LLUUID>::iterator iter = sIndexAndLocalIDToUUID.find(indexid);
-		if (iter == sIndexAndLocalIDToUUID.end())
+		const LLUUID* idp = sIndexAndLocalIDToUUID.find(indexid);
+		if (!idp)
 		{
 			return FALSE;
 		}
 		
 		// Found existing entry
-		if (iter->second == objectp->getID())
+		if (*idp == objectp->getID())
 		{   // Full UUIDs match, so remove the entry
-			sIndexAndLocalIDToUUID.erase(iter);
+			sIndexAndLocalIDToUUID.erase(indexid);
 			return TRUE;
 		}
 		// UUIDs did not match - this would zap a valid entry, so don't erase it
@@ -207,17 +211,17 @@ void LLViewerObjectList::setUUIDAndLocal(const LLUUID &id,
 {
 	U64 ipport = (((U64)ip) << 32) | (U64)port;
 
-	U32 index = sIPAndPortToIndex[ipport];
+	U32 index = sIPAndPortToIndex.get(ipport, 0);
 
 	if (!index)
 	{
 		index = sSimulatorMachineIndex++;
-		sIPAndPortToIndex[ipport] = index;
+		sIPAndPortToIndex.set(ipport, index);
 	}
 
 	U64	indexid = (((U64)index) << 32) | (U64)local_id;
 
-	sIndexAndLocalIDToUUID[indexid] = id;
+	sIndexAndLocalIDToUUID.set(indexid, id);
 	
 	//LL_INFOS() << "Adding object to table, full ID " << id
 	//	<< ", local ID " << local_id << ", ip " << ip << ":" << port << LL_ENDL;
@@ -232,7 +236,8 @@ void LLViewerObjectList::processUpdateCore(LLViewerObject* objectp,
 										   const EObjectUpdateType update_type, 
 										   LLDataPacker* dpp, 
 										   bool just_created,
-										   bool from_cache)
+										   bool from_cache,
+										   LLDecodedObjectUpdate* decoded)
 {
 	LLMessageSystem* msg = NULL;
 	
@@ -246,7 +251,7 @@ void LLViewerObjectList::processUpdateCore(LLViewerObject* objectp,
                               << objectp << " just_created " << just_created << " from_cache " << from_cache << " msg " << msg << LL_ENDL;
     dumpStack("ObjectUpdateStack");
 	 	
-	objectp->processUpdateMessage(msg, user_data, i, update_type, dpp);
+	objectp->processUpdateMessage(msg, user_data, i, update_type, dpp, decoded);
 		
 	if (objectp->isDead())
 	{
@@ -300,6 +305,61 @@ void LLViewerObjectList::processUpdateCore(LLViewerObject* objectp,
 }
 
 static LLTrace::BlockTimerStatHandle FTM_PROCESS_OBJECTS("Process Objects");
+static LLTrace::BlockTimerStatHandle FTM_DECODE_OBJECTS("Decode Objects");
+
+static const S32 MAX_OBJECT_DATA_SIZE = 2048;
+
+// Blocks per pool job, smaller messages are decoded inline.
+static const U32 OBJECT_DECODE_GRAIN = 16;
+
+// One ObjectData block, copied out of the message and decoded before any
+// viewer object is looked up. Decoding runs on pool threads, so nothing in
+// here may refer to viewer objects, regions or the message system.
+struct LLObjectUpdateHeader
+{
+	U32		mLocalID;
+	LLUUID	mFullID;
+	LLPCode	mPCode;
+	U32		mFlags;
+	S32		mDataSize;
+	S32		mDataOffset;	// where the rest of the update starts in mData
+	U8		mData[MAX_OBJECT_DATA_SIZE];
+	LLDecodedObjectUpdate mDecoded;	// texture entries, extra params and name values
+};
+
+// Only touched by processObjectUpdate(), kept around to avoid reallocating
+// for every message. Held by pointer since blocks own their decoded data.
+static std::vector<LLObjectUpdateHeader*> sUpdateHeaders;
+
+static void delete_update_headers()
+{
+	for_each(sUpdateHeaders.begin(), sUpdateHeaders.end(), DeletePointer());
+	sUpdateHeaders.clear();
+}
+
+static void decode_update_blocks(LLObjectUpdateHeader** headers, U32 begin, U32 end, bool compressed, bool terse)
+{
+	for (U32 i = begin; i < end; ++i)
+	{
+		LLObjectUpdateHeader& header = *headers[i];
+		if (compressed)
+		{
+			LLDataPackerBinaryBuffer dp(header.mData, header.mDataSize);
+			if (terse)
+			{
+				dp.unpackU32(header.mLocalID, "LocalID");
+			}
+			else
+			{
+				dp.unpackUUID(header.mFullID, "ID");
+				dp.unpackU32(header.mLocalID, "LocalID");
+				dp.unpackU8(header.mPCode, "PCode");
+			}
+			header.mDataOffset = dp.getCurrentSize();
+		}
+		header.mDecoded.decode();
+	}
+}
 
 LLViewerObject* LLViewerObjectList::processObjectUpdateFromCache(LLVOCacheEntry* entry, LLViewerRegion* regionp)
 {
@@ -407,6 +467,7 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 	LLPCode		pcode = 0;
 	LLUUID		fullid;
 	S32			i;
+	LLTimer		process_timer;
 
 	// figure out which simulator these are from and get it's index
 	// Coordinates in simulators are region-local
@@ -461,37 +522,93 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 		return;
 	}
 
-	U8 compressed_dpbuffer[2048];
-	LLDataPackerBinaryBuffer compressed_dp(compressed_dpbuffer, 2048);
 	LLViewerStatsRecorder& recorder = LLViewerStatsRecorder::instance();
 
+	// Decode pass: pull every block out of the message. The message reader
+	// is not thread safe, so copying happens here; unpacking the compressed
+	// headers, texture entries, extra params and name values is spread over
+	// the pool.
+	while ((S32)sUpdateHeaders.size() < num_objects)
+	{
+		sUpdateHeaders.push_back(new LLObjectUpdateHeader);
+	}
+	{
+		LL_RECORD_BLOCK_TIME(FTM_DECODE_OBJECTS);
+		for (i = 0; i < num_objects; i++)
+		{
+			LLObjectUpdateHeader& header = *sUpdateHeaders[i];
+			header.mLocalID = 0;
+			header.mFullID.setNull();
+			header.mPCode = 0;
+			header.mFlags = 0;
+			header.mDataSize = 0;
+			header.mDataOffset = 0;
+
+			if (compressed)
+			{
+				header.mDataSize = llclamp(mesgsys->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_Data), 0, MAX_OBJECT_DATA_SIZE);
+				LL_DEBUGS("ObjectUpdate") << "got binary data from message for block " << i << LL_ENDL;
+				mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_Data, header.mData, 0, i, MAX_OBJECT_DATA_SIZE);
+				if (update_type != OUT_TERSE_IMPROVED)
+				{
+					mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, header.mFlags, i);
+				}
+			}
+			else if (update_type != OUT_FULL)
+			{
+				mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, header.mLocalID, i);
+			}
+			else
+			{
+				mesgsys->getUUIDFast(_PREHASH_ObjectData, _PREHASH_FullID, header.mFullID, i);
+				mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, header.mLocalID, i);
+				mesgsys->getU8Fast(_PREHASH_ObjectData, _PREHASH_PCode, header.mPCode, i);
+			}
+			header.mDecoded.extract(mesgsys, i, update_type, compressed);
+		}
+
+		if (num_objects > 0)
+		{
+			LLObjectUpdateHeader** headers = &sUpdateHeaders[0];
+			bool terse = (update_type == OUT_TERSE_IMPROVED);
+			LLThreadPool* pool = LLThreadPool::getInstance();
+			if (pool)
+			{
+				pool->parallelFor(num_objects, OBJECT_DECODE_GRAIN,
+					[headers, compressed, terse](U32 begin, U32 end)
+					{
+						decode_update_blocks(headers, begin, end, compressed, terse);
+					});
+			}
+			else
+			{
+				decode_update_blocks(headers, 0, num_objects, compressed, terse);
+			}
+		}
+	}
+
+	// Apply pass: everything that touches viewer objects, the region or the
+	// lookup tables stays on the main thread.
 	for (i = 0; i < num_objects; i++)
 	{
-		// timer is unused?
-		LLTimer update_timer;
+		LLObjectUpdateHeader& header = *sUpdateHeaders[i];
+		LLDataPackerBinaryBuffer compressed_dp(header.mData, header.mDataSize);
 		BOOL justCreated = FALSE;
 		S32	msg_size = 0;
 		bool update_cache = false; //update object cache if it is a full-update or terse update
 
+		local_id = header.mLocalID;
+		fullid = header.mFullID;
+		pcode = header.mPCode;
+
 		if (compressed)
 		{
-			S32							uncompressed_length = 2048;
-			compressed_dp.reset();
-
-			uncompressed_length = mesgsys->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_Data);
-			LL_DEBUGS("ObjectUpdate") << "got binary data from message to compressed_dpbuffer" << LL_ENDL;
-			mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_Data, compressed_dpbuffer, 0, i, 2048);
-			compressed_dp.assignBuffer(compressed_dpbuffer, uncompressed_length);
+			compressed_dp.shift(header.mDataOffset);
 
 			if (update_type != OUT_TERSE_IMPROVED) // OUT_FULL_COMPRESSED only?
 			{
-				U32 flags = 0;
-				mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, flags, i);
+				U32 flags = header.mFlags;
 
-				compressed_dp.unpackUUID(fullid, "ID");
-				compressed_dp.unpackU32(local_id, "LocalID");
-				compressed_dp.unpackU8(pcode, "PCode");
-				
 				if (pcode == 0)
 				{
 					// object creation will fail, LLViewerObject::createObject()
@@ -513,7 +630,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 			else //OUT_TERSE_IMPROVED
 			{
 				update_cache = true;
-				compressed_dp.unpackU32(local_id, "LocalID");
 				getUUIDFromLocal(fullid,
 								 local_id,
 								 gMessageSystem->getSenderIP(),
@@ -527,7 +643,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 		}
 		else if (update_type != OUT_FULL) // !compressed, !OUT_FULL ==> OUT_FULL_CACHED only?
 		{
-			mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, local_id, i);
 			msg_size += sizeof(U32);
 
 			getUUIDFromLocal(fullid,
@@ -547,8 +662,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 		else // OUT_FULL only?
 		{
 			update_cache = true;
-			mesgsys->getUUIDFast(_PREHASH_ObjectData, _PREHASH_FullID, fullid, i);
-			mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, local_id, i);
 			msg_size += sizeof(LLUUID);
 			msg_size += sizeof(U32);
 			LL_DEBUGS("ObjectUpdate") << "Full Update, obj " << local_id << ", global ID " << fullid << " from " << mesgsys->getSender() << LL_ENDL;
@@ -623,7 +736,6 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 					continue;
 				}
 
-				mesgsys->getU8Fast(_PREHASH_ObjectData, _PREHASH_PCode, pcode, i);
 				msg_size += sizeof(U8);
 
 			}
@@ -665,7 +777,7 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 			{
 				objectp->mLocalID = local_id;
 			}
-			processUpdateCore(objectp, user_data, i, update_type, &compressed_dp, justCreated);
+			processUpdateCore(objectp, user_data, i, update_type, &compressed_dp, justCreated, false, &header.mDecoded);
 
 #if 0
 			if (update_type != OUT_TERSE_IMPROVED) // OUT_FULL_COMPRESSED only?
@@ -688,12 +800,18 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 			{
 				objectp->mLocalID = local_id;
 			}
-			processUpdateCore(objectp, user_data, i, update_type, NULL, justCreated);
+			processUpdateCore(objectp, user_data, i, update_type, NULL, justCreated, false, &header.mDecoded);
 		}
 		recorder.objectUpdateEvent(local_id, update_type, objectp, msg_size);
 		objectp->setLastUpdateType(update_type);
 	}
 
+	F64 elapsed_ms = process_timer.getElapsedTimeF64() * 1000.0;
+	if (num_objects > 0 && elapsed_ms > 0.0)
+	{
+		record(LLStatViewer::OBJECT_UPDATES_PER_MS, (F64)num_objects / elapsed_ms);
+	}
+
 	recorder.log(0.2f);
 
 	LLVOAvatar::cullAvatarsByPixelArea();
@@ -965,6 +1083,9 @@ void LLViewerObjectList::update(LLAgent &agent)
 	fetchObjectCosts();
 	fetchPhysicsFlags();
 
+	// switch LODs whose volumes finished building
+	LLVOVolume::updatePendingLODs();
+
 	// update max computed render cost
 	LLVOVolume::updateRenderComplexity();
 
@@ -980,7 +1101,7 @@ void LLViewerObjectList::update(LLAgent &agent)
 	LLUUID id;
 	for (i = 0; i < mOrphanParents.size(); i++)
 	{
-		id = sIndexAndLocalIDToUUID[mOrphanParents[i]];
+		id = sIndexAndLocalIDToUUID.get(mOrphanParents[i], LLUUID::null);
 		LLViewerObject *objectp = findObject(id);
 		if (objectp)
 		{
@@ -1014,7 +1135,7 @@ void LLViewerObjectList::update(LLAgent &agent)
 				tmpstr = std::string("ChNoP:	") + id_str;
 				text_color = LLColor4(1.f, 0.f, 0.f, 1.f);
 			}
-			id = sIndexAndLocalIDToUUID[oi.mParentInfo];
+			id = sIndexAndLocalIDToUUID.get(oi.mParentInfo, LLUUID::null);
 			addDebugBeacon(objectp->getPositionAgent() + LLVector3(0.f, 0.f, -0.25f),
 							tmpstr,
 							LLColor4(0.25f,0.25f,0.25f,1.f),
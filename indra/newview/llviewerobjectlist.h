@@ -31,6 +31,7 @@
 #include <set>
 
 // common includes
+#include "llopenhashmap.h"
 #include "llstring.h"
 #include "lltrace.h"
 
@@ -83,7 +84,8 @@ public:
 
 	// Simulator and viewer side object updates...
 	void processUpdateCore(LLViewerObject* objectp, void** data, U32 block, const EObjectUpdateType update_type, 
-		                   LLDataPacker* dpp, bool justCreated, bool from_cache = false);
+		                   LLDataPacker* dpp, bool justCreated, bool from_cache = false,
+		                   LLDecodedObjectUpdate* decoded = NULL);
 	LLViewerObject* processObjectUpdateFromCache(LLVOCacheEntry* entry, LLViewerRegion* regionp);
 	void processObjectUpdate(LLMessageSystem *mesgsys, void **user_data, EObjectUpdateType update_type, bool compressed=false);
 	void processCompressedObjectUpdate(LLMessageSystem *mesgsys, void **user_data, EObjectUpdateType update_type);
@@ -207,7 +209,7 @@ protected:
 
     uuid_set_t   mDeadObjects;
 
-	std::map<LLUUID, LLPointer<LLViewerObject> > mUUIDObjectMap;
+	LLOpenHashMap<LLUUID, LLPointer<LLViewerObject> > mUUIDObjectMap;
 
 	//set of objects that need to update their cost
     uuid_set_t   mStaleObjectCost;
@@ -222,9 +224,10 @@ protected:
 	S32 mCurLazyUpdateIndex;
 
 	static U32 sSimulatorMachineIndex;
-	static std::map<U64, U32> sIPAndPortToIndex;
+	static LLOpenHashMap<U64, U32> sIPAndPortToIndex;
 
-	static std::map<U64, LLUUID> sIndexAndLocalIDToUUID;
+	// Keyed by (region index << 32) | local id, see getIndex()
+	static LLOpenHashMap<U64, LLUUID> sIndexAndLocalIDToUUID;
 
 	std::set<LLViewerObject *> mSelectPickList;
 
@@ -265,10 +268,10 @@ extern LLViewerObjectList gObjectList;
  */
 inline LLViewerObject *LLViewerObjectList::findObject(const LLUUID &id)
 {
-	std::map<LLUUID, LLPointer<LLViewerObject> >::iterator iter = mUUIDObjectMap.find(id);
-	if(iter != mUUIDObjectMap.end())
+	LLPointer<LLViewerObject>* objectpp = mUUIDObjectMap.find(id);
+	if (objectpp)
 	{
-		return iter->second;
+		return *objectpp;
 	}
 	else
 	{
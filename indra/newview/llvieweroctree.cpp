@@ -41,7 +41,9 @@ BOOL LLViewerOctreeDebug::sInDebug = FALSE;
 
 static LLTrace::CountStatHandle<S32> sOcclusionQueries("occlusion_queries", "Number of occlusion queries executed"),
 									 sNumObjectsOccluded("occluded_objects", "Count of objects being occluded by a query"),
-									 sNumObjectsUnoccluded("unoccluded_objects", "Count of objects being unoccluded by a query");
+									 sNumObjectsUnoccluded("unoccluded_objects", "Count of objects being unoccluded by a query"),
+									 sOcclusionResultsLate("occlusion_results_late", "Occlusion query results read back later than RenderOcclusionLatency frames"),
+									 sOcclusionStallsAvoided("occlusion_stalls_avoided", "Occlusion query results not ready when due, previous visibility kept instead of waiting");
 
 //-----------------------------------------------------------------------------------
 //some global functions definitions
@@ -871,8 +873,15 @@ LLOcclusionCullingGroup::LLOcclusionCullingGroup(OctreeNode* node, LLViewerOctre
 
 	for (U32 i = 0; i < LLViewerCamera::NUM_CAMERAS; i++)
 	{
-		mOcclusionQuery[i] = 0;
+		for (U32 j = 0; j < QUERY_RING_SIZE; j++)
+		{
+			mOcclusionQuery[i][j] = 0;
+			mOcclusionQueryFrame[i][j] = 0;
+		}
+		mOcclusionQueryHead[i] = 0;
+		mOcclusionQueryCount[i] = 0;
 		mOcclusionIssued[i] = 0;
+		mOcclusionStalled[i] = 0;
 		mOcclusionState[i] = parent ? SG_STATE_INHERIT_MASK & parent->mOcclusionState[i] : 0;
 		mVisible[i] = 0;
 	}
@@ -923,15 +932,25 @@ void LLOcclusionCullingGroup::releaseOcclusionQueryObjectNames()
 	{
 		for (U32 i = 0; i < LLViewerCamera::NUM_CAMERAS; ++i)
 		{
-			if (mOcclusionQuery[i])
-			{
-				releaseOcclusionQueryObjectName(mOcclusionQuery[i]);
-				mOcclusionQuery[i] = 0;
-			}
+			releaseOcclusionQueries(i);
 		}
 	}
 }
 
+void LLOcclusionCullingGroup::releaseOcclusionQueries(U32 camera)
+{
+	for (U32 i = 0; i < QUERY_RING_SIZE; ++i)
+	{
+		if (mOcclusionQuery[camera][i])
+		{
+			releaseOcclusionQueryObjectName(mOcclusionQuery[camera][i]);
+			mOcclusionQuery[camera][i] = 0;
+		}
+	}
+	mOcclusionQueryHead[camera] = 0;
+	mOcclusionQueryCount[camera] = 0;
+}
+
 void LLOcclusionCullingGroup::setOcclusionState(U32 state, S32 mode) 
 {
 	if (mode > STATE_MODE_SINGLE)
@@ -952,10 +971,9 @@ void LLOcclusionCullingGroup::setOcclusionState(U32 state, S32 mode)
 			{
 				mOcclusionState[i] |= state;
 
-				if ((state & DISCARD_QUERY) && mOcclusionQuery[i])
+				if (state & DISCARD_QUERY)
 				{
-					releaseOcclusionQueryObjectName(mOcclusionQuery[i]);
-					mOcclusionQuery[i] = 0;
+					releaseOcclusionQueries(i);
 				}
 			}
 		}
@@ -967,10 +985,9 @@ void LLOcclusionCullingGroup::setOcclusionState(U32 state, S32 mode)
 			add(sNumObjectsOccluded, 1);
 		}
 		mOcclusionState[LLViewerCamera::sCurCameraID] |= state;
-		if ((state & DISCARD_QUERY) && mOcclusionQuery[LLViewerCamera::sCurCameraID])
+		if (state & DISCARD_QUERY)
 		{
-			releaseOcclusionQueryObjectName(mOcclusionQuery[LLViewerCamera::sCurCameraID]);
-			mOcclusionQuery[LLViewerCamera::sCurCameraID] = 0;
+			releaseOcclusionQueries(LLViewerCamera::sCurCameraID);
 		}
 	}
 }
@@ -1040,7 +1057,6 @@ void LLOcclusionCullingGroup::clearOcclusionState(U32 state, S32 mode)
 }
 
 static LLTrace::BlockTimerStatHandle FTM_OCCLUSION_READBACK("Readback Occlusion");
-static LLTrace::BlockTimerStatHandle FTM_OCCLUSION_WAIT("Occlusion Wait");
 
 BOOL LLOcclusionCullingGroup::earlyFail(LLCamera* camera, const LLVector4a* bounds)
 {
@@ -1095,73 +1111,88 @@ void LLOcclusionCullingGroup::checkOcclusion()
 	if (LLPipeline::sUseOcclusion > 1)
 	{
 		LL_RECORD_BLOCK_TIME(FTM_OCCLUSION_READBACK);
+		U32 camera_id = LLViewerCamera::sCurCameraID;
 		LLOcclusionCullingGroup* parent = (LLOcclusionCullingGroup*)getParent();
 		if (parent && parent->isOcclusionState(LLOcclusionCullingGroup::OCCLUDED))
 		{	//if the parent has been marked as occluded, the child is implicitly occluded
+			//drop the queries in flight, their names get reused
+			mOcclusionQueryHead[camera_id] = 0;
+			mOcclusionQueryCount[camera_id] = 0;
 			clearOcclusionState(QUERY_PENDING | DISCARD_QUERY);
 		}
 		else if (isOcclusionState(QUERY_PENDING))
-		{	//otherwise, if a query is pending, read it back
+		{	//otherwise, read back every query that is due and finished
+			static LLCachedControl<U32> occlusion_latency(gSavedSettings, "RenderOcclusionLatency", 1);
+			const U32 latency = llclamp((U32) occlusion_latency, 1U, (U32) QUERY_RING_SIZE - 1);
+
+			S32 res = -1;
+			if (isOcclusionState(DISCARD_QUERY))
+			{ //queries were thrown away, draw the group until a new one comes back
+				releaseOcclusionQueries(camera_id);
+				res = 2;
+			}
 
-			GLuint available = 0;
-			if (mOcclusionQuery[LLViewerCamera::sCurCameraID])
+			while (mOcclusionQueryCount[camera_id] > 0)
 			{
-				glGetQueryObjectuivARB(mOcclusionQuery[LLViewerCamera::sCurCameraID], GL_QUERY_RESULT_AVAILABLE_ARB, &available);
-
-				static LLCachedControl<bool> wait_for_query(gSavedSettings, "RenderSynchronousOcclusion", true);
+				U32 slot = mOcclusionQueryHead[camera_id];
+				U32 age = gFrameCount - mOcclusionQueryFrame[camera_id][slot];
+				if (age < latency)
+				{
+					break;
+				}
 
-				if (wait_for_query && mOcclusionIssued[LLViewerCamera::sCurCameraID] < gFrameCount)
-				{ //query was issued last frame, wait until it's available
-					S32 max_loop = 1024;
-					LL_RECORD_BLOCK_TIME(FTM_OCCLUSION_WAIT);
-					while (!available && max_loop-- > 0)
+				GLuint available = 0;
+				glGetQueryObjectuivARB(mOcclusionQuery[camera_id][slot], GL_QUERY_RESULT_AVAILABLE_ARB, &available);
+				if (!available)
+				{ //queries finish in order, so none of the later ones are ready either
+					if (mOcclusionStalled[camera_id] != gFrameCount)
 					{
-						glGetQueryObjectuivARB(mOcclusionQuery[LLViewerCamera::sCurCameraID], GL_QUERY_RESULT_AVAILABLE_ARB, &available);
+						mOcclusionStalled[camera_id] = gFrameCount;
+						add(sOcclusionStallsAvoided, 1);
 					}
+					break;
 				}
-			}
-			else
-			{
-				available = 1;
-			}
 
-			if (available)
-			{ //result is available, read it back, otherwise wait until next frame
-				GLuint res = 1;
-				if (!isOcclusionState(DISCARD_QUERY) && mOcclusionQuery[LLViewerCamera::sCurCameraID])
-				{
-					glGetQueryObjectuivARB(mOcclusionQuery[LLViewerCamera::sCurCameraID], GL_QUERY_RESULT_ARB, &res);	
+				GLuint samples = 1;
+				glGetQueryObjectuivARB(mOcclusionQuery[camera_id][slot], GL_QUERY_RESULT_ARB, &samples);
 #if LL_TRACK_PENDING_OCCLUSION_QUERIES
-					sPendingQueries.erase(mOcclusionQuery[LLViewerCamera::sCurCameraID]);
+				sPendingQueries.erase(mOcclusionQuery[camera_id][slot]);
 #endif
-				}
-				else if (mOcclusionQuery[LLViewerCamera::sCurCameraID])
-				{ //delete the query to avoid holding onto hundreds of pending queries
-					releaseOcclusionQueryObjectName(mOcclusionQuery[LLViewerCamera::sCurCameraID]);
-					mOcclusionQuery[LLViewerCamera::sCurCameraID] = 0;
-				}
-				
-				if (isOcclusionState(DISCARD_QUERY))
+				if (age > latency)
 				{
-					res = 2;
+					add(sOcclusionResultsLate, 1);
 				}
 
-				if (res > 0)
-				{
-					assert_states_valid(this);
-					clearOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
-					assert_states_valid(this);
-				}
-				else
-				{
-					assert_states_valid(this);
-					
-					setOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
-					
-					assert_states_valid(this);
-				}
+				res = samples > 0 ? 1 : 0;
+				mOcclusionQueryHead[camera_id] = (slot + 1) % QUERY_RING_SIZE;
+				mOcclusionQueryCount[camera_id]--;
+			}
 
-				clearOcclusionState(QUERY_PENDING | DISCARD_QUERY);
+			if (res > 0)
+			{
+				assert_states_valid(this);
+				clearOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
+				assert_states_valid(this);
+			}
+			else if (res == 0)
+			{
+				assert_states_valid(this);
+				
+				setOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
+				
+				assert_states_valid(this);
+			}
+			else if (mOcclusionQueryCount[camera_id] == QUERY_RING_SIZE && isOcclusionState(LLOcclusionCullingGroup::OCCLUDED))
+			{ //results are too far behind to keep trusting the last one, draw the group until they catch up
+				assert_states_valid(this);
+				clearOcclusionState(LLOcclusionCullingGroup::OCCLUDED, LLOcclusionCullingGroup::STATE_MODE_DIFF);
+				assert_states_valid(this);
+			}
+
+			clearOcclusionState(DISCARD_QUERY);
+			if (mOcclusionQueryCount[camera_id] == 0)
+			{
+				clearOcclusionState(QUERY_PENDING);
 			}
 		}
 		else if (mSpatialPartition->isOcclusionEnabled() && isOcclusionState(LLOcclusionCullingGroup::OCCLUDED))
@@ -1214,16 +1245,30 @@ void LLOcclusionCullingGroup::doOcclusion(LLCamera* camera, const LLVector4a* sh
 		}
 		else
 		{
-			if (!isOcclusionState(QUERY_PENDING) || isOcclusionState(DISCARD_QUERY))
+			U32 camera_id = LLViewerCamera::sCurCameraID;
+			if (isOcclusionState(DISCARD_QUERY))
+			{ //results still in flight no longer apply
+				mOcclusionQueryHead[camera_id] = 0;
+				mOcclusionQueryCount[camera_id] = 0;
+			}
+
+			//issue a query a frame while earlier ones are still in flight, as long
+			//as the ring has room; checkOcclusion() picks the results up later
+			if (mOcclusionQueryCount[camera_id] < QUERY_RING_SIZE &&
+				(mOcclusionQueryCount[camera_id] == 0 || mOcclusionIssued[camera_id] != gFrameCount))
 			{
-				{ //no query pending, or previous query to be discarded
+				{
 					LL_RECORD_BLOCK_TIME(FTM_RENDER_OCCLUSION);
 
-					if (!mOcclusionQuery[LLViewerCamera::sCurCameraID])
+					U32 slot = (mOcclusionQueryHead[camera_id] + mOcclusionQueryCount[camera_id]) % QUERY_RING_SIZE;
+					if (!mOcclusionQuery[camera_id][slot])
 					{
 						LL_RECORD_BLOCK_TIME(FTM_OCCLUSION_ALLOCATE);
-						mOcclusionQuery[LLViewerCamera::sCurCameraID] = getNewOcclusionQueryObjectName();
+						mOcclusionQuery[camera_id][slot] = getNewOcclusionQueryObjectName();
 					}
+					U32 query = mOcclusionQuery[camera_id][slot];
+					mOcclusionQueryFrame[camera_id][slot] = gFrameCount;
+					mOcclusionQueryCount[camera_id]++;
 
 					// Depth clamp all water to avoid it being culled as a result of being
 					// behind the far clip plane, and in the case of edge water to avoid
@@ -1241,7 +1286,7 @@ void LLOcclusionCullingGroup::doOcclusion(LLCamera* camera, const LLVector4a* sh
 #endif
 					
 #if LL_TRACK_PENDING_OCCLUSION_QUERIES
-					sPendingQueries.insert(mOcclusionQuery[LLViewerCamera::sCurCameraID]);
+					sPendingQueries.insert(query);
 #endif
 					add(sOcclusionQueries, 1);
 
@@ -1249,11 +1294,11 @@ void LLOcclusionCullingGroup::doOcclusion(LLCamera* camera, const LLVector4a* sh
 						LL_RECORD_BLOCK_TIME(FTM_PUSH_OCCLUSION_VERTS);
 						
 						//store which frame this query was issued on
-						mOcclusionIssued[LLViewerCamera::sCurCameraID] = gFrameCount;
+						mOcclusionIssued[camera_id] = gFrameCount;
 
 						{
 							LL_RECORD_BLOCK_TIME(FTM_OCCLUSION_BEGIN_QUERY);
-							glBeginQueryARB(mode, mOcclusionQuery[LLViewerCamera::sCurCameraID]);					
+							glBeginQueryARB(mode, query);					
 						}
 					
 						LLGLSLShader* shader = LLGLSLShader::sCurBoundShaderPtr;
@@ -1357,6 +1402,9 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
 {
 	LLViewerOctreeGroup* group = (LLViewerOctreeGroup*) n->getListener(0);
 
+	S32 bounds_res = mBoundsRes;
+	mBoundsRes = -1;
+
 	if (earlyFail(group))
 	{
 		return;
@@ -1369,16 +1417,53 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
 	}
 	else
 	{
-		mRes = frustumCheck(group);
+		mRes = bounds_res < 0 ? frustumCheck(group) : frustumCheckBatched(group, bounds_res);
 				
 		if (mRes)
 		{ //at least partially in, run on down
-			OctreeTraveler::traverse(n);
+			n->accept(this);
+			traverseChildren(n);
 		}
 
 		mRes = 0;
 	}
 }
+
+// Same as the child loop of OctreeTraveler::traverse(), but tests the bounds
+// of all children against the frustum at once first.
+void LLViewerOctreeCull::traverseChildren(const OctreeNode* n)
+{
+	U32 count = n->getChildCount();
+	U32 batch = getBatchedFrustumCheck();
+	if (batch == BATCH_NONE || count < 2)
+	{
+		for (U32 i = 0; i < count; i++)
+		{
+			traverse(n->getChild(i));
+		}
+		return;
+	}
+
+	LL_ALIGN_16(LLVector4a centers[8]);
+	LL_ALIGN_16(LLVector4a radii[8]);
+	S32 results[8];
+	llassert(count <= 8);
+
+	for (U32 i = 0; i < count; i++)
+	{
+		const LLViewerOctreeGroup* child = (const LLViewerOctreeGroup*) n->getChild(i)->getListener(0);
+		centers[i] = child->mBounds[0];
+		radii[i] = child->mBounds[1];
+	}
+	mCamera->AABBInFrustumBatch(centers, radii, count, results, batch == BATCH_GROUP_BOUNDS);
+
+	for (U32 i = 0; i < count; i++)
+	{
+		mBoundsRes = results[i];
+		traverse(n->getChild(i));
+	}
+	mBoundsRes = -1;
+}
 	
 //------------------------------------------
 //agent space group culling
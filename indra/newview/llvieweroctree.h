@@ -283,6 +283,11 @@ public:
 		EARLY_FAIL				= 0x00100000,
 	} eOcclusionState;
 
+	enum
+	{
+		QUERY_RING_SIZE = 4,		//occlusion queries each camera can have in flight
+	};
+
 	typedef enum
 	{
 		STATE_MODE_SINGLE = 0,		//set one node
@@ -303,7 +308,7 @@ public:
 
 	void setOcclusionState(U32 state, S32 mode = STATE_MODE_SINGLE);
 	void clearOcclusionState(U32 state, S32 mode = STATE_MODE_SINGLE);
-	void checkOcclusion(); //read back last occlusion query (if any)
+	void checkOcclusion(); //read back finished occlusion queries (if any), never waits on GL
 	void doOcclusion(LLCamera* camera, const LLVector4a* shift = NULL); //issue occlusion query
 	BOOL isOcclusionState(U32 state) const	{ return mOcclusionState[LLViewerCamera::sCurCameraID] & state ? TRUE : FALSE; }
 	U32  getOcclusionState() const	{ return mOcclusionState[LLViewerCamera::sCurCameraID];}
@@ -324,18 +329,26 @@ public:
 
 protected:
 	void releaseOcclusionQueryObjectNames();
+	void releaseOcclusionQueries(U32 camera);
 
 private:	
 	BOOL earlyFail(LLCamera* camera, const LLVector4a* bounds);
 
 protected:
 	U32         mOcclusionState[LLViewerCamera::NUM_CAMERAS];
-	U32         mOcclusionIssued[LLViewerCamera::NUM_CAMERAS];
+	U32         mOcclusionIssued[LLViewerCamera::NUM_CAMERAS];	//frame the newest query was issued on
+	U32         mOcclusionStalled[LLViewerCamera::NUM_CAMERAS];	//last frame a late result was counted as a stall avoided
 
 	S32         mLODHash;
 
 	LLViewerOctreePartition* mSpatialPartition;
-	U32		                 mOcclusionQuery[LLViewerCamera::NUM_CAMERAS];
+
+	//per camera ring of queries in flight, the oldest at mOcclusionQueryHead;
+	//names of empty slots stay allocated so they can be reused
+	U32		                 mOcclusionQuery[LLViewerCamera::NUM_CAMERAS][QUERY_RING_SIZE];
+	U32		                 mOcclusionQueryFrame[LLViewerCamera::NUM_CAMERAS][QUERY_RING_SIZE];
+	U8		                 mOcclusionQueryHead[LLViewerCamera::NUM_CAMERAS];
+	U8		                 mOcclusionQueryCount[LLViewerCamera::NUM_CAMERAS];
 
 public:		
 	static std::set<U32> sPendingQueries;
@@ -365,11 +378,23 @@ class LLViewerOctreeCull : public OctreeTraveler
 {
 public:
 	LLViewerOctreeCull(LLCamera* camera)
-		: mCamera(camera), mRes(0) { }
+		: mCamera(camera), mRes(0), mBoundsRes(-1) { }
 	
 	virtual void traverse(const OctreeNode* n);
 
 protected:
+	// Group bounds test frustumCheck() starts with, so the children of a
+	// partially visible node can be tested in one LLCamera::AABBInFrustumBatch().
+	enum
+	{
+		BATCH_NONE = 0,
+		BATCH_GROUP_BOUNDS,				// AABBInFrustumGroupBounds()
+		BATCH_GROUP_BOUNDS_NO_FAR_CLIP	// AABBInFrustumNoFarClipGroupBounds()
+	};
+	virtual U32 getBatchedFrustumCheck() const { return BATCH_NONE; }
+	// Rest of frustumCheck() once the group bounds test gave bounds_res.
+	virtual S32 frustumCheckBatched(const LLViewerOctreeGroup* group, S32 bounds_res) { return bounds_res; }
+
 	virtual bool earlyFail(LLViewerOctreeGroup* group);	
 	
 	//agent space group cull
@@ -401,9 +426,13 @@ protected:
 	virtual void processGroup(LLViewerOctreeGroup* group);
 	virtual void visit(const OctreeNode* branch);
 	
+private:
+	void traverseChildren(const OctreeNode* n);
+
 protected:
 	LLCamera *mCamera;
 	S32 mRes;
+	S32 mBoundsRes;	// batched group bounds result for the node being entered, -1 if none
 };
 
 //scan the octree, output the info of each node for debug use.
@@ -614,6 +614,12 @@ LLViewerRegion::LLViewerRegion(const U64 &handle,
 	mImpl->mObjectPartition.push_back(NULL);					//PARTITION_NONE
 	mImpl->mVOCachePartition = getVOCachePartition();
 
+	// Get the object cache off the disk while the handshake is under way.
+	if(LLVOCache::instanceExists())
+	{
+		LLVOCache::getInstance()->prefetchCache(mHandle);
+	}
+
 	setCapabilitiesReceivedCallback(boost::bind(&LLAvatarRenderInfoAccountant::scanNewRegion, _1));
 }
 
@@ -702,6 +708,9 @@ void LLViewerRegion::loadObjectCache()
 		{
 			mCacheDirty = TRUE;
 		}
+		// Nothing can come out of the cache before this point.
+		LL_INFOS("ObjectCache") << "Object cache for " << mName << " ready "
+								<< mRegionTimer.getElapsedTimeF32() << " s after region creation" << LL_ENDL;
 	}
 }
 
@@ -710,6 +719,10 @@ void LLViewerRegion::saveObjectCache()
 {
 	if (!mCacheLoaded)
 	{
+		if(LLVOCache::instanceExists())
+		{
+			LLVOCache::getInstance()->cancelPrefetch(mHandle);
+		}
 		return;
 	}
 
@@ -2302,8 +2315,8 @@ void LLViewerRegion::decodeBoundingInfo(LLVOCacheEntry* entry)
 	LLVector3 scale;
 	LLQuaternion rot;
 
-	//decode spatial info and parent info
-	U32 parent_id = LLViewerObject::extractSpatialExtents(entry->getDP(), pos, scale, rot);
+	//decode spatial info and parent info, the entry data stays unmaterialized until visible
+	U32 parent_id = entry->extractSpatialExtents(pos, scale, rot);
 	
 	U32 old_parent_id = entry->getParentID();
 	bool same_old_parent = false;
@@ -414,6 +414,8 @@ void LLViewerShaderMgr::setShaders()
 
     reentrance = true;
 
+    LLTimer load_timer;
+
     //setup preprocessor definitions
     LLShaderMgr::instance()->mDefinitions["NUM_TEX_UNITS"] = llformat("%d", gGLManager.mNumTextureImageUnits);
     
@@ -443,6 +445,10 @@ void LLViewerShaderMgr::setShaders()
     LL_INFOS("ShaderLoading") << "\n~~~~~~~~~~~~~~~~~~\n Loading Shaders:\n~~~~~~~~~~~~~~~~~~" << LL_ENDL;
     LL_INFOS("ShaderLoading") << llformat("Using GLSL %d.%d", gGLManager.mGLSLVersionMajor, gGLManager.mGLSLVersionMinor) << LL_ENDL;
 
+    static LLCachedControl<bool> program_cache(gSavedSettings, "RenderShaderProgramCache", true);
+    setProgramCacheDir(program_cache ? gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "shader_programs") : std::string());
+    resetProgramLoadStats();
+
     for (S32 i = 0; i < SHADER_COUNT; i++)
     {
         mShaderLevel[i] = 0;
@@ -572,7 +578,7 @@ void LLViewerShaderMgr::setShaders()
 
         if (loaded)
         {
-            loaded = loadShadersWindLight();
+            loaded = loadBatched(&LLViewerShaderMgr::loadShadersWindLight);
             if (loaded)
             {
                 LL_INFOS() << "Loaded windlight shaders." << LL_ENDL;
@@ -600,7 +606,7 @@ void LLViewerShaderMgr::setShaders()
 
         if (loaded)
         {
-            loaded = loadShadersInterface();
+            loaded = loadBatched(&LLViewerShaderMgr::loadShadersInterface);
             if (loaded)
             {
                 LL_INFOS() << "Loaded interface shaders." << LL_ENDL;
@@ -633,7 +639,7 @@ void LLViewerShaderMgr::setShaders()
             mShaderLevel[SHADER_AVATAR] = 3;
             mMaxAvatarShaderLevel = 3;
                 
-            if (gSavedSettings.getBOOL("RenderAvatarVP") && loadShadersObject())
+            if (gSavedSettings.getBOOL("RenderAvatarVP") && loadBatched(&LLViewerShaderMgr::loadShadersObject))
             { //hardware skinning is enabled and rigged attachment shaders loaded correctly
                 BOOL avatar_cloth = gSavedSettings.getBOOL("RenderAvatarCloth");
 
@@ -677,7 +683,7 @@ void LLViewerShaderMgr::setShaders()
 
                 loadShadersAvatar(); // unloads
 
-                loaded = loadShadersObject();
+                loaded = loadBatched(&LLViewerShaderMgr::loadShadersObject);
                 llassert(loaded);
             }
         }
@@ -696,7 +702,7 @@ void LLViewerShaderMgr::setShaders()
 
         llassert(loaded);
 
-        if (loaded && !loadShadersDeferred())
+        if (loaded && !loadBatched(&LLViewerShaderMgr::loadShadersDeferred))
         { //everything else succeeded but deferred failed, disable deferred and try again
             gSavedSettings.setBOOL("RenderDeferred", FALSE);
             LL_WARNS() << "Falling back to no deferred shaders." << LL_ENDL;
@@ -720,6 +726,14 @@ void LLViewerShaderMgr::setShaders()
         mShaderLevel[SHADER_AVATAR] = 0;
     }
     
+    LL_INFOS("ShaderLoading") << llformat("Compiled %d programs in %.0f ms, loaded %d from the program cache in %.0f ms",
+                                          mProgramsCompiled, mProgramCompileSeconds * 1000.0,
+                                          mProgramsFromCache, mProgramCacheSeconds * 1000.0) << LL_ENDL;
+    LL_INFOS("ShaderLoading") << llformat("setShaders took %.0f ms (%s program cache, parallel compile %s)",
+                                          load_timer.getElapsedTimeF64() * 1000.0,
+                                          mProgramsCompiled ? (mProgramsFromCache ? "partial" : "cold") : "warm",
+                                          gSavedSettings.getBOOL("RenderParallelShaderCompile") ? (gGLManager.mHasParallelShaderCompile ? "on" : "batched") : "off") << LL_ENDL;
+
     if (gViewerWindow)
     {
         gViewerWindow->setCursor(UI_CURSOR_ARROW);
@@ -729,6 +743,21 @@ void LLViewerShaderMgr::setShaders()
     reentrance = false;
 }
 
+BOOL LLViewerShaderMgr::loadBatched(BOOL (LLViewerShaderMgr::*load)())
+{
+    static LLCachedControl<bool> parallel_compile(gSavedSettings, "RenderParallelShaderCompile", true);
+    if (!parallel_compile)
+    {
+        return (this->*load)();
+    }
+
+    beginShaderBatch();
+    BOOL loaded = (this->*load)();
+    // finish even after a failure so no program is left pending
+    BOOL finished = finishShaderBatch();
+    return loaded && finished;
+}
+
 void LLViewerShaderMgr::unloadShaders()
 {
 	gOcclusionProgram.unload();
@@ -938,16 +967,25 @@ BOOL LLViewerShaderMgr::loadBasicShaders()
        attribs["LOCAL_LIGHT_KILL"] = "1";
     }
 
+	// Submit every basic object before reading any compile status so the
+	// driver can compile them in parallel; failures are redone one at a time
+	// below, which also walks down the shader levels.
+	static LLCachedControl<bool> parallel_compile(gSavedSettings, "RenderParallelShaderCompile", true);
+	BOOL defer_status = parallel_compile;
+
 	// We no longer have to bind the shaders to global glhandles, they are automatically added to a map now.
+	std::vector<GLhandleARB> vertex_objects(shaders.size(), 0);
 	for (U32 i = 0; i < shaders.size(); i++)
 	{
 		// Note usage of GL_VERTEX_SHADER_ARB
-		if (loadShaderFile(shaders[i].first, shaders[i].second, GL_VERTEX_SHADER_ARB, &attribs) == 0)
+		vertex_objects[i] = loadShaderFile(shaders[i].first, shaders[i].second, GL_VERTEX_SHADER_ARB, &attribs, -1, defer_status);
+		if (vertex_objects[i] == 0)
 		{
 			LL_SHADER_LOADING_WARNS() << "Failed to load vertex shader " << shaders[i].first << LL_ENDL;
 			return FALSE;
 		}
 	}
+	std::vector<std::pair<std::string, S32> > vertex_shaders(shaders);
 
 	// Load the Basic Fragment Shaders at the appropriate level. 
 	// (in order of shader function call depth for reference purposes, deepest level first)
@@ -999,16 +1037,48 @@ BOOL LLViewerShaderMgr::loadBasicShaders()
 	index_channels.push_back(ch);    shaders.push_back( make_pair( "lighting/lightShinyWaterF.glsl",            mShaderLevel[SHADER_LIGHTING] ) );
     index_channels.push_back(ch);    shaders.push_back( make_pair( "lighting/lightFullbrightShinyWaterF.glsl", mShaderLevel[SHADER_LIGHTING] ) );
     
+	std::vector<GLhandleARB> fragment_objects(shaders.size(), 0);
 	for (U32 i = 0; i < shaders.size(); i++)
 	{
 		// Note usage of GL_FRAGMENT_SHADER_ARB
-		if (loadShaderFile(shaders[i].first, shaders[i].second, GL_FRAGMENT_SHADER_ARB, &attribs, index_channels[i]) == 0)
+		fragment_objects[i] = loadShaderFile(shaders[i].first, shaders[i].second, GL_FRAGMENT_SHADER_ARB, &attribs, index_channels[i], defer_status);
+		if (fragment_objects[i] == 0)
 		{
 			LL_SHADER_LOADING_WARNS() << "Failed to load fragment shader " << shaders[i].first << LL_ENDL;
 			return FALSE;
 		}
 	}
 
+	if (defer_status)
+	{
+		for (U32 i = 0; i < vertex_shaders.size(); i++)
+		{
+			if (!isShaderCompiled(vertex_objects[i]))
+			{
+				glDeleteObjectARB(vertex_objects[i]);
+				mShaderObjectHashes.erase(vertex_objects[i]);
+				if (loadShaderFile(vertex_shaders[i].first, vertex_shaders[i].second, GL_VERTEX_SHADER_ARB, &attribs) == 0)
+				{
+					LL_SHADER_LOADING_WARNS() << "Failed to load vertex shader " << vertex_shaders[i].first << LL_ENDL;
+					return FALSE;
+				}
+			}
+		}
+		for (U32 i = 0; i < shaders.size(); i++)
+		{
+			if (!isShaderCompiled(fragment_objects[i]))
+			{
+				glDeleteObjectARB(fragment_objects[i]);
+				mShaderObjectHashes.erase(fragment_objects[i]);
+				if (loadShaderFile(shaders[i].first, shaders[i].second, GL_FRAGMENT_SHADER_ARB, &attribs, index_channels[i]) == 0)
+				{
+					LL_SHADER_LOADING_WARNS() << "Failed to load fragment shader " << shaders[i].first << LL_ENDL;
+					return FALSE;
+				}
+			}
+		}
+	}
+
 	return TRUE;
 }
 
@@ -129,6 +129,9 @@ public:
 	/* virtual */ void updateShaderUniforms(LLGLSLShader * shader);
 
 private:
+	// Runs a loader inside a shader batch so its programs compile in parallel
+	BOOL loadBatched(BOOL (LLViewerShaderMgr::*load)());
+
 	// the list of shaders we need to propagate parameters to.
 	std::vector<LLGLSLShader *> mShaderList;
 
@@ -31,8 +31,11 @@
 
 #include "message.h"
 #include "llfloaterreg.h"
+#include "llfontgl.h"
+#include "llimagegl.h"
 #include "llmemory.h"
 #include "lltimer.h"
+#include "llvertexbuffer.h"
 #include "llvfile.h"
 
 #include "llappviewer.h"
@@ -98,6 +101,33 @@ LLTrace::CountStatHandle<LLUnit<F64, LLUnits::Kilotriangles> >
 LLTrace::EventStatHandle<LLUnit<F64, LLUnits::Kilotriangles> >
 							TRIANGLES_DRAWN_PER_FRAME("trianglesdrawnperframestat");
 
+LLTrace::CountStatHandle<>	RENDER_BATCHES("renderbatches", "Batches drawn by render passes"),
+							RENDER_STATE_CHANGES("renderstatechanges", "Texture, vertex buffer and transform changes between render batches");
+
+// One stat per LLDrawPool type, named after the pool, the first one for
+// batches drawn outside the pool loops.
+#define RENDER_POOL_STATS(prefix) \
+	{ prefix "other" }, { prefix "simple" }, { prefix "ground" }, { prefix "fullbright" }, \
+	{ prefix "bump" }, { prefix "materials" }, { prefix "terrain" }, { prefix "sky" }, \
+	{ prefix "wlsky" }, { prefix "tree" }, { prefix "alphamask" }, { prefix "fullbrightalphamask" }, \
+	{ prefix "grass" }, { prefix "invisible" }, { prefix "avatar" }, { prefix "voidwater" }, \
+	{ prefix "water" }, { prefix "glow" }, { prefix "alpha" }
+
+LLTrace::CountStatHandle<>	RENDER_POOL_BATCHES[] = { RENDER_POOL_STATS("renderbatches_") },
+							RENDER_POOL_STATE_CHANGES[] = { RENDER_POOL_STATS("renderstatechanges_") };
+
+LLTrace::EventStatHandle<>	RENDER_POOL_BATCHES_PER_FRAME[] = { RENDER_POOL_STATS("renderbatchesperframe_") },
+							RENDER_POOL_STATE_CHANGES_PER_FRAME[] = { RENDER_POOL_STATS("renderstatechangesperframe_") };
+
+LL_STATIC_ASSERT(LL_ARRAY_SIZE(RENDER_POOL_BATCHES) == LLDrawPool::NUM_POOL_TYPES, "one render pool stat per draw pool type");
+
+LLTrace::EventStatHandle<>	RENDER_BATCHES_PER_FRAME("renderbatchesperframe", "Batches drawn by render passes per frame"),
+							RENDER_STATE_CHANGES_PER_FRAME("renderstatechangesperframe", "State changes between render batches per frame"),
+							FONT_GLYPH_LOOKUPS_PER_FRAME("fontglyphlookupsperframe", "Glyph lookups made laying out text runs per frame"),
+							VBO_STREAM_FENCE_WAITS_PER_FRAME("vbostreamfencewaitsperframe", "Times the vertex stream ring waited for the GPU per frame");
+
+LLTrace::EventStatHandle<F64Kilobytes >	VBO_STREAMED_DATA_PER_FRAME("vbostreameddataperframe", "Vertex data copied into the stream ring per frame");
+
 LLTrace::CountStatHandle<F64Kilobytes >	
 							ACTIVE_MESSAGE_DATA_RECEIVED("activemessagedatareceived", "Message system data received on all active regions"),
 							LAYERS_NETWORK_DATA_RECEIVED("layersdatareceived", "Network data received for layer data (terrain)"),
@@ -195,7 +225,8 @@ LLTrace::EventStatHandle<F64Milliseconds >	REGION_CROSSING_TIME("regioncrossingt
 																NETWORK_STACKTIME("networkstacktime", "NETWORK_SECS"),
 																IMAGE_STACKTIME("imagestacktime", "IMAGE_SECS"),
 																REBUILD_STACKTIME("rebuildstacktime", "REBUILD_SECS"),
-																RENDER_STACKTIME("renderstacktime", "RENDER_SECS");
+																RENDER_STACKTIME("renderstacktime", "RENDER_SECS"),
+																TEXTURE_UPLOAD_TIME_PER_FRAME("textureuploadtimeperframe", "Main thread time spent creating GL textures per frame");
 	
 LLTrace::EventStatHandle<F64Seconds >	AVATAR_EDIT_TIME("avataredittime", "Seconds in Edit Appearance"),
 															TOOLBOX_TIME("toolboxtime", "Seconds using Toolbox"),
@@ -206,6 +237,8 @@ LLTrace::EventStatHandle<F64Seconds >	AVATAR_EDIT_TIME("avataredittime", "Second
 
 LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > OBJECT_CACHE_HIT_RATE("object_cache_hits");
 
+LLTrace::EventStatHandle<>	OBJECT_UPDATES_PER_MS("objectupdatespermsec", "Object update blocks processed per millisecond");
+
 }
 
 LLViewerStats::LLViewerStats() 
@@ -341,6 +374,17 @@ void update_statistics()
 	LLTrace::Recording& last_frame_recording = LLTrace::get_frame_recording().getLastRecording();
 
 	record(LLStatViewer::TRIANGLES_DRAWN_PER_FRAME, last_frame_recording.getSum(LLStatViewer::TRIANGLES_DRAWN));
+	record(LLStatViewer::RENDER_BATCHES_PER_FRAME, last_frame_recording.getSum(LLStatViewer::RENDER_BATCHES));
+	record(LLStatViewer::RENDER_STATE_CHANGES_PER_FRAME, last_frame_recording.getSum(LLStatViewer::RENDER_STATE_CHANGES));
+	for (U32 i = 0; i < LLDrawPool::NUM_POOL_TYPES; ++i)
+	{
+		record(LLStatViewer::RENDER_POOL_BATCHES_PER_FRAME[i], last_frame_recording.getSum(LLStatViewer::RENDER_POOL_BATCHES[i]));
+		record(LLStatViewer::RENDER_POOL_STATE_CHANGES_PER_FRAME[i], last_frame_recording.getSum(LLStatViewer::RENDER_POOL_STATE_CHANGES[i]));
+	}
+	record(LLStatViewer::FONT_GLYPH_LOOKUPS_PER_FRAME, last_frame_recording.getSum(LLFontGL::sGlyphLookups));
+	record(LLStatViewer::TEXTURE_UPLOAD_TIME_PER_FRAME, last_frame_recording.getSum(LLImageGL::sMainThreadUploadTime));
+	record(LLStatViewer::VBO_STREAMED_DATA_PER_FRAME, last_frame_recording.getSum(LLVertexBuffer::sStreamedData));
+	record(LLStatViewer::VBO_STREAM_FENCE_WAITS_PER_FRAME, last_frame_recording.getSum(LLVertexBuffer::sStreamFenceWaits));
 
 	sample(LLStatViewer::ENABLE_VBO,      (F64)gSavedSettings.getBOOL("RenderVBOEnable"));
 	sample(LLStatViewer::LIGHTING_DETAIL, (F64)gPipeline.getLightingDetail());
@@ -142,6 +142,14 @@ extern LLTrace::CountStatHandle<>			FPS,
 
 extern LLTrace::CountStatHandle<LLUnit<F64, LLUnits::Kilotriangles> > TRIANGLES_DRAWN;
 
+extern LLTrace::CountStatHandle<>			RENDER_BATCHES,
+											RENDER_STATE_CHANGES;
+
+// The same split by the draw pool being rendered, indexed by LLDrawPool
+// type. Slot 0 counts batches drawn outside the pipeline's pool loops.
+extern LLTrace::CountStatHandle<>			RENDER_POOL_BATCHES[],
+											RENDER_POOL_STATE_CHANGES[];
+
 extern LLTrace::CountStatHandle<F64Kilobytes >	ACTIVE_MESSAGE_DATA_RECEIVED,
 																	LAYERS_NETWORK_DATA_RECEIVED,
 																	OBJECT_NETWORK_DATA_RECEIVED,
@@ -231,7 +239,8 @@ extern LLTrace::EventStatHandle<F64Milliseconds >	REGION_CROSSING_TIME,
 														NETWORK_STACKTIME,
 														IMAGE_STACKTIME,
 														REBUILD_STACKTIME,
-														RENDER_STACKTIME;
+														RENDER_STACKTIME,
+														TEXTURE_UPLOAD_TIME_PER_FRAME;
 
 extern LLTrace::EventStatHandle<F64Seconds >	AVATAR_EDIT_TIME,
 																TOOLBOX_TIME,
@@ -242,6 +251,8 @@ extern LLTrace::EventStatHandle<F64Seconds >	AVATAR_EDIT_TIME,
 
 extern LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > OBJECT_CACHE_HIT_RATE;
 
+extern LLTrace::EventStatHandle<>	OBJECT_UPDATES_PER_MS;
+
 }
 
 class LLViewerStats : public LLSingleton<LLViewerStats>
@@ -36,6 +36,7 @@
 #include "llhost.h"
 #include "llimage.h"
 #include "llimagebmp.h"
+#include "llimagedxt.h"
 #include "llimagej2c.h"
 #include "llimagetga.h"
 #include "llstl.h"
@@ -667,6 +668,7 @@ void LLViewerTexture::init(bool firstinit)
 {
 	mSelectedTime = 0.f;
 	mMaxVirtualSize = 0.f;
+	mPriorityVirtualSize = 0.f;
 	mMaxVirtualSizeResetInterval = 1;
 	mMaxVirtualSizeResetCounter = mMaxVirtualSizeResetInterval;
 	mAdditionalDecodePriority = 0.f;	
@@ -745,6 +747,7 @@ void LLViewerTexture::setBoostLevel(S32 level)
 		{
 			setNoDelete();		
 		}
+		requestPriorityUpdate();
 	}
 
 	if (mBoostLevel == LLViewerTexture::BOOST_SELECTED)
@@ -839,6 +842,12 @@ void LLViewerTexture::addTextureStats(F32 virtual_size, BOOL needs_gltexture) co
 	{
 		mMaxVirtualSize = virtual_size;
 	}	
+
+	// Same 25% threshold LLViewerTextureList uses to reorder the fetch list
+	if (mMaxVirtualSize > mPriorityVirtualSize * 1.25f)
+	{
+		requestPriorityUpdate();
+	}
 }
 
 void LLViewerTexture::resetTextureStats()
@@ -1098,6 +1107,8 @@ void LLViewerFetchedTexture::init(bool firstinit)
 	mCanUseHTTP = true;
 	mDesiredDiscardLevel = MAX_DISCARD_LEVEL + 1;
 	mMinDesiredDiscardLevel = MAX_DISCARD_LEVEL + 1;
+	mBudgetDiscardLevel = 0;
+	mFetchRequestTime = 0.0;
 	
 	mDecodingAux = FALSE;
 
@@ -1109,6 +1120,8 @@ void LLViewerFetchedTexture::init(bool firstinit)
 	{
 		mDecodePriority = 0.f;
 		mInImageList = 0;
+		mPriorityUpdateQueued = FALSE;
+		mEvictionPriority = 0.f;
 	}
 
 	// Only set mIsMissingAsset true when we know for certain that the database
@@ -1397,7 +1410,7 @@ void LLViewerFetchedTexture::addToCreateTexture()
 		mNeedsCreateTexture = FALSE;
 		destroyRawImage();
 	}
-	else if(!force_update && getDiscardLevel() > -1 && getDiscardLevel() <= mRawDiscardLevel)
+	else if(!force_update && getUploadDiscardLevel() > -1 && getUploadDiscardLevel() <= mRawDiscardLevel)
 	{
 		mNeedsCreateTexture = FALSE;
 		destroyRawImage();
@@ -1541,7 +1554,24 @@ BOOL LLViewerFetchedTexture::createTexture(S32 usename/*= 0*/)
 		return FALSE;
 	}
 
-	res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename, TRUE, mBoostLevel);
+	res = FALSE;
+	if (mCompressedImage.notNull() && usename == 0)
+	{
+		// Falls back to the raw image if the blocks do not match it any more
+		res = mGLTexturep->createGLTextureCompressed(mRawDiscardLevel, mRawImage, mCompressedImage, mBoostLevel);
+	}
+	mCompressedImage = NULL;
+	if (!res)
+	{
+		res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename, TRUE, mBoostLevel, true);
+	}
+
+	if (res && mFetchRequestTime > 0.0)
+	{
+		// Includes the upload only when it is not left to LLImageGLThread
+		sample(LLTextureFetch::sTexDisplayLatency, F32Seconds(LLTimer::getTotalSeconds() - mFetchRequestTime));
+		mFetchRequestTime = 0.0;
+	}
 
 	notifyAboutCreatingTexture();
 
@@ -1667,6 +1697,8 @@ F32 LLViewerFetchedTexture::calcDecodePriority()
 	}
 #endif
 	
+	mPriorityVirtualSize = mMaxVirtualSize;
+
 	if (mNeedsCreateTexture)
 	{
 		return mDecodePriority; // no change while waiting to create
@@ -1843,6 +1875,67 @@ void LLViewerFetchedTexture::setAdditionalDecodePriority(F32 priority)
 	}
 }
 
+//virtual
+void LLViewerFetchedTexture::requestPriorityUpdate() const
+{
+	if (!mPriorityUpdateQueued && mInImageList)
+	{
+		mPriorityUpdateQueued = TRUE;
+		gTextureList.queuePriorityUpdate(const_cast<LLViewerFetchedTexture*>(this));
+	}
+}
+
+F32 LLViewerFetchedTexture::calcEvictionPriority()
+{
+	if (mBoostLevel != BOOST_NONE && mBoostLevel != BOOST_ALM)
+	{
+		return F32_MAX; // boosted textures are never evicted for space
+	}
+	if (mMaxVirtualSize > 0.f)
+	{
+		// on screen, the most texels per screen pixel go first
+		U32 texels = hasGLTexture() ? getTexelsInGLTexture() : 0;
+		return texels > 0 ? mMaxVirtualSize / (F32)texels : mMaxVirtualSize;
+	}
+	if (hasGLTexture())
+	{
+		return -getTimePassedSinceLastBound(); // off screen, the longest unused goes first
+	}
+	return 0.f;
+}
+
+bool LLViewerFetchedTexture::downgradeForBudget()
+{
+	if (!hasGLTexture() || mNeedsCreateTexture || !getUseDiscard())
+	{
+		return false;
+	}
+
+	S32 discard = getDiscardLevel() + 1;
+	if (!mGLTexturep->scaleDown(discard))
+	{
+		return false;
+	}
+
+	// Don't fetch back what was just dropped
+	mBudgetDiscardLevel = llmax(mBudgetDiscardLevel, (S8)discard);
+	mDesiredDiscardLevel = llmax(mDesiredDiscardLevel, mBudgetDiscardLevel);
+	return true;
+}
+
+bool LLViewerFetchedTexture::upgradeForBudget()
+{
+	if (mBudgetDiscardLevel <= 0)
+	{
+		return false;
+	}
+
+	mBudgetDiscardLevel--;
+	mFullyLoaded = FALSE;
+	requestPriorityUpdate();
+	return true;
+}
+
 void LLViewerFetchedTexture::updateVirtualSize() 
 {	
 	if(!mMaxVirtualSizeResetCounter)
@@ -1897,7 +1990,8 @@ void LLViewerFetchedTexture::updateVirtualSize()
 
 S32 LLViewerFetchedTexture::getCurrentDiscardLevelForFetching()
 {
-	S32 current_discard = getDiscardLevel();
+	// a level still being uploaded does not need fetching again
+	S32 current_discard = getUploadDiscardLevel();
 	if(mForceToSaveRawImage)
 	{
 		if(mSavedRawDiscardLevel < 0 || current_discard < 0)
@@ -1989,7 +2083,7 @@ bool LLViewerFetchedTexture::updateFetch()
 		
 		if (mRawImage.notNull()) sRawCount--;
 		if (mAuxRawImage.notNull()) sAuxCount--;
-		bool finished = LLAppViewer::getTextureFetch()->getRequestFinished(getID(), fetch_discard, mRawImage, mAuxRawImage,
+		bool finished = LLAppViewer::getTextureFetch()->getRequestFinished(getID(), fetch_discard, mRawImage, mAuxRawImage, mCompressedImage,
 																		   mLastHttpGetStatus);
 		if (mRawImage.notNull()) sRawCount++;
 		if (mAuxRawImage.notNull())
@@ -2206,10 +2300,14 @@ bool LLViewerFetchedTexture::updateFetch()
 		// bypass texturefetch directly by pulling from LLTextureCache
 		bool fetch_request_created = false;
 		fetch_request_created = LLAppViewer::getTextureFetch()->createRequest(mFTType, mUrl, getID(), getTargetHost(), decode_priority,
-																			  w, h, c, desired_discard, needsAux(), mCanUseHTTP);
+																			  w, h, c, desired_discard, needsAux(), canBlockCompress(), mCanUseHTTP);
 		
 		if (fetch_request_created)
 		{
+			if (!mIsFetching)
+			{
+				mFetchRequestTime = LLTimer::getTotalSeconds();
+			}
 			mHasFetcher = TRUE;
 			mIsFetching = TRUE;
 			mRequestedDiscardLevel = desired_discard;
@@ -2832,6 +2930,37 @@ bool LLViewerFetchedTexture::needsToSaveRawImage()
 	return mForceToSaveRawImage || mSaveRawImage;
 }
 
+bool LLViewerFetchedTexture::canBlockCompress() const
+{
+	static LLCachedControl<bool> block_compression(gSavedSettings, "TextureBlockCompression", false);
+	static LLCachedControl<bool> block_compression_ui(gSavedSettings, "TextureBlockCompressionUI", false);
+	static LLCachedControl<bool> block_compression_bump(gSavedSettings, "TextureBlockCompressionBump", false);
+
+	// Textures whose raw pixels are kept around gain nothing from it
+	if (!block_compression || !gGLManager.mHasCompressedTextures || !gGLManager.mHasTextureCompressionS3TC ||
+		mForceToSaveRawImage || mNeedsAux || !mUseMipMaps)
+	{
+		return false;
+	}
+
+	switch (mBoostLevel)
+	{
+	case BOOST_HUD:
+	case BOOST_ICON:
+	case BOOST_UI:
+	case BOOST_PREVIEW:
+	case BOOST_MAP:
+	case BOOST_MAP_VISIBLE:
+		// Compression artifacts are easy to see on flat UI art
+		return block_compression_ui;
+	case BOOST_BUMP:
+		// Normals do not survive colour endpoint quantization well
+		return block_compression_bump;
+	default:
+		return true;
+	}
+}
+
 void LLViewerFetchedTexture::destroyRawImage()
 {	
 	if (mAuxRawImage.notNull() && !needsToSaveRawImage())
@@ -2854,6 +2983,7 @@ void LLViewerFetchedTexture::destroyRawImage()
 		}
 		
 		mRawImage = NULL;
+		mCompressedImage = NULL;
 	
 		mIsRawImageValid = FALSE;
 		mRawDiscardLevel = INVALID_DISCARD_LEVEL;
@@ -3247,6 +3377,8 @@ void LLViewerLODTexture::processTextureStats()
 		mDesiredDiscardLevel = llmin(getMaxDiscardLevel() + 1, (S32)discard_level);
 		// Clamp to min desired discard
 		mDesiredDiscardLevel = llmin(mMinDesiredDiscardLevel, mDesiredDiscardLevel);
+		// Held down by the texture budget until there is room again
+		mDesiredDiscardLevel = llmax(mDesiredDiscardLevel, mBudgetDiscardLevel);
 
 		//
 		// At this point we've calculated the quality level that we want,
@@ -45,6 +45,7 @@ extern const S32Megabytes gMaxVideoRam;
 class LLFace;
 class LLImageGL ;
 class LLImageRaw;
+class LLImageDXT;
 class LLViewerObject;
 class LLViewerTexture;
 class LLViewerFetchedTexture ;
@@ -181,6 +182,10 @@ protected:
 	void notifyAboutMissingAsset();
 	void notifyAboutCreatingTexture();
 
+	// Called when the virtual size or boost level grew enough that the
+	// texture should move up the fetch list before the next sweep reaches it.
+	virtual void requestPriorityUpdate() const {}
+
 private:
 	friend class LLBumpImageList;
 	friend class LLUIImageList;
@@ -197,6 +202,7 @@ protected:
 
 	F32 mSelectedTime;				// time texture was last selected
 	mutable F32 mMaxVirtualSize;	// The largest virtual size of the image, in pixels - how much data to we need?	
+	mutable F32 mPriorityVirtualSize;	// mMaxVirtualSize when the decode priority was last computed
 	mutable S32  mMaxVirtualSizeResetCounter ;
 	mutable S32  mMaxVirtualSizeResetInterval;
 	mutable F32 mAdditionalDecodePriority;  // priority add to mDecodePriority.
@@ -301,6 +307,21 @@ public:
 		}
 	};
 
+	struct CompareEviction
+	{
+		// lower eviction priority is "less", the front of the set goes first
+		bool operator()(const LLViewerFetchedTexture* lhsp, const LLViewerFetchedTexture* rhsp) const
+		{
+			const F32 lpriority = lhsp->getEvictionPriority();
+			const F32 rpriority = rhsp->getEvictionPriority();
+			if (lpriority < rpriority)
+				return true;
+			if (lpriority > rpriority)
+				return false;
+			return lhsp < rhsp;
+		}
+	};
+
 public:
 	/*virtual*/ S8 getType() const ;
 	FTType getFTType() const;
@@ -330,6 +351,8 @@ public:
 	F32  calcDecodePriority() ;
 
 	BOOL needsAux() const { return mNeedsAux; }
+	// TRUE if fetches should block compress the decoded image for upload
+	bool canBlockCompress() const;
 
 	// Host we think might have this image, used for baked av textures.
 	void setTargetHost(LLHost host)			{ mTargetHost = host; }
@@ -343,6 +366,19 @@ public:
 	F32 getAdditionalDecodePriority() const { return mAdditionalDecodePriority; };
 
 	void setAdditionalDecodePriority(F32 priority) ;
+
+	// Key of LLViewerTextureList::mEvictionList. Only the list may set it,
+	// and only while the texture is out of that set.
+	F32 calcEvictionPriority();
+	void setEvictionPriority(F32 priority) { mEvictionPriority = priority; }
+	F32 getEvictionPriority() const { return mEvictionPriority; }
+	void clearPriorityUpdateQueued() { mPriorityUpdateQueued = FALSE; }
+
+	// Texture budget: drop one mip level of the GL texture and keep it from
+	// being fetched back, or allow one level back.
+	bool downgradeForBudget();
+	bool upgradeForBudget();
+	S32  getBudgetDiscardLevel() const { return mBudgetDiscardLevel; }
 	
 	void updateVirtualSize() ;
 
@@ -426,6 +462,7 @@ public:
 
 protected:
 	/*virtual*/ void switchToCachedImage();
+	/*virtual*/ void requestPriorityUpdate() const;
 	S32 getCurrentDiscardLevelForFetching() ;
 
 private:
@@ -471,6 +508,7 @@ protected:
 	S32	mMinDiscardLevel;
 	S8  mDesiredDiscardLevel;			// The discard level we'd LIKE to have - if we have it and there's space	
 	S8  mMinDesiredDiscardLevel;	// The minimum discard level we'd like to have
+	S8  mBudgetDiscardLevel;		// The texture budget won't let mDesiredDiscardLevel go below this
 
 	S8  mNeedsAux;					// We need to decode the auxiliary channels
 	S8  mHasAux;                    // We have aux channels
@@ -497,6 +535,9 @@ protected:
 	// doing if you use it for anything else! - djs
 	LLPointer<LLImageRaw> mAuxRawImage;
 
+	// mRawImage block compressed on the decode thread, see canBlockCompress()
+	LLPointer<LLImageDXT> mCompressedImage;
+
 	//keep a copy of mRawImage for some special purposes
 	//when mForceToSaveRawImage is set.
 	BOOL mForceToSaveRawImage ;
@@ -517,8 +558,11 @@ protected:
 	// Timers
 	LLFrameTimer mLastPacketTimer;		// Time since last packet.
 	LLFrameTimer mStopFetchingTimer;	// Time since mDecodePriority == 0.f.
+	F64 mFetchRequestTime;				// When the current fetch was requested, 0 once its texture is created
 
 	BOOL  mInImageList;				// TRUE if image is in list (in which case don't reset priority!)
+	mutable BOOL mPriorityUpdateQueued;	// TRUE if waiting in LLViewerTextureList::mPriorityUpdateList
+	F32   mEvictionPriority;			// lower is evicted first, see calcEvictionPriority()
 	BOOL  mNeedsCreateTexture;	
 
 	BOOL   mForSculpt ; //a flag if the texture is used as sculpt data.
@@ -32,6 +32,7 @@
 
 #include "llgl.h" // fot gathering stats from GL
 #include "llimagegl.h"
+#include "llimageglthread.h"
 #include "llimagebmp.h"
 #include "llimagej2c.h"
 #include "llimagetga.h"
@@ -94,6 +95,10 @@ LLViewerTextureList::LLViewerTextureList()
 	: mForceResetTextureStats(FALSE),
 	mMaxResidentTexMemInMegaBytes(0),
 	mMaxTotalTextureMemInMegaBytes(0),
+	mTextureBudget(0),
+	mBudgetDowngrades(0),
+	mBudgetUpgrades(0),
+	mBudgetDegradedCount(0),
 	mInitialized(FALSE)
 {
 }
@@ -326,6 +331,8 @@ void LLViewerTextureList::shutdown()
 	
 	mUUIDMap.clear();
 	
+	mPriorityUpdateList.clear();
+	mEvictionList.clear();
 	mImageList.clear();
 
 	mInitialized = FALSE ; //prevent loading textures again.
@@ -646,6 +653,8 @@ void LLViewerTextureList::addImageToList(LLViewerFetchedTexture *image)
 	{
 			LL_WARNS() << "Error happens when insert image " << image->getID()  << " into mImageList!" << LL_ENDL ;
 	}
+	image->setEvictionPriority(image->calcEvictionPriority());
+	mEvictionList.insert(image);
 	image->setInImageList(TRUE) ;
 }
 }
@@ -657,6 +666,7 @@ void LLViewerTextureList::removeImageFromList(LLViewerFetchedTexture *image)
 	llassert(image);
 
 	S32 count = 0;
+	mEvictionList.erase(image);
 	if (image->isInImageList())
 	{
 		count = mImageList.erase(image) ;
@@ -753,6 +763,7 @@ static LLTrace::BlockTimerStatHandle FTM_IMAGE_CALLBACKS("Callbacks");
 static LLTrace::BlockTimerStatHandle FTM_IMAGE_FETCH("Fetch");
 static LLTrace::BlockTimerStatHandle FTM_FAST_CACHE_IMAGE_FETCH("Fast Cache Fetch");
 static LLTrace::BlockTimerStatHandle FTM_IMAGE_CREATE("Create");
+static LLTrace::BlockTimerStatHandle FTM_IMAGE_BUDGET("Budget");
 static LLTrace::BlockTimerStatHandle FTM_IMAGE_STATS("Stats");
 static LLTrace::BlockTimerStatHandle FTM_UPDATE_TEXTURES("Update Textures");
 
@@ -807,6 +818,11 @@ void LLViewerTextureList::updateImages(F32 max_time)
 		max_time = llmax(max_time, total_max_time*.50f); // at least 50% of max_time
 		max_time -= updateImagesCreateTextures(max_time);
 	}
+
+	{
+		LL_RECORD_BLOCK_TIME(FTM_IMAGE_BUDGET);
+		updateImagesTextureBudget();
+	}
 	
 	if (!mDirtyTextureList.empty())
 	{
@@ -859,9 +875,59 @@ void LLViewerTextureList::clearFetchingRequests()
 	}
 }
 
+void LLViewerTextureList::queuePriorityUpdate(LLViewerFetchedTexture* imagep)
+{
+	mPriorityUpdateList.push_back(imagep);
+}
+
+void LLViewerTextureList::updateImagePriority(LLViewerFetchedTexture* imagep)
+{
+	imagep->processTextureStats();
+	F32 old_priority = imagep->getDecodePriority();
+	F32 old_priority_test = llmax(old_priority, 0.0f);
+	F32 decode_priority = imagep->calcDecodePriority();
+	F32 decode_priority_test = llmax(decode_priority, 0.0f);
+	// Ignore < 20% difference
+	if ((decode_priority_test < old_priority_test * .8f) ||
+		(decode_priority_test > old_priority_test * 1.25f))
+	{
+		mImageList.erase(imagep) ;
+		imagep->setDecodePriority(decode_priority);
+		mImageList.insert(imagep);
+	}
+	imagep->clearPriorityUpdateQueued();
+
+	F32 eviction_priority = imagep->calcEvictionPriority();
+	if (eviction_priority != imagep->getEvictionPriority())
+	{
+		mEvictionList.erase(imagep);
+		imagep->setEvictionPriority(eviction_priority);
+		mEvictionList.insert(imagep);
+	}
+}
+
 void LLViewerTextureList::updateImagesDecodePriorities()
 {
-	// Update the decode priority for N images each frame
+	// Textures that grew since their last update go first, so a texture
+	// coming into view doesn't wait for the sweep below to reach it.
+	{
+		std::vector<LLPointer<LLViewerFetchedTexture> > update_list;
+		update_list.swap(mPriorityUpdateList);
+		for (std::vector<LLPointer<LLViewerFetchedTexture> >::iterator iter = update_list.begin();
+			 iter != update_list.end(); ++iter)
+		{
+			LLViewerFetchedTexture* imagep = *iter;
+			if (!imagep->isInImageList() || imagep->isInDebug() || imagep->isInFastCacheList())
+			{
+				imagep->clearPriorityUpdateQueued();
+				continue;
+			}
+			updateImagePriority(imagep);
+		}
+	}
+
+	// Update the decode priority for N images each frame, this also
+	// handles flushing and deleting the ones nobody uses any more.
 	{
 		F32 lazy_flush_timeout = 30.f; // stop decoding
 		F32 max_inactive_time  = 20.f; // actually delete
@@ -957,18 +1023,135 @@ void LLViewerTextureList::updateImagesDecodePriorities()
 				continue; //wait for loading from the fast cache.
 			}
 
-			imagep->processTextureStats();
-			F32 old_priority = imagep->getDecodePriority();
-			F32 old_priority_test = llmax(old_priority, 0.0f);
-			F32 decode_priority = imagep->calcDecodePriority();
-			F32 decode_priority_test = llmax(decode_priority, 0.0f);
-			// Ignore < 20% difference
-			if ((decode_priority_test < old_priority_test * .8f) ||
-				(decode_priority_test > old_priority_test * 1.25f))
+			updateImagePriority(imagep);
+		}
+	}
+}
+
+void LLViewerTextureList::updateImagesTextureBudget()
+{
+	static LLCachedControl<F32> budget_target(gSavedSettings, "TextureBudgetTarget", 0.85f);
+	const F32 target = llclamp((F32)budget_target, 0.f, 1.f);
+	mTextureBudget = getMaxTotalTextureMem() * target;
+	const S32Megabytes bound_budget = getMaxResidentTexMem() * target;
+
+	if (mBudgetCategoryTimer.getElapsedTimeF32() > 1.f)
+	{
+		mBudgetCategoryTimer.reset();
+		mTextureMemByCategory.assign(LLGLTexture::getTotalNumOfCategories(), S32Bytes(0));
+		mBudgetDegradedCount = 0;
+		for (image_priority_list_t::iterator iter = mImageList.begin(); iter != mImageList.end(); ++iter)
+		{
+			LLViewerFetchedTexture* imagep = *iter;
+			if (imagep->getBudgetDiscardLevel() > 0)
+			{
+				mBudgetDegradedCount++;
+			}
+			if (imagep->hasGLTexture())
+			{
+				S32 index = LLGLTexture::getIndexFromCategory(imagep->getCategory());
+				if (index >= 0 && index < (S32)mTextureMemByCategory.size())
+				{
+					mTextureMemByCategory[index] += imagep->getTextureMemory();
+				}
+			}
+		}
+	}
+
+	if (target <= 0.f)
+	{
+		return;
+	}
+
+	// Drop textures one mip level at a time, least needed first, instead
+	// of letting the discard bias throw whole textures out and fetch them
+	// back. Only allow levels back well under the budget so the two don't
+	// fight over the same textures.
+	const F32 UPGRADE_HEADROOM = 0.8f;
+	const F32 MIN_UNBOUND_TIME = 30.f;
+	const S32 MAX_DOWNGRADES = 16;
+	const S32 MAX_UPGRADES = 4;
+	const S32 MAX_VISITS = 1024;
+
+	S32Bytes total_mem = LLImageGL::sGlobalTextureMemory;
+	S32Bytes bound_mem = LLImageGL::sBoundTextureMemory;
+	if (total_mem > mTextureBudget || bound_mem > bound_budget)
+	{
+		S32Bytes to_free = llmax(total_mem - S32Bytes(mTextureBudget), bound_mem - S32Bytes(bound_budget));
+		S32Bytes freed(0);
+		S32 visited = 0;
+		std::vector<LLViewerFetchedTexture*> downgraded;
+		for (image_eviction_list_t::iterator iter = mEvictionList.begin();
+			 iter != mEvictionList.end() && (S32)downgraded.size() < MAX_DOWNGRADES && visited < MAX_VISITS && freed < to_free;
+			 ++iter, ++visited)
+		{
+			LLViewerFetchedTexture* imagep = *iter;
+			if (imagep->getEvictionPriority() == F32_MAX)
+			{
+				break; // only boosted textures left
+			}
+			if (!imagep->hasGLTexture() || imagep->isUnremovable() || imagep->isInDebug() ||
+				imagep->getType() != LLViewerTexture::LOD_TEXTURE)
+			{
+				continue;
+			}
+
+			S32Bytes old_mem = imagep->getTextureMemory();
+			if (imagep->downgradeForBudget())
+			{
+				freed += old_mem - imagep->getTextureMemory();
+				downgraded.push_back(imagep);
+				mBudgetDowngrades++;
+			}
+			else if (imagep->getEvictionPriority() <= 0.f &&
+					 imagep->getTimePassedSinceLastBound() > MIN_UNBOUND_TIME)
+			{
+				// Nothing left to drop and not drawn in a while
+				imagep->destroyTexture();
+			}
+		}
+
+		// Reorder after the walk so no texture loses two levels in one frame
+		for (std::vector<LLViewerFetchedTexture*>::iterator iter = downgraded.begin(); iter != downgraded.end(); ++iter)
+		{
+			LLViewerFetchedTexture* imagep = *iter;
+			mEvictionList.erase(imagep);
+			imagep->setEvictionPriority(imagep->calcEvictionPriority());
+			mEvictionList.insert(imagep);
+		}
+	}
+	else if (total_mem < mTextureBudget * UPGRADE_HEADROOM &&
+			 bound_mem < bound_budget * UPGRADE_HEADROOM &&
+			 LLViewerTexture::sDesiredDiscardBias <= 0.f)
+	{
+		S64 headroom = S32Bytes(mTextureBudget * UPGRADE_HEADROOM).value() - total_mem.value();
+		S32 upgraded = 0;
+		S32 visited = 0;
+		for (image_eviction_list_t::reverse_iterator iter = mEvictionList.rbegin();
+			 iter != mEvictionList.rend() && upgraded < MAX_UPGRADES && visited < MAX_VISITS;
+			 ++iter, ++visited)
+		{
+			LLViewerFetchedTexture* imagep = *iter;
+			if (imagep->getEvictionPriority() <= 0.f)
 			{
-				mImageList.erase(imagep) ;
-				imagep->setDecodePriority(decode_priority);
-				mImageList.insert(imagep);
+				break; // the rest is off screen
+			}
+			if (imagep->getBudgetDiscardLevel() <= 0)
+			{
+				continue;
+			}
+
+			// One level up is about four times the memory
+			S64 growth = imagep->hasGLTexture() ? imagep->getTextureMemory().value() * 3 : 0;
+			if (growth > headroom)
+			{
+				break;
+			}
+			if (imagep->upgradeForBudget())
+			{
+				headroom -= growth;
+				upgraded++;
+				mBudgetUpgrades++;
 			}
 		}
 	}
@@ -1032,6 +1215,10 @@ F32 LLViewerTextureList::updateImagesCreateTextures(F32 max_time)
 	//
 		
 	LLTimer create_timer;
+
+	// Swap in textures the upload thread has finished
+	LLImageGLThread::updateClass();
+
 	image_list_t::iterator enditer = mCreateTextureList.begin();
 	for (image_list_t::iterator iter = mCreateTextureList.begin();
 		 iter != mCreateTextureList.end();)
@@ -1205,6 +1392,7 @@ void LLViewerTextureList::decodeAllImages(F32 max_time)
 	}
 
 	llassert_always(image_list.size() == mImageList.size()) ;
+	mEvictionList.clear();
 	mImageList.clear();
 	for (std::vector<LLPointer<LLViewerFetchedTexture> >::iterator iter = image_list.begin();
 		 iter != image_list.end(); ++iter)
@@ -136,11 +136,24 @@ public:
 	void clearFetchingRequests();
 	void setDebugFetching(LLViewerFetchedTexture* tex, S32 debug_level);
 
+	// Reprioritize the texture next frame instead of waiting for the sweep
+	void queuePriorityUpdate(LLViewerFetchedTexture* imagep);
+
+	// Texture budget, for the texture console
+	S32Megabytes getTextureBudget() const				{ return mTextureBudget; }
+	U32 getBudgetDowngrades() const						{ return mBudgetDowngrades; }
+	U32 getBudgetUpgrades() const						{ return mBudgetUpgrades; }
+	S32 getBudgetDegradedCount() const					{ return mBudgetDegradedCount; }
+	// GL memory per LLGLTexture category index, refreshed once a second
+	const std::vector<S32Bytes>& getTextureMemByCategory() const { return mTextureMemByCategory; }
+
 	static S32Megabytes getMinVideoRamSetting();
 	static S32Megabytes getMaxVideoRamSetting(bool get_recommended, float mem_multiplier);
 	
 private:
 	void updateImagesDecodePriorities();
+	void updateImagePriority(LLViewerFetchedTexture* imagep);
+	void updateImagesTextureBudget();
 	F32  updateImagesCreateTextures(F32 max_time);
 	F32  updateImagesFetchTextures(F32 max_time);
 	void updateImagesUpdateStats();
@@ -218,6 +231,14 @@ private:
 	typedef std::set<LLPointer<LLViewerFetchedTexture>, LLViewerFetchedTexture::Compare> image_priority_list_t;	
 	image_priority_list_t mImageList;
 
+	// Same textures as mImageList, least needed first. Raw pointers, an image
+	// is always removed from here before it leaves mImageList.
+	typedef std::set<LLViewerFetchedTexture*, LLViewerFetchedTexture::CompareEviction> image_eviction_list_t;
+	image_eviction_list_t mEvictionList;
+
+	// Textures whose virtual size or boost level grew since their last update
+	std::vector<LLPointer<LLViewerFetchedTexture> > mPriorityUpdateList;
+
 	// simply holds on to LLViewerFetchedTexture references to stop them from being purged too soon
 	std::set<LLPointer<LLViewerFetchedTexture> > mImagePreloads;
 
@@ -225,6 +246,13 @@ private:
 	S32Megabytes	mMaxResidentTexMemInMegaBytes;
 	S32Megabytes mMaxTotalTextureMemInMegaBytes;
 	LLFrameTimer mForceDecodeTimer;
+
+	S32Megabytes mTextureBudget;		// TextureBudgetTarget of mMaxTotalTextureMemInMegaBytes
+	U32 mBudgetDowngrades;				// mip levels dropped to stay in budget
+	U32 mBudgetUpgrades;				// mip levels allowed back
+	S32 mBudgetDegradedCount;			// textures currently held below their desired level
+	std::vector<S32Bytes> mTextureMemByCategory;
+	LLFrameTimer mBudgetCategoryTimer;
 	
 private:
 	static S32 sNumImages;
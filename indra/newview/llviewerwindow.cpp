@@ -123,6 +123,7 @@
 #include "llhudobject.h"
 #include "llhudview.h"
 #include "llimage.h"
+#include "llimageglthread.h"
 #include "llimagej2c.h"
 #include "llimageworker.h"
 #include "llkeyboard.h"
@@ -1888,6 +1889,10 @@ LLViewerWindow::LLViewerWindow(const Params& p)
 	// Init the image list.  Must happen after GL is initialized and before the images that
 	// LLViewerWindow needs are requested.
 	LLImageGL::initClass(LLViewerTexture::MAX_GL_IMAGE_CATEGORY) ;
+	if (gSavedSettings.getBOOL("RenderTextureUploadThread"))
+	{
+		LLImageGLThread::initClass(mWindow);
+	}
 	gTextureList.init();
 	LLViewerTextureManager::init() ;
 	gBumpImageList.init();
@@ -2285,6 +2290,7 @@ void LLViewerWindow::shutdownGL()
 	LL_INFOS() << "Cleaning up wearables" << LL_ENDL;
 	LLWearableList::instance().cleanup() ;
 
+	LLImageGLThread::cleanupClass();
 	gTextureList.shutdown();
 	stop_glerror();
 
@@ -5207,6 +5213,9 @@ void LLViewerWindow::stopGL(BOOL save_state)
 		LLAppViewer::getTextureCache()->pause();
 		LLAppViewer::getImageDecodeThread()->pause();
 		LLAppViewer::getTextureFetch()->pause();
+
+		// Land any textures still being uploaded before their images are saved off
+		LLImageGLThread::cleanupClass();
 				
 		gSky.destroyGL();
 		stop_glerror();		
@@ -5220,6 +5229,9 @@ void LLViewerWindow::stopGL(BOOL save_state)
 		LLFontGL::destroyAllGL();
 		stop_glerror();
 
+		LLPanel::destroyRenderCaches();
+		stop_glerror();
+
 		LLVOAvatar::destroyGL();
 		stop_glerror();
 
@@ -5272,6 +5284,10 @@ void LLViewerWindow::restoreGL(const std::string& progress_message)
 		LLGLState::restoreGL();
 		
 		gTextureList.restoreGL();
+		if (gSavedSettings.getBOOL("RenderTextureUploadThread"))
+		{
+			LLImageGLThread::initClass(mWindow);
+		}
 		
 		// for future support of non-square pixels, and fonts that are properly stretched
 		//LLFontGL::destroyDefaultFonts();
@@ -2341,12 +2341,13 @@ void LLVOAvatar::updateMeshData()
 U32 LLVOAvatar::processUpdateMessage(LLMessageSystem *mesgsys,
 									 void **user_data,
 									 U32 block_num, const EObjectUpdateType update_type,
-									 LLDataPacker *dp)
+									 LLDataPacker *dp,
+									 LLDecodedObjectUpdate* decoded)
 {
 	const BOOL has_name = !getNVPair("FirstName");
 
 	// Do base class updates...
-	U32 retval = LLViewerObject::processUpdateMessage(mesgsys, user_data, block_num, update_type, dp);
+	U32 retval = LLViewerObject::processUpdateMessage(mesgsys, user_data, block_num, update_type, dp, decoded);
 
 	// Print out arrival information once we have name of avatar.
     if (has_name && getNVPair("FirstName"))
@@ -135,7 +135,8 @@ public:
 													 void **user_data,
 													 U32 block_num,
 													 const EObjectUpdateType update_type,
-													 LLDataPacker *dp);
+													 LLDataPacker *dp,
+													 LLDecodedObjectUpdate* decoded = NULL);
 	virtual void   	 	 	idleUpdate(LLAgent &agent, const F64 &time);
 	/*virtual*/ BOOL   	 	 	updateLOD();
 	BOOL  	 	 	 	 	updateJointLODs();
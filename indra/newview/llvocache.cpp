@@ -35,6 +35,14 @@
 #include "pipeline.h"
 #include "llagentcamera.h"
 #include "llmemory.h"
+#include "llthreadpool.h"
+
+#if !LL_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 //static variables
 U32 LLVOCacheEntry::sMinFrameRange = 0;
@@ -72,7 +80,8 @@ LLVOCacheEntry::LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &
 	mSceneContrib(0.f),
 	mValid(TRUE),
 	mParentID(0),
-	mBSphereRadius(-1.0f)
+	mBSphereRadius(-1.0f),
+	mImageOffset(0)
 {
 	mBuffer = new U8[dp.getBufferSize()];
 	mDP.assignBuffer(mBuffer, dp.getBufferSize());
@@ -93,84 +102,36 @@ LLVOCacheEntry::LLVOCacheEntry()
 	mSceneContrib(0.f),
 	mValid(TRUE),
 	mParentID(0),
-	mBSphereRadius(-1.0f)
+	mBSphereRadius(-1.0f),
+	mImageOffset(0)
 {
 	mDP.assignBuffer(mBuffer, 0);
 }
 
-LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
+LLVOCacheEntry::LLVOCacheEntry(const LLVOCacheRecordHeader& header, const std::shared_ptr<const LLVOCacheFileImage>& image, U32 offset)
 :	LLTrace::MemTrackable<LLVOCacheEntry, 16>("LLVOCacheEntry"),
 	LLViewerOctreeEntryData(LLViewerOctreeEntry::LLVOCACHEENTRY), 
+	mLocalID(header.mLocalID),
+	mCRC(header.mCRC),
+	mHitCount(header.mHitCount),
+	mDupeCount(header.mDupeCount),
+	mCRCChangeCount(header.mCRCChangeCount),
 	mBuffer(NULL),
 	mUpdateFlags(-1),
 	mState(INACTIVE),
 	mSceneContrib(0.f),
 	mValid(FALSE),
 	mParentID(0),
-	mBSphereRadius(-1.0f)
+	mBSphereRadius(-1.0f),
+	mImageOffset(offset)
 {
-	S32 size = -1;
-	BOOL success;
-
 	mDP.assignBuffer(mBuffer, 0);
-	
-	success = check_read(apr_file, &mLocalID, sizeof(U32));
-	if(success)
-	{
-		success = check_read(apr_file, &mCRC, sizeof(U32));
-	}
-	if(success)
-	{
-		success = check_read(apr_file, &mHitCount, sizeof(S32));
-	}
-	if(success)
-	{
-		success = check_read(apr_file, &mDupeCount, sizeof(S32));
-	}
-	if(success)
-	{
-		success = check_read(apr_file, &mCRCChangeCount, sizeof(S32));
-	}
-	if(success)
-	{
-		success = check_read(apr_file, &size, sizeof(S32));
-
-		// Corruption in the cache entries
-		if ((size > 10000) || (size < 1))
-		{
-			// We've got a bogus size, skip reading it.
-			// We won't bother seeking, because the rest of this file
-			// is likely bogus, and will be tossed anyway.
-			LL_WARNS() << "Bogus cache entry, size " << size << ", aborting!" << LL_ENDL;
-			success = FALSE;
-		}
-	}
-	if(success && size > 0)
-	{
-		mBuffer = new U8[size];
-		success = check_read(apr_file, mBuffer, size);
-
-		if(success)
-		{
-			mDP.assignBuffer(mBuffer, size);
-		}
-		else
-		{
-			delete[] mBuffer ;
-			mBuffer = NULL ;
-		}
-	}
 
-	if(!success)
+	if (header.mSize > 0)
 	{
-		mLocalID = 0;
-		mCRC = 0;
-		mHitCount = 0;
-		mDupeCount = 0;
-		mCRCChangeCount = 0;
-		mBuffer = NULL;
-		mEntry = NULL;
-		mState = INACTIVE;
+		// Nothing is copied until the object is about to be created, most
+		// cached objects never get that far.
+		mImage = image;
 	}
 }
 
@@ -188,6 +149,7 @@ void LLVOCacheEntry::updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp)
 	}
 
 	mDP.freeBuffer();
+	mImage.reset();
 
 	llassert_always(dp.getBufferSize() > 0);
 	mBuffer = new U8[dp.getBufferSize()];
@@ -223,10 +185,13 @@ void LLVOCacheEntry::removeAllChildren()
 //virtual 
 void LLVOCacheEntry::setOctreeEntry(LLViewerOctreeEntry* entry)
 {
-	if(!entry && mDP.getBufferSize() > 0)
+	S32 size = 0;
+	U8* data = entry ? NULL : peekData(size);
+	if(data)
 	{
+		LLDataPackerBinaryBuffer dp(data, size);
 		LLUUID fullid;
-		LLViewerObject::unpackUUID(&mDP, fullid, "ID");
+		LLViewerObject::unpackUUID(&dp, fullid, "ID");
 		
 		LLViewerObject* obj = gObjectList.findObject(fullid);
 		if(obj && obj->mDrawable)
@@ -320,6 +285,16 @@ LLVOCacheEntry* LLVOCacheEntry::getChild()
 
 LLDataPackerBinaryBuffer *LLVOCacheEntry::getDP()
 {
+	if (mImage)
+	{
+		S32 size = 0;
+		U8* data = peekData(size);
+		mBuffer = new U8[size];
+		memcpy(mBuffer, data, size);
+		mDP.assignBuffer(mBuffer, size);
+		mImage.reset();
+	}
+
 	if (mDP.getBufferSize() == 0)
 	{
 		//LL_INFOS() << "Not getting cache entry, invalid!" << LL_ENDL;
@@ -329,6 +304,34 @@ LLDataPackerBinaryBuffer *LLVOCacheEntry::getDP()
 	return &mDP;
 }
 
+U8* LLVOCacheEntry::peekData(S32& size) const
+{
+	if (mImage)
+	{
+		LLVOCacheRecordHeader header;
+		memcpy(&header, mImage->getData() + mImageOffset - sizeof(header), sizeof(header));
+		size = header.mSize;
+		// Only ever unpacked from, the image may be mapped read only.
+		return const_cast<U8*>(mImage->getData() + mImageOffset);
+	}
+
+	size = mDP.getBufferSize();
+	return size > 0 ? const_cast<U8*>(mDP.getBuffer()) : NULL;
+}
+
+U32 LLVOCacheEntry::extractSpatialExtents(LLVector3& pos, LLVector3& scale, LLQuaternion& rot) const
+{
+	S32 size = 0;
+	U8* data = peekData(size);
+	if (!data)
+	{
+		return 0;
+	}
+
+	LLDataPackerBinaryBuffer dp(data, size);
+	return LLViewerObject::extractSpatialExtents(&dp, pos, scale, rot);
+}
+
 void LLVOCacheEntry::recordHit()
 {
 	mHitCount++;
@@ -345,38 +348,29 @@ void LLVOCacheEntry::dump() const
 		<< LL_ENDL;
 }
 
-BOOL LLVOCacheEntry::writeToFile(LLAPRFile* apr_file) const
+BOOL LLVOCacheEntry::appendRecord(std::vector<U8>& buffer) const
 {
-	BOOL success;
-	success = check_write(apr_file, (void*)&mLocalID, sizeof(U32));
-	if(success)
-	{
-		success = check_write(apr_file, (void*)&mCRC, sizeof(U32));
-	}
-	if(success)
-	{
-		success = check_write(apr_file, (void*)&mHitCount, sizeof(S32));
-	}
-	if(success)
-	{
-		success = check_write(apr_file, (void*)&mDupeCount, sizeof(S32));
-	}
-	if(success)
-	{
-		success = check_write(apr_file, (void*)&mCRCChangeCount, sizeof(S32));
-	}
-	if(success)
-	{
-		S32 size = mDP.getBufferSize();
-		success = check_write(apr_file, (void*)&size, sizeof(S32));
-	
-		if(success)
-		{
-			success = check_write(apr_file, (void*)mBuffer, size);
-		}
-	}
-
-	return success ;
+	S32 size = 0;
+	const U8* data = peekData(size);
+	if (!data)
+	{
+		// Would read back as a removal record.
+		return FALSE;
+	}
+
+	LLVOCacheRecordHeader header;
+	header.mLocalID = mLocalID;
+	header.mCRC = mCRC;
+	header.mHitCount = mHitCount;
+	header.mDupeCount = mDupeCount;
+	header.mCRCChangeCount = mCRCChangeCount;
+	header.mSize = size;
+
+	size_t offset = buffer.size();
+	buffer.resize(offset + sizeof(header) + size);
+	memcpy(&buffer[offset], &header, sizeof(header));
+	memcpy(&buffer[offset + sizeof(header)], data, size);
+	return TRUE;
 }
 
 //static 
@@ -1044,6 +1038,226 @@ const U32 INVALID_TIME = 0 ;
 const char* object_cache_dirname = "objectcache";
 const char* header_filename = "object.cache";
 
+// Compact a region file once it holds this many more records than live
+// entries, and at least twice as many.
+const U32 MIN_RECORDS_TO_COMPACT = 256;
+// Same bound the old format used to spot corruption.
+const S32 MAX_CACHE_RECORD_SIZE = 10000;
+
+struct LLVOCache::CacheFileRead
+{
+	CacheFileRead() : mSuccess(false), mDone(false) {}
+
+	std::shared_ptr<LLVOCacheFileImage> mImage;
+	bool					mSuccess;
+	bool					mDone;
+	std::mutex				mMutex;
+	std::condition_variable	mCondition;
+};
+
+//-------------------------------------------------------------------
+// Region file I/O, runs on the LLVOCache I/O thread
+//-------------------------------------------------------------------
+
+static bool read_cache_file(const std::string& filename, std::vector<U8>& data)
+{
+	LLFILE* fp = LLFile::fopen(filename, "rb");		/* Flawfinder: ignore */
+	if (!fp)
+	{
+		return false;
+	}
+
+	bool success = false;
+	if (fseek(fp, 0, SEEK_END) == 0)
+	{
+		long size = ftell(fp);
+		if (size >= UUID_BYTES && fseek(fp, 0, SEEK_SET) == 0)
+		{
+			data.resize(size);
+			success = fread(&data[0], size, 1, fp) == 1;
+		}
+	}
+	fclose(fp);
+	return success;
+}
+
+//-------------------------------------------------------------------
+// LLVOCacheFileImage
+//-------------------------------------------------------------------
+
+LLVOCacheFileImage::LLVOCacheFileImage()
+:	mData(NULL),
+	mSize(0),
+	mMapped(false)
+{
+}
+
+LLVOCacheFileImage::~LLVOCacheFileImage()
+{
+#if !LL_WINDOWS
+	if (mMapped)
+	{
+		::munmap(const_cast<U8*>(mData), mSize);
+	}
+#endif
+}
+
+bool LLVOCacheFileImage::open(const std::string& filename)
+{
+#if !LL_WINDOWS
+	// Region files are only ever replaced by rename or appended to, so the
+	// mapping stays valid for as long as the entries need it. Windows will
+	// not rename over or delete a mapped file, read it there instead.
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat st;
+	if (::fstat(fd, &st) == 0 && st.st_size >= UUID_BYTES)
+	{
+		void* addr = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr != MAP_FAILED)
+		{
+			mData = (const U8*)addr;
+			mSize = st.st_size;
+			mMapped = true;
+		}
+	}
+	::close(fd);
+
+	if (mMapped)
+	{
+		return true;
+	}
+#endif
+
+	if (!read_cache_file(filename, mBuffer))
+	{
+		return false;
+	}
+	mData = mBuffer.data();
+	mSize = mBuffer.size();
+	return true;
+}
+
+// Calls func(header, data) for each record in a region file image. Returns
+// the number of records, or -1 when a bogus record was found; records up to
+// that point have been passed on. A truncated last record, left behind if
+// the viewer died during an append, is dropped and reported through
+// truncated, since anything appended after it would be misread.
+template <typename FUNC>
+static S32 for_each_cache_record(const U8* data, size_t size, FUNC func, bool* truncated = NULL)
+{
+	if (truncated)
+	{
+		*truncated = false;
+	}
+
+	S32 count = 0;
+	size_t offset = UUID_BYTES;
+	while (offset + sizeof(LLVOCacheRecordHeader) <= size)
+	{
+		LLVOCacheRecordHeader header;
+		memcpy(&header, data + offset, sizeof(header));
+		if (!header.mLocalID || header.mSize < 0 || header.mSize > MAX_CACHE_RECORD_SIZE)
+		{
+			LL_WARNS() << "Bogus cache record, local id " << header.mLocalID << ", size " << header.mSize << LL_ENDL;
+			return -1;
+		}
+
+		if (offset + sizeof(header) + header.mSize > size)
+		{
+			break;
+		}
+		offset += sizeof(header);
+		func(header, data + offset);
+		offset += header.mSize;
+		++count;
+	}
+
+	if (truncated && offset < size)
+	{
+		*truncated = true;
+	}
+	return count;
+}
+
+static bool write_cache_file(const std::string& filename, const char* mode, const U8* data, size_t size)
+{
+	LLFILE* fp = LLFile::fopen(filename, mode);		/* Flawfinder: ignore */
+	if (!fp)
+	{
+		return false;
+	}
+	bool success = size == 0 || fwrite(data, size, 1, fp) == 1;
+	success = (fclose(fp) == 0) && success;
+	return success;
+}
+
+// Rewrites a whole region file through a temporary so that a crash never
+// leaves a half written cache behind.
+static bool replace_cache_file(const std::string& filename, const std::vector<U8>& data)
+{
+	std::string temp_filename = filename + ".tmp";
+	if (!write_cache_file(temp_filename, "wb", data.data(), data.size()))
+	{
+		LLFile::remove(temp_filename, ENOENT);
+		return false;
+	}
+	LLFile::remove(filename, ENOENT);
+	return LLFile::rename(temp_filename, filename) == 0;
+}
+
+// Drops superseded and removal records from a region file.
+static void compact_cache_file(const std::string& filename)
+{
+	std::vector<U8> data;
+	if (!read_cache_file(filename, data))
+	{
+		return;
+	}
+
+	// Latest record offset for every live local id.
+	std::map<U32, size_t> latest;
+	size_t offset = UUID_BYTES;
+	S32 count = for_each_cache_record(data.data(), data.size(),
+		[&latest, &offset](const LLVOCacheRecordHeader& header, const U8*)
+		{
+			if (header.mSize > 0)
+			{
+				latest[header.mLocalID] = offset;
+			}
+			else
+			{
+				latest.erase(header.mLocalID);
+			}
+			offset += sizeof(header) + header.mSize;
+		});
+	if (count < 0)
+	{
+		// Leave it to the next readFromCache() to deal with.
+		return;
+	}
+
+	std::vector<U8> compacted(data.begin(), data.begin() + UUID_BYTES);
+	for (std::map<U32, size_t>::const_iterator iter = latest.begin(); iter != latest.end(); ++iter)
+	{
+		LLVOCacheRecordHeader header;
+		memcpy(&header, &data[iter->second], sizeof(header));
+		compacted.insert(compacted.end(),
+						 data.begin() + iter->second,
+						 data.begin() + iter->second + sizeof(header) + header.mSize);
+	}
+
+	if (!replace_cache_file(filename, compacted))
+	{
+		LL_WARNS() << "Failed to compact object cache file " << filename << LL_ENDL;
+		LLFile::remove(filename, ENOENT);
+	}
+}
+
 
 LLVOCache::LLVOCache(bool read_only) :
 	mInitialized(false),
@@ -1053,18 +1267,26 @@ LLVOCache::LLVOCache(bool read_only) :
 {
 	mEnabled = gSavedSettings.getBOOL("ObjectCacheEnabled");
 	mLocalAPRFilePoolp = new LLVolatileAPRPool() ;
+	mIOThread = new LLThreadPool("ObjectCache", 1);
 }
 
 LLVOCache::~LLVOCache()
 {
+	flushIO();
 	if(mEnabled)
 	{
 		writeCacheHeader();
 		clearCacheInMemory();
 	}
+	delete mIOThread;
 	delete mLocalAPRFilePoolp;
 }
 
+void LLVOCache::flushIO()
+{
+	mIOThread->waitForIdle();
+}
+
 void LLVOCache::setDirNames(ELLPath location)
 {
 	mHeaderFileName = gDirUtilp->getExpandedFilename(location, object_cache_dirname, header_filename);
@@ -1135,6 +1357,8 @@ void LLVOCache::removeCache(ELLPath location, bool started)
 
 	LL_INFOS() << "about to remove the object cache due to settings." << LL_ENDL ;
 
+	flushIO();
+
 	std::string mask = "*";
 	std::string cache_dir = gDirUtilp->getExpandedFilename(location, object_cache_dirname);
 	LL_INFOS() << "Removing cache at " << cache_dir << LL_ENDL;
@@ -1159,6 +1383,8 @@ void LLVOCache::removeCache()
 		return ;
 	}
 
+	flushIO();
+
 	std::string mask = "*";
 	LL_INFOS() << "Removing object cache at " << mObjectCacheDirName << LL_ENDL;
 	gDirUtilp->deleteFilesInDir(mObjectCacheDirName, mask); 
@@ -1214,7 +1440,8 @@ void LLVOCache::clearCacheInMemory()
 		mHandleEntryMap.clear();
 		mNumEntries = 0 ;
 	}
-
+	mPendingReads.clear();
+	mRegionLogs.clear();
 }
 
 void LLVOCache::getObjectCacheFilename(U64 handle, std::string& filename) 
@@ -1236,9 +1463,16 @@ void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
 		return ;
 	}
 
+	mPendingReads.erase(entry->mHandle);
+	mRegionLogs.erase(entry->mHandle);
+
+	// Queued behind any write still pending for this region.
 	std::string filename;
 	getObjectCacheFilename(entry->mHandle, filename);
-	LLAPRFile::remove(filename, mLocalAPRFilePoolp);
+	mIOThread->post([filename]()
+		{
+			LLFile::remove(filename, ENOENT);
+		});
 	entry->mTime = INVALID_TIME ;
 	updateEntry(entry) ; //update the head file.
 }
@@ -1386,6 +1620,47 @@ BOOL LLVOCache::updateEntry(const HeaderEntryInfo* entry)
 	return check_write(&apr_file, (void*)entry, sizeof(HeaderEntryInfo)) ;
 }
 
+void LLVOCache::prefetchCache(U64 handle)
+{
+	if(!mEnabled || !mInitialized)
+	{
+		return;
+	}
+
+	if(mHandleEntryMap.find(handle) == mHandleEntryMap.end() //no cache
+	   || mPendingReads.find(handle) != mPendingReads.end())
+	{
+		return;
+	}
+
+	std::shared_ptr<CacheFileRead> read = std::make_shared<CacheFileRead>();
+	mPendingReads[handle] = read;
+
+	std::string filename;
+	getObjectCacheFilename(handle, filename);
+	mIOThread->post([filename, read]()
+		{
+			std::shared_ptr<LLVOCacheFileImage> image = std::make_shared<LLVOCacheFileImage>();
+			bool success = image->open(filename);
+			if (success)
+			{
+				read->mImage = image;
+			}
+			{
+				std::unique_lock<std::mutex> lock(read->mMutex);
+				read->mSuccess = success;
+				read->mDone = true;
+			}
+			read->mCondition.notify_all();
+		});
+}
+
+void LLVOCache::cancelPrefetch(U64 handle)
+{
+	// The I/O thread keeps its own reference if it is still reading.
+	mPendingReads.erase(handle);
+}
+
 void LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map) 
 {
 	if(!mEnabled)
@@ -1402,44 +1677,77 @@ void LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
 		return ;
 	}
 
-	bool success = true ;
+	LLTimer read_timer;
+
+	// Normally the read was started when the region was created and has
+	// long finished by the time the handshake gets here.
+	prefetchCache(handle);
+	std::shared_ptr<CacheFileRead> read = mPendingReads[handle];
+	mPendingReads.erase(handle);
+	{
+		std::unique_lock<std::mutex> lock(read->mMutex);
+		while (!read->mDone)
+		{
+			read->mCondition.wait(lock);
+		}
+	}
+	F64 wait_time = read_timer.getElapsedTimeF64();
+
+	bool success = read->mSuccess;
+	if(success)
 	{
-		std::string filename;
-		getObjectCacheFilename(handle, filename);
-		LLAPRFile apr_file(filename, APR_READ|APR_BINARY, mLocalAPRFilePoolp);
-	
 		LLUUID cache_id ;
-		success = check_read(&apr_file, cache_id.mData, UUID_BYTES) ;
-	
-		if(success)
-		{		
-			if(cache_id != id)
-			{
-				LL_INFOS() << "Cache ID doesn't match for this region, discarding"<< LL_ENDL;
-				success = false ;
-			}
+		memcpy(cache_id.mData, read->mImage->getData(), UUID_BYTES);
+		if(cache_id != id)
+		{
+			LL_INFOS() << "Cache ID doesn't match for this region, discarding"<< LL_ENDL;
+			success = false ;
+		}
+	}
 
-			if(success)
+	if(success)
+	{
+		RegionLogInfo& log = mRegionLogs[handle];
+		log = RegionLogInfo();
+		std::shared_ptr<const LLVOCacheFileImage> image = read->mImage;
+		bool truncated = false;
+		S32 num_records = for_each_cache_record(image->getData(), image->getSize(),
+			[&cache_entry_map, &log, &image](const LLVOCacheRecordHeader& header, const U8* data)
 			{
-				S32 num_entries;
-				success = check_read(&apr_file, &num_entries, sizeof(S32)) ;
-	
-				if(success)
+				if (header.mSize > 0)
+				{
+					// Only the index is built here, the object data stays in
+					// the image until the object is potentially visible.
+					cache_entry_map[header.mLocalID] = new LLVOCacheEntry(header, image, (U32)(data - image->getData()));
+					log.mPersistedCRCs.set(header.mLocalID, header.mCRC);
+				}
+				else
 				{
-					for (S32 i = 0; i < num_entries && apr_file.eof() != APR_EOF; i++)
-					{
-						LLPointer<LLVOCacheEntry> entry = new LLVOCacheEntry(&apr_file);
-						if (!entry->getLocalID())
-						{
-							LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
-							success = false ;
-							break ;
-						}
-						cache_entry_map[entry->getLocalID()] = entry;
-					}
+					cache_entry_map.erase(header.mLocalID);
+					log.mPersistedCRCs.erase(header.mLocalID);
 				}
+			}, &truncated);
+
+		if (num_records < 0)
+		{
+			LL_WARNS() << "Cache file corruption for region " << handle << ", keeping " << cache_entry_map.size() << " entries" << LL_ENDL;
+			log.mNeedsRewrite = true;
+			success = false;
+		}
+		else
+		{
+			log.mNumRecords = num_records;
+			if (truncated)
+			{
+				LL_INFOS("ObjectCache") << "Dropped truncated cache record for region " << handle << ", file will be rewritten" << LL_ENDL;
+				log.mNeedsRewrite = true;
 			}
-		}		
+		}
+
+		LL_INFOS("ObjectCache") << "Indexed " << cache_entry_map.size() << " cached objects for region " << handle
+								<< " in " << read_timer.getElapsedTimeF64() * 1000.0 << " ms ("
+								<< wait_time * 1000.0 << " ms waiting for I/O), "
+								<< image->getSize() / 1024 << " KB " << (image->isMapped() ? "mapped" : "read") << LL_ENDL;
 	}
 	
 	if(!success)
@@ -1482,6 +1790,8 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
 		return ;
 	}	
 
+	LLTimer write_timer;
+
 	HeaderEntryInfo* entry;
 	handle_entry_map_t::iterator iter = mHandleEntryMap.find(handle) ;
 	if(iter == mHandleEntryMap.end()) //new entry
@@ -1514,48 +1824,103 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
 	if(!updateEntry(entry))
 	{
 		LL_WARNS() << "Failed to update cache header index " << entry->mIndex << ". handle = " << handle << LL_ENDL;
+		mRegionLogs.erase(handle);
 		return ; //update failed.
 	}
 
 	if(!dirty_cache)
 	{
 		LL_WARNS() << "Skipping write to cache for handle " << handle << ": cache not dirty" << LL_ENDL;
+		mRegionLogs.erase(handle);
 		return ; //nothing changed, no need to update.
 	}
 
-	//write to cache file
-	bool success = true ;
+	// Without a readable file from this session, write the region out in
+	// full. Otherwise only append records for entries that changed since
+	// the file was read.
+	region_log_map_t::iterator log_iter = mRegionLogs.find(handle);
+	bool append = (log_iter != mRegionLogs.end()) && !log_iter->second.mNeedsRewrite;
+
+	std::shared_ptr<std::vector<U8> > records = std::make_shared<std::vector<U8> >();
+	if(!append)
 	{
-		std::string filename;
-		getObjectCacheFilename(handle, filename);
-		LLAPRFile apr_file(filename, APR_CREATE|APR_WRITE|APR_BINARY, mLocalAPRFilePoolp);
-	
-		success = check_write(&apr_file, (void*)id.mData, UUID_BYTES) ;
+		records->insert(records->end(), id.mData, id.mData + UUID_BYTES);
+	}
 
-	
-		if(success)
+	U32 num_live = 0;
+	U32 num_written = 0;
+	for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
+	{
+		const LLVOCacheEntry* cache_entry = iter->second;
+		U32 local_id = iter->first;
+		U32* persisted_crc = append ? log_iter->second.mPersistedCRCs.find(local_id) : NULL;
+		if(!removal_enabled || cache_entry->isValid())
 		{
-			S32 num_entries = cache_entry_map.size() ;
-			success = check_write(&apr_file, &num_entries, sizeof(S32));
-	
-			for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); success && iter != cache_entry_map.end(); ++iter)
+			num_live++;
+			if(!persisted_crc || *persisted_crc != cache_entry->getCRC())
 			{
-				if(!removal_enabled || iter->second->isValid())
+				if (cache_entry->appendRecord(*records))
 				{
-					success = iter->second->writeToFile(&apr_file) ;
-					if(!success)
-					{
-						break;
-					}
+					num_written++;
 				}
 			}
+			if(persisted_crc)
+			{
+				// Anything left over afterwards is gone from the region.
+				log_iter->second.mPersistedCRCs.erase(local_id);
+			}
 		}
 	}
 
-	if(!success)
+	if(append)
 	{
-		removeEntry(entry) ;
+		// Removal records for whatever was in the file but is no more.
+		log_iter->second.mPersistedCRCs.forEach([&records, &num_written](U32 local_id, U32)
+			{
+				LLVOCacheRecordHeader header;
+				memset(&header, 0, sizeof(header));
+				header.mLocalID = local_id;
+				const U8* bytes = (const U8*)&header;
+				records->insert(records->end(), bytes, bytes + sizeof(header));
+				num_written++;
+			});
 	}
 
-	return ;
+	std::string filename;
+	getObjectCacheFilename(handle, filename);
+	if(!append)
+	{
+		mIOThread->post([filename, records]()
+			{
+				if (!replace_cache_file(filename, *records))
+				{
+					LL_WARNS() << "Failed to write object cache file " << filename << LL_ENDL;
+					LLFile::remove(filename, ENOENT);
+				}
+			});
+	}
+	else if(num_written > 0)
+	{
+		U32 num_records = log_iter->second.mNumRecords + num_written;
+		bool compact = num_records > num_live * 2 && num_records - num_live > MIN_RECORDS_TO_COMPACT;
+		mIOThread->post([filename, records, compact]()
+			{
+				if (!write_cache_file(filename, "ab", records->data(), records->size()))
+				{
+					// A partial record in the middle of the log would hide
+					// everything appended after it.
+					LL_WARNS() << "Failed to append to object cache file " << filename << LL_ENDL;
+					LLFile::remove(filename, ENOENT);
+				}
+				else if (compact)
+				{
+					compact_cache_file(filename);
+				}
+			});
+	}
+	mRegionLogs.erase(handle);
+
+	LL_INFOS("ObjectCache") << (append ? "Appended " : "Wrote ") << num_written << " of " << num_live
+							<< " cached objects for region " << handle << " in "
+							<< write_timer.getElapsedTimeF64() * 1000.0 << " ms" << LL_ENDL;
 }
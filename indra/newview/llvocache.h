@@ -32,10 +32,50 @@
 #include "lldir.h"
 #include "llvieweroctree.h"
 #include "llapr.h"
+#include "llopenhashmap.h"
+
+#include <memory>
 
 //---------------------------------------------------------------------------
 // Cache entries
 class LLCamera;
+class LLThreadPool;
+
+// Region cache files are a log: the region id followed by one record per
+// change. A record is this header followed by mSize bytes of object data,
+// or just the header with mSize 0 when the entry was removed. The latest
+// record for a local id wins.
+struct LLVOCacheRecordHeader
+{
+	U32 mLocalID;
+	U32 mCRC;
+	S32 mHitCount;
+	S32 mDupeCount;
+	S32 mCRCChangeCount;
+	S32 mSize;
+};
+
+// Read only image of a region cache file, shared by the entries loaded from
+// it until they need their data. Memory mapped where a mapped file can still
+// be replaced or removed, read into memory elsewhere.
+class LLVOCacheFileImage
+{
+public:
+	LLVOCacheFileImage();
+	~LLVOCacheFileImage();
+
+	bool open(const std::string& filename);
+
+	const U8* getData() const	{ return mData; }
+	size_t getSize() const		{ return mSize; }
+	bool isMapped() const		{ return mMapped; }
+
+private:
+	const U8*		mData;
+	size_t			mSize;
+	bool			mMapped;
+	std::vector<U8>	mBuffer;	// when not mapped
+};
 
 class LLVOCacheEntry 
 :	public LLViewerOctreeEntryData,
@@ -83,7 +123,9 @@ protected:
 	~LLVOCacheEntry();
 public:
 	LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &dp);
-	LLVOCacheEntry(LLAPRFile* apr_file);
+	// Entry for the record at offset in image, its data stays there until
+	// getDP() is first called.
+	LLVOCacheEntry(const LLVOCacheRecordHeader& header, const std::shared_ptr<const LLVOCacheFileImage>& image, U32 offset);
 	LLVOCacheEntry();	
 
 	void updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp);
@@ -106,8 +148,11 @@ public:
 	F32 getSceneContribution() const             { return mSceneContrib;}
 
 	void dump() const;
-	BOOL writeToFile(LLAPRFile* apr_file) const;
+	BOOL appendRecord(std::vector<U8>& buffer) const;
 	LLDataPackerBinaryBuffer *getDP();
+	bool isMaterialized() const { return !mImage; }
+	// Spatial info and parent id, without materializing the entry.
+	U32 extractSpatialExtents(LLVector3& pos, LLVector3& scale, LLQuaternion& rot) const;
 	void recordHit();
 	void recordDupe() { mDupeCount++; }
 	
@@ -138,6 +183,8 @@ public:
 
 private:
 	void updateParentBoundingInfo(const LLVOCacheEntry* child);	
+	// Object data wherever it currently lives, NULL when there is none.
+	U8* peekData(S32& size) const;
 
 public:
 	typedef std::map<U32, LLPointer<LLVOCacheEntry> >	   vocache_entry_map_t;
@@ -155,6 +202,8 @@ protected:
 	S32							mCRCChangeCount;
 	LLDataPackerBinaryBuffer	mDP;
 	U8							*mBuffer;
+	std::shared_ptr<const LLVOCacheFileImage> mImage; //set until materialized
+	U32							mImageOffset; //of the object data in mImage
 
 	F32                         mSceneContrib; //projected scene contributuion of this object.
 	U32                         mState; //high 16 bits reserved for special use.
@@ -258,11 +307,30 @@ private:
 	typedef std::set<HeaderEntryInfo*, header_entry_less> header_entry_queue_t;
 	typedef std::map<U64, HeaderEntryInfo*> handle_entry_map_t;
 
+	// Region file contents, filled in by the I/O thread.
+	struct CacheFileRead;
+	typedef std::map<U64, std::shared_ptr<CacheFileRead> > pending_read_map_t;
+
+	// What the region file held when it was read, so that writeToCache()
+	// only has to append what changed since.
+	struct RegionLogInfo
+	{
+		RegionLogInfo() : mNumRecords(0), mNeedsRewrite(false) {}
+
+		LLOpenHashMap<U32, U32>	mPersistedCRCs;	// local id -> CRC of its latest record
+		U32						mNumRecords;	// including superseded and removal records
+		bool					mNeedsRewrite;	// file damaged, appending would be unreadable
+	};
+	typedef std::map<U64, RegionLogInfo> region_log_map_t;
+
 public:
 	// We need this init to be separate from constructor, since we might construct cache, purge it, then init.
 	void initCache(ELLPath location, U32 size, U32 cache_version);
 	void removeCache(ELLPath location, bool started = false) ;
 
+	// Start reading a region file on the I/O thread ahead of readFromCache().
+	void prefetchCache(U64 handle);
+	void cancelPrefetch(U64 handle);
 	void readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map) ;
 	void writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, BOOL dirty_cache, bool removal_enabled);
 	void removeEntry(U64 handle) ;
@@ -282,6 +350,8 @@ private:
 	void removeEntry(HeaderEntryInfo* entry) ;
 	void purgeEntries(U32 size);
 	BOOL updateEntry(const HeaderEntryInfo* entry);
+	// Wait for queued region file reads and writes.
+	void flushIO();
 	
 private:
 	bool                 mEnabled;
@@ -295,6 +365,9 @@ private:
 	LLVolatileAPRPool*   mLocalAPRFilePoolp ; 	
 	header_entry_queue_t mHeaderEntryQueue;
 	handle_entry_map_t   mHandleEntryMap;	
+	LLThreadPool*        mIOThread;			// single thread, so region file jobs run in order
+	pending_read_map_t   mPendingReads;
+	region_log_map_t     mRegionLogs;
 };
 
 #endif
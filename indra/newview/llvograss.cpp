@@ -246,10 +246,11 @@ U32 LLVOGrass::processUpdateMessage(LLMessageSystem *mesgsys,
 										  void **user_data,
 										  U32 block_num,
 										  const EObjectUpdateType update_type,
-										  LLDataPacker *dp)
+										  LLDataPacker *dp,
+										  LLDecodedObjectUpdate* decoded)
 {
 	// Do base class updates...
-	U32 retval = LLViewerObject::processUpdateMessage(mesgsys, user_data, block_num, update_type, dp);
+	U32 retval = LLViewerObject::processUpdateMessage(mesgsys, user_data, block_num, update_type, dp, decoded);
 
 	updateSpecies();
 
@@ -275,10 +275,11 @@ void LLVOTree::cleanupClass()
 U32 LLVOTree::processUpdateMessage(LLMessageSystem *mesgsys,
 										  void **user_data,
 										  U32 block_num, EObjectUpdateType update_type,
-										  LLDataPacker *dp)
+										  LLDataPacker *dp,
+										  LLDecodedObjectUpdate* decoded)
 {
 	// Do base class updates...
-	U32 retval = LLViewerObject::processUpdateMessage(mesgsys, user_data, block_num, update_type, dp);
+	U32 retval = LLViewerObject::processUpdateMessage(mesgsys, user_data, block_num, update_type, dp, decoded);
 
 	if (  (getVelocity().lengthSquared() > 0.f)
 		||(getAcceleration().lengthSquared() > 0.f)
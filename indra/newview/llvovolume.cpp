@@ -86,6 +86,8 @@
 #include "llcallstack.h"
 #include "llsculptidsize.h"
 #include "llavatarappearancedefines.h"
+#include "llthreadpool.h"
+#include "llvolumegeometryjob.h"
 
 const F32 FORCE_SIMPLE_RENDER_AREA = 512.f;
 const F32 FORCE_CULL_AREA = 8.f;
@@ -98,6 +100,7 @@ F32 LLVOVolume::sLODFactor = 1.f;
 F32	LLVOVolume::sLODSlopDistanceFactor = 0.5f; //Changing this to zero, effectively disables the LOD transition slop 
 F32 LLVOVolume::sDistanceFactor = 1.0f;
 S32 LLVOVolume::sNumLODChanges = 0;
+std::vector<LLPointer<LLVOVolume> > LLVOVolume::sPendingLODVolumes;
 S32 LLVOVolume::mRenderComplexity_last = 0;
 S32 LLVOVolume::mRenderComplexity_current = 0;
 LLPointer<LLObjectMediaDataClient> LLVOVolume::sObjectMediaClient = NULL;
@@ -228,6 +231,7 @@ LLVOVolume::LLVOVolume(const LLUUID &id, const LLPCode pcode, LLViewerRegion *re
 	mVObjRadius = LLVector3(1,1,0.5f).length();
 	mNumFaces = 0;
 	mLODChanged = FALSE;
+	mLODPending = false;
 	mSculptChanged = FALSE;
 	mSpotLightPriority = 0.f;
 
@@ -314,19 +318,43 @@ void LLVOVolume::cleanupClass()
 {
     sObjectMediaClient = NULL;
     sObjectMediaNavigateClient = NULL;
+	sPendingLODVolumes.clear();
+}
+
+// static
+void LLVOVolume::updatePendingLODs()
+{
+	if (sPendingLODVolumes.empty())
+	{
+		return;
+	}
+
+	// updateLOD() queues volumes that are still waiting again
+	std::vector<LLPointer<LLVOVolume> > pending;
+	pending.swap(sPendingLODVolumes);
+	for (std::vector<LLPointer<LLVOVolume> >::iterator iter = pending.begin(); iter != pending.end(); ++iter)
+	{
+		LLVOVolume* volumep = *iter;
+		volumep->mLODPending = false;
+		if (!volumep->isDead())
+		{
+			volumep->updateLOD();
+		}
+	}
 }
 
 U32 LLVOVolume::processUpdateMessage(LLMessageSystem *mesgsys,
 										  void **user_data,
 										  U32 block_num, EObjectUpdateType update_type,
-										  LLDataPacker *dp)
+										  LLDataPacker *dp,
+										  LLDecodedObjectUpdate* decoded)
 {
 	 	
 	LLColor4U color;
 	const S32 teDirtyBits = (TEM_CHANGE_TEXTURE|TEM_CHANGE_COLOR|TEM_CHANGE_MEDIA);
 
 	// Do base class updates...
-	U32 retval = LLViewerObject::processUpdateMessage(mesgsys, user_data, block_num, update_type, dp);
+	U32 retval = LLViewerObject::processUpdateMessage(mesgsys, user_data, block_num, update_type, dp, decoded);
 
 	LLUUID sculpt_id;
 	U8 sculpt_type = 0;
@@ -393,17 +421,20 @@ U32 LLVOVolume::processUpdateMessage(LLMessageSystem *mesgsys,
 		// Sigh, this needs to be done AFTER the volume is set as well, otherwise bad stuff happens...
 		////////////////////////////
 		//
-		// Unpack texture entry data
+		// Apply texture entry data decoded by LLDecodedObjectUpdate
 		//
 
-		S32 result = unpackTEMessage(mesgsys, _PREHASH_ObjectData, (S32) block_num);
-		if (result & teDirtyBits)
-		{
-			updateTEData();
-		}
-		if (result & TEM_CHANGE_MEDIA)
+		if (decoded && decoded->mHasTEs)
 		{
-			retval |= MEDIA_FLAGS_CHANGED;
+			S32 result = applyParsedTEBuffer(decoded->mTEContents);
+			if (result & teDirtyBits)
+			{
+				updateTEData();
+			}
+			if (result & TEM_CHANGE_MEDIA)
+			{
+				retval |= MEDIA_FLAGS_CHANGED;
+			}
 		}
 	}
 	else
@@ -484,13 +515,9 @@ U32 LLVOVolume::processUpdateMessage(LLMessageSystem *mesgsys,
 		}
 		else
 		{
-			S32 texture_length = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_TextureEntry);
-			if (texture_length)
+			if (decoded && decoded->mHasTEs)
 			{
-				U8							tdpbuffer[1024];
-				LLDataPackerBinaryBuffer	tdp(tdpbuffer, 1024);
-				mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_TextureEntry, tdpbuffer, 0, block_num, 1024);
-				S32 result = unpackTEMessage(tdp);
+				S32 result = applyParsedTEBuffer(decoded->mTEContents);
 				if (result & teDirtyBits)
 				{
 					updateTEData();
@@ -1440,6 +1467,19 @@ BOOL LLVOVolume::calcLOD()
         setDebugText(llformat("%d", cur_detail));
 	}
 
+	static LLCachedControl<bool> async_volume_lod(gSavedSettings, "RenderAsyncVolumeLOD", true);
+	if (cur_detail != mLOD && async_volume_lod && !mVolumeImpl && getVolume() && !getVolume()->isUnique()
+		&& !sVolumeManager->requestVolume(getVolume()->getParams(), cur_detail))
+	{
+		// Keep drawing the current LOD until the pool has built the new one
+		if (!mLODPending)
+		{
+			mLODPending = true;
+			sPendingLODVolumes.push_back(this);
+		}
+		return FALSE;
+	}
+
 	if (cur_detail != mLOD)
 	{
         LL_DEBUGS("DynamicBox","CalcLOD") << "new LOD " << cur_detail << " change from " << mLOD 
@@ -5247,6 +5287,47 @@ void LLVolumeGeometryManager::getGeometry(LLSpatialGroup* group)
 static LLTrace::BlockTimerStatHandle FTM_REBUILD_VOLUME_VB("Volume VB");
 static LLTrace::BlockTimerStatHandle FTM_REBUILD_VOLUME_FACE_LIST("Build Face List");
 static LLTrace::BlockTimerStatHandle FTM_REBUILD_VOLUME_GEN_DRAW_INFO("Gen Draw Info");
+static LLTrace::BlockTimerStatHandle FTM_REBUILD_VOLUME_GEOM_JOBS("Geometry Jobs");
+
+// Faces per slice handed to a worker, most prim faces are only a few
+// hundred vertices.
+const U32 GEOMETRY_JOB_GRAIN = 16;
+
+// Copies queued by getGeometryVolume() for the buffers currently mapped.
+static std::vector<LLVolumeFaceGeometryJob> sGeometryJobs;
+
+// Runs the queued copies on the viewer thread pool, the main thread takes a
+// share too. Must happen before the buffers they write to are flushed.
+static void run_geometry_jobs()
+{
+	if (sGeometryJobs.empty())
+	{
+		return;
+	}
+
+	LL_RECORD_BLOCK_TIME(FTM_REBUILD_VOLUME_GEOM_JOBS);
+	const LLVolumeFaceGeometryJob* jobs = &sGeometryJobs[0];
+	LLThreadPool* pool = LLThreadPool::getInstance();
+	if (pool)
+	{
+		pool->parallelFor((U32)sGeometryJobs.size(), GEOMETRY_JOB_GRAIN,
+			[jobs](U32 begin, U32 end)
+			{
+				for (U32 i = begin; i < end; ++i)
+				{
+					jobs[i].run();
+				}
+			});
+	}
+	else
+	{
+		for (U32 i = 0; i < sGeometryJobs.size(); ++i)
+		{
+			jobs[i].run();
+		}
+	}
+	sGeometryJobs.clear();
+}
 
 static LLDrawPoolAvatar* get_avatar_drawpool(LLViewerObject* vobj)
 {
@@ -5951,6 +6032,8 @@ void LLVolumeGeometryManager::rebuildGeom(LLSpatialGroup* group)
 
 	group->mGeometryBytes = geometryBytes;
 
+	group->buildIndirectCommands();
+
 	if (!LLPipeline::sDelayVBUpdate)
 	{
 		//drawables have been rebuilt, clear rebuild status
@@ -6031,12 +6114,17 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 						{
 							llassert(!face->isState(LLFace::RIGGED));
 
+							LLVolumeFaceGeometryJob job;
 							if (!face->getGeometryVolume(*volume, face->getTEOffset(), 
-								vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), face->getGeomIndex()))
+								vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), face->getGeomIndex(), false, &job))
 							{ //something's gone wrong with the vertex buffer accounting, rebuild this group 
 								group->dirtyGeom();
 								gPipeline.markRebuild(group, TRUE);
 							}
+							else if (!job.empty())
+							{
+								sGeometryJobs.push_back(job);
+							}
 
 
 							if (buff->isLocked() && buffer_count < MAX_BUFFER_COUNT)
@@ -6057,6 +6145,8 @@ void LLVolumeGeometryManager::rebuildMesh(LLSpatialGroup* group)
 			}
 		}
 		
+		run_geometry_jobs();
+
 		{
 			LL_RECORD_BLOCK_TIME(FTM_REBUILD_MESH_FLUSH);
 			for (LLVertexBuffer** iter = locked_buffer, ** end_iter = locked_buffer+buffer_count; iter != end_iter; ++iter)
@@ -6198,6 +6288,9 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
 	
 	LLSpatialGroup::buffer_map_t buffer_map;
 
+	// flushed once their geometry jobs have run
+	std::vector<LLVertexBuffer*> filled_buffers;
+
 	LLViewerTexture* last_tex = NULL;
 	S32 buffer_index = 0;
 
@@ -6450,11 +6543,16 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
 
 					llassert(!facep->isState(LLFace::RIGGED));
 
+					LLVolumeFaceGeometryJob job;
 					if (!facep->getGeometryVolume(*volume, te_idx, 
-						vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), index_offset,true))
+						vobj->getRelativeXform(), vobj->getRelativeXformInvTrans(), index_offset,true, &job))
 					{
 						LL_WARNS() << "Failed to get geometry for face!" << LL_ENDL;
 					}
+					else if (!job.empty())
+					{
+						sGeometryJobs.push_back(job);
+					}
 
 					if (drawablep->isState(LLDrawable::ANIMATED_CHILD))
 					{
@@ -6761,10 +6859,16 @@ U32 LLVolumeGeometryManager::genDrawInfo(LLSpatialGroup* group, U32 mask, LLFace
 
 		if (buffer)
 		{
-			buffer->flush();
+			filled_buffers.push_back(buffer);
 		}
 	}
 
+	run_geometry_jobs();
+	for (std::vector<LLVertexBuffer*>::iterator iter = filled_buffers.begin(); iter != filled_buffers.end(); ++iter)
+	{
+		(*iter)->flush();
+	}
+
 	group->mBufferMap[mask].clear();
 	for (LLSpatialGroup::buffer_texture_map_t::iterator i = buffer_map[mask].begin(); i != buffer_map[mask].end(); ++i)
 	{
@@ -181,7 +181,8 @@ public:
 	/*virtual*/ U32		processUpdateMessage(LLMessageSystem *mesgsys,
 											void **user_data,
 											U32 block_num, const EObjectUpdateType update_type,
-											LLDataPacker *dp);
+											LLDataPacker *dp,
+											LLDecodedObjectUpdate* decoded = NULL);
 
 	/*virtual*/ void	setSelected(BOOL sel);
 	/*virtual*/ BOOL	setDrawableParent(LLDrawable* parentp);
@@ -397,6 +398,9 @@ public:
 	static S32 getRenderComplexityMax() {return mRenderComplexity_last;}
 	static void updateRenderComplexity();
 
+	// Retries LOD switches that were waiting on a volume build, call once a frame
+	static void updatePendingLODs();
+
 	LLViewerTextureAnim *mTextureAnimp;
 	U8 mTexAnimMode;
     F32 mLODDistance;
@@ -410,6 +414,7 @@ private:
 	LLFrameTimer mTextureUpdateTimer;
 	S32			mLOD;
 	BOOL		mLODChanged;
+	bool		mLODPending;		// in sPendingLODVolumes
 	BOOL		mSculptChanged;
 	F32			mSpotLightPriority;
 	LLMatrix4	mRelativeXform;
@@ -438,6 +443,11 @@ public:
 protected:
 	static S32 sNumLODChanges;
 
+	// Volumes whose LOD switch waits on LLVolumeMgr::requestVolume(). Static
+	// groups only update LOD when the group's LOD changes, so these are
+	// retried from updatePendingLODs() until the new LOD is in.
+	static std::vector<LLPointer<LLVOVolume> > sPendingLODVolumes;
+
 	friend class LLVolumeImplFlexible;
 
 public:
@@ -207,6 +207,8 @@ bool LLPipeline::CameraOffset;
 F32 LLPipeline::CameraMaxCoF;
 F32 LLPipeline::CameraDoFResScale;
 F32 LLPipeline::RenderAutoHideSurfaceAreaLimit;
+bool LLPipeline::RenderSortDrawInfo;
+bool LLPipeline::RenderMultiDrawIndirect;
 LLTrace::EventStatHandle<S64> LLPipeline::sStatBatchSize("renderbatchsize");
 
 const F32 BACKLIGHT_DAY_MAGNITUDE_OBJECT = 0.1f;
@@ -264,6 +266,7 @@ LLTrace::BlockTimerStatHandle FTM_RENDER_UI_SCENE_MON("Scene Mon");
 
 static LLTrace::BlockTimerStatHandle FTM_STATESORT_DRAWABLE("Sort Drawables");
 static LLTrace::BlockTimerStatHandle FTM_STATESORT_POSTSORT("Post Sort");
+static LLTrace::BlockTimerStatHandle FTM_STATESORT_DRAWINFO("Sort Render Maps");
 
 static LLStaticHashedString sTint("tint");
 static LLStaticHashedString sAmbiance("ambiance");
@@ -337,6 +340,7 @@ bool	LLPipeline::sUseFarClip = true;
 bool	LLPipeline::sShadowRender = false;
 bool	LLPipeline::sWaterReflections = false;
 bool	LLPipeline::sRenderGlow = false;
+bool	LLPipeline::sMultiDrawIndirect = false;
 bool	LLPipeline::sReflectionRender = false;
 bool    LLPipeline::sDistortionRender = false;
 bool	LLPipeline::sImpostorRender = false;
@@ -407,6 +411,8 @@ LLPipeline::LLPipeline() :
 	mScreenWidth(0),
 	mScreenHeight(0)
 {
+	mScreenSamples = 0;
+	mPhysicsDisplay = NULL;
 	mNoiseMap = 0;
 	mTrueNoiseMap = 0;
 	mLightFunc = 0;
@@ -441,6 +447,7 @@ void LLPipeline::init()
 	sUseTriStrips = gSavedSettings.getBOOL("RenderUseTriStrips");
 	LLVertexBuffer::sUseStreamDraw = gSavedSettings.getBOOL("RenderUseStreamVBO");
 	LLVertexBuffer::sUseVAO = gSavedSettings.getBOOL("RenderUseVAO");
+	LLVertexBuffer::sUseStreamRing = gSavedSettings.getBOOL("RenderUseStreamRing");
 	LLVertexBuffer::sPreferStreamDraw = gSavedSettings.getBOOL("RenderPreferStreamDraw");
 	sRenderAttachedLights = gSavedSettings.getBOOL("RenderAttachedLights");
 	sRenderAttachedParticles = gSavedSettings.getBOOL("RenderAttachedParticles");
@@ -606,6 +613,8 @@ void LLPipeline::init()
 	connectRefreshCachedSettingsSafe("CameraDoFResScale");
 	connectRefreshCachedSettingsSafe("RenderAutoHideSurfaceAreaLimit");
 	gSavedSettings.getControl("RenderAutoHideSurfaceAreaLimit")->getCommitSignal()->connect(boost::bind(&LLPipeline::refreshCachedSettings));
+	connectRefreshCachedSettingsSafe("RenderSortDrawInfo");
+	connectRefreshCachedSettingsSafe("RenderMultiDrawIndirect");
 }
 
 LLPipeline::~LLPipeline()
@@ -775,9 +784,15 @@ void LLPipeline::allocatePhysicsBuffer()
 	GLuint resX = gViewerWindow->getWorldViewWidthRaw();
 	GLuint resY = gViewerWindow->getWorldViewHeightRaw();
 
-	if (mPhysicsDisplay.getWidth() != resX || mPhysicsDisplay.getHeight() != resY)
+	if (mPhysicsDisplay && (mPhysicsDisplay->getWidth() != resX || mPhysicsDisplay->getHeight() != resY))
 	{
-		mPhysicsDisplay.allocate(resX, resY, GL_RGBA, TRUE, FALSE, LLTexUnit::TT_RECT_TEXTURE, FALSE);
+		mTargetPool.release(mPhysicsDisplay);
+		mPhysicsDisplay = NULL;
+	}
+
+	if (!mPhysicsDisplay)
+	{
+		mPhysicsDisplay = mTargetPool.acquire(resX, resY, GL_RGBA, TRUE, FALSE, LLTexUnit::TT_RECT_TEXTURE, FALSE);
 	}
 }
 
@@ -919,14 +934,8 @@ bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY, U32 samples)
 		}
         
 		if (!mScreen.allocate(resX, resY, screenFormat, FALSE, FALSE, LLTexUnit::TT_RECT_TEXTURE, FALSE, samples)) return false;
-		if (samples > 0)
-		{
-			if (!mFXAABuffer.allocate(resX, resY, GL_RGBA, FALSE, FALSE, LLTexUnit::TT_TEXTURE, FALSE, samples)) return false;
-		}
-		else
-		{
-			mFXAABuffer.release();
-		}
+		// the FXAA target comes from mTargetPool when renderBloom needs it
+		mScreenSamples = samples;
 		
 		if (shadow_detail > 0 || ssao || RenderDepthOfField || samples > 0)
 		{ //only need mDeferredLight for shadows OR ssao OR dof OR fxaa
@@ -951,7 +960,7 @@ bool LLPipeline::allocateScreenBuffer(U32 resX, U32 resY, U32 samples)
 
         releaseShadowTargets();
 
-		mFXAABuffer.release();
+		mScreenSamples = 0;
 		mScreen.release();
 		mDeferredScreen.release(); //make sure to release any render targets that share a depth buffer with mDeferredScreen first
 		mDeferredDepth.release();
@@ -1158,6 +1167,9 @@ void LLPipeline::refreshCachedSettings()
 	CameraMaxCoF = gSavedSettings.getF32("CameraMaxCoF");
 	CameraDoFResScale = gSavedSettings.getF32("CameraDoFResScale");
 	RenderAutoHideSurfaceAreaLimit = gSavedSettings.getF32("RenderAutoHideSurfaceAreaLimit");
+	RenderSortDrawInfo = gSavedSettings.getBOOL("RenderSortDrawInfo");
+	RenderMultiDrawIndirect = gSavedSettings.getBOOL("RenderMultiDrawIndirect");
+	sMultiDrawIndirect = RenderMultiDrawIndirect && gGLManager.mHasMultiDrawIndirect;
 	RenderSpotLight = nullptr;
 	updateRenderDeferred();
 }
@@ -1184,11 +1196,7 @@ void LLPipeline::releaseGLBuffers()
 	mWaterDis.release();
     mBake.release();
 	mHighlight.release();
-	
-	for (U32 i = 0; i < 3; i++)
-	{
-		mGlow[i].release();
-	}
+	mGlow.release();
 
 	releaseScreenBuffers();
 
@@ -1214,8 +1222,9 @@ void LLPipeline::releaseScreenBuffers()
 {
 	mUIScreen.release();
 	mScreen.release();
-	mFXAABuffer.release();
-	mPhysicsDisplay.release();
+	mTargetPool.release(mPhysicsDisplay);
+	mPhysicsDisplay = NULL;
+	mTargetPool.flush();
 	mDeferredScreen.release();
 	mDeferredDepth.release();
 	mDeferredLight.release();
@@ -1265,10 +1274,7 @@ void LLPipeline::createGLBuffers()
 		const U32 glow_res = llmax(1, 
 			llmin(512, 1 << gSavedSettings.getS32("RenderGlowResolutionPow")));
 
-		for (U32 i = 0; i < 3; i++)
-		{
-			mGlow[i].allocate(512,glow_res,GL_RGBA,FALSE,FALSE);
-		}
+		mGlow.allocate(512,glow_res,GL_RGBA,FALSE,FALSE);
 
 		allocateScreenBuffer(resX,resY);
 		mScreenWidth = 0;
@@ -1912,6 +1918,8 @@ void LLPipeline::resetFrameStats()
 	sCompiles        = 0;
 	mNumVisibleFaces = 0;
 
+	mTargetPool.nextFrame();
+
 	if (mOldRenderDebugMask != mRenderDebugMask)
 	{
 		gObjectList.clearDebugText();
@@ -3850,10 +3858,17 @@ void LLPipeline::postSort(LLCamera& camera)
 			
 			for (LLSpatialGroup::drawmap_elem_t::iterator k = src_vec.begin(); k != src_vec.end(); ++k)
 			{
+				if (sMultiDrawIndirect && (*k)->mIndirectMerged)
+				{ //drawn by the indirect commands of an earlier batch
+					continue;
+				}
+
 				if (sMinRenderSize > 0.f)
 				{
+					//a merged run is drawn as a whole, so it is culled by the size of the whole run
+					const LLVector4a* extents = sMultiDrawIndirect && (*k)->mIndirectCount ? (*k)->mIndirectExtents : (*k)->mExtents;
 					LLVector4a bounds;
-					bounds.setSub((*k)->mExtents[1],(*k)->mExtents[0]);
+					bounds.setSub(extents[1], extents[0]);
 
 					if (llmax(llmax(bounds[0], bounds[1]), bounds[2]) > sMinRenderSize)
 					{
@@ -3895,6 +3910,18 @@ void LLPipeline::postSort(LLCamera& camera)
 		}
 	}
 	
+	if (RenderSortDrawInfo)
+	{ //group batches sharing shader, texture, vertex buffer and material state
+		LL_RECORD_BLOCK_TIME(FTM_STATESORT_DRAWINFO);
+		for (U32 type = LLRenderPass::PASS_SIMPLE; type < LLRenderPass::NUM_RENDER_TYPES; ++type)
+		{
+			if (LLRenderPass::isOrderIndependent(type))
+			{
+				sCull->sortRenderMap(type);
+			}
+		}
+	}
+
 	//flush particle VB
 	if (LLVOPartGroup::sVB)
 	{
@@ -4425,6 +4452,7 @@ void LLPipeline::renderGeom(LLCamera& camera, bool forceVBOUpdate)
 			LLDrawPool *poolp = *iter1;
 			
 			cur_type = poolp->getType();
+			LLRenderPass::sStatPoolType = cur_type;
 
 			//debug use
 			sCurRenderPoolType = cur_type ;
@@ -4486,6 +4514,7 @@ void LLPipeline::renderGeom(LLCamera& camera, bool forceVBOUpdate)
 			iter1 = iter2;
 			stop_glerror();
 		}
+		LLRenderPass::sStatPoolType = 0;
 		
 		LLAppViewer::instance()->pingMainloopTimeout("Pipeline:RenderDrawPoolsEnd");
 
@@ -4605,6 +4634,7 @@ void LLPipeline::renderGeomDeferred(LLCamera& camera)
 		LLDrawPool *poolp = *iter1;
 		
 		cur_type = poolp->getType();
+		LLRenderPass::sStatPoolType = cur_type;
 
 		pool_set_t::iterator iter2 = iter1;
 		if (hasRenderType(poolp->getType()) && poolp->getNumDeferredPasses() > 0)
@@ -4652,6 +4682,7 @@ void LLPipeline::renderGeomDeferred(LLCamera& camera)
 		iter1 = iter2;
 		stop_glerror();
 	}
+	LLRenderPass::sStatPoolType = 0;
 
 	gGLLastMatrix = NULL;
     gGL.matrixMode(LLRender::MM_MODELVIEW);
@@ -4682,6 +4713,7 @@ void LLPipeline::renderGeomPostDeferred(LLCamera& camera, bool do_occlusion)
 		LLDrawPool *poolp = *iter1;
 		
 		cur_type = poolp->getType();
+		LLRenderPass::sStatPoolType = cur_type;
 
 		if (occlude && cur_type >= LLDrawPool::POOL_GRASS)
 		{
@@ -4739,6 +4771,7 @@ void LLPipeline::renderGeomPostDeferred(LLCamera& camera, bool do_occlusion)
 		iter1 = iter2;
 		stop_glerror();
 	}
+	LLRenderPass::sStatPoolType = 0;
 
 	gGLLastMatrix = NULL;
 	gGL.matrixMode(LLRender::MM_MODELVIEW);
@@ -4770,6 +4803,7 @@ void LLPipeline::renderGeomShadow(LLCamera& camera)
 		LLDrawPool *poolp = *iter1;
 		
 		cur_type = poolp->getType();
+		LLRenderPass::sStatPoolType = cur_type;
 
 		pool_set_t::iterator iter2 = iter1;
 		if (hasRenderType(poolp->getType()) && poolp->getNumShadowPasses() > 0)
@@ -4814,6 +4848,7 @@ void LLPipeline::renderGeomShadow(LLCamera& camera)
 		iter1 = iter2;
 		stop_glerror();
 	}
+	LLRenderPass::sStatPoolType = 0;
 
 	gGLLastMatrix = NULL;
 	gGL.loadMatrix(gGLModelView);
@@ -4847,16 +4882,22 @@ void LLPipeline::renderPhysicsDisplay()
 {
 	if (!hasRenderDebugMask(LLPipeline::RENDER_DEBUG_PHYSICS_SHAPES))
 	{
+		mTargetPool.release(mPhysicsDisplay);
+		mPhysicsDisplay = NULL;
 		return;
 	}
 
 	allocatePhysicsBuffer();
+	if (!mPhysicsDisplay)
+	{
+		return;
+	}
 
 	gGL.flush();
-	mPhysicsDisplay.bindTarget();
+	mPhysicsDisplay->bindTarget();
 	glClearColor(0,0,0,1);
 	gGL.setColorMask(true, true);
-	mPhysicsDisplay.clear();
+	mPhysicsDisplay->clear();
 	glClearColor(0,0,0,0);
 
 	gGL.setColorMask(true, false);
@@ -4890,7 +4931,7 @@ void LLPipeline::renderPhysicsDisplay()
 		gDebugProgram.unbind();
 	}
 
-	mPhysicsDisplay.flush();
+	mPhysicsDisplay->flush();
 }
 
 extern std::set<LLSpatialGroup*> visible_selected_groups;
@@ -7435,6 +7476,7 @@ void LLPipeline::doResetVertexBuffers(bool forced)
 	sUseTriStrips = gSavedSettings.getBOOL("RenderUseTriStrips");
 	LLVertexBuffer::sUseStreamDraw = gSavedSettings.getBOOL("RenderUseStreamVBO");
 	LLVertexBuffer::sUseVAO = gSavedSettings.getBOOL("RenderUseVAO");
+	LLVertexBuffer::sUseStreamRing = gSavedSettings.getBOOL("RenderUseStreamRing");
 	LLVertexBuffer::sPreferStreamDraw = gSavedSettings.getBOOL("RenderPreferStreamDraw");
 	LLVertexBuffer::sEnableVBOs = gSavedSettings.getBOOL("RenderVBOEnable");
 	LLVertexBuffer::sDisableVBOMapping = LLVertexBuffer::sEnableVBOs && gSavedSettings.getBOOL("RenderVBOMappingDisable") ;
@@ -7585,8 +7627,8 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 	{
 		{
 			LL_RECORD_BLOCK_TIME(FTM_RENDER_BLOOM_FBO);
-			mGlow[2].bindTarget();
-			mGlow[2].clear();
+			mGlow.bindTarget();
+			mGlow.clear();
 		}
 		
 		gGlowExtractProgram.bind();
@@ -7625,7 +7667,7 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 		
 		gGL.getTexUnit(0)->unbind(mScreen.getUsage());
 
-		mGlow[2].flush();
+		mGlow.flush();
 	}
 
 	tc1.setVec(0,0);
@@ -7646,25 +7688,28 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 	}
 	F32 strength = RenderGlowStrength;
 
+	// Blur back and forth between mGlow and a scratch target. The kernel is
+	// even, so the result ends up in mGlow.
+	LLRenderTarget* glow_scratch = kernel > 0 ? mTargetPool.acquire(mGlow.getWidth(), mGlow.getHeight(), GL_RGBA, FALSE, FALSE) : NULL;
+	if (!glow_scratch)
+	{
+		kernel = 0;
+	}
+
 	gGlowProgram.bind();
 	gGlowProgram.uniform1f(LLShaderMgr::GLOW_STRENGTH, strength);
 
 	for (S32 i = 0; i < kernel; i++)
 	{
+		LLRenderTarget* glow_src = (i%2 == 0) ? &mGlow : glow_scratch;
+		LLRenderTarget* glow_dst = (i%2 == 0) ? glow_scratch : &mGlow;
 		{
 			LL_RECORD_BLOCK_TIME(FTM_RENDER_BLOOM_FBO);
-			mGlow[i%2].bindTarget();
-			mGlow[i%2].clear();
+			glow_dst->bindTarget();
+			glow_dst->clear();
 		}
 			
-		if (i == 0)
-		{
-			gGL.getTexUnit(0)->bind(&mGlow[2]);
-		}
-		else
-		{
-			gGL.getTexUnit(0)->bind(&mGlow[(i-1)%2]);
-		}
+		gGL.getTexUnit(0)->bind(glow_src);
 
 		if (i%2 == 0)
 		{
@@ -7687,10 +7732,11 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 		
 		gGL.end();
 		
-		mGlow[i%2].flush();
+		glow_dst->flush();
 	}
 
 	gGlowProgram.unbind();
+	mTargetPool.release(glow_scratch);
 
 	/*if (LLRenderTarget::sUseFBO)
 	{
@@ -7719,7 +7765,12 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 							RenderDepthOfField;
 
 
-		bool multisample = RenderFSAASamples > 1 && mFXAABuffer.isComplete();
+		LLRenderTarget* fxaa_target = NULL;
+		if (RenderFSAASamples > 1 && mScreenSamples > 0)
+		{
+			fxaa_target = mTargetPool.acquire(mScreen.getWidth(), mScreen.getHeight(), GL_RGBA, FALSE, FALSE, LLTexUnit::TT_TEXTURE, FALSE);
+		}
+		bool multisample = fxaa_target != NULL;
 
 		gViewerWindow->setup3DViewport();
 				
@@ -7990,7 +8041,7 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 		if (multisample)
 		{
 			//bake out texture2D with RGBL for FXAA shader
-			mFXAABuffer.bindTarget();
+			fxaa_target->bindTarget();
 			
 			S32 width = mScreen.getWidth();
 			S32 height = mScreen.getHeight();
@@ -8018,15 +8069,15 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 			shader->disableTexture(LLShaderMgr::DEFERRED_DIFFUSE, mDeferredLight.getUsage());
 			shader->unbind();
 			
-			mFXAABuffer.flush();
+			fxaa_target->flush();
 
 			shader = &gFXAAProgram;
 			shader->bind();
 
-			channel = shader->enableTexture(LLShaderMgr::DIFFUSE_MAP, mFXAABuffer.getUsage());
+			channel = shader->enableTexture(LLShaderMgr::DIFFUSE_MAP, fxaa_target->getUsage());
 			if (channel > -1)
 			{
-				mFXAABuffer.bindTexture(0, channel, LLTexUnit::TFO_BILINEAR);
+				fxaa_target->bindTexture(0, channel, LLTexUnit::TFO_BILINEAR);
 			}
 			
 			gGLViewport[0] = gViewerWindow->getWorldViewRectRaw().mLeft;
@@ -8035,8 +8086,8 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 			gGLViewport[3] = gViewerWindow->getWorldViewRectRaw().getHeight();
 			glViewport(gGLViewport[0], gGLViewport[1], gGLViewport[2], gGLViewport[3]);
 
-			F32 scale_x = (F32) width/mFXAABuffer.getWidth();
-			F32 scale_y = (F32) height/mFXAABuffer.getHeight();
+			F32 scale_x = (F32) width/fxaa_target->getWidth();
+			F32 scale_y = (F32) height/fxaa_target->getHeight();
 			shader->uniform2f(LLShaderMgr::FXAA_TC_SCALE, scale_x, scale_y);
 			shader->uniform2f(LLShaderMgr::FXAA_RCP_SCREEN_RES, 1.f/width*scale_x, 1.f/height*scale_y);
 			shader->uniform4f(LLShaderMgr::FXAA_RCP_FRAME_OPT, -0.5f/width*scale_x, -0.5f/height*scale_y, 0.5f/width*scale_x, 0.5f/height*scale_y);
@@ -8050,6 +8101,8 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 
 			gGL.flush();
 			shader->unbind();
+
+			mTargetPool.release(fxaa_target);
 		}
 	}
 	else
@@ -8094,7 +8147,7 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 			gGL.getTexUnit(1)->setTextureColorBlend(LLTexUnit::TBO_ADD, LLTexUnit::TBS_TEX_COLOR, LLTexUnit::TBS_PREV_COLOR);
 		}
 		
-		gGL.getTexUnit(0)->bind(&mGlow[1]);
+		gGL.getTexUnit(0)->bind(&mGlow);
 		gGL.getTexUnit(1)->bind(&mScreen);
 		
 		LLGLEnable multisample(RenderFSAASamples > 0 ? GL_MULTISAMPLE_ARB : 0);
@@ -8119,7 +8172,7 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 
 	gGL.setSceneBlendType(LLRender::BT_ALPHA);
 
-	if (hasRenderDebugMask(LLPipeline::RENDER_DEBUG_PHYSICS_SHAPES))
+	if (hasRenderDebugMask(LLPipeline::RENDER_DEBUG_PHYSICS_SHAPES) && mPhysicsDisplay)
 	{
 		if (LLGLSLShader::sNoFixedFunction)
 		{
@@ -8135,7 +8188,7 @@ void LLPipeline::renderBloom(bool for_snapshot, F32 zoom_factor, int subfield)
 		LLGLEnable blend(GL_BLEND);
 		gGL.color4f(1,1,1,0.75f);
 
-		gGL.getTexUnit(0)->bind(&mPhysicsDisplay);
+		gGL.getTexUnit(0)->bind(mPhysicsDisplay);
 
 		gGL.begin(LLRender::TRIANGLES);
 		gGL.texCoord2f(tc1.mV[0], tc1.mV[1]);
@@ -8259,7 +8312,7 @@ void LLPipeline::bindDeferredShader(LLGLSLShader& shader, LLRenderTarget* light_
 	channel = shader.enableTexture(LLShaderMgr::DEFERRED_BLOOM);
 	if (channel > -1)
 	{
-		mGlow[1].bindTexture(0, channel);
+		mGlow.bindTexture(0, channel);
 	}
 
 	stop_glerror();
@@ -38,6 +38,7 @@
 #include "llgl.h"
 #include "lldrawable.h"
 #include "llrendertarget.h"
+#include "llrendertargetpool.h"
 
 #include <stack>
 
@@ -597,6 +598,7 @@ public:
 	static bool				sRenderAttachedLights;
 	static bool				sRenderAttachedParticles;
 	static bool				sRenderDeferred;
+	static bool				sMultiDrawIndirect; // draw merged static batches with glMultiDrawElementsIndirect
 	static bool             sMemAllocationThrottled;
 	static S32				sVisibleLightCount;
 	static F32				sMinRenderSize;
@@ -608,17 +610,20 @@ public:
 	//screen texture
 	U32 					mScreenWidth;
 	U32 					mScreenHeight;
+	U32						mScreenSamples;	// samples the screen buffers were allocated with
 	
 	LLRenderTarget			mScreen;
 	LLRenderTarget			mUIScreen;
 	LLRenderTarget			mDeferredScreen;
-	LLRenderTarget			mFXAABuffer;
 	LLRenderTarget			mEdgeMap;
 	LLRenderTarget			mDeferredDepth;
 	LLRenderTarget			mOcclusionDepth;
 	LLRenderTarget			mDeferredLight;
 	LLRenderTarget			mHighlight;
-	LLRenderTarget			mPhysicsDisplay;
+	LLRenderTarget*			mPhysicsDisplay;	// from mTargetPool while the physics view is on
+
+	//targets only needed for part of a frame (FXAA, glow blur, debug views)
+	LLRenderTargetPool		mTargetPool;
 
     LLCullResult            mSky;
     LLCullResult            mReflectedObjects;
@@ -660,8 +665,8 @@ public:
 
     LLRenderTarget				mBake;
 
-	//texture for making the glow
-	LLRenderTarget				mGlow[3];
+	//glow result, blurred in place with a scratch target from mTargetPool
+	LLRenderTarget				mGlow;
 
 	//noise map
 	U32					mNoiseMap;
@@ -954,6 +959,8 @@ public:
 	static F32 CameraMaxCoF;
 	static F32 CameraDoFResScale;
 	static F32 RenderAutoHideSurfaceAreaLimit;
+	static bool RenderSortDrawInfo;
+	static bool RenderMultiDrawIndirect;
 };
 
 void render_bbox(const LLVector3 &min, const LLVector3 &max);